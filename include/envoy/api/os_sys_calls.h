@@ -59,6 +59,12 @@ public:
    */
   virtual SysCallSizeResult recvmsg(int sockfd, struct msghdr* msg, int flags) PURE;
 
+  /**
+   * @see recvmmsg (man 2 recvmmsg)
+   */
+  virtual SysCallIntResult recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags, struct timespec* timeout) PURE;
+
   /**
    * Release all resources allocated for fd.
    * @return zero on success, -1 returned otherwise.
@@ -109,6 +115,35 @@ public:
    */
   virtual SysCallSizeResult sendmsg(int fd, const msghdr* message, int flags) PURE;
 
+  /**
+   * @see man 2 sendmmsg
+   */
+  virtual SysCallIntResult sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                    int flags) PURE;
+
+  /**
+   * @return true if the platform supports recvmmsg() and sendmmsg().
+   */
+  virtual bool supportsMmsg() const PURE;
+
+  /**
+   * Create a non-blocking pipe whose file descriptors are closed on exec.
+   * @see man 2 pipe2
+   */
+  virtual SysCallIntResult pipe(int pipefd[2]) PURE;
+
+  /**
+   * Move data between file descriptors without copying it to user space. One of them must refer
+   * to a pipe.
+   * @see man 2 splice
+   */
+  virtual SysCallSizeResult splice(int fd_in, int fd_out, size_t length, unsigned int flags) PURE;
+
+  /**
+   * @return true if the platform supports splice().
+   */
+  virtual bool supportsSplice() const PURE;
+
   /**
    * @see man 2 getsockname
    */
@@ -5,16 +5,20 @@
 #include <memory>
 #include <string>
 
+#include "envoy/api/io_error.h"
 #include "envoy/api/os_sys_calls.h"
 #include "envoy/common/exception.h"
 #include "envoy/common/pure.h"
-#include "envoy/network/io_handle.h"
 
 #include "common/common/byte_order.h"
 
 #include "absl/strings/string_view.h"
 
 namespace Envoy {
+namespace Network {
+class IoHandle;
+} // namespace Network
+
 namespace Buffer {
 
 /**
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+
+/**
+ * A region of memory from which objects sharing a lifetime are allocated. Individual allocations
+ * are never freed; all of the memory is released at once when the arena is destroyed. The arena
+ * does not run destructors, objects allocated from it must be destroyed by their owners before the
+ * arena goes away.
+ */
+class Arena {
+public:
+  virtual ~Arena() = default;
+
+  /**
+   * Allocate memory from the arena.
+   * @param size supplies the number of bytes to allocate.
+   * @param alignment supplies the required alignment, which must be a power of two.
+   * @return a pointer to the allocated memory, which is valid until the arena is destroyed.
+   */
+  virtual void* allocate(size_t size, size_t alignment) PURE;
+
+  /**
+   * Construct an object and its shared_ptr control block in the arena. The last reference to the
+   * object must be dropped before the arena is destroyed.
+   */
+  template <class T, class... Args> std::shared_ptr<T> makeShared(Args&&... args);
+};
+
+/**
+ * Standard allocator adaptor for an Arena. Deallocation is a no-op.
+ */
+template <class T> class ArenaAllocator {
+public:
+  using value_type = T;
+
+  explicit ArenaAllocator(Arena& arena) : arena_(&arena) {}
+  template <class U> ArenaAllocator(const ArenaAllocator<U>& rhs) : arena_(&rhs.arena()) {}
+
+  T* allocate(size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+  void deallocate(T*, size_t) {}
+
+  Arena& arena() const { return *arena_; }
+
+  template <class U> bool operator==(const ArenaAllocator<U>& rhs) const {
+    return arena_ == &rhs.arena();
+  }
+  template <class U> bool operator!=(const ArenaAllocator<U>& rhs) const {
+    return arena_ != &rhs.arena();
+  }
+
+private:
+  Arena* arena_;
+};
+
+template <class T, class... Args> std::shared_ptr<T> Arena::makeShared(Args&&... args) {
+  return std::allocate_shared<T>(ArenaAllocator<T>(*this), std::forward<Args>(args)...);
+}
+
+} // namespace Envoy
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Io {
+
+/**
+ * Callback invoked for every completed request, with the user data the request was prepared with
+ * and the result of the operation: the number of bytes transferred, the accepted file descriptor,
+ * the poll events, or a negated errno value.
+ */
+using CompletionCb = std::function<void(void* user_data, int32_t result)>;
+
+enum class IoUringResult {
+  // The request was queued.
+  Ok,
+  // The submission queue is full. Submit the queued requests and retry.
+  Busy,
+  // The request could not be queued or submitted.
+  Failed
+};
+
+/**
+ * Abstraction of a Linux io_uring submission/completion queue pair. Requests are queued with the
+ * prepare*() methods and handed to the kernel in one system call by submit(). Completions are
+ * signalled on an eventfd and consumed by forEveryCompletion(). Not thread safe; each thread uses
+ * its own ring.
+ */
+class IoUring {
+public:
+  virtual ~IoUring() = default;
+
+  /**
+   * Create an eventfd which is signalled whenever a request completes. forEveryCompletion() does
+   * not read it, so it must be polled edge triggered.
+   * @return int the eventfd, owned by the ring.
+   */
+  virtual int registerEventfd() PURE;
+
+  /**
+   * Invoke the callback for every completion which has not been consumed yet.
+   * @param completion_cb supplies the callback.
+   */
+  virtual void forEveryCompletion(const CompletionCb& completion_cb) PURE;
+
+  /**
+   * Queue a readv(2) request.
+   * @param fd supplies the file descriptor to read from.
+   * @param iovecs supplies the buffers to read into. They must stay valid until completion.
+   * @param nr_vecs supplies the number of buffers.
+   * @param user_data supplies the value passed to the completion callback.
+   */
+  virtual IoUringResult prepareReadv(int fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                     void* user_data) PURE;
+
+  /**
+   * Queue a writev(2) request.
+   * @param fd supplies the file descriptor to write to.
+   * @param iovecs supplies the data to write. It must stay valid until completion.
+   * @param nr_vecs supplies the number of buffers.
+   * @param user_data supplies the value passed to the completion callback.
+   */
+  virtual IoUringResult prepareWritev(int fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                      void* user_data) PURE;
+
+  /**
+   * Queue an accept4(2) request with SOCK_NONBLOCK.
+   * @param fd supplies the listening socket.
+   * @param remote_addr supplies the storage for the address of the peer. It must stay valid until
+   *        completion.
+   * @param remote_addr_len supplies the size of the storage, and receives the size of the address.
+   *        It must stay valid until completion.
+   * @param user_data supplies the value passed to the completion callback.
+   */
+  virtual IoUringResult prepareAccept(int fd, struct sockaddr* remote_addr,
+                                      socklen_t* remote_addr_len, void* user_data) PURE;
+
+  /**
+   * Queue a one-shot poll(2) request, which completes with the events which occurred.
+   * @param fd supplies the file descriptor to poll.
+   * @param events supplies the events to wait for, e.g. POLLRDHUP.
+   * @param user_data supplies the value passed to the completion callback.
+   */
+  virtual IoUringResult preparePollAdd(int fd, uint32_t events, void* user_data) PURE;
+
+  /**
+   * Queue the cancellation of an earlier request. The cancelled request still completes, usually
+   * with -ECANCELED.
+   * @param cancelled_user_data supplies the user data of the request to cancel.
+   * @param user_data supplies the value passed to the completion callback of the cancellation.
+   */
+  virtual IoUringResult prepareCancel(void* cancelled_user_data, void* user_data) PURE;
+
+  /**
+   * Hand all queued requests to the kernel.
+   */
+  virtual IoUringResult submit() PURE;
+};
+
+using IoUringPtr = std::unique_ptr<IoUring>;
+
+} // namespace Io
+} // namespace Envoy
@@ -18,3 +18,15 @@ using ssize_t = int64_t;
 #define PACKED_STRUCT(definition, ...) definition, ##__VA_ARGS__ __attribute__((packed))
 
 #endif
+
+#ifdef __linux__
+#include <netinet/udp.h>
+
+// UDP generic segmentation and receive offload socket options, which older C libraries lack.
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
@@ -140,10 +140,12 @@ public:
    * Creates a logical udp listener on a specific port.
    * @param socket supplies the socket to listen on.
    * @param cb supplies the udp listener callbacks to invoke for listener events.
+   * @param batch_config supplies the batching of the listener's system calls.
    * @return Network::ListenerPtr a new listener that is owned by the caller.
    */
-  virtual Network::UdpListenerPtr createUdpListener(Network::Socket& socket,
-                                                    Network::UdpListenerCallbacks& cb) PURE;
+  virtual Network::UdpListenerPtr
+  createUdpListener(Network::Socket& socket, Network::UdpListenerCallbacks& cb,
+                    const Network::UdpListenerBatchConfig& batch_config) PURE;
   /**
    * Allocates a timer. @see Timer for docs on how to use the timer.
    * @param cb supplies the callback to invoke when the timer fires.
@@ -241,6 +241,16 @@ struct Http1Settings {
 
   // How header keys should be formatted when serializing HTTP/1.1 headers.
   HeaderKeyFormat header_key_format_{HeaderKeyFormat::Default};
+
+  enum class ParserImpl {
+    // The node.js http_parser, which parses one byte at a time.
+    HttpParser,
+    // Scans for line delimiters in bulk and parses each line of the head as a whole.
+    Vectorized,
+  };
+
+  // Which parser implementation the codec uses.
+  ParserImpl parser_impl_{ParserImpl::HttpParser};
 };
 
 /**
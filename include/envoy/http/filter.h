@@ -6,6 +6,7 @@
 #include <string>
 
 #include "envoy/access_log/access_log.h"
+#include "envoy/common/arena.h"
 #include "envoy/common/scope_tracker.h"
 #include "envoy/event/dispatcher.h"
 #include "envoy/grpc/status.h"
@@ -746,6 +747,14 @@ public:
    * @param handler supplies the handler to add.
    */
   virtual void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) PURE;
+
+  /**
+   * @return Arena& the arena of the stream the filter chain is created for. Filters may be
+   * allocated from it with Arena::makeShared() to avoid per-filter heap allocations. The arena is
+   * released when the stream is destroyed, so such filters must not be referenced, not even by a
+   * weak_ptr, by anything which may outlive the stream, e.g. pending asynchronous callbacks.
+   */
+  virtual Arena& streamArena() PURE;
 };
 
 /**
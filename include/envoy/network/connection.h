@@ -13,6 +13,8 @@
 #include "envoy/ssl/connection.h"
 #include "envoy/stream_info/stream_info.h"
 
+#include "common/common/assert.h"
+
 namespace Envoy {
 namespace Event {
 class Dispatcher;
@@ -59,6 +61,21 @@ public:
   virtual void onBelowWriteBufferLowWatermark() PURE;
 };
 
+/**
+ * Callbacks of the owner of a connection's socket while the connection is bypassed.
+ * @see Connection::bypassTransportSocket().
+ */
+class BypassCallbacks {
+public:
+  virtual ~BypassCallbacks() = default;
+
+  /**
+   * Called when the socket may have become readable or writable.
+   * @param events supplies the ready events as a mask of Event::FileReadyType values.
+   */
+  virtual void onSocketEvent(uint32_t events) PURE;
+};
+
 /**
  * Type of connection close to perform.
  */
@@ -294,6 +311,25 @@ public:
    *         occurred an empty string is returned.
    */
   virtual absl::string_view transportFailureReason() const PURE;
+
+  /**
+   * @return bool whether bypassTransportSocket() may be called, i.e. whether the connection is
+   *         open, its transport socket passes data through, the socket is accessible directly, it
+   *         has no filters other than a single read filter and no buffered data. Connections
+   *         which cannot be bypassed need not implement it.
+   */
+  virtual bool canBypassTransportSocket() const { return false; }
+
+  /**
+   * Let the caller move data to and from the connection's socket directly, e.g. with splice(2),
+   * instead of through the transport socket and the filters of the connection. From then on the
+   * connection neither reads from nor writes to the socket, and reports the socket's events to the
+   * callbacks until it is closed. Its close() does not wait for any data to be flushed. Must only
+   * be called if canBypassTransportSocket() returns true.
+   * @param callbacks supplies the callbacks to report socket events to.
+   * @return IoHandle& the socket.
+   */
+  virtual IoHandle& bypassTransportSocket(BypassCallbacks&) { NOT_IMPLEMENTED_GCOVR_EXCL_LINE; }
 };
 
 using ConnectionPtr = std::unique_ptr<Connection>;
@@ -1,13 +1,14 @@
 #pragma once
 
+#include <sys/socket.h>
+
 #include "envoy/api/io_error.h"
+#include "envoy/buffer/buffer.h"
 #include "envoy/common/pure.h"
 
-namespace Envoy {
-namespace Buffer {
-struct RawSlice;
-} // namespace Buffer
+#include "common/common/assert.h"
 
+namespace Envoy {
 namespace Network {
 namespace Address {
 class Instance;
@@ -59,6 +60,29 @@ public:
    */
   virtual Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) PURE;
 
+  /**
+   * Read data into the buffer, as Buffer::Instance::read() would. Handles which buffer read data
+   * themselves move it into the buffer without copying. By default the buffer reads through
+   * readv().
+   * @param buffer supplies the buffer to append the data to.
+   * @param max_length supplies the maximum length to read.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the bytes read for success.
+   */
+  virtual Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) {
+    return buffer.read(*this, max_length);
+  }
+
+  /**
+   * Write data out of the buffer and drain it, as Buffer::Instance::write() would. Handles which
+   * buffer written data themselves move it out of the buffer without copying. By default the
+   * buffer writes through writev().
+   * @param buffer supplies the buffer to write from.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the bytes written for success.
+   */
+  virtual Api::IoCallUint64Result write(Buffer::Instance& buffer) { return buffer.write(*this); }
+
   /**
    * Send buffer to address.
    * @param slice points to the location of the data to be sent.
@@ -97,6 +121,9 @@ public:
     std::shared_ptr<const Address::Instance> local_address_;
     // The the source address from transport header.
     std::shared_ptr<const Address::Instance> peer_address_;
+    // If not 0, the kernel coalesced several datagrams of the same flow into the message (UDP_GRO)
+    // and this is the size of each of them but the last, which may be shorter.
+    uint64_t gso_size_{0};
   };
 
   /**
@@ -112,6 +139,80 @@ public:
    */
   virtual Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                           uint32_t self_port, RecvMsgOutput& output) PURE;
+
+  /**
+   * Receive multiple messages with one system call, one message per slice.
+   * @param slices points to the receiving buffers, one per message. Upon success, the length of
+   * each of the first rc_ slices is set to the number of bytes received into it.
+   * @param num_packets indicates the number of slices |slices| and of outputs |output| contains.
+   * @param self_port the port this handle is assigned to. @see recvmsg().
+   * @param output points to the outputs of each message, whose first rc_ entries are modified
+   * upon success. All of them must share the same dropped_packets_.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages received for success.
+   */
+  virtual Api::IoCallUint64Result recvmmsg(Buffer::RawSlice*, uint64_t, uint32_t,
+                                           RecvMsgOutput*) {
+    // Only called if supportsMmsg() returns true.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  struct SendMsgInput {
+    // The data of the message.
+    const Buffer::RawSlice* slices_;
+    uint64_t num_slice_;
+    // The source address whose port should be ignored, or nullptr to let the kernel select it.
+    const Address::Ip* self_ip_;
+    // The destination address.
+    const Address::Instance* peer_address_;
+    // If not 0, the kernel splits the message into datagrams of this size, but the last which
+    // may be shorter (UDP_SEGMENT).
+    uint64_t gso_size_;
+  };
+
+  /**
+   * Send multiple messages with one system call.
+   * @param messages points to the messages to send.
+   * @param num_messages indicates the number of messages |messages| contains.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = the number of messages sent for success. Messages are sent in order,
+   * so the first rc_ of them have been sent.
+   */
+  virtual Api::IoCallUint64Result sendmmsg(const SendMsgInput*, uint64_t) {
+    // Only called if supportsMmsg() returns true.
+    NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
+  }
+
+  /**
+   * @return true if recvmmsg() and sendmmsg() are supported.
+   */
+  virtual bool supportsMmsg() const { return false; }
+
+  /**
+   * @return true if data may be moved to and from fd() with splice(2), i.e. if the handle performs
+   *         no I/O of its own on the file descriptor.
+   */
+  virtual bool supportsSplice() const { return false; }
+
+  /**
+   * Shut down all or part of a full-duplex connection, as shutdown(2) would. Handles which buffer
+   * written data shut down writes only once that data has been written out. By default fd() is
+   * shut down right away and failures, which only happen on failed connections, are not reported.
+   * @param how supplies SHUT_RD, SHUT_WR or SHUT_RDWR.
+   * @return a Api::IoCallUint64Result with err_ = an Api::IoError instance or
+   * err_ = nullptr and rc_ = 0 for success.
+   */
+  virtual Api::IoCallUint64Result shutdown(int how) {
+    ::shutdown(fd(), how);
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  /**
+   * Drop the written data the handle buffers itself and has not written out yet, as
+   * ConnectionCloseType::NoFlush requires. close() otherwise writes it out first. Handles which do
+   * not buffer written data do nothing, as by default.
+   */
+  virtual void discardPendingWrites() {}
 };
 
 using IoHandlePtr = std::unique_ptr<IoHandle>;
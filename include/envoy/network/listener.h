@@ -157,6 +157,18 @@ struct UdpSendData {
   Buffer::Instance& buffer_;
 };
 
+/**
+ * Batching of the system calls of a UdpListener.
+ */
+struct UdpListenerBatchConfig {
+  // Maximum number of datagrams read or written with one system call. Datagrams are read and
+  // written one at a time if 1 or if the platform lacks recvmmsg()/sendmmsg().
+  uint32_t max_batch_size_{1};
+  // Whether to use UDP generic receive offload (UDP_GRO) and generic segmentation offload
+  // (UDP_SEGMENT) if the kernel supports them.
+  bool enable_udp_offload_{false};
+};
+
 /**
  * UDP listener callbacks.
  */
@@ -241,6 +253,19 @@ public:
    * sender.
    */
   virtual Api::IoCallUint64Result send(const UdpSendData& data) PURE;
+
+  /**
+   * Send multiple packets with as few system calls as possible. Consecutive packets of equal size
+   * to the same peer are sent as one message with UDP generic segmentation offload if it is
+   * enabled and supported.
+   *
+   * @param data supplies the packets to send.
+   * @param num_packets supplies the number of packets.
+   * @return the error code of the underlying send api if no packet was sent, or rc_ = the number of
+   * packets sent. Packets are sent in order and the buffers of the sent packets are drained. The
+   * remaining packets can be retried by the sender.
+   */
+  virtual Api::IoCallUint64Result sendBatch(const UdpSendData* data, uint64_t num_packets) PURE;
 };
 
 using UdpListenerPtr = std::unique_ptr<UdpListener>;
@@ -147,6 +147,13 @@ public:
    * @return the const SSL connection data if this is an SSL connection, or nullptr if it is not.
    */
   virtual Ssl::ConnectionInfoConstSharedPtr ssl() const PURE;
+
+  /**
+   * @return bool whether the socket reads and writes data unmodified and without inspecting it, so
+   *         that the connection may move data to and from the underlying socket directly. False
+   *         unless the socket opts in.
+   */
+  virtual bool passThrough() const { return false; }
 };
 
 using TransportSocketPtr = std::unique_ptr<TransportSocket>;
@@ -39,6 +39,13 @@ public:
    */
   virtual Http::StreamDecoderFilterCallbacks& getDecoderFilterCallbacks() const PURE;
 
+  /**
+   * @return bool whether getDecoderFilterCallbacks() may be called. This is false for requests
+   * made through Admin::request(), whose response is complete once the handler returns, and true
+   * by default.
+   */
+  virtual bool hasDecoderFilterCallbacks() const { return true; }
+
   /**
    * @return const Buffer::Instance* the fully buffered admin request if applicable.
    */
@@ -31,6 +31,20 @@ public:
    */
   virtual const std::vector<std::reference_wrapper<const Gauge>>& gauges() PURE;
 
+  /**
+   * @return the subset of counters() which have been incremented since the previous snapshot.
+   * Snapshots which do not track changes return all the counters.
+   */
+  virtual const std::vector<CounterSnapshot>& changedCounters() { return counters(); }
+
+  /**
+   * @return the subset of gauges() which have been updated since the previous snapshot.
+   * Snapshots which do not track changes return all the gauges.
+   */
+  virtual const std::vector<std::reference_wrapper<const Gauge>>& changedGauges() {
+    return gauges();
+  }
+
   /**
    * @return a snapshot of all histograms.
    */
@@ -50,6 +64,13 @@ public:
    */
   virtual void flush(MetricSnapshot& snapshot) PURE;
 
+  /**
+   * @return whether flush() must be called on the main thread. Otherwise it may be called on the
+   * thread which builds the snapshot, when stats are flushed on a dedicated thread. Calls of
+   * flush() never overlap either way. Sinks flush on the main thread unless they override this.
+   */
+  virtual bool flushOnMainThread() const { return true; }
+
   /**
    * Flush a single histogram sample. Note: this call is called synchronously as a part of recording
    * the metric, so implementations must be thread-safe.
@@ -94,6 +94,7 @@ public:
     static const uint8_t Used = 0x01;
     static const uint8_t LogicAccumulate = 0x02;
     static const uint8_t NeverImport = 0x04;
+    static const uint8_t Changed = 0x08;
   };
   virtual SymbolTable& symbolTable() PURE;
   virtual const SymbolTable& constSymbolTable() const PURE;
@@ -137,6 +138,14 @@ public:
   virtual void sub(uint64_t amount) PURE;
   virtual uint64_t value() const PURE;
 
+  /**
+   * Returns whether the gauge has been updated since the last call, and resets that state. This is
+   * called once per stats flush, so that sinks can skip the gauges which did not change. Gauges
+   * which do not track changes always report one.
+   * @return bool whether the gauge has been added to, subtracted from or set since the last call.
+   */
+  virtual bool latchChanged() { return true; }
+
   /**
    * @return the import mode, dictating behavior of the gauge across hot restarts.
    */
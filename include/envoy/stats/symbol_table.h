@@ -111,6 +111,18 @@ public:
    */
   virtual StoragePtr join(const StatNameVec& stat_names) const PURE;
 
+  /**
+   * Determines whether the dot-separated tokens of a stat name start with all of
+   * the tokens of a prefix, e.g. "a.b" is a prefix of "a.b" and "a.b.c", but not
+   * of "a.bc". This compares the encodings, and so it neither decodes the names
+   * nor takes the SymbolTable lock.
+   *
+   * @param stat_name the stat name.
+   * @param prefix the prefix to check for.
+   * @return bool true if prefix is empty, or if stat_name starts with its tokens.
+   */
+  virtual bool startsWith(StatName stat_name, StatName prefix) const PURE;
+
   /**
    * Populates a StatNameList from a list of encodings. This is not done at
    * construction time to enable StatNameList to be instantiated directly in
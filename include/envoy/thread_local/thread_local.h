@@ -7,6 +7,8 @@
 #include "envoy/common/pure.h"
 #include "envoy/event/dispatcher.h"
 
+#include "absl/types/optional.h"
+
 namespace Envoy {
 namespace ThreadLocal {
 
@@ -134,6 +136,20 @@ public:
    * @return Event::Dispatcher& the thread local dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * @return absl::optional<uint32_t> the index of the calling worker thread, in the order in
+   *         which the worker threads were registered, or absl::nullopt if the calling thread is
+   *         not a registered worker thread. Implementations which do not number their worker
+   *         threads report no thread as a worker thread.
+   */
+  virtual absl::optional<uint32_t> workerIndex() { return absl::nullopt; }
+
+  /**
+   * @return uint32_t the number of registered worker threads. Must be called on the main thread.
+   *         Implementations which do not number their worker threads report none.
+   */
+  virtual uint32_t workerCount() { return 0; }
 };
 
 } // namespace ThreadLocal
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
 #include <string>
 
 #include "envoy/api/v2/core/base.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/network/address.h"
 #include "envoy/network/transport_socket.h"
 #include "envoy/stats/primitive_stats_macros.h"
@@ -53,6 +55,30 @@ struct HostStats {
 
 class ClusterInfo;
 
+/**
+ * Estimates the response time of an upstream host from the response times of its past requests.
+ * Shared by all workers, so implementations must be thread safe.
+ */
+class ResponseTimeEstimator {
+public:
+  virtual ~ResponseTimeEstimator() = default;
+
+  /**
+   * Record the response time of a request to the host.
+   * @param response_time supplies the time between sending the request and receiving the full
+   *        response.
+   * @param now supplies the current monotonic time.
+   */
+  virtual void putResponseTime(std::chrono::microseconds response_time, MonotonicTime now) PURE;
+
+  /**
+   * @param now supplies the current monotonic time.
+   * @return double the estimated response time of the host in microseconds as of now, or 0 if no
+   *         response time has been recorded.
+   */
+  virtual double estimate(MonotonicTime now) const PURE;
+};
+
 /**
  * A description of an upstream host.
  */
@@ -95,6 +121,12 @@ public:
    */
   virtual HealthCheckHostMonitor& healthChecker() const PURE;
 
+  /**
+   * @return the host's response time estimator, only fed if the cluster uses the peak EWMA load
+   *         balancer.
+   */
+  virtual ResponseTimeEstimator& responseTimeEstimator() const PURE;
+
   /**
    * @return the hostname associated with the host if any.
    * Empty string "" indicates that hostname is not a DNS name.
@@ -113,6 +113,14 @@ public:
    * @return LoadBalancerPtr a new load balancer.
    */
   virtual LoadBalancerPtr create() PURE;
+
+  /**
+   * @return bool whether worker local load balancers must be re-created on host membership
+   *         changes. Factories whose load balancers snapshot state at create() return true;
+   *         factories whose load balancers follow a table published by the thread aware load
+   *         balancer return false.
+   */
+  virtual bool recreateOnHostChange() const { return true; }
 };
 
 using LoadBalancerFactorySharedPtr = std::shared_ptr<LoadBalancerFactory>;
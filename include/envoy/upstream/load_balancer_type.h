@@ -22,7 +22,8 @@ enum class LoadBalancerType {
   RingHash,
   OriginalDst,
   Maglev,
-  ClusterProvided
+  ClusterProvided,
+  PeakEwma
 };
 
 struct SubsetSelector {
@@ -519,6 +519,7 @@ public:
   COUNTER(lb_subsets_fallback_panic)                                                               \
   COUNTER(lb_subsets_removed)                                                                      \
   COUNTER(lb_subsets_selected)                                                                     \
+  COUNTER(lb_unhealthy_host_skipped)                                                               \
   COUNTER(lb_zone_cluster_too_small)                                                               \
   COUNTER(lb_zone_no_capacity_left)                                                                \
   COUNTER(lb_zone_number_differs)                                                                  \
@@ -550,6 +551,9 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_prefetch_total)                                                              \
+  COUNTER(upstream_cx_prefetch_used)                                                               \
+  COUNTER(upstream_cx_prefetch_wasted)                                                             \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -562,6 +566,7 @@ public:
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_forwarded)                                                                   \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(upstream_rq_pending_failure_eject)                                                       \
   COUNTER(upstream_rq_pending_overflow)                                                            \
@@ -750,6 +755,12 @@ public:
   virtual const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>&
   lbRingHashConfig() const PURE;
 
+  /**
+   * @return configuration for peak EWMA load balancing, only used if type is set to peak EWMA.
+   */
+  virtual const absl::optional<envoy::api::v2::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const PURE;
+
   /**
    * @return const absl::optional<envoy::api::v2::Cluster::OriginalDstLbConfig>& the configuration
    *         for the Original Destination load balancing policy, only used if type is set to
@@ -773,6 +784,27 @@ public:
    */
   virtual uint64_t maxRequestsPerConnection() const PURE;
 
+  /**
+   * @return float the ratio of connections, connecting or connected, that a connection pool keeps
+   *         to the number of requests it serves or has queued. Connections beyond the requests
+   *         are prefetched. 1 indicates no prefetching.
+   */
+  virtual float perUpstreamPrefetchRatio() const PURE;
+
+  /**
+   * @return uint32_t the number of connections, connecting or connected, that a connection pool
+   *         keeps regardless of its requests, so that a burst after an idle period finds them
+   *         ready. 0 indicates no reserve.
+   */
+  virtual uint32_t perUpstreamMinWarmConnections() const PURE;
+
+  /**
+   * @return uint32_t the number of workers which own the HTTP/2 connections to each host when
+   *         they are shared between workers. 0 indicates that every worker establishes its own
+   *         connections.
+   */
+  virtual uint32_t http2ConnectionSharingOwners() const PURE;
+
   /**
    * @return uint32_t the maximum number of response headers. The default value is 100. Results in a
    * reset if the number of headers exceeds this value.
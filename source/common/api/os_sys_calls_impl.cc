@@ -6,6 +6,8 @@
 
 #include <cerrno>
 
+#include "common/common/macros.h"
+
 namespace Envoy {
 namespace Api {
 
@@ -50,6 +52,21 @@ SysCallSizeResult OsSysCallsImpl::recvmsg(int sockfd, struct msghdr* msg, int fl
   return {rc, errno};
 }
 
+SysCallIntResult OsSysCallsImpl::recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags, struct timespec* timeout) {
+#ifdef __linux__
+  const int rc = ::recvmmsg(sockfd, msgvec, vlen, flags, timeout);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  UNREFERENCED_PARAMETER(timeout);
+  return {-1, ENOSYS};
+#endif
+}
+
 SysCallIntResult OsSysCallsImpl::ftruncate(int fd, off_t length) {
   const int rc = ::ftruncate(fd, length);
   return {rc, errno};
@@ -94,6 +111,69 @@ SysCallSizeResult OsSysCallsImpl::sendmsg(int fd, const msghdr* message, int fla
   return {rc, errno};
 }
 
+SysCallIntResult OsSysCallsImpl::sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                                          int flags) {
+#ifdef __linux__
+  const int rc = ::sendmmsg(sockfd, msgvec, vlen, flags);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(sockfd);
+  UNREFERENCED_PARAMETER(msgvec);
+  UNREFERENCED_PARAMETER(vlen);
+  UNREFERENCED_PARAMETER(flags);
+  return {-1, ENOSYS};
+#endif
+}
+
+bool OsSysCallsImpl::supportsMmsg() const {
+#ifdef __linux__
+  return true;
+#else
+  return false;
+#endif
+}
+
+SysCallIntResult OsSysCallsImpl::pipe(int pipefd[2]) {
+#ifdef __linux__
+  const int rc = ::pipe2(pipefd, O_NONBLOCK | O_CLOEXEC);
+#else
+  int rc = ::pipe(pipefd);
+  for (int i = 0; rc == 0 && i < 2; i++) {
+    if (::fcntl(pipefd[i], F_SETFL, O_NONBLOCK) == -1 ||
+        ::fcntl(pipefd[i], F_SETFD, FD_CLOEXEC) == -1) {
+      const int error = errno;
+      ::close(pipefd[0]);
+      ::close(pipefd[1]);
+      errno = error;
+      rc = -1;
+    }
+  }
+#endif
+  return {rc, errno};
+}
+
+SysCallSizeResult OsSysCallsImpl::splice(int fd_in, int fd_out, size_t length,
+                                         unsigned int flags) {
+#ifdef __linux__
+  const ssize_t rc = ::splice(fd_in, nullptr, fd_out, nullptr, length, flags);
+  return {rc, errno};
+#else
+  UNREFERENCED_PARAMETER(fd_in);
+  UNREFERENCED_PARAMETER(fd_out);
+  UNREFERENCED_PARAMETER(length);
+  UNREFERENCED_PARAMETER(flags);
+  return {-1, ENOSYS};
+#endif
+}
+
+bool OsSysCallsImpl::supportsSplice() const {
+#ifdef __linux__
+  return true;
+#else
+  return false;
+#endif
+}
+
 SysCallIntResult OsSysCallsImpl::getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) {
   const int rc = ::getsockname(sockfd, addr, addrlen);
   return {rc, errno};
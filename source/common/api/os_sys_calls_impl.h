@@ -18,6 +18,8 @@ public:
   SysCallSizeResult recvfrom(int sockfd, void* buffer, size_t length, int flags,
                              struct sockaddr* addr, socklen_t* addrlen) override;
   SysCallSizeResult recvmsg(int sockfd, struct msghdr* msg, int flags) override;
+  SysCallIntResult recvmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen, int flags,
+                            struct timespec* timeout) override;
   SysCallIntResult close(int fd) override;
   SysCallIntResult ftruncate(int fd, off_t length) override;
   SysCallPtrResult mmap(void* addr, size_t length, int prot, int flags, int fd,
@@ -31,6 +33,12 @@ public:
   SysCallSizeResult sendto(int fd, const void* buffer, size_t size, int flags, const sockaddr* addr,
                            socklen_t addrlen) override;
   SysCallSizeResult sendmsg(int fd, const msghdr* message, int flags) override;
+  SysCallIntResult sendmmsg(int sockfd, struct mmsghdr* msgvec, unsigned int vlen,
+                            int flags) override;
+  bool supportsMmsg() const override;
+  SysCallIntResult pipe(int pipefd[2]) override;
+  SysCallSizeResult splice(int fd_in, int fd_out, size_t length, unsigned int flags) override;
+  bool supportsSplice() const override;
   SysCallIntResult getsockname(int sockfd, sockaddr* addr, socklen_t* addrlen) override;
 };
 
@@ -1,16 +1,184 @@
 #include "common/buffer/buffer_impl.h"
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/common/macros.h"
 #include "common/common/stack_array.h"
+#include "common/common/thread.h"
 
 #include "event2/buffer.h"
 
 namespace Envoy {
 namespace Buffer {
 
+constexpr uint64_t SlicePool::SizeClasses[];
+constexpr uint32_t SlicePool::NumSizeClasses;
+constexpr uint32_t SlicePool::Unpooled;
+constexpr uint64_t SlicePool::MaxCachedBytesPerSizeClass;
+
+namespace {
+
+// Every allocation is preceded by a header recording its size class, so that deallocate() does
+// not depend on the (already destroyed) slice. It is padded to keep the slice maximally aligned.
+struct alignas(alignof(std::max_align_t)) SlicePoolHeader {
+  uint32_t size_class_;
+};
+
+class SlicePoolThreadCache;
+
+// Registry of the live thread caches, for SlicePool::stats().
+struct SlicePoolRegistry {
+  Thread::MutexBasicLockable mutex_;
+  std::vector<const SlicePoolThreadCache*> caches_ ABSL_GUARDED_BY(mutex_);
+  // Hits and misses of the threads which have exited.
+  uint64_t retired_hits_ ABSL_GUARDED_BY(mutex_){};
+  uint64_t retired_misses_ ABSL_GUARDED_BY(mutex_){};
+};
+
+SlicePoolRegistry& slicePoolRegistry() { MUTABLE_CONSTRUCT_ON_FIRST_USE(SlicePoolRegistry); }
+
+class SlicePoolThreadCache {
+public:
+  SlicePoolThreadCache() {
+    SlicePoolRegistry& registry = slicePoolRegistry();
+    Thread::LockGuard lock(registry.mutex_);
+    registry.caches_.push_back(this);
+  }
+
+  ~SlicePoolThreadCache() {
+    release();
+    SlicePoolRegistry& registry = slicePoolRegistry();
+    Thread::LockGuard lock(registry.mutex_);
+    registry.caches_.erase(std::find(registry.caches_.begin(), registry.caches_.end(), this));
+    registry.retired_hits_ += hits_.load(std::memory_order_relaxed);
+    registry.retired_misses_ += misses_.load(std::memory_order_relaxed);
+  }
+
+  SlicePoolHeader* pop(uint32_t size_class) {
+    std::vector<SlicePoolHeader*>& free_list = free_lists_[size_class];
+    if (free_list.empty()) {
+      increment(misses_, 1);
+      return nullptr;
+    }
+    SlicePoolHeader* header = free_list.back();
+    free_list.pop_back();
+    increment(hits_, 1);
+    cached_bytes_.store(cached_bytes_.load(std::memory_order_relaxed) -
+                            SlicePool::SizeClasses[size_class],
+                        std::memory_order_relaxed);
+    return header;
+  }
+
+  bool push(SlicePoolHeader* header) {
+    const uint64_t size = SlicePool::SizeClasses[header->size_class_];
+    std::vector<SlicePoolHeader*>& free_list = free_lists_[header->size_class_];
+    if ((free_list.size() + 1) * size > SlicePool::MaxCachedBytesPerSizeClass) {
+      return false;
+    }
+    free_list.push_back(header);
+    increment(cached_bytes_, size);
+    return true;
+  }
+
+  void release() {
+    for (std::vector<SlicePoolHeader*>& free_list : free_lists_) {
+      for (SlicePoolHeader* header : free_list) {
+        ::operator delete(header);
+      }
+      free_list.clear();
+    }
+    cached_bytes_.store(0, std::memory_order_relaxed);
+  }
+
+  void addTo(SlicePool::Stats& stats) const {
+    stats.hits_ += hits_.load(std::memory_order_relaxed);
+    stats.misses_ += misses_.load(std::memory_order_relaxed);
+    stats.cached_bytes_ += cached_bytes_.load(std::memory_order_relaxed);
+  }
+
+private:
+  // The counters are only written by the owning thread, so a relaxed load and store is enough and
+  // avoids a locked instruction on the data path. Other threads only read them.
+  static void increment(std::atomic<uint64_t>& counter, uint64_t delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+  }
+
+  std::vector<SlicePoolHeader*> free_lists_[SlicePool::NumSizeClasses];
+  std::atomic<uint64_t> hits_{};
+  std::atomic<uint64_t> misses_{};
+  std::atomic<uint64_t> cached_bytes_{};
+};
+
+// Set once the calling thread's cache has been destroyed during thread exit, after which slices
+// freed by other thread_local destructors go straight back to the heap.
+thread_local bool slice_pool_thread_cache_destroyed = false;
+
+struct SlicePoolThreadCacheHolder {
+  ~SlicePoolThreadCacheHolder() { slice_pool_thread_cache_destroyed = true; }
+  SlicePoolThreadCache cache_;
+};
+
+SlicePoolThreadCache* slicePoolThreadCache() {
+  if (slice_pool_thread_cache_destroyed) {
+    return nullptr;
+  }
+  static thread_local SlicePoolThreadCacheHolder holder;
+  return &holder.cache_;
+}
+
+} // namespace
+
+void* SlicePool::allocate(uint64_t size, uint32_t size_class) {
+  SlicePoolHeader* header = nullptr;
+  if (size_class != Unpooled) {
+    SlicePoolThreadCache* cache = slicePoolThreadCache();
+    if (cache != nullptr) {
+      header = cache->pop(size_class);
+    }
+  }
+  if (header == nullptr) {
+    header = static_cast<SlicePoolHeader*>(::operator new(sizeof(SlicePoolHeader) + size));
+    header->size_class_ = size_class;
+  }
+  return header + 1;
+}
+
+void SlicePool::deallocate(void* address) {
+  SlicePoolHeader* header = static_cast<SlicePoolHeader*>(address) - 1;
+  if (header->size_class_ != Unpooled) {
+    SlicePoolThreadCache* cache = slicePoolThreadCache();
+    if (cache != nullptr && cache->push(header)) {
+      return;
+    }
+  }
+  ::operator delete(header);
+}
+
+SlicePool::Stats SlicePool::stats() {
+  SlicePoolRegistry& registry = slicePoolRegistry();
+  Thread::LockGuard lock(registry.mutex_);
+  Stats stats;
+  stats.hits_ = registry.retired_hits_;
+  stats.misses_ = registry.retired_misses_;
+  for (const SlicePoolThreadCache* cache : registry.caches_) {
+    cache->addTo(stats);
+  }
+  return stats;
+}
+
+void SlicePool::releaseThreadCache() {
+  SlicePoolThreadCache* cache = slicePoolThreadCache();
+  if (cache != nullptr) {
+    cache->release();
+  }
+}
+
 void OwnedImpl::add(const void* data, uint64_t size) {
   if (old_impl_) {
     evbuffer_add(buffer_.get(), data, size);
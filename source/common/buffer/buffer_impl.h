@@ -193,6 +193,73 @@ protected:
 
 using SlicePtr = std::unique_ptr<Slice>;
 
+/**
+ * Per-thread cache of the storage behind OwnedSlices. Slices with a capacity of 4 KiB, 16 KiB or
+ * 64 KiB (which covers socket reads and most appends) are allocated from the calling thread's free
+ * list for their size class when it is not empty. When freed, their storage is pushed onto the
+ * free list of the freeing thread, up to MaxCachedBytesPerSizeClass per size class, and otherwise
+ * returned to the heap. This takes a malloc/free pair off the data path of every read and write
+ * on a worker.
+ */
+class SlicePool {
+public:
+  // Data capacities of the pooled size classes, in bytes.
+  static constexpr uint64_t SizeClasses[] = {4096, 16384, 65536};
+  static constexpr uint32_t NumSizeClasses = 3;
+  // Size class of storage which is not pooled.
+  static constexpr uint32_t Unpooled = NumSizeClasses;
+  // Upper bound of the free storage cached by each thread for each size class, in bytes.
+  static constexpr uint64_t MaxCachedBytesPerSizeClass = 256 * 1024;
+
+  struct Stats {
+    // Allocations served from a free list.
+    uint64_t hits_{};
+    // Allocations of a pooled size class which found an empty free list.
+    uint64_t misses_{};
+    // Storage currently held on free lists, in bytes.
+    uint64_t cached_bytes_{};
+  };
+
+  /**
+   * @param data_size supplies the minimum capacity of a slice.
+   * @return uint32_t the smallest size class that fits data_size, or Unpooled if it is larger than
+   *         all of them.
+   */
+  static uint32_t sizeClass(uint64_t data_size) {
+    for (uint32_t size_class = 0; size_class < NumSizeClasses; size_class++) {
+      if (data_size <= SizeClasses[size_class]) {
+        return size_class;
+      }
+    }
+    return Unpooled;
+  }
+
+  /**
+   * Allocate storage. All allocations of a pooled size class must have the same size.
+   * @param size supplies the number of bytes to allocate.
+   * @param size_class supplies the size class of the allocation or Unpooled.
+   * @return void* the storage, to be freed with deallocate().
+   */
+  static void* allocate(uint64_t size, uint32_t size_class);
+
+  /**
+   * Free storage returned by allocate(), possibly caching it for reuse on the calling thread.
+   * @param address supplies the storage.
+   */
+  static void deallocate(void* address);
+
+  /**
+   * @return Stats the pool statistics summed over all threads. Hits and misses of threads which
+   *         have exited are included.
+   */
+  static Stats stats();
+
+  /**
+   * Return the storage cached by the calling thread to the heap.
+   */
+  static void releaseThreadCache();
+};
+
 // OwnedSlice can not be derived from as it has variable sized array as member.
 class OwnedSlice final : public Slice, public InlineStorage {
 public:
@@ -221,15 +288,30 @@ public:
     return slice;
   }
 
+  // Storage comes from, and is returned to, the SlicePool. As in InlineStorage, defining only the
+  // single argument form keeps C++14 from pairing the placement new below with the sized delete.
+  static void operator delete(void* address) { SlicePool::deallocate(address); }
+
 private:
   OwnedSlice(uint64_t size) : Slice(0, 0, size) { base_ = storage_; }
 
+  static void* operator new(size_t object_size, size_t data_size_bytes) {
+    return SlicePool::allocate(object_size + data_size_bytes,
+                               SlicePool::sizeClass(data_size_bytes));
+  }
+
   /**
-   * Compute a slice size big enough to hold a specified amount of data.
+   * Compute a slice size big enough to hold a specified amount of data. Sizes up to the largest
+   * SlicePool size class are rounded up to a size class, larger ones to a multiple of the page
+   * size.
    * @param data_size the minimum amount of data the slice must be able to store, in bytes.
    * @return a recommended slice size, in bytes.
    */
   static uint64_t sliceSize(uint64_t data_size) {
+    const uint32_t size_class = SlicePool::sizeClass(data_size);
+    if (size_class != SlicePool::Unpooled) {
+      return SlicePool::SizeClasses[size_class];
+    }
     static constexpr uint64_t PageSize = 4096;
     const uint64_t num_pages = (sizeof(OwnedSlice) + data_size + PageSize - 1) / PageSize;
     return num_pages * PageSize - sizeof(OwnedSlice);
@@ -0,0 +1,54 @@
+#include "common/common/arena_impl.h"
+
+#include <algorithm>
+#include <new>
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+
+constexpr size_t ArenaImpl::MinBlockSize;
+constexpr size_t ArenaImpl::MaxBlockSize;
+
+ArenaImpl::ArenaImpl(char* initial_block, size_t initial_block_size)
+    : cursor_(initial_block), end_(initial_block + initial_block_size) {}
+
+ArenaImpl::~ArenaImpl() {
+  while (heap_blocks_head_ != nullptr) {
+    Block* next = heap_blocks_head_->next_;
+    ::operator delete(heap_blocks_head_);
+    heap_blocks_head_ = next;
+  }
+}
+
+void* ArenaImpl::allocate(size_t size, size_t alignment) {
+  ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0);
+  const uintptr_t cursor = reinterpret_cast<uintptr_t>(cursor_);
+  const size_t padding = (alignment - (cursor & (alignment - 1))) & (alignment - 1);
+  if (cursor_ == nullptr || padding + size > static_cast<size_t>(end_ - cursor_)) {
+    return allocateFromNewBlock(size, alignment);
+  }
+
+  void* result = cursor_ + padding;
+  cursor_ += padding + size;
+  bytes_allocated_ += padding + size;
+  return result;
+}
+
+void* ArenaImpl::allocateFromNewBlock(size_t size, size_t alignment) {
+  // Blocks start max_align_t aligned, only stricter alignments need room for padding.
+  const size_t worst_case = size + (alignment > alignof(std::max_align_t) ? alignment : 0);
+  const size_t block_size = std::max(next_block_size_, worst_case);
+  next_block_size_ = std::min(next_block_size_ * 2, MaxBlockSize);
+
+  auto* block = static_cast<Block*>(::operator new(sizeof(Block) + block_size));
+  block->next_ = heap_blocks_head_;
+  heap_blocks_head_ = block;
+  heap_blocks_++;
+
+  cursor_ = reinterpret_cast<char*>(block + 1);
+  end_ = cursor_ + block_size;
+  return allocate(size, alignment);
+}
+
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "envoy/common/arena.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+
+/**
+ * Bump pointer implementation of Arena. Memory is carved sequentially out of blocks; when a block
+ * is exhausted a new one, twice the size of the previous one up to MaxBlockSize, is allocated from
+ * the heap. Not thread safe.
+ */
+class ArenaImpl : public Arena, NonCopyable {
+public:
+  static constexpr size_t MinBlockSize = 1024;
+  static constexpr size_t MaxBlockSize = 64 * 1024;
+
+  ArenaImpl() : ArenaImpl(nullptr, 0) {}
+  ~ArenaImpl() override;
+
+  // Arena
+  void* allocate(size_t size, size_t alignment) override;
+
+  /**
+   * @return the number of bytes handed out by allocate(), including alignment padding.
+   */
+  uint64_t bytesAllocated() const { return bytes_allocated_; }
+
+  /**
+   * @return the number of blocks allocated from the heap.
+   */
+  uint32_t heapBlocks() const { return heap_blocks_; }
+
+protected:
+  /**
+   * @param initial_block supplies storage to allocate from before going to the heap. It is not
+   *        owned by the arena and must outlive it.
+   * @param initial_block_size supplies the size of initial_block.
+   */
+  ArenaImpl(char* initial_block, size_t initial_block_size);
+
+private:
+  // Header of a heap allocated block. The usable memory follows it.
+  struct alignas(alignof(std::max_align_t)) Block {
+    Block* next_;
+  };
+
+  void* allocateFromNewBlock(size_t size, size_t alignment);
+
+  char* cursor_;
+  char* end_;
+  Block* heap_blocks_head_{};
+  size_t next_block_size_{MinBlockSize};
+  uint64_t bytes_allocated_{};
+  uint32_t heap_blocks_{};
+};
+
+/**
+ * ArenaImpl whose first Size bytes are stored inline, so that an arena embedded in another object
+ * serves small workloads without touching the heap at all.
+ */
+template <size_t Size> class InlineArenaImpl : public ArenaImpl {
+public:
+  InlineArenaImpl() : ArenaImpl(storage_, Size) {}
+
+private:
+  alignas(alignof(std::max_align_t)) char storage_[Size];
+};
+
+} // namespace Envoy
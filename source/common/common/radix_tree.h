@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * A compressed (radix) trie mapping string keys to values. Unlike TrieLookupTable, each node only
+ * stores the children that exist and edges carry whole substrings, so memory is proportional to
+ * the total key length rather than to 256 pointers per character. Lookup time is bounded by the
+ * length of the key. Intended for tables which are built once and then only read.
+ */
+template <class Value> class RadixTree {
+public:
+  /**
+   * Returns the value stored at the given key, creating a default constructed one if there is no
+   * entry for the key yet.
+   * @param key supplies the key.
+   * @return Value& the value associated with the key.
+   */
+  Value& getOrCreate(absl::string_view key) {
+    empty_ = false;
+    Node* node = &root_;
+    while (!key.empty()) {
+      std::unique_ptr<Node>* slot = findChild(*node, key[0]);
+      if (slot == nullptr) {
+        auto child = std::make_unique<Node>();
+        child->label_ = std::string(key);
+        Node* created = child.get();
+        node->children_.insert(lowerBound(*node, key[0]), std::move(child));
+        return created->value_;
+      }
+
+      const std::string& label = (*slot)->label_;
+      size_t common = 0;
+      while (common < label.size() && common < key.size() && label[common] == key[common]) {
+        common++;
+      }
+      if (common < label.size()) {
+        // Split the edge so that the shared part of the label gets its own node.
+        auto split = std::make_unique<Node>();
+        split->label_ = label.substr(0, common);
+        (*slot)->label_ = label.substr(common);
+        split->children_.push_back(std::move(*slot));
+        *slot = std::move(split);
+      }
+      key.remove_prefix(common);
+      node = slot->get();
+    }
+    return node->value_;
+  }
+
+  /**
+   * Invokes the callback for every node on the path of the key, from the root down, including the
+   * root and the node reached by the whole key if it exists. Nodes which were never passed to
+   * getOrCreate() hold a default constructed value.
+   * @param key supplies the key to walk.
+   * @param ignore_case supplies whether to ASCII lower case the key while walking. Keys must have
+   *        been inserted in lower case for this to be meaningful.
+   * @param cb supplies the callback, invoked with the number of key characters consumed and the
+   *        value of the node.
+   */
+  template <class Callback>
+  void forEachPrefix(absl::string_view key, bool ignore_case, Callback cb) const {
+    const Node* node = &root_;
+    size_t depth = 0;
+    while (true) {
+      cb(depth, node->value_);
+      if (depth == key.size()) {
+        return;
+      }
+
+      node = findChild(*node, fold(key[depth], ignore_case));
+      if (node == nullptr || node->label_.size() > key.size() - depth) {
+        return;
+      }
+      for (const char c : node->label_) {
+        if (fold(key[depth], ignore_case) != c) {
+          return;
+        }
+        depth++;
+      }
+    }
+  }
+
+  /**
+   * @return bool whether getOrCreate() has never been called.
+   */
+  bool empty() const { return empty_; }
+
+private:
+  struct Node {
+    // Edge label leading from the parent into this node.
+    std::string label_;
+    Value value_{};
+    // Children sorted by the first character of their label.
+    std::vector<std::unique_ptr<Node>> children_;
+  };
+
+  static char fold(char c, bool ignore_case) { return ignore_case ? absl::ascii_tolower(c) : c; }
+
+  static typename std::vector<std::unique_ptr<Node>>::const_iterator lowerBound(const Node& node,
+                                                                               char c) {
+    return std::lower_bound(
+        node.children_.begin(), node.children_.end(), c,
+        [](const std::unique_ptr<Node>& lhs, char rhs) { return lhs->label_[0] < rhs; });
+  }
+
+  static std::unique_ptr<Node>* findChild(Node& node, char c) {
+    const auto it = lowerBound(node, c);
+    if (it == node.children_.end() || (*it)->label_[0] != c) {
+      return nullptr;
+    }
+    return &node.children_[it - node.children_.cbegin()];
+  }
+
+  static const Node* findChild(const Node& node, char c) {
+    const auto it = lowerBound(node, c);
+    if (it == node.children_.end() || (*it)->label_[0] != c) {
+      return nullptr;
+    }
+    return it->get();
+  }
+
+  Node root_;
+  bool empty_{true};
+};
+
+} // namespace Envoy
@@ -1,5 +1,9 @@
 #include "common/common/to_lower_table.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace Envoy {
 ToLowerTable::ToLowerTable() {
   for (size_t c = 0; c < 256; c++) {
@@ -11,7 +15,22 @@ ToLowerTable::ToLowerTable() {
 }
 
 void ToLowerTable::toLowerCase(char* buffer, uint32_t size) const {
-  for (size_t i = 0; i < size; i++) {
+  size_t i = 0;
+#ifdef __SSE2__
+  // Convert whole 16 byte blocks first by OR-ing 0x20 into every byte in ['A', 'Z']. The signed
+  // comparisons are fine since both bounds are ASCII and bytes >= 0x80 compare as negative.
+  const __m128i before_upper = _mm_set1_epi8('A' - 1);
+  const __m128i after_upper = _mm_set1_epi8('Z' + 1);
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  for (; i + sizeof(__m128i) <= size; i += sizeof(__m128i)) {
+    __m128i* block = reinterpret_cast<__m128i*>(buffer + i);
+    const __m128i chunk = _mm_loadu_si128(block);
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_upper),
+                                        _mm_cmplt_epi8(chunk, after_upper));
+    _mm_storeu_si128(block, _mm_or_si128(chunk, _mm_and_si128(upper, case_bit)));
+  }
+#endif
+  for (; i < size; i++) {
     buffer[i] = table_[static_cast<uint8_t>(buffer[i])];
   }
 }
@@ -20,6 +20,8 @@
 #include "common/filesystem/watcher_impl.h"
 #include "common/network/connection_impl.h"
 #include "common/network/dns_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
+#include "common/network/listen_socket_impl.h"
 #include "common/network/listener_impl.h"
 #include "common/network/udp_listener_impl.h"
 
@@ -46,8 +48,14 @@ DispatcherImpl::DispatcherImpl(Buffer::WatermarkFactoryPtr&& factory, Api::Api&
   SignalAction::registerFatalErrorHandler(*this);
 #endif
   updateApproximateMonotonicTime();
-  base_scheduler_.registerOnPrepareCallback(
-      std::bind(&DispatcherImpl::updateApproximateMonotonicTime, this));
+  base_scheduler_.registerOnPrepareCallback([this]() {
+    updateApproximateMonotonicTime();
+    // Hand the io_uring requests queued during this iteration of the event loop to the kernel in
+    // one system call, right before polling.
+    if (io_uring_worker_ != nullptr) {
+      io_uring_worker_->submit();
+    }
+  });
 }
 
 DispatcherImpl::~DispatcherImpl() {
@@ -56,6 +64,15 @@ DispatcherImpl::~DispatcherImpl() {
 #endif
 }
 
+Io::IoUringWorker* DispatcherImpl::ioUringWorker() {
+  ASSERT(isThreadSafe());
+  if (!io_uring_worker_initialized_) {
+    io_uring_worker_initialized_ = true;
+    io_uring_worker_ = Io::IoUringWorker::create(*this);
+  }
+  return io_uring_worker_.get();
+}
+
 void DispatcherImpl::initializeStats(Stats::Scope& scope, const std::string& prefix) {
   // This needs to be run in the dispatcher's thread, so that we have a thread id to log.
   post([this, &scope, prefix] {
@@ -113,6 +130,15 @@ DispatcherImpl::createClientConnection(Network::Address::InstanceConstSharedPtr
                                        Network::TransportSocketPtr&& transport_socket,
                                        const Network::ConnectionSocket::OptionsSharedPtr& options) {
   ASSERT(isThreadSafe());
+  Io::IoUringWorker* io_uring_worker = ioUringWorker();
+  if (io_uring_worker != nullptr) {
+    // Reads and writes go through the ring once the connection is established.
+    auto io_handle = std::make_unique<Network::IoUringSocketHandleImpl>(
+        io_uring_worker->addSocket(address->socket(Network::Address::SocketType::Stream)));
+    return std::make_unique<Network::ClientConnectionImpl>(
+        *this, std::make_unique<Network::ClientSocketImpl>(std::move(io_handle), address),
+        source_address, std::move(transport_socket), options);
+  }
   return std::make_unique<Network::ClientConnectionImpl>(*this, address, source_address,
                                                          std::move(transport_socket), options);
 }
@@ -126,7 +152,11 @@ Network::DnsResolverSharedPtr DispatcherImpl::createDnsResolver(
 FileEventPtr DispatcherImpl::createFileEvent(int fd, FileReadyCb cb, FileTriggerType trigger,
                                              uint32_t events) {
   ASSERT(isThreadSafe());
-  return FileEventPtr{new FileEventImpl(*this, fd, cb, trigger, events)};
+  FileEventPtr file_event{new FileEventImpl(*this, fd, cb, trigger, events)};
+  if (io_uring_worker_ != nullptr) {
+    return io_uring_worker_->wrapFileEvent(fd, std::move(file_event), trigger, events);
+  }
+  return file_event;
 }
 
 Filesystem::WatcherPtr DispatcherImpl::createFilesystemWatcher() {
@@ -141,10 +171,11 @@ Network::ListenerPtr DispatcherImpl::createListener(Network::Socket& socket,
   return std::make_unique<Network::ListenerImpl>(*this, socket, cb, bind_to_port);
 }
 
-Network::UdpListenerPtr DispatcherImpl::createUdpListener(Network::Socket& socket,
-                                                          Network::UdpListenerCallbacks& cb) {
+Network::UdpListenerPtr
+DispatcherImpl::createUdpListener(Network::Socket& socket, Network::UdpListenerCallbacks& cb,
+                                  const Network::UdpListenerBatchConfig& batch_config) {
   ASSERT(isThreadSafe());
-  return std::make_unique<Network::UdpListenerImpl>(*this, socket, cb, timeSource());
+  return std::make_unique<Network::UdpListenerImpl>(*this, socket, cb, timeSource(), batch_config);
 }
 
 TimerPtr DispatcherImpl::createTimer(TimerCb cb) { return createTimerInternal(cb); }
@@ -18,6 +18,7 @@
 #include "common/common/thread.h"
 #include "common/event/libevent.h"
 #include "common/event/libevent_scheduler.h"
+#include "common/io/io_uring_worker_impl.h"
 #include "common/signal/fatal_error_handler.h"
 
 namespace Envoy {
@@ -40,6 +41,12 @@ public:
    */
   event_base& base() { return base_scheduler_.base(); }
 
+  /**
+   * @return Io::IoUringWorker* the io_uring worker of this dispatcher, created on first use, or
+   *         nullptr if io_uring is not enabled or not supported.
+   */
+  Io::IoUringWorker* ioUringWorker();
+
   // Event::Dispatcher
   TimeSource& timeSource() override { return api_.timeSource(); }
   void initializeStats(Stats::Scope& scope, const std::string& prefix) override;
@@ -59,8 +66,9 @@ public:
   Filesystem::WatcherPtr createFilesystemWatcher() override;
   Network::ListenerPtr createListener(Network::Socket& socket, Network::ListenerCallbacks& cb,
                                       bool bind_to_port) override;
-  Network::UdpListenerPtr createUdpListener(Network::Socket& socket,
-                                            Network::UdpListenerCallbacks& cb) override;
+  Network::UdpListenerPtr
+  createUdpListener(Network::Socket& socket, Network::UdpListenerCallbacks& cb,
+                    const Network::UdpListenerBatchConfig& batch_config) override;
   TimerPtr createTimer(TimerCb cb) override;
   void deferredDelete(DeferredDeletablePtr&& to_delete) override;
   void exit() override;
@@ -105,6 +113,10 @@ private:
   Buffer::WatermarkFactoryPtr buffer_factory_;
   LibeventScheduler base_scheduler_;
   SchedulerPtr scheduler_;
+  // Declared before the deferred deletion lists, so that connections pending deletion release
+  // their io_uring sockets before the worker is destroyed.
+  Io::IoUringWorkerPtr io_uring_worker_;
+  bool io_uring_worker_initialized_{};
   TimerPtr deferred_delete_timer_;
   TimerPtr post_timer_;
   std::vector<DeferredDeletablePtr> to_delete_1_;
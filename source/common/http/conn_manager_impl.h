@@ -28,6 +28,7 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/buffer/watermark_buffer.h"
+#include "common/common/arena_impl.h"
 #include "common/common/dump_state_utils.h"
 #include "common/common/linked_object.h"
 #include "common/grpc/common.h"
@@ -103,6 +104,14 @@ private:
           continue_headers_continued_(false), end_stream_(false), dual_filter_(dual_filter),
           decode_headers_called_(false), encode_headers_called_(false) {}
 
+    // Filter wrappers live in the arena of their stream. The memory is released with the arena,
+    // which outlives the filter lists, so deleting a wrapper only runs its destructor.
+    static void* operator new(size_t size, Arena& arena) {
+      return arena.allocate(size, alignof(std::max_align_t));
+    }
+    static void operator delete(void*) {}
+    static void operator delete(void*, Arena&) {}
+
     // Functions in the following block are called after the filter finishes processing
     // corresponding data. Those functions handle state updates and data storage (if needed)
     // according to the status returned by filter's callback functions.
@@ -474,6 +483,7 @@ private:
       addStreamEncoderFilterWorker(filter, true);
     }
     void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override;
+    Arena& streamArena() override { return arena_; }
 
     // Tracing::TracingConfig
     Tracing::OperationName operationName() const override;
@@ -601,6 +611,10 @@ private:
     HeaderMapPtr request_headers_;
     Buffer::WatermarkBufferPtr buffered_request_data_;
     HeaderMapPtr request_trailers_;
+    // Backs the filter wrappers and any filters allocated via streamArena(). Must be declared
+    // before, and so destroyed after, everything that references memory allocated from it. The
+    // inline part is sized for the wrappers of a typical filter chain.
+    InlineArenaImpl<1024> arena_;
     std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
     std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
     std::list<AccessLog::InstanceSharedPtr> access_log_handlers_;
@@ -4,6 +4,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "common/common/assert.h"
 #include "common/common/dump_state_utils.h"
@@ -295,6 +296,8 @@ struct HeaderMapImpl::StaticLookupTable : public TrieLookupTable<EntryCb> {
   }
 };
 
+constexpr size_t HeaderMapImpl::HashIndexMinHeaders;
+
 uint64_t HeaderMapImpl::appendToHeader(HeaderString& header, absl::string_view data) {
   if (data.empty()) {
     return 0;
@@ -385,6 +388,7 @@ void HeaderMapImpl::insertByKey(HeaderString&& key, HeaderString&& value) {
     addSize(key.size() + value.size());
     std::list<HeaderEntryImpl>::iterator i = headers_.insert(std::move(key), std::move(value));
     i->entry_ = i;
+    addToIndex(*i);
   }
 }
 
@@ -496,24 +500,48 @@ uint64_t HeaderMapImpl::byteSizeInternal() const {
 }
 
 const HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) const {
+  return getExisting(key.get());
+}
+
+HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
+  // The entry is owned by this map, the const is only there to share the lookup code.
+  auto* entry = const_cast<HeaderEntryImpl*>(getExisting(key.get()));
+  if (entry != nullptr) {
+    cached_byte_size_.reset();
+  }
+  return entry;
+}
+
+const HeaderMapImpl::HeaderEntryImpl* HeaderMapImpl::getExisting(absl::string_view key) const {
+  if (index_ != nullptr) {
+    const auto it = index_->find(key);
+    return it != index_->end() ? it->second : nullptr;
+  }
+
   for (const HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
+    if (header.key() == key) {
       return &header;
     }
   }
-
   return nullptr;
 }
 
-HeaderEntry* HeaderMapImpl::get(const LowerCaseString& key) {
-  for (HeaderEntryImpl& header : headers_) {
-    if (header.key() == key.get().c_str()) {
-      cached_byte_size_.reset();
-      return &header;
-    }
+void HeaderMapImpl::addToIndex(const HeaderEntryImpl& entry) {
+  // New entries are never placed before an existing entry with the same key, so an existing index
+  // entry is still the first one.
+  if (index_ != nullptr) {
+    index_->emplace(entry.key().getStringView(), &entry);
+  } else if (headers_.size() >= HashIndexMinHeaders) {
+    buildIndex();
   }
+}
 
-  return nullptr;
+void HeaderMapImpl::buildIndex() {
+  index_ = std::make_unique<HeaderIndex>(headers_.size());
+  for (const HeaderEntryImpl& header : headers_) {
+    // emplace() does not overwrite, so the first entry with a given key wins as in the scan.
+    index_->emplace(header.key().getStringView(), &header);
+  }
 }
 
 void HeaderMapImpl::iterate(ConstIterateCb cb, void* context) const {
@@ -561,6 +589,10 @@ void HeaderMapImpl::remove(const LowerCaseString& key) {
     StaticLookupResponse ref_lookup_response = cb(*this);
     removeInline(ref_lookup_response.entry_);
   } else {
+    if (index_ != nullptr && index_->erase(key.get()) == 0) {
+      // The index holds every key, so there is nothing to remove.
+      return;
+    }
     for (auto i = headers_.begin(); i != headers_.end();) {
       if (i->key() == key.get().c_str()) {
         subtractSize(i->key().size() + i->value().size());
@@ -573,6 +605,7 @@ void HeaderMapImpl::remove(const LowerCaseString& key) {
 }
 
 void HeaderMapImpl::removePrefix(const LowerCaseString& prefix) {
+  index_.reset();
   headers_.remove_if([&prefix, this](const HeaderEntryImpl& entry) {
     bool to_remove = absl::StartsWith(entry.key().getStringView(), prefix.get());
     if (to_remove) {
@@ -593,6 +626,9 @@ void HeaderMapImpl::removePrefix(const LowerCaseString& prefix) {
     }
     return to_remove;
   });
+  if (headers_.size() >= HashIndexMinHeaders) {
+    buildIndex();
+  }
 }
 
 void HeaderMapImpl::dumpState(std::ostream& os, int indent_level) const {
@@ -618,6 +654,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
 
   std::list<HeaderEntryImpl>::iterator i = headers_.insert(key);
   i->entry_ = i;
+  addToIndex(*i);
   *entry = &(*i);
   return **entry;
 }
@@ -633,6 +670,7 @@ HeaderMapImpl::HeaderEntryImpl& HeaderMapImpl::maybeCreateInline(HeaderEntryImpl
   addSize(key.get().size() + value.size());
   std::list<HeaderEntryImpl>::iterator i = headers_.insert(key, std::move(value));
   i->entry_ = i;
+  addToIndex(*i);
   *entry = &(*i);
   return **entry;
 }
@@ -655,6 +693,10 @@ void HeaderMapImpl::removeInline(HeaderEntryImpl** ptr_to_entry) {
   const uint64_t size_to_subtract = entry->entry_->key().size() + entry->entry_->value().size();
   subtractSize(size_to_subtract);
   *ptr_to_entry = nullptr;
+  if (index_ != nullptr) {
+    // There is at most one entry for an inline header key.
+    index_->erase(entry->key().getStringView());
+  }
   headers_.erase(entry->entry_);
 }
 
@@ -11,6 +11,8 @@
 #include "common/common/non_copyable.h"
 #include "common/http/headers.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -43,6 +45,11 @@ public:
  * If it is, we store a reference to it that can be accessed later directly. Most high performance
  * paths use O(1) direct access. In general, we try to copy as little as possible and allocate as
  * little as possible in any of the paths.
+ *
+ * Lookups of other headers by key scan the header list while the map is small. Once the map holds
+ * HashIndexMinHeaders or more headers, the insertion which reaches that size builds a hash index
+ * from key to the first matching entry, which is then maintained on insertion and removal. Lookups
+ * never modify the map, so that a const map can be shared between threads.
  */
 class HeaderMapImpl : public HeaderMap, NonCopyable {
 public:
@@ -54,6 +61,9 @@ public:
    */
   static uint64_t appendToHeader(HeaderString& header, absl::string_view data);
 
+  // The number of headers at which get() switches from a linear scan to a hash index.
+  static constexpr size_t HashIndexMinHeaders = 16;
+
   HeaderMapImpl();
   explicit HeaderMapImpl(
       const std::initializer_list<std::pair<LowerCaseString, std::string>>& values);
@@ -204,6 +214,9 @@ protected:
   HeaderEntryImpl& maybeCreateInline(HeaderEntryImpl** entry, const LowerCaseString& key,
                                      HeaderString&& value);
   HeaderEntryImpl* getExistingInline(absl::string_view key);
+  const HeaderEntryImpl* getExisting(absl::string_view key) const;
+  void addToIndex(const HeaderEntryImpl& entry);
+  void buildIndex();
 
   void removeInline(HeaderEntryImpl** entry);
   void addSize(uint64_t size);
@@ -212,6 +225,12 @@ protected:
   AllInlineHeaders inline_headers_;
   HeaderList headers_;
 
+  // Maps header keys to the first entry with that key. Built by the insertion which makes the map
+  // large enough, and rebuilt by operations that would be expensive to track, such as
+  // removePrefix(). The keys point into the entries themselves.
+  using HeaderIndex = absl::flat_hash_map<absl::string_view, const HeaderEntryImpl*>;
+  std::unique_ptr<HeaderIndex> index_;
+
   // When present, this holds the internal byte size of the HeaderMap. The value is removed once an
   // inline header entry is accessed and updated when refreshByteSize() is called.
   absl::optional<uint64_t> cached_byte_size_ = 0;
@@ -8,6 +8,10 @@
 #include "absl/strings/match.h"
 #include "nghttp2/nghttp2.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace Envoy {
 namespace Http {
 
@@ -131,8 +135,29 @@ bool HeaderUtility::matchHeaders(const HeaderMap& request_headers, const HeaderD
 }
 
 bool HeaderUtility::headerIsValid(const absl::string_view header_value) {
-  return (nghttp2_check_header_value(reinterpret_cast<const uint8_t*>(header_value.data()),
-                                     header_value.size()) != 0);
+  const char* data = header_value.data();
+  size_t remaining = header_value.size();
+#ifdef __SSE2__
+  // Valid header value characters are HTAB, SP, VCHAR and obs-text, i.e. everything except DEL
+  // and the control characters other than HTAB. Check 16 bytes at a time and leave the tail to
+  // nghttp2, which applies the same rule one byte at a time.
+  const __m128i max_control = _mm_set1_epi8(0x1f);
+  const __m128i htab = _mm_set1_epi8('\t');
+  const __m128i del = _mm_set1_epi8(0x7f);
+  while (remaining >= sizeof(__m128i)) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    // Unsigned chunk <= 0x1f, as SSE2 only has signed byte comparisons.
+    const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk);
+    const __m128i invalid = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi8(chunk, htab), control),
+                                         _mm_cmpeq_epi8(chunk, del));
+    if (_mm_movemask_epi8(invalid) != 0) {
+      return false;
+    }
+    data += sizeof(__m128i);
+    remaining -= sizeof(__m128i);
+  }
+#endif
+  return nghttp2_check_header_value(reinterpret_cast<const uint8_t*>(data), remaining) != 0;
 }
 
 void HeaderUtility::addHeaders(HeaderMap& headers, const HeaderMap& headers_to_add) {
@@ -1,5 +1,6 @@
 #include "common/http/http1/codec_impl.h"
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -10,15 +11,20 @@
 #include "envoy/network/connection.h"
 
 #include "common/common/enum_to_int.h"
+#include "common/common/macros.h"
 #include "common/common/stack_array.h"
 #include "common/common/utility.h"
 #include "common/http/exception.h"
 #include "common/http/header_utility.h"
 #include "common/http/headers.h"
 #include "common/http/http1/header_formatter.h"
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/vectorized_parser_impl.h"
 #include "common/http/utility.h"
 #include "common/runtime/runtime_impl.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Http {
 namespace Http1 {
@@ -30,6 +36,41 @@ const StringUtil::CaseUnorderedSet& caseUnorderdSetContainingUpgradeAndHttp2Sett
                          Http::Headers::get().ConnectionValues.Http2Settings);
 }
 
+/**
+ * Pre-serialized "HTTP/1.x <code> <reason phrase>\r\n" status lines for every status code in
+ * [100, 599], so that encoding a response head does not need to format the code and look up the
+ * reason phrase each time.
+ */
+class StatusLines {
+public:
+  StatusLines() {
+    for (uint64_t code = MinCode; code <= MaxCode; code++) {
+      const char* reason_phrase = CodeUtility::toString(static_cast<Code>(code));
+      http11_[code - MinCode] = absl::StrCat("HTTP/1.1 ", code, " ", reason_phrase, "\r\n");
+      http10_[code - MinCode] = absl::StrCat("HTTP/1.0 ", code, " ", reason_phrase, "\r\n");
+    }
+  }
+
+  /**
+   * @return the status line for the code, or nullptr if the code is out of the cached range.
+   */
+  const std::string* get(uint64_t code, bool http10) const {
+    if (code < MinCode || code > MaxCode) {
+      return nullptr;
+    }
+    return http10 ? &http10_[code - MinCode] : &http11_[code - MinCode];
+  }
+
+private:
+  static constexpr uint64_t MinCode = 100;
+  static constexpr uint64_t MaxCode = 599;
+
+  std::array<std::string, MaxCode - MinCode + 1> http11_;
+  std::array<std::string, MaxCode - MinCode + 1> http10_;
+};
+
+const StatusLines& statusLines() { CONSTRUCT_ON_FIRST_USE(StatusLines); }
+
 HeaderKeyFormatterPtr formatter(const Http::Http1Settings& settings) {
   if (settings.header_key_format_ == Http1Settings::HeaderKeyFormat::ProperCase) {
     return std::make_unique<ProperCaseHeaderKeyFormatter>();
@@ -53,15 +94,16 @@ StreamEncoderImpl::StreamEncoderImpl(ConnectionImpl& connection,
 void StreamEncoderImpl::encodeHeader(const char* key, uint32_t key_size, const char* value,
                                      uint32_t value_size) {
 
-  connection_.reserveBuffer(key_size + value_size + 4);
+  static constexpr char separator[] = {':', ' '};
+  static constexpr char crlf[] = {'\r', '\n'};
+
+  connection_.reserveBuffer(key_size + value_size + sizeof(separator) + sizeof(crlf));
   ASSERT(key_size > 0);
 
   connection_.copyToBuffer(key, key_size);
-  connection_.addCharToBuffer(':');
-  connection_.addCharToBuffer(' ');
+  connection_.copyToBuffer(separator, sizeof(separator));
   connection_.copyToBuffer(value, value_size);
-  connection_.addCharToBuffer('\r');
-  connection_.addCharToBuffer('\n');
+  connection_.copyToBuffer(crlf, sizeof(crlf));
 }
 void StreamEncoderImpl::encodeHeader(absl::string_view key, absl::string_view value) {
   this->encodeHeader(key.data(), key.size(), value.data(), value.size());
@@ -84,6 +126,9 @@ void StreamEncoderImpl::encode100ContinueHeaders(const HeaderMap& headers) {
 
 void StreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end_stream) {
   bool saw_content_length = false;
+  // Unlike status lines, header lines are not cached pre-serialized. Each one is copied into the
+  // reserved slice as is, and finding a cached copy would compare at least as many bytes as that
+  // copy does, since header maps carry no generation to key a cache on.
   headers.iterate(
       [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
         absl::string_view key_to_use = header.key().getStringView();
@@ -264,20 +309,26 @@ void ResponseStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end
   uint64_t numeric_status = Utility::getResponseStatus(headers);
 
   connection_.reserveBuffer(4096);
-  if (connection_.protocol() == Protocol::Http10 && connection_.supports_http_10()) {
-    connection_.copyToBuffer(HTTP_10_RESPONSE_PREFIX, sizeof(HTTP_10_RESPONSE_PREFIX) - 1);
+  const bool http10 = connection_.protocol() == Protocol::Http10 && connection_.supports_http_10();
+  const std::string* status_line = statusLines().get(numeric_status, http10);
+  if (status_line != nullptr) {
+    connection_.copyToBuffer(status_line->data(), status_line->size());
   } else {
-    connection_.copyToBuffer(RESPONSE_PREFIX, sizeof(RESPONSE_PREFIX) - 1);
-  }
-  connection_.addIntToBuffer(numeric_status);
-  connection_.addCharToBuffer(' ');
+    if (http10) {
+      connection_.copyToBuffer(HTTP_10_RESPONSE_PREFIX, sizeof(HTTP_10_RESPONSE_PREFIX) - 1);
+    } else {
+      connection_.copyToBuffer(RESPONSE_PREFIX, sizeof(RESPONSE_PREFIX) - 1);
+    }
+    connection_.addIntToBuffer(numeric_status);
+    connection_.addCharToBuffer(' ');
 
-  const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
-  uint32_t status_string_len = strlen(status_string);
-  connection_.copyToBuffer(status_string, status_string_len);
+    const char* status_string = CodeUtility::toString(static_cast<Code>(numeric_status));
+    uint32_t status_string_len = strlen(status_string);
+    connection_.copyToBuffer(status_string, status_string_len);
 
-  connection_.addCharToBuffer('\r');
-  connection_.addCharToBuffer('\n');
+    connection_.addCharToBuffer('\r');
+    connection_.addCharToBuffer('\n');
+  }
 
   if (numeric_status == 204 || numeric_status < 200) {
     // Per https://tools.ietf.org/html/rfc7230#section-3.3.2
@@ -312,47 +363,14 @@ void RequestStreamEncoderImpl::encodeHeaders(const HeaderMap& headers, bool end_
   StreamEncoderImpl::encodeHeaders(headers, end_stream);
 }
 
-http_parser_settings ConnectionImpl::settings_{
-    [](http_parser* parser) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onMessageBeginBase();
-      return 0;
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onUrl(at, length);
-      return 0;
-    },
-    nullptr, // on_status
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onHeaderField(at, length);
-      return 0;
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onHeaderValue(at, length);
-      return 0;
-    },
-    [](http_parser* parser) -> int {
-      return static_cast<ConnectionImpl*>(parser->data)->onHeadersCompleteBase();
-    },
-    [](http_parser* parser, const char* at, size_t length) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onBody(at, length);
-      return 0;
-    },
-    [](http_parser* parser) -> int {
-      static_cast<ConnectionImpl*>(parser->data)->onMessageCompleteBase();
-      return 0;
-    },
-    nullptr, // on_chunk_header
-    nullptr  // on_chunk_complete
-};
-
 const ToLowerTable& ConnectionImpl::toLowerTable() {
   static auto* table = new ToLowerTable();
   return *table;
 }
 
 ConnectionImpl::ConnectionImpl(Network::Connection& connection, Stats::Scope& stats,
-                               http_parser_type type, uint32_t max_headers_kb,
-                               const uint32_t max_headers_count,
+                               http_parser_type type, Http1Settings::ParserImpl parser_impl,
+                               uint32_t max_headers_kb, const uint32_t max_headers_count,
                                HeaderKeyFormatterPtr&& header_key_formatter)
     : connection_(connection), stats_{ALL_HTTP1_CODEC_STATS(POOL_COUNTER_PREFIX(stats, "http1."))},
       header_key_formatter_(std::move(header_key_formatter)),
@@ -362,8 +380,15 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, Stats::Scope& st
       strict_header_validation_(
           Runtime::runtimeFeatureEnabled("envoy.reloadable_features.strict_header_validation")) {
   output_buffer_.setWatermarks(connection.bufferLimit());
-  http_parser_init(&parser_, type);
-  parser_.data = this;
+  switch (parser_impl) {
+  case Http1Settings::ParserImpl::HttpParser:
+    parser_ = std::make_unique<LegacyHttpParserImpl>(type, parser_callbacks_);
+    break;
+  case Http1Settings::ParserImpl::Vectorized:
+    // No single line of the head can be larger than the whole head.
+    parser_ = std::make_unique<VectorizedParserImpl>(type, parser_callbacks_, max_headers_kb * 1024);
+    break;
+  }
 }
 
 void ConnectionImpl::completeLastHeader() {
@@ -413,7 +438,7 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
   }
 
   // Always unpause before dispatch.
-  http_parser_pause(&parser_, 0);
+  parser_->pause(false);
 
   ssize_t total_parsed = 0;
   if (data.length() > 0) {
@@ -436,11 +461,17 @@ void ConnectionImpl::dispatch(Buffer::Instance& data) {
 }
 
 size_t ConnectionImpl::dispatchSlice(const char* slice, size_t len) {
-  ssize_t rc = http_parser_execute(&parser_, &settings_, slice, len);
-  if (HTTP_PARSER_ERRNO(&parser_) != HPE_OK && HTTP_PARSER_ERRNO(&parser_) != HPE_PAUSED) {
+  ssize_t rc = parser_->execute(slice, len);
+  const http_errno error = parser_->error();
+  if (error != HPE_OK && error != HPE_PAUSED) {
+    if (error == HPE_HEADER_OVERFLOW) {
+      // Raised by parsers which limit the size of a line of the head.
+      error_code_ = Http::Code::RequestHeaderFieldsTooLarge;
+      sendProtocolError();
+      throw CodecProtocolException("headers size exceeds limit");
+    }
     sendProtocolError();
-    throw CodecProtocolException("http/1.1 protocol error: " +
-                                 std::string(http_errno_name(HTTP_PARSER_ERRNO(&parser_))));
+    throw CodecProtocolException("http/1.1 protocol error: " + std::string(http_errno_name(error)));
   }
 
   return rc;
@@ -504,7 +535,7 @@ int ConnectionImpl::onHeadersCompleteBase() {
   // This assert iterates over the HeaderMap.
   ASSERT(current_header_map_->byteSize().has_value() &&
          current_header_map_->byteSize() == current_header_map_->byteSizeInternal());
-  if (!(parser_.http_major == 1 && parser_.http_minor == 1)) {
+  if (!(parser_->httpMajor() == 1 && parser_->httpMinor() == 1)) {
     // This is not necessarily true, but it's good enough since higher layers only care if this is
     // HTTP/1.1 or not.
     protocol_ = Protocol::Http10;
@@ -549,7 +580,7 @@ void ConnectionImpl::onMessageCompleteBase() {
     // upgrade payload will be treated as stream body.
     ASSERT(!deferred_end_stream_headers_);
     ENVOY_CONN_LOG(trace, "Pausing parser due to upgrade.", connection_);
-    http_parser_pause(&parser_, 1);
+    parser_->pause(true);
     return;
   }
   onMessageComplete();
@@ -577,8 +608,8 @@ ServerConnectionImpl::ServerConnectionImpl(Network::Connection& connection, Stat
                                            ServerConnectionCallbacks& callbacks,
                                            Http1Settings settings, uint32_t max_request_headers_kb,
                                            const uint32_t max_request_headers_count)
-    : ConnectionImpl(connection, stats, HTTP_REQUEST, max_request_headers_kb,
-                     max_request_headers_count, formatter(settings)),
+    : ConnectionImpl(connection, stats, HTTP_REQUEST, settings.parser_impl_,
+                     max_request_headers_kb, max_request_headers_count, formatter(settings)),
       callbacks_(callbacks), codec_settings_(settings) {}
 
 void ServerConnectionImpl::onEncodeComplete() {
@@ -639,15 +670,15 @@ int ServerConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
   // to disconnect the connection but we shouldn't fire any more events since it doesn't make
   // sense.
   if (active_request_) {
-    const char* method_string = http_method_str(static_cast<http_method>(parser_.method));
+    const char* method_string = http_method_str(parser_->method());
 
     // Inform the response encoder about any HEAD method, so it can set content
     // length and transfer encoding headers correctly.
-    active_request_->response_encoder_.isResponseToHeadRequest(parser_.method == HTTP_HEAD);
+    active_request_->response_encoder_.isResponseToHeadRequest(parser_->method() == HTTP_HEAD);
 
     // Currently, CONNECT is not supported, however; http_parser_parse_url needs to know about
     // CONNECT
-    handlePath(*headers, parser_.method);
+    handlePath(*headers, parser_->method());
     ASSERT(active_request_->request_url_.empty());
 
     headers->insertMethod().value(method_string, strlen(method_string));
@@ -658,14 +689,15 @@ int ServerConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
     // with message complete. This allows upper layers to behave like HTTP/2 and prevents a proxy
     // scenario where the higher layers stream through and implicitly switch to chunked transfer
     // encoding because end stream with zero body length has not yet been indicated.
-    if (parser_.flags & F_CHUNKED ||
-        (parser_.content_length > 0 && parser_.content_length != ULLONG_MAX) || handling_upgrade_) {
+    if (parser_->isChunked() ||
+        (parser_->contentLength() > 0 && parser_->contentLength() != ULLONG_MAX) ||
+        handling_upgrade_) {
       active_request_->request_decoder_->decodeHeaders(std::move(headers), false);
 
       // If the connection has been closed (or is closing) after decoding headers, pause the parser
       // so we return control to the caller.
       if (connection_.state() != Network::Connection::State::Open) {
-        http_parser_pause(&parser_, 1);
+        parser_->pause(true);
       }
 
     } else {
@@ -716,7 +748,7 @@ void ServerConnectionImpl::onMessageComplete() {
   // Always pause the parser so that the calling code can process 1 request at a time and apply
   // back pressure. However this means that the calling code needs to detect if there is more data
   // in the buffer and dispatch it again.
-  http_parser_pause(&parser_, 1);
+  parser_->pause(true);
 }
 
 void ServerConnectionImpl::onResetStream(StreamResetReason reason) {
@@ -753,13 +785,13 @@ void ServerConnectionImpl::onBelowLowWatermark() {
 ClientConnectionImpl::ClientConnectionImpl(Network::Connection& connection, Stats::Scope& stats,
                                            ConnectionCallbacks&, const Http1Settings& settings,
                                            const uint32_t max_response_headers_count)
-    : ConnectionImpl(connection, stats, HTTP_RESPONSE, MAX_RESPONSE_HEADERS_KB,
-                     max_response_headers_count, formatter(settings)) {}
+    : ConnectionImpl(connection, stats, HTTP_RESPONSE, settings.parser_impl_,
+                     MAX_RESPONSE_HEADERS_KB, max_response_headers_count, formatter(settings)) {}
 
 bool ClientConnectionImpl::cannotHaveBody() {
   if ((!pending_responses_.empty() && pending_responses_.front().head_request_) ||
-      parser_.status_code == 204 || parser_.status_code == 304 ||
-      (parser_.status_code >= 200 && parser_.content_length == 0)) {
+      parser_->statusCode() == 204 || parser_->statusCode() == 304 ||
+      (parser_->statusCode() >= 200 && parser_->contentLength() == 0)) {
     return true;
   } else {
     return false;
@@ -787,7 +819,7 @@ void ClientConnectionImpl::onEncodeHeaders(const HeaderMap& headers) {
 }
 
 int ClientConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
-  headers->insertStatus().value(parser_.status_code);
+  headers->insertStatus().value(parser_->statusCode());
 
   // Handle the case where the client is closing a kept alive connection (by sending a 408
   // with a 'Connection: close' header). In this case we just let response flush out followed
@@ -795,7 +827,7 @@ int ClientConnectionImpl::onHeadersComplete(HeaderMapImplPtr&& headers) {
   if (pending_responses_.empty() && !resetStreamCalled()) {
     throw PrematureResponseException(std::move(headers));
   } else if (!pending_responses_.empty()) {
-    if (parser_.status_code == 100) {
+    if (parser_->statusCode() == 100) {
       // http-parser treats 100 continue headers as their own complete response.
       // Swallow the spurious onMessageComplete and continue processing.
       ignore_message_complete_for_100_continue_ = true;
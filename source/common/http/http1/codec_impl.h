@@ -19,6 +19,7 @@
 #include "common/http/codes.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/http1/header_formatter.h"
+#include "common/http/http1/parser.h"
 
 namespace Envoy {
 namespace Http {
@@ -194,14 +195,14 @@ public:
 
 protected:
   ConnectionImpl(Network::Connection& connection, Stats::Scope& stats, http_parser_type type,
-                 uint32_t max_headers_kb, const uint32_t max_headers_count,
-                 HeaderKeyFormatterPtr&& header_key_formatter);
+                 Http1Settings::ParserImpl parser_impl, uint32_t max_headers_kb,
+                 const uint32_t max_headers_count, HeaderKeyFormatterPtr&& header_key_formatter);
 
   bool resetStreamCalled() { return reset_stream_called_; }
 
   Network::Connection& connection_;
   CodecStats stats_;
-  http_parser parser_;
+  ParserPtr parser_;
   HeaderMapPtr deferred_end_stream_headers_;
   Http::Code error_code_{Http::Code::BadRequest};
   bool handling_upgrade_{};
@@ -210,6 +211,30 @@ protected:
 private:
   enum class HeaderParsingState { Field, Value, Done };
 
+  /**
+   * Forwards the callbacks of the parser to the base routines of the connection.
+   */
+  class ParserCallbacksImpl : public ParserCallbacks {
+  public:
+    ParserCallbacksImpl(ConnectionImpl& connection) : connection_(connection) {}
+
+    // Http1::ParserCallbacks
+    void onMessageBegin() override { connection_.onMessageBeginBase(); }
+    void onUrl(const char* data, size_t length) override { connection_.onUrl(data, length); }
+    void onHeaderField(const char* data, size_t length) override {
+      connection_.onHeaderField(data, length);
+    }
+    void onHeaderValue(const char* data, size_t length) override {
+      connection_.onHeaderValue(data, length);
+    }
+    int onHeadersComplete() override { return connection_.onHeadersCompleteBase(); }
+    void onBody(const char* data, size_t length) override { connection_.onBody(data, length); }
+    void onMessageComplete() override { connection_.onMessageCompleteBase(); }
+
+  private:
+    ConnectionImpl& connection_;
+  };
+
   /**
    * Called in order to complete an in progress header decode.
    */
@@ -293,9 +318,9 @@ private:
    */
   virtual void onBelowLowWatermark() PURE;
 
-  static http_parser_settings settings_;
   static const ToLowerTable& toLowerTable();
 
+  ParserCallbacksImpl parser_callbacks_{*this};
   HeaderMapImplPtr current_header_map_;
   HeaderParsingState header_parsing_state_{HeaderParsingState::Field};
   HeaderString current_header_field_;
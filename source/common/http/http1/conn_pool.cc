@@ -1,5 +1,7 @@
 #include "common/http/http1/conn_pool.h"
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -74,6 +76,10 @@ void ConnPoolImpl::attachRequestToClient(ActiveClient& client, StreamDecoder& re
   ASSERT(!client.stream_wrapper_);
   host_->cluster().stats().upstream_rq_total_.inc();
   host_->stats().rq_total_.inc();
+  if (client.prefetched_) {
+    host_->cluster().stats().upstream_cx_prefetch_used_.inc();
+    client.prefetched_ = false;
+  }
   client.stream_wrapper_ = std::make_unique<StreamWrapper>(response_decoder, client);
   callbacks.onPoolReady(*client.stream_wrapper_, client.real_host_description_,
                         client.codec_client_->streamInfo());
@@ -97,12 +103,34 @@ void ConnPoolImpl::createNewConnection() {
   client->moveIntoList(std::move(client), busy_clients_);
 }
 
+void ConnPoolImpl::prefetchConnections() {
+  const float ratio = host_->cluster().perUpstreamPrefetchRatio();
+  const uint64_t min_warm = host_->cluster().perUpstreamMinWarmConnections();
+  if ((ratio <= 1.0 && min_warm == 0) || !drained_callbacks_.empty()) {
+    return;
+  }
+
+  // Keep enough connections, whether connecting or connected, to serve the current requests
+  // times the prefetch ratio, so that the next requests of a burst find a connection ready. The
+  // warm reserve covers the first requests of a burst after the pool has been idle.
+  const uint64_t requests = busy_clients_.size() - connecting_clients_ + pending_requests_.size();
+  const uint64_t target = std::max(static_cast<uint64_t>(std::ceil(requests * ratio)), min_warm);
+  while (ready_clients_.size() + busy_clients_.size() < target &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "prefetching a connection");
+    createNewConnection();
+    busy_clients_.front()->prefetched_ = true;
+    host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+  }
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_decoder,
                                                      ConnectionPool::Callbacks& callbacks) {
   if (!ready_clients_.empty()) {
     ready_clients_.front()->moveBetweenLists(ready_clients_, busy_clients_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_clients_.front()->codec_client_);
     attachRequestToClient(*busy_clients_.front(), response_decoder, callbacks);
+    prefetchConnections();
     return nullptr;
   }
 
@@ -118,7 +146,9 @@ ConnectionPool::Cancellable* ConnPoolImpl::newStream(StreamDecoder& response_dec
       createNewConnection();
     }
 
-    return newPendingRequest(response_decoder, callbacks);
+    ConnectionPool::Cancellable* pending_request = newPendingRequest(response_decoder, callbacks);
+    prefetchConnections();
+    return pending_request;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, absl::string_view(),
@@ -138,6 +168,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
     ActiveClientPtr removed;
     bool check_for_drained = true;
+    bool connect_failure = false;
     if (client.stream_wrapper_) {
       if (!client.stream_wrapper_->decode_complete_) {
         Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -156,6 +187,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
       // The only time this happens is if we actually saw a connect failure.
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
+      connect_failure = true;
 
       removed = client.removeFromList(busy_clients_);
 
@@ -176,6 +208,12 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
       createNewConnection();
     }
 
+    // Replace connections of the warm reserve which the upstream closed. Connect failures and
+    // local closes, such as the ones of the pool's destructor, are not retried here.
+    if (event == Network::ConnectionEvent::RemoteClose && !connect_failure) {
+      prefetchConnections();
+    }
+
     if (check_for_drained) {
       checkForDrained();
     }
@@ -184,6 +222,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveClient& client, Network::ConnectionEv
   if (client.connect_timer_) {
     client.connect_timer_->disableTimer();
     client.connect_timer_.reset();
+    connecting_clients_--;
   }
 
   // Note that the order in this function is important. Concretely, we must destroy the connect
@@ -323,6 +362,7 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
   conn_length_ = std::make_unique<Stats::HistogramCompletableTimespanImpl>(
       parent_.host_->cluster().stats().upstream_cx_length_ms_, parent_.dispatcher_.timeSource());
   connect_timer_->enableTimer(parent_.host_->cluster().connectTimeout());
+  parent_.connecting_clients_++;
   parent_.host_->cluster().resourceManager(parent_.priority_).connections().inc();
 
   codec_client_->setConnectionStats(
@@ -334,6 +374,9 @@ ConnPoolImpl::ActiveClient::ActiveClient(ConnPoolImpl& parent)
 }
 
 ConnPoolImpl::ActiveClient::~ActiveClient() {
+  if (prefetched_) {
+    parent_.host_->cluster().stats().upstream_cx_prefetch_wasted_.inc();
+  }
   parent_.host_->cluster().stats().upstream_cx_active_.dec();
   parent_.host_->stats().cx_active_.dec();
   conn_length_->complete();
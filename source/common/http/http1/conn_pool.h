@@ -106,6 +106,8 @@ protected:
     Stats::TimespanPtr conn_connect_ms_;
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
+    // Whether the connection was prefetched and has not served a request yet.
+    bool prefetched_{};
   };
 
   using ActiveClientPtr = std::unique_ptr<ActiveClient>;
@@ -118,11 +120,15 @@ protected:
   void onDownstreamReset(ActiveClient& client);
   void onResponseComplete(ActiveClient& client);
   void onUpstreamReady();
+  void prefetchConnections();
   void processIdleClient(ActiveClient& client, bool delay);
 
   Event::Dispatcher& dispatcher_;
   std::list<ActiveClientPtr> ready_clients_;
+  // Clients which are connecting or have a request attached.
   std::list<ActiveClientPtr> busy_clients_;
+  // The number of busy clients which are still connecting.
+  uint64_t connecting_clients_{};
   std::list<DrainedCb> drained_callbacks_;
   const Network::ConnectionSocket::OptionsSharedPtr socket_options_;
   const Network::TransportSocketOptionsSharedPtr transport_socket_options_;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include "common/http/http1/parser.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser implementation backed by the node.js http_parser, which parses one byte at a time and
+ * hands header names and values over in fragments.
+ */
+class LegacyHttpParserImpl : public Parser {
+public:
+  LegacyHttpParserImpl(http_parser_type type, ParserCallbacks& callbacks);
+
+  // Http1::Parser
+  size_t execute(const char* data, size_t length) override;
+  void pause(bool paused) override { http_parser_pause(&parser_, paused ? 1 : 0); }
+  http_errno error() const override { return HTTP_PARSER_ERRNO(&parser_); }
+  unsigned short httpMajor() const override { return parser_.http_major; }
+  unsigned short httpMinor() const override { return parser_.http_minor; }
+  http_method method() const override { return static_cast<http_method>(parser_.method); }
+  unsigned int statusCode() const override { return parser_.status_code; }
+  bool isChunked() const override { return parser_.flags & F_CHUNKED; }
+  uint64_t contentLength() const override { return parser_.content_length; }
+
+private:
+  static http_parser_settings settings_;
+
+  http_parser parser_;
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
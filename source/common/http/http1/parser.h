@@ -0,0 +1,127 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/pure.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Callbacks raised by a Parser while it parses HTTP/1 messages. They follow the http_parser
+ * callbacks: header names and values may be delivered in several fragments which are to be
+ * concatenated.
+ */
+class ParserCallbacks {
+public:
+  virtual ~ParserCallbacks() = default;
+
+  /**
+   * Called when a request or response is beginning.
+   */
+  virtual void onMessageBegin() PURE;
+
+  /**
+   * Called when URL data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onUrl(const char* data, size_t length) PURE;
+
+  /**
+   * Called when header field data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onHeaderField(const char* data, size_t length) PURE;
+
+  /**
+   * Called when header value data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onHeaderValue(const char* data, size_t length) PURE;
+
+  /**
+   * Called when headers are complete.
+   * @return 0 if no error, 1 if there should be no body, 2 if there should be no body and the
+   *         rest of the data belongs to an upgraded protocol.
+   */
+  virtual int onHeadersComplete() PURE;
+
+  /**
+   * Called when body data is received.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   */
+  virtual void onBody(const char* data, size_t length) PURE;
+
+  /**
+   * Called when the request/response is complete.
+   */
+  virtual void onMessageComplete() PURE;
+};
+
+/**
+ * An HTTP/1 parser. Errors, methods and flags are reported with the http_parser enums so that
+ * every implementation can be driven the same way.
+ */
+class Parser {
+public:
+  virtual ~Parser() = default;
+
+  /**
+   * Parse a span of data, raising callbacks. An empty span signals the end of the stream.
+   * @param data supplies the start address.
+   * @param length supplies the length.
+   * @return size_t the number of bytes consumed. Parsing stops early on an error or when paused.
+   */
+  virtual size_t execute(const char* data, size_t length) PURE;
+
+  /**
+   * Pause or unpause the parser. A paused parser consumes nothing and reports HPE_PAUSED.
+   * @param paused supplies whether to pause.
+   */
+  virtual void pause(bool paused) PURE;
+
+  /**
+   * @return http_errno HPE_OK, HPE_PAUSED or the error which stopped the parser.
+   */
+  virtual http_errno error() const PURE;
+
+  /**
+   * @return the HTTP version of the current message.
+   */
+  virtual unsigned short httpMajor() const PURE;
+  virtual unsigned short httpMinor() const PURE;
+
+  /**
+   * @return http_method the method of the current request.
+   */
+  virtual http_method method() const PURE;
+
+  /**
+   * @return the status code of the current response.
+   */
+  virtual unsigned int statusCode() const PURE;
+
+  /**
+   * @return whether the body of the current message uses chunked transfer encoding.
+   */
+  virtual bool isChunked() const PURE;
+
+  /**
+   * @return the content length of the current message, ULLONG_MAX if not present.
+   */
+  virtual uint64_t contentLength() const PURE;
+};
+
+using ParserPtr = std::unique_ptr<Parser>;
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,680 @@
+#include "common/http/http1/vectorized_parser_impl.h"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstring>
+
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+struct MethodEntry {
+  absl::string_view name_;
+  http_method method_;
+};
+
+constexpr MethodEntry Methods[] = {
+#define XX(num, name, string) {#string, HTTP_##name},
+    HTTP_METHOD_MAP(XX)
+#undef XX
+};
+
+struct CharTables {
+  CharTables() {
+    for (const char c : absl::string_view("!#$%&'*+-.^_`|~")) {
+      token_[static_cast<uint8_t>(c)] = true;
+    }
+    for (int c = '0'; c <= '9'; c++) {
+      token_[c] = true;
+    }
+    for (int c = 'A'; c <= 'Z'; c++) {
+      token_[c] = true;
+      token_[c - 'A' + 'a'] = true;
+    }
+    for (const MethodEntry& entry : Methods) {
+      method_initial_[static_cast<uint8_t>(entry.name_[0])] = true;
+    }
+  }
+
+  // tchar of RFC 7230, the characters of header names.
+  std::array<bool, 256> token_{};
+  // The first characters of the methods known to http_parser.
+  std::array<bool, 256> method_initial_{};
+};
+
+const CharTables& charTables() { CONSTRUCT_ON_FIRST_USE(CharTables); }
+
+bool isMethodChar(char c) { return (c >= 'A' && c <= 'Z') || c == '-'; }
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+bool isUrlStop(char c) { return static_cast<uint8_t>(c) <= 0x20 || c == 0x7f; }
+
+int unhex(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+#if defined(__SSE4_2__)
+/**
+ * Skip 16 bytes at a time until a block contains a byte in one of the given inclusive ranges.
+ * @return const char* the first byte in one of the ranges, or the start of the tail which is
+ *         shorter than 16 bytes and left to the caller.
+ */
+const char* findCharFast(const char* p, const char* end, const char* ranges, int ranges_size) {
+  const __m128i ranges16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ranges));
+  while (end - p >= 16) {
+    const __m128i b16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int r = _mm_cmpestri(ranges16, ranges_size, b16, 16,
+                               _SIDD_LEAST_SIGNIFICANT | _SIDD_CMP_RANGES | _SIDD_UBYTE_OPS);
+    if (r != 16) {
+      return p + r;
+    }
+    p += 16;
+  }
+  return p;
+}
+#endif
+
+/**
+ * @return const char* the end of the request target starting at p: the first control character,
+ *         space or DEL.
+ */
+const char* findUrlEnd(const char* p, const char* end) {
+#if defined(__SSE4_2__)
+  // Zero padded to the 16 bytes loaded by findCharFast().
+  alignas(16) static const char ranges[16] = "\x00\x20\x7f\x7f";
+  p = findCharFast(p, end, ranges, 4);
+#elif defined(__SSE2__)
+  const __m128i space = _mm_set1_epi8(0x20);
+  const __m128i del = _mm_set1_epi8(0x7f);
+  while (end - p >= 16) {
+    const __m128i b16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    // An unsigned byte is at most 0x20 if it is its own minimum with 0x20.
+    const __m128i ctl = _mm_cmpeq_epi8(_mm_min_epu8(b16, space), b16);
+    const int mask = _mm_movemask_epi8(_mm_or_si128(ctl, _mm_cmpeq_epi8(b16, del)));
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p != end && !isUrlStop(*p)) {
+    p++;
+  }
+  return p;
+}
+
+/**
+ * @return const char* the end of the header name starting at p: the first byte which is not a
+ *         tchar.
+ */
+const char* findTokenEnd(const char* p, const char* end) {
+#if defined(__SSE4_2__)
+  // Every byte outside of these ranges is a tchar. '|' and '~' are left to the scalar loop to fit
+  // the ranges in a single register.
+  alignas(16) static const char ranges[] = "\x00 "  // Control characters and SP.
+                                             "\"\""   // 0x22
+                                             "()"     // 0x28 and 0x29
+                                             ",,"     // 0x2c
+                                             "//"     // 0x2f
+                                             ":@"     // 0x3a to 0x40
+                                             "[]"     // 0x5b to 0x5d
+                                             "{\xff"; // 0x7b to 0xff
+  p = findCharFast(p, end, ranges, 16);
+#endif
+  const auto& token = charTables().token_;
+  while (p != end && token[static_cast<uint8_t>(*p)]) {
+    p++;
+  }
+  return p;
+}
+
+bool isOws(char c) { return c == ' ' || c == '\t'; }
+
+bool isInvalidValueChar(char c) {
+  return (static_cast<uint8_t>(c) < 0x20 && c != '\t') || c == 0x7f;
+}
+
+/**
+ * @return const char* the first byte of the header value starting at p which http_parser rejects:
+ *         a control character other than HTAB, or DEL.
+ */
+const char* findInvalidValueChar(const char* p, const char* end) {
+#if defined(__SSE4_2__)
+  // Zero padded to the 16 bytes loaded by findCharFast().
+  alignas(16) static const char ranges[16] = "\x00\x08\x0a\x1f\x7f\x7f";
+  p = findCharFast(p, end, ranges, 6);
+#elif defined(__SSE2__)
+  const __m128i us = _mm_set1_epi8(0x1f);
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i del = _mm_set1_epi8(0x7f);
+  while (end - p >= 16) {
+    const __m128i b16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i ctl =
+        _mm_andnot_si128(_mm_cmpeq_epi8(b16, tab), _mm_cmpeq_epi8(_mm_min_epu8(b16, us), b16));
+    const int mask = _mm_movemask_epi8(_mm_or_si128(ctl, _mm_cmpeq_epi8(b16, del)));
+    if (mask != 0) {
+      return p + __builtin_ctz(mask);
+    }
+    p += 16;
+  }
+#endif
+  while (p != end && !isInvalidValueChar(*p)) {
+    p++;
+  }
+  return p;
+}
+
+} // namespace
+
+VectorizedParserImpl::VectorizedParserImpl(http_parser_type type, ParserCallbacks& callbacks,
+                                           uint32_t max_line_size)
+    : callbacks_(callbacks), type_(type), max_line_size_(max_line_size) {
+  ASSERT(type_ == HTTP_REQUEST || type_ == HTTP_RESPONSE);
+}
+
+void VectorizedParserImpl::pause(bool paused) {
+  // As with http_parser, a parser which failed stays failed.
+  if (error_ == HPE_OK || error_ == HPE_PAUSED) {
+    error_ = paused ? HPE_PAUSED : HPE_OK;
+  }
+}
+
+size_t VectorizedParserImpl::execute(const char* data, size_t length) {
+  if (error_ != HPE_OK) {
+    return 0;
+  }
+
+  if (length == 0) {
+    // End of stream.
+    switch (state_) {
+    case State::MessageStart:
+      break;
+    case State::BodyUntilClose:
+      state_ = State::MessageStart;
+      callbacks_.onMessageComplete();
+      break;
+    default:
+      error_ = HPE_INVALID_EOF_STATE;
+      break;
+    }
+    return 0;
+  }
+
+  const char* p = data;
+  const char* const end = data + length;
+  // A message without a body is completed even when its head ends the data.
+  while (error_ == HPE_OK && (p != end || state_ == State::MessageDone)) {
+    switch (state_) {
+    case State::MessageStart: {
+      // Like http_parser, tolerate empty lines ahead of a message.
+      while (p != end && (*p == '\r' || *p == '\n')) {
+        p++;
+      }
+      if (p == end) {
+        break;
+      }
+      if (type_ == HTTP_REQUEST && !charTables().method_initial_[static_cast<uint8_t>(*p)]) {
+        error_ = HPE_INVALID_METHOD;
+        break;
+      }
+      if (type_ == HTTP_RESPONSE && *p != 'H') {
+        error_ = HPE_INVALID_CONSTANT;
+        break;
+      }
+      method_ = HTTP_DELETE;
+      status_code_ = 0;
+      chunked_ = false;
+      has_content_length_ = false;
+      upgrade_ = false;
+      content_length_ = ULLONG_MAX;
+      state_ = State::FirstLine;
+      callbacks_.onMessageBegin();
+      break;
+    }
+    case State::FirstLine:
+    case State::HeaderLine:
+      p = parseHead(p, end);
+      break;
+    case State::MessageDone:
+      if (head_lf_pending_) {
+        ASSERT(p != end && *p == '\n');
+        p++;
+        head_lf_pending_ = false;
+      }
+      state_ = State::MessageStart;
+      callbacks_.onMessageComplete();
+      if (upgrade_) {
+        // The rest of the data belongs to the upgraded protocol.
+        return p - data;
+      }
+      break;
+    default:
+      p = parseBody(p, end);
+      break;
+    }
+  }
+
+  return p - data;
+}
+
+const char* VectorizedParserImpl::parseHead(const char* p, const char* end) {
+  while (p != end && error_ == HPE_OK &&
+         (state_ == State::FirstLine || state_ == State::HeaderLine)) {
+    const char* lf = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (lf == nullptr) {
+      // The line continues in the next dispatch, hold on to what has been received so far.
+      if (line_buffer_.size() + (end - p) > max_line_size_) {
+        error_ = HPE_HEADER_OVERFLOW;
+        return p;
+      }
+      line_buffer_.append(p, end - p);
+      if (line_buffer_.size() >= 2 * line_buffer_validated_) {
+        line_buffer_validated_ = line_buffer_.size();
+        parseLine(line_buffer_.data(), line_buffer_.data() + line_buffer_.size(), true);
+      }
+      return end;
+    }
+
+    const char* line = p;
+    const char* line_end = lf;
+    if (!line_buffer_.empty()) {
+      if (line_buffer_.size() + (lf - p) > max_line_size_) {
+        error_ = HPE_HEADER_OVERFLOW;
+        return p;
+      }
+      line_buffer_.append(p, lf - p);
+      line = line_buffer_.data();
+      line_end = line + line_buffer_.size();
+    } else if (static_cast<size_t>(lf - p) > max_line_size_) {
+      error_ = HPE_HEADER_OVERFLOW;
+      return p;
+    }
+
+    p = lf + 1;
+    parseLine(line, line_end, false);
+    line_buffer_.clear();
+    line_buffer_validated_ = 0;
+
+    if (error_ == HPE_PAUSED && state_ == State::MessageDone) {
+      // Like http_parser, leave the final LF of a head without body in place when paused, so that
+      // the message is completed by the dispatch which resumes parsing.
+      head_lf_pending_ = true;
+      return lf;
+    }
+  }
+
+  return p;
+}
+
+VectorizedParserImpl::LineStatus VectorizedParserImpl::parseLine(const char* line, const char* end,
+                                                                 bool partial) {
+  // Lines end with CRLF or a bare LF. For a partial line a trailing CR may be the start of CRLF.
+  if (line != end && end[-1] == '\r') {
+    end--;
+  }
+
+  if (state_ == State::FirstLine) {
+    const LineStatus status = type_ == HTTP_REQUEST ? parseRequestLine(line, end, partial)
+                                                    : parseStatusLine(line, end, partial);
+    if (!partial && status == LineStatus::Complete) {
+      state_ = State::HeaderLine;
+    }
+    return status;
+  }
+
+  ASSERT(state_ == State::HeaderLine);
+  if (line == end) {
+    if (partial) {
+      return LineStatus::Incomplete;
+    }
+    onHeadersDone();
+    return error_ == HPE_OK || error_ == HPE_PAUSED ? LineStatus::Complete : LineStatus::Error;
+  }
+  return parseHeaderLine(line, end, partial);
+}
+
+VectorizedParserImpl::LineStatus
+VectorizedParserImpl::parseRequestLine(const char* line, const char* end, bool partial) {
+  const char* p = line;
+  while (p != end && isMethodChar(*p)) {
+    p++;
+  }
+  if (p == end) {
+    return partial ? LineStatus::Incomplete : fail(HPE_INVALID_METHOD);
+  }
+  if (*p != ' ') {
+    return fail(HPE_INVALID_METHOD);
+  }
+  const absl::string_view method_name(line, p - line);
+  const MethodEntry* method =
+      std::find_if(std::begin(Methods), std::end(Methods),
+                   [method_name](const MethodEntry& entry) { return entry.name_ == method_name; });
+  if (method == std::end(Methods)) {
+    return fail(HPE_INVALID_METHOD);
+  }
+
+  const char* url = ++p;
+  p = findUrlEnd(p, end);
+  if (p == end) {
+    // HTTP/0.9 simple requests are not supported.
+    return partial ? LineStatus::Incomplete : fail(HPE_INVALID_VERSION);
+  }
+  if (p == url || *p != ' ') {
+    return fail(HPE_INVALID_URL);
+  }
+  const char* url_end = p++;
+
+  const LineStatus status = parseVersion(p, end, partial);
+  if (status != LineStatus::Complete) {
+    return status;
+  }
+  if (p != end) {
+    return fail(HPE_INVALID_VERSION);
+  }
+
+  if (!partial) {
+    method_ = method->method_;
+    callbacks_.onUrl(url, url_end - url);
+  }
+  return LineStatus::Complete;
+}
+
+VectorizedParserImpl::LineStatus
+VectorizedParserImpl::parseStatusLine(const char* line, const char* end, bool partial) {
+  const char* p = line;
+  const LineStatus status = parseVersion(p, end, partial);
+  if (status != LineStatus::Complete) {
+    return status;
+  }
+  if (p == end) {
+    return partial ? LineStatus::Incomplete : fail(HPE_INVALID_STATUS);
+  }
+  if (*p != ' ') {
+    return fail(HPE_INVALID_VERSION);
+  }
+
+  // Like http_parser, accept status codes of up to three digits.
+  unsigned int status_code = 0;
+  const char* code = ++p;
+  while (p != end && isDigit(*p) && p - code < 3) {
+    status_code = status_code * 10 + (*p++ - '0');
+  }
+  if (p == code) {
+    return partial && p == end ? LineStatus::Incomplete : fail(HPE_INVALID_STATUS);
+  }
+  if (p != end && *p != ' ') {
+    return fail(HPE_INVALID_STATUS);
+  }
+  // The reason phrase is ignored, but must not hide a bare CR.
+  if (memchr(p, '\r', end - p) != nullptr) {
+    return fail(HPE_LF_EXPECTED);
+  }
+
+  if (!partial) {
+    status_code_ = status_code;
+  }
+  return LineStatus::Complete;
+}
+
+VectorizedParserImpl::LineStatus VectorizedParserImpl::parseVersion(const char*& p, const char* end,
+                                                                    bool partial) {
+  static constexpr absl::string_view pattern = "HTTP/0.0";
+  for (size_t i = 0; i < pattern.size(); i++) {
+    if (p + i == end) {
+      return partial ? LineStatus::Incomplete : fail(HPE_INVALID_VERSION);
+    }
+    if (pattern[i] == '0' ? !isDigit(p[i]) : p[i] != pattern[i]) {
+      return fail(i < 5 ? HPE_INVALID_CONSTANT : HPE_INVALID_VERSION);
+    }
+  }
+
+  if (!partial) {
+    http_major_ = p[5] - '0';
+    http_minor_ = p[7] - '0';
+  }
+  p += pattern.size();
+  return LineStatus::Complete;
+}
+
+VectorizedParserImpl::LineStatus
+VectorizedParserImpl::parseHeaderLine(const char* line, const char* end, bool partial) {
+  const char* name_end = findTokenEnd(line, end);
+  if (name_end == end) {
+    return partial ? LineStatus::Incomplete : fail(HPE_INVALID_HEADER_TOKEN);
+  }
+  // This also rejects obsolete line folding, which starts with whitespace.
+  if (name_end == line || *name_end != ':') {
+    return fail(HPE_INVALID_HEADER_TOKEN);
+  }
+
+  const char* value = name_end + 1;
+  while (value != end && isOws(*value)) {
+    value++;
+  }
+  const char* invalid = findInvalidValueChar(value, end);
+  if (invalid != end) {
+    // The CRLF has been stripped from the line, any CR left is not followed by LF.
+    return fail(*invalid == '\r' ? HPE_LF_EXPECTED : HPE_INVALID_HEADER_TOKEN);
+  }
+  if (partial) {
+    return LineStatus::Incomplete;
+  }
+
+  const char* value_end = end;
+  while (value_end != value && isOws(value_end[-1])) {
+    value_end--;
+  }
+  if (!onHeader(absl::string_view(line, name_end - line),
+                absl::string_view(value, value_end - value))) {
+    return LineStatus::Error;
+  }
+
+  callbacks_.onHeaderField(line, name_end - line);
+  callbacks_.onHeaderValue(value, value_end - value);
+  return LineStatus::Complete;
+}
+
+bool VectorizedParserImpl::onHeader(absl::string_view name, absl::string_view value) {
+  if (absl::EqualsIgnoreCase(name, "content-length")) {
+    if (has_content_length_) {
+      fail(HPE_UNEXPECTED_CONTENT_LENGTH);
+      return false;
+    }
+    if (value.empty()) {
+      fail(HPE_INVALID_CONTENT_LENGTH);
+      return false;
+    }
+    uint64_t content_length = 0;
+    for (const char c : value) {
+      // Like http_parser, reject overflow and the ULLONG_MAX "absent" marker.
+      if (!isDigit(c) || content_length > (ULLONG_MAX - 10) / 10) {
+        fail(HPE_INVALID_CONTENT_LENGTH);
+        return false;
+      }
+      content_length = content_length * 10 + (c - '0');
+    }
+    has_content_length_ = true;
+    content_length_ = content_length;
+  } else if (absl::EqualsIgnoreCase(name, "transfer-encoding")) {
+    // Like http_parser 2.9, only a value of exactly "chunked" selects chunked framing.
+    if (absl::EqualsIgnoreCase(value, "chunked")) {
+      chunked_ = true;
+    }
+  }
+  return true;
+}
+
+void VectorizedParserImpl::onHeadersDone() {
+  if (chunked_ && has_content_length_) {
+    fail(HPE_UNEXPECTED_CONTENT_LENGTH);
+    return;
+  }
+
+  // CONNECT always switches protocols once the head has been sent.
+  upgrade_ = type_ == HTTP_REQUEST && method_ == HTTP_CONNECT;
+  bool skip_body = false;
+  switch (callbacks_.onHeadersComplete()) {
+  case 0:
+    break;
+  case 2:
+    upgrade_ = true;
+    FALLTHRU;
+  case 1:
+    skip_body = true;
+    break;
+  default:
+    fail(HPE_CB_headers_complete);
+    return;
+  }
+
+  // The next state is chosen even when paused, so that dispatching resumes in the right place.
+  const bool has_body = chunked_ || (content_length_ > 0 && content_length_ != ULLONG_MAX);
+  if (skip_body || (upgrade_ && (method_ == HTTP_CONNECT || !has_body))) {
+    state_ = State::MessageDone;
+  } else if (chunked_) {
+    state_ = State::ChunkSizeStart;
+  } else if (content_length_ == 0) {
+    state_ = State::MessageDone;
+  } else if (content_length_ != ULLONG_MAX) {
+    remaining_ = content_length_;
+    state_ = State::BodyIdentity;
+  } else if (type_ == HTTP_REQUEST || status_code_ / 100 == 1 || status_code_ == 204 ||
+             status_code_ == 304) {
+    state_ = State::MessageDone;
+  } else {
+    // Without framing a response is delimited by the connection close.
+    state_ = State::BodyUntilClose;
+  }
+}
+
+const char* VectorizedParserImpl::parseBody(const char* p, const char* end) {
+  switch (state_) {
+  case State::BodyIdentity:
+  case State::ChunkData: {
+    const uint64_t length = std::min<uint64_t>(remaining_, end - p);
+    remaining_ -= length;
+    if (remaining_ == 0) {
+      state_ = state_ == State::BodyIdentity ? State::MessageDone : State::ChunkDataCr;
+    }
+    callbacks_.onBody(p, length);
+    return p + length;
+  }
+  case State::BodyUntilClose:
+    callbacks_.onBody(p, end - p);
+    return end;
+  case State::ChunkSizeStart: {
+    const int value = unhex(*p);
+    if (value < 0) {
+      fail(HPE_INVALID_CHUNK_SIZE);
+      return p;
+    }
+    remaining_ = value;
+    state_ = State::ChunkSize;
+    return p + 1;
+  }
+  case State::ChunkSize:
+    for (; p != end; p++) {
+      const int value = unhex(*p);
+      if (value < 0) {
+        if (*p == ';' || *p == ' ') {
+          state_ = State::ChunkExtension;
+        } else if (*p == '\r') {
+          state_ = State::ChunkSizeLf;
+        } else {
+          fail(HPE_INVALID_CHUNK_SIZE);
+          return p;
+        }
+        return p + 1;
+      }
+      if (remaining_ > (ULLONG_MAX - 16) / 16) {
+        fail(HPE_INVALID_CHUNK_SIZE);
+        return p;
+      }
+      remaining_ = remaining_ * 16 + value;
+    }
+    return p;
+  case State::ChunkExtension: {
+    // Chunk extensions are ignored.
+    const char* cr = static_cast<const char*>(memchr(p, '\r', end - p));
+    if (cr == nullptr) {
+      return end;
+    }
+    state_ = State::ChunkSizeLf;
+    return cr + 1;
+  }
+  case State::ChunkSizeLf:
+    if (*p != '\n') {
+      fail(HPE_LF_EXPECTED);
+      return p;
+    }
+    state_ = remaining_ == 0 ? State::TrailerLineStart : State::ChunkData;
+    return p + 1;
+  case State::ChunkDataCr:
+    if (*p != '\r') {
+      fail(HPE_STRICT);
+      return p;
+    }
+    state_ = State::ChunkDataLf;
+    return p + 1;
+  case State::ChunkDataLf:
+    if (*p != '\n') {
+      fail(HPE_LF_EXPECTED);
+      return p;
+    }
+    state_ = State::ChunkSizeStart;
+    return p + 1;
+  case State::TrailerLineStart:
+    // Trailers are consumed but not reported.
+    if (*p == '\r') {
+      state_ = State::TrailerLf;
+      return p + 1;
+    }
+    if (*p == '\n') {
+      state_ = State::MessageDone;
+      return p + 1;
+    }
+    state_ = State::TrailerLine;
+    return p;
+  case State::TrailerLine: {
+    const char* lf = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (lf == nullptr) {
+      return end;
+    }
+    state_ = State::TrailerLineStart;
+    return lf + 1;
+  }
+  case State::TrailerLf:
+    if (*p != '\n') {
+      fail(HPE_LF_EXPECTED);
+      return p;
+    }
+    state_ = State::MessageDone;
+    return p + 1;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+}
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
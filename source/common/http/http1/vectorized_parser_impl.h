@@ -0,0 +1,133 @@
+#pragma once
+
+#include <http_parser.h>
+
+#include <climits>
+#include <cstdint>
+#include <string>
+
+#include "common/http/http1/parser.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+
+/**
+ * Parser implementation in the style of picohttpparser. Rather than walking a state machine one
+ * byte at a time, the message head is split into lines by scanning for delimiters in bulk and
+ * each line is parsed as a whole: the request/status line and every header are handed over with a
+ * single onUrl() / onHeaderField() / onHeaderValue() call each, pointing into the dispatched data
+ * whenever the line is contained in it. Only a line which straddles two dispatches is copied.
+ *
+ * Errors, flags and body framing follow http_parser 2.9 so that the two implementations can be
+ * used interchangeably. Deliberate differences: obsolete line folding is rejected, control
+ * characters other than HTAB are rejected anywhere in header values, trailers are skipped without
+ * callbacks and any single line of the head is limited to max_line_size bytes
+ * (HPE_HEADER_OVERFLOW).
+ */
+class VectorizedParserImpl : public Parser {
+public:
+  VectorizedParserImpl(http_parser_type type, ParserCallbacks& callbacks, uint32_t max_line_size);
+
+  // Http1::Parser
+  size_t execute(const char* data, size_t length) override;
+  void pause(bool paused) override;
+  http_errno error() const override { return error_; }
+  unsigned short httpMajor() const override { return http_major_; }
+  unsigned short httpMinor() const override { return http_minor_; }
+  http_method method() const override { return method_; }
+  unsigned int statusCode() const override { return status_code_; }
+  bool isChunked() const override { return chunked_; }
+  uint64_t contentLength() const override { return content_length_; }
+
+private:
+  enum class State {
+    MessageStart,
+    FirstLine,
+    HeaderLine,
+    MessageDone,
+    BodyIdentity,
+    BodyUntilClose,
+    ChunkSizeStart,
+    ChunkSize,
+    ChunkExtension,
+    ChunkSizeLf,
+    ChunkData,
+    ChunkDataCr,
+    ChunkDataLf,
+    TrailerLineStart,
+    TrailerLine,
+    TrailerLf,
+  };
+
+  enum class LineStatus { Complete, Incomplete, Error };
+
+  /**
+   * Parse the message head up to and including the empty line which terminates it.
+   * @return const char* the first byte not consumed.
+   */
+  const char* parseHead(const char* p, const char* end);
+
+  /**
+   * Parse a line of the message head.
+   * @param line supplies the line, without the terminating LF.
+   * @param end supplies the end of the line.
+   * @param partial supplies whether the line is a prefix of a line which is still being received.
+   *        A partial line is only validated, no callbacks are raised.
+   */
+  LineStatus parseLine(const char* line, const char* end, bool partial);
+  LineStatus parseRequestLine(const char* line, const char* end, bool partial);
+  LineStatus parseStatusLine(const char* line, const char* end, bool partial);
+  LineStatus parseHeaderLine(const char* line, const char* end, bool partial);
+  LineStatus parseVersion(const char*& p, const char* end, bool partial);
+  bool onHeader(absl::string_view name, absl::string_view value);
+
+  /**
+   * Called once the head has been parsed, raises onHeadersComplete() and decides how the body is
+   * framed.
+   */
+  void onHeadersDone();
+
+  /**
+   * Consume the body and the chunked framing.
+   * @return const char* the first byte not consumed.
+   */
+  const char* parseBody(const char* p, const char* end);
+
+  LineStatus fail(http_errno error) {
+    error_ = error;
+    return LineStatus::Error;
+  }
+
+  ParserCallbacks& callbacks_;
+  const http_parser_type type_;
+  const uint32_t max_line_size_;
+  State state_{State::MessageStart};
+  http_errno error_{HPE_OK};
+
+  // A line of the head which did not fit in the previously dispatched data.
+  std::string line_buffer_;
+  // The size of line_buffer_ when it was last validated. Partial lines are validated every time
+  // they double in size, which rejects garbage early at a linear cost overall.
+  size_t line_buffer_validated_{};
+  // Whether the LF ending the head was left unconsumed because of a pause, see parseHead().
+  bool head_lf_pending_{};
+
+  // The current message.
+  unsigned short http_major_{};
+  unsigned short http_minor_{};
+  http_method method_{HTTP_DELETE};
+  unsigned int status_code_{};
+  bool chunked_{};
+  bool has_content_length_{};
+  bool upgrade_{};
+  uint64_t content_length_{ULLONG_MAX};
+  // The number of body bytes still to read in BodyIdentity and ChunkData.
+  uint64_t remaining_{};
+};
+
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,549 @@
+#include "common/http/http2/shared_conn_pool.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/lock_guard.h"
+#include "common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+// Bounds the body bytes in flight between the two halves of a stream whose upstream stream has no
+// buffer limit.
+constexpr uint32_t DefaultForwardedBufferLimit = 1024 * 1024;
+
+} // namespace
+
+void DispatcherHandle::post(Event::PostCb cb, Event::PostCb on_closed) {
+  {
+    // The lock keeps the dispatcher from being closed, and so from going away, while posting.
+    Thread::LockGuard lock(lock_);
+    if (dispatcher_ != nullptr) {
+      dispatcher_->post(
+          [handle = shared_from_this(), cb = std::move(cb), on_closed = std::move(on_closed)]() {
+            if (handle->isOpen()) {
+              cb();
+            } else if (on_closed != nullptr) {
+              on_closed();
+            }
+          });
+      return;
+    }
+  }
+
+  if (on_closed != nullptr) {
+    on_closed();
+  }
+}
+
+void DispatcherHandle::close() {
+  Thread::LockGuard lock(lock_);
+  dispatcher_ = nullptr;
+}
+
+bool DispatcherHandle::isOpen() {
+  Thread::LockGuard lock(lock_);
+  return dispatcher_ != nullptr;
+}
+
+void SharedStreamLink::postToOrigin(std::function<void(OriginStream&)> cb) {
+  origin_dispatcher_->post([link = shared_from_this(), cb = std::move(cb)]() -> void {
+    if (link->origin_ != nullptr) {
+      cb(*link->origin_);
+    }
+  });
+}
+
+void SharedStreamLink::postToOwner(std::function<void(OwnerStream&)> cb) {
+  owner_dispatcher_->post([link = shared_from_this(), cb = std::move(cb)]() -> void {
+    if (link->owner_ != nullptr) {
+      cb(*link->owner_);
+    }
+  });
+}
+
+OriginStream::OriginStream(ForwardingConnPoolImpl& parent, StreamDecoder& response_decoder,
+                           ConnectionPool::Callbacks& callbacks)
+    : link_(std::make_shared<SharedStreamLink>(parent.dispatcher_handle_,
+                                               parent.owner_dispatcher_)),
+      parent_(parent), response_decoder_(response_decoder), callbacks_(callbacks),
+      stream_info_(parent.protocol_, parent.dispatcher_.timeSource()) {
+  link_->origin_ = this;
+}
+
+OriginStream::~OriginStream() { link_->origin_ = nullptr; }
+
+void OriginStream::onPoolReady(Upstream::HostDescriptionConstSharedPtr host,
+                               uint32_t buffer_limit) {
+  buffer_limit_ = buffer_limit;
+  callbacks_.onPoolReady(*this, std::move(host), stream_info_);
+}
+
+void OriginStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                 const std::string& transport_failure_reason,
+                                 Upstream::HostDescriptionConstSharedPtr host) {
+  callbacks_.onPoolFailure(reason, transport_failure_reason, std::move(host));
+  destroy();
+}
+
+void OriginStream::onOwnerDropped() {
+  onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, "", parent_.host_);
+}
+
+void OriginStream::onUpstreamReset(StreamResetReason reason) {
+  runResetCallbacks(reason);
+  destroy();
+}
+
+void OriginStream::onRequestBytesEncoded() {
+  if (above_high_watermark_ && link_->request_bytes_posted_ <= buffer_limit_ / 2) {
+    above_high_watermark_ = false;
+    runLowWatermarkCallbacks();
+  }
+}
+
+void OriginStream::cancel() {
+  link_->postToOwner(
+      [](OwnerStream& owner) -> void { owner.resetStream(StreamResetReason::LocalReset); });
+  destroy();
+}
+
+void OriginStream::encode100ContinueHeaders(const HeaderMap& headers) {
+  auto copy = std::make_shared<HeaderMapImpl>(headers);
+  link_->postToOwner([copy](OwnerStream& owner) -> void { owner.encode100ContinueHeaders(*copy); });
+}
+
+void OriginStream::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  auto copy = std::make_shared<HeaderMapImpl>(headers);
+  link_->postToOwner(
+      [copy, end_stream](OwnerStream& owner) -> void { owner.encodeHeaders(*copy, end_stream); });
+  if (end_stream) {
+    onLocalEndStream();
+  }
+}
+
+void OriginStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  const uint64_t length = data.length();
+  auto buffer = std::make_shared<Buffer::OwnedImpl>();
+  buffer->move(data);
+  // Counted before posting, so that the owner half never sees the bytes before they are counted.
+  const uint64_t posted = link_->request_bytes_posted_ += length;
+  link_->postToOwner(
+      [buffer, end_stream](OwnerStream& owner) -> void { owner.encodeData(*buffer, end_stream); });
+  if (end_stream) {
+    onLocalEndStream();
+    return;
+  }
+
+  // Stop reading the request while the owner half is behind by more than the buffer limit.
+  if (!above_high_watermark_ && posted > buffer_limit_) {
+    above_high_watermark_ = true;
+    runHighWatermarkCallbacks();
+  }
+}
+
+void OriginStream::encodeTrailers(const HeaderMap& trailers) {
+  auto copy = std::make_shared<HeaderMapImpl>(trailers);
+  link_->postToOwner([copy](OwnerStream& owner) -> void { owner.encodeTrailers(*copy); });
+  onLocalEndStream();
+}
+
+void OriginStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  auto copy = std::make_shared<MetadataMapVector>();
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    copy->push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  link_->postToOwner([copy](OwnerStream& owner) -> void { owner.encodeMetadata(*copy); });
+}
+
+void OriginStream::resetStream(StreamResetReason reason) {
+  link_->postToOwner([reason](OwnerStream& owner) -> void { owner.resetStream(reason); });
+  runResetCallbacks(reason);
+  destroy();
+}
+
+void OriginStream::readDisable(bool disable) {
+  link_->postToOwner([disable](OwnerStream& owner) -> void { owner.readDisable(disable); });
+}
+
+void OriginStream::decode100ContinueHeaders(HeaderMapPtr&& headers) {
+  response_decoder_.decode100ContinueHeaders(std::move(headers));
+}
+
+void OriginStream::decodeHeaders(HeaderMapPtr&& headers, bool end_stream) {
+  response_decoder_.decodeHeaders(std::move(headers), end_stream);
+  if (end_stream) {
+    onRemoteEndStream();
+  }
+}
+
+void OriginStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  const uint64_t length = data.length();
+  response_decoder_.decodeData(data, end_stream);
+  const uint64_t posted = link_->response_bytes_posted_.fetch_sub(length);
+  if (posted > buffer_limit_ / 2 && posted - length <= buffer_limit_ / 2) {
+    link_->postToOwner([](OwnerStream& owner) -> void { owner.onResponseBytesDecoded(); });
+  }
+  if (end_stream) {
+    onRemoteEndStream();
+  }
+}
+
+void OriginStream::decodeTrailers(HeaderMapPtr&& trailers) {
+  response_decoder_.decodeTrailers(std::move(trailers));
+  onRemoteEndStream();
+}
+
+void OriginStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  response_decoder_.decodeMetadata(std::move(metadata_map));
+}
+
+void OriginStream::onLocalEndStream() {
+  local_end_stream_ = true;
+  if (remote_end_stream_) {
+    destroy();
+  }
+}
+
+void OriginStream::onRemoteEndStream() {
+  remote_end_stream_ = true;
+  if (local_end_stream_) {
+    destroy();
+  }
+}
+
+void OriginStream::destroy() {
+  if (link_->origin_ == nullptr) {
+    return;
+  }
+
+  // The stream is deleted once the current event completes, so it remains usable by the caller.
+  // Events of the owner half posted afterwards are dropped.
+  link_->origin_ = nullptr;
+  parent_.dispatcher_.deferredDelete(removeFromList(parent_.streams_));
+  parent_.checkForDrained();
+}
+
+OwnerStream::OwnerStream(SharedConnPoolImpl& parent, SharedStreamLinkSharedPtr link)
+    : parent_(parent), link_(std::move(link)) {
+  link_->owner_ = this;
+}
+
+OwnerStream::~OwnerStream() {
+  if (link_->owner_ == this) {
+    link_->owner_ = nullptr;
+  }
+}
+
+void OwnerStream::attach(ConnectionPool::Instance& pool) {
+  ConnectionPool::Cancellable* handle = pool.newStream(*this, *this);
+  if (handle != nullptr) {
+    handle_ = handle;
+  }
+}
+
+void OwnerStream::onParentDestroyed() {
+  if (link_->owner_ == nullptr) {
+    return;
+  }
+
+  if (encoder_ == nullptr) {
+    link_->postToOrigin([](OriginStream& origin) -> void { origin.onOwnerDropped(); });
+  } else {
+    link_->postToOrigin([](OriginStream& origin) -> void {
+      origin.onUpstreamReset(StreamResetReason::ConnectionTermination);
+    });
+  }
+  link_->owner_ = nullptr;
+}
+
+void OwnerStream::encode100ContinueHeaders(const HeaderMap& headers) {
+  ASSERT(encoder_ != nullptr);
+  encoder_->encode100ContinueHeaders(headers);
+}
+
+void OwnerStream::encodeHeaders(const HeaderMap& headers, bool end_stream) {
+  ASSERT(encoder_ != nullptr);
+  encoder_->encodeHeaders(headers, end_stream);
+  if (end_stream) {
+    onLocalEndStream();
+  }
+}
+
+void OwnerStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  ASSERT(encoder_ != nullptr);
+  const uint64_t length = data.length();
+  encoder_->encodeData(data, end_stream);
+  const uint64_t posted = link_->request_bytes_posted_.fetch_sub(length);
+  if (posted > buffer_limit_ / 2 && posted - length <= buffer_limit_ / 2) {
+    link_->postToOrigin([](OriginStream& origin) -> void { origin.onRequestBytesEncoded(); });
+  }
+  if (end_stream) {
+    onLocalEndStream();
+  }
+}
+
+void OwnerStream::encodeTrailers(const HeaderMap& trailers) {
+  ASSERT(encoder_ != nullptr);
+  encoder_->encodeTrailers(trailers);
+  onLocalEndStream();
+}
+
+void OwnerStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  ASSERT(encoder_ != nullptr);
+  encoder_->encodeMetadata(metadata_map_vector);
+}
+
+void OwnerStream::readDisable(bool disable) {
+  if (encoder_ != nullptr) {
+    encoder_->getStream().readDisable(disable);
+  }
+}
+
+void OwnerStream::resetStream(StreamResetReason reason) {
+  if (handle_ != nullptr) {
+    handle_->cancel();
+    handle_ = nullptr;
+  } else if (encoder_ != nullptr) {
+    encoder_->getStream().removeCallbacks(*this);
+    encoder_->getStream().resetStream(reason);
+    encoder_ = nullptr;
+  }
+  destroy();
+}
+
+void OwnerStream::onResponseBytesDecoded() {
+  if (above_high_watermark_ && link_->response_bytes_posted_ <= buffer_limit_ / 2) {
+    above_high_watermark_ = false;
+    if (encoder_ != nullptr) {
+      encoder_->getStream().readDisable(false);
+    }
+  }
+}
+
+void OwnerStream::decode100ContinueHeaders(HeaderMapPtr&& headers) {
+  auto holder = std::make_shared<HeaderMapPtr>(std::move(headers));
+  link_->postToOrigin([holder](OriginStream& origin) -> void {
+    origin.decode100ContinueHeaders(std::move(*holder));
+  });
+}
+
+void OwnerStream::decodeHeaders(HeaderMapPtr&& headers, bool end_stream) {
+  auto holder = std::make_shared<HeaderMapPtr>(std::move(headers));
+  link_->postToOrigin([holder, end_stream](OriginStream& origin) -> void {
+    origin.decodeHeaders(std::move(*holder), end_stream);
+  });
+  if (end_stream) {
+    onRemoteEndStream();
+  }
+}
+
+void OwnerStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  const uint64_t length = data.length();
+  auto buffer = std::make_shared<Buffer::OwnedImpl>();
+  buffer->move(data);
+  const uint64_t posted = link_->response_bytes_posted_ += length;
+  link_->postToOrigin([buffer, end_stream](OriginStream& origin) -> void {
+    origin.decodeData(*buffer, end_stream);
+  });
+  if (end_stream) {
+    onRemoteEndStream();
+    return;
+  }
+
+  // Stop reading the response while the origin half is behind by more than the buffer limit.
+  if (!above_high_watermark_ && posted > buffer_limit_) {
+    above_high_watermark_ = true;
+    encoder_->getStream().readDisable(true);
+  }
+}
+
+void OwnerStream::decodeTrailers(HeaderMapPtr&& trailers) {
+  auto holder = std::make_shared<HeaderMapPtr>(std::move(trailers));
+  link_->postToOrigin(
+      [holder](OriginStream& origin) -> void { origin.decodeTrailers(std::move(*holder)); });
+  onRemoteEndStream();
+}
+
+void OwnerStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  auto holder = std::make_shared<MetadataMapPtr>(std::move(metadata_map));
+  link_->postToOrigin(
+      [holder](OriginStream& origin) -> void { origin.decodeMetadata(std::move(*holder)); });
+}
+
+void OwnerStream::onResetStream(StreamResetReason reason, absl::string_view) {
+  encoder_ = nullptr;
+  link_->postToOrigin([reason](OriginStream& origin) -> void { origin.onUpstreamReset(reason); });
+  destroy();
+}
+
+void OwnerStream::onAboveWriteBufferHighWatermark() {
+  link_->postToOrigin([](OriginStream& origin) -> void { origin.runHighWatermarkCallbacks(); });
+}
+
+void OwnerStream::onBelowWriteBufferLowWatermark() {
+  link_->postToOrigin([](OriginStream& origin) -> void { origin.runLowWatermarkCallbacks(); });
+}
+
+void OwnerStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                absl::string_view transport_failure_reason,
+                                Upstream::HostDescriptionConstSharedPtr host) {
+  handle_ = nullptr;
+  link_->postToOrigin([reason, transport_failure_reason = std::string(transport_failure_reason),
+                       host](OriginStream& origin) -> void {
+    origin.onPoolFailure(reason, transport_failure_reason, host);
+  });
+  destroy();
+}
+
+void OwnerStream::onPoolReady(StreamEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                              const StreamInfo::StreamInfo&) {
+  handle_ = nullptr;
+  encoder_ = &encoder;
+  encoder.getStream().addCallbacks(*this);
+  buffer_limit_ = encoder.getStream().bufferLimit();
+  if (buffer_limit_ == 0) {
+    buffer_limit_ = DefaultForwardedBufferLimit;
+  }
+  link_->postToOrigin([host, buffer_limit = buffer_limit_](OriginStream& origin) -> void {
+    origin.onPoolReady(host, buffer_limit);
+  });
+}
+
+void OwnerStream::onLocalEndStream() {
+  local_end_stream_ = true;
+  if (remote_end_stream_) {
+    destroy();
+  }
+}
+
+void OwnerStream::onRemoteEndStream() {
+  remote_end_stream_ = true;
+  if (local_end_stream_) {
+    destroy();
+  }
+}
+
+void OwnerStream::destroy() {
+  if (link_->owner_ == nullptr) {
+    return;
+  }
+
+  if (encoder_ != nullptr) {
+    // The upstream stream is complete and about to be destroyed by its codec.
+    encoder_->getStream().removeCallbacks(*this);
+    encoder_ = nullptr;
+  }
+  link_->owner_ = nullptr;
+  parent_.dispatcher_.deferredDelete(removeFromList(parent_.forwarded_streams_));
+}
+
+SharedConnPoolImpl::SharedConnPoolImpl(Event::Dispatcher& dispatcher,
+                                       ConnectionPool::InstancePtr pool)
+    : dispatcher_(dispatcher), pool_(std::move(pool)) {}
+
+SharedConnPoolImpl::~SharedConnPoolImpl() {
+  // Destroying the pool resets its active streams, the forwarded ones included. The pending
+  // streams are dropped silently, so report the forwarded ones to their origin here.
+  pool_.reset();
+  for (OwnerStreamPtr& stream : forwarded_streams_) {
+    stream->onParentDestroyed();
+  }
+}
+
+uint32_t SharedConnPoolImpl::ownerWorker(uint64_t host_hash, uint32_t worker_index,
+                                         uint32_t num_workers, uint32_t owners_per_host) {
+  ASSERT(worker_index < num_workers);
+  ASSERT(owners_per_host > 0);
+  const uint32_t num_owners = std::min(owners_per_host, num_workers);
+  const uint32_t first_owner = host_hash % num_workers;
+  if ((worker_index + num_workers - first_owner) % num_workers < num_owners) {
+    return worker_index;
+  }
+  return (first_owner + worker_index % num_owners) % num_workers;
+}
+
+void SharedConnPoolImpl::attachForwardedStream(SharedStreamLinkSharedPtr link) {
+  if (draining_) {
+    ENVOY_LOG(debug, "rejecting forwarded stream of a draining pool");
+    link->postToOrigin([](OriginStream& origin) -> void { origin.onOwnerDropped(); });
+    return;
+  }
+
+  OwnerStreamPtr stream = std::make_unique<OwnerStream>(*this, std::move(link));
+  stream->moveIntoList(std::move(stream), forwarded_streams_);
+  forwarded_streams_.front()->attach(*pool_);
+}
+
+void SharedConnPoolImpl::addDrainedCallback(DrainedCb cb) {
+  draining_ = true;
+  pool_->addDrainedCallback(cb);
+}
+
+ForwardingConnPoolImpl::ForwardingConnPoolImpl(Event::Dispatcher& dispatcher,
+                                               DispatcherHandleSharedPtr dispatcher_handle,
+                                               DispatcherHandleSharedPtr owner_dispatcher,
+                                               Upstream::HostConstSharedPtr host,
+                                               Http::Protocol protocol, OwnerPoolLocator locator)
+    : dispatcher_(dispatcher), dispatcher_handle_(std::move(dispatcher_handle)),
+      owner_dispatcher_(std::move(owner_dispatcher)), host_(std::move(host)), protocol_(protocol),
+      locator_(std::make_shared<const OwnerPoolLocator>(std::move(locator))) {}
+
+ForwardingConnPoolImpl::~ForwardingConnPoolImpl() {
+  // Let the owning worker release the upstream streams which are still open.
+  for (OriginStreamPtr& stream : streams_) {
+    stream->link_->postToOwner(
+        [](OwnerStream& owner) -> void { owner.resetStream(StreamResetReason::LocalReset); });
+  }
+}
+
+void ForwardingConnPoolImpl::addDrainedCallback(DrainedCb cb) {
+  drained_callbacks_.push_back(cb);
+  checkForDrained();
+}
+
+ConnectionPool::Cancellable*
+ForwardingConnPoolImpl::newStream(StreamDecoder& response_decoder,
+                                  ConnectionPool::Callbacks& callbacks) {
+  ASSERT(drained_callbacks_.empty());
+  ENVOY_LOG(debug, "forwarding stream to the owning worker");
+  host_->cluster().stats().upstream_rq_forwarded_.inc();
+
+  OriginStreamPtr stream = std::make_unique<OriginStream>(*this, response_decoder, callbacks);
+  SharedStreamLinkSharedPtr link = stream->link_;
+  stream->moveIntoList(std::move(stream), streams_);
+  auto fail = [link]() -> void {
+    link->postToOrigin([](OriginStream& origin) -> void { origin.onOwnerDropped(); });
+  };
+  // The stream fails if the owning worker is shutting down, as it then drops the attachment.
+  owner_dispatcher_->post(
+      [link, locator = locator_, fail]() -> void {
+        SharedConnPoolImpl* pool = (*locator)();
+        if (pool == nullptr) {
+          fail();
+          return;
+        }
+        pool->attachForwardedStream(link);
+      },
+      fail);
+
+  return streams_.front().get();
+}
+
+void ForwardingConnPoolImpl::checkForDrained() {
+  if (!drained_callbacks_.empty() && streams_.empty()) {
+    ENVOY_LOG(debug, "invoking drained callbacks");
+    for (const DrainedCb& cb : drained_callbacks_) {
+      cb();
+    }
+  }
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
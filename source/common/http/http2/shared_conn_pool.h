@@ -0,0 +1,347 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/upstream/upstream.h"
+
+#include "common/common/linked_object.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/http/codec_helper.h"
+#include "common/stream_info/stream_info_impl.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+class ForwardingConnPoolImpl;
+class OriginStream;
+class OwnerStream;
+class SharedConnPoolImpl;
+
+/**
+ * A handle through which other workers post to the dispatcher of a worker. The worker closes it
+ * on its own thread before it destroys the state which the posted callbacks use, and before its
+ * dispatcher goes away. Nothing is posted through a closed handle, and the callbacks which were
+ * posted before it was closed are dropped when they run.
+ */
+class DispatcherHandle : public std::enable_shared_from_this<DispatcherHandle> {
+public:
+  explicit DispatcherHandle(Event::Dispatcher& dispatcher) : dispatcher_(&dispatcher) {}
+
+  /**
+   * Post a callback to the dispatcher.
+   * @param cb supplies the callback, which is run unless the handle is closed by then.
+   * @param on_closed supplies an optional callback which is run instead of cb if the handle is
+   *        closed. It runs on the calling thread if the handle is already closed, and on the
+   *        dispatcher otherwise.
+   */
+  void post(Event::PostCb cb, Event::PostCb on_closed = nullptr);
+
+  /**
+   * Close the handle. Must be called on the dispatcher.
+   */
+  void close();
+
+private:
+  bool isOpen();
+
+  Thread::MutexBasicLockable lock_;
+  Event::Dispatcher* dispatcher_ ABSL_GUARDED_BY(lock_);
+};
+
+using DispatcherHandleSharedPtr = std::shared_ptr<DispatcherHandle>;
+
+/**
+ * Connects the two halves of a stream which a worker forwarded to the connection pool of another
+ * worker. The origin half lives on the worker which created the stream and the owner half on the
+ * worker which owns the connection. Each half is only accessed on the dispatcher of its worker,
+ * and is cleared once it is gone, so that the events posted to it afterwards are dropped.
+ *
+ * The body bytes which are posted by one half and not yet passed on by the other are counted, so
+ * that the sending half can stop reading once they reach the buffer limit of the stream, and
+ * resume once the other half has passed on enough of them.
+ */
+class SharedStreamLink : public std::enable_shared_from_this<SharedStreamLink> {
+public:
+  SharedStreamLink(DispatcherHandleSharedPtr origin_dispatcher,
+                   DispatcherHandleSharedPtr owner_dispatcher)
+      : origin_dispatcher_(std::move(origin_dispatcher)),
+        owner_dispatcher_(std::move(owner_dispatcher)) {}
+
+  /**
+   * Run a callback with the origin half on its dispatcher, unless the origin half is gone by then.
+   */
+  void postToOrigin(std::function<void(OriginStream&)> cb);
+
+  /**
+   * Run a callback with the owner half on its dispatcher, unless the owner half is gone by then.
+   */
+  void postToOwner(std::function<void(OwnerStream&)> cb);
+
+  const DispatcherHandleSharedPtr origin_dispatcher_;
+  const DispatcherHandleSharedPtr owner_dispatcher_;
+  // Request body bytes posted by the origin half and not yet encoded by the owner half.
+  std::atomic<uint64_t> request_bytes_posted_{};
+  // Response body bytes posted by the owner half and not yet decoded by the origin half.
+  std::atomic<uint64_t> response_bytes_posted_{};
+  // Only accessed on origin_dispatcher_.
+  OriginStream* origin_{};
+  // Only accessed on owner_dispatcher_.
+  OwnerStream* owner_{};
+};
+
+using SharedStreamLinkSharedPtr = std::shared_ptr<SharedStreamLink>;
+
+/**
+ * The origin half of a forwarded stream. It stands in for the upstream stream towards the pool
+ * callbacks and the response decoder of its worker. The response of the owner half is delivered
+ * through the StreamDecoder interface.
+ */
+class OriginStream : public ConnectionPool::Cancellable,
+                     public StreamEncoder,
+                     public Stream,
+                     public StreamDecoder,
+                     public StreamCallbackHelper,
+                     public LinkedObject<OriginStream>,
+                     public Event::DeferredDeletable {
+public:
+  OriginStream(ForwardingConnPoolImpl& parent, StreamDecoder& response_decoder,
+               ConnectionPool::Callbacks& callbacks);
+  ~OriginStream() override;
+
+  // Events of the owner half.
+  void onPoolReady(Upstream::HostDescriptionConstSharedPtr host, uint32_t buffer_limit);
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     const std::string& transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr host);
+  // The owning worker dropped the stream before it got an upstream stream. The failure is
+  // reported for the host of the parent pool.
+  void onOwnerDropped();
+  void onUpstreamReset(StreamResetReason reason);
+  void onRequestBytesEncoded();
+
+  // ConnectionPool::Cancellable
+  void cancel() override;
+
+  // Http::StreamEncoder
+  void encode100ContinueHeaders(const HeaderMap& headers) override;
+  void encodeHeaders(const HeaderMap& headers, bool end_stream) override;
+  void encodeData(Buffer::Instance& data, bool end_stream) override;
+  void encodeTrailers(const HeaderMap& trailers) override;
+  Stream& getStream() override { return *this; }
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+
+  // Http::Stream
+  void addCallbacks(StreamCallbacks& callbacks) override { addCallbacks_(callbacks); }
+  void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacks_(callbacks); }
+  void resetStream(StreamResetReason reason) override;
+  void readDisable(bool disable) override;
+  uint32_t bufferLimit() override { return buffer_limit_; }
+
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&& headers) override;
+  void decodeHeaders(HeaderMapPtr&& headers, bool end_stream) override;
+  void decodeData(Buffer::Instance& data, bool end_stream) override;
+  void decodeTrailers(HeaderMapPtr&& trailers) override;
+  void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+  const SharedStreamLinkSharedPtr link_;
+
+private:
+  void onLocalEndStream();
+  void onRemoteEndStream();
+  void destroy();
+
+  ForwardingConnPoolImpl& parent_;
+  StreamDecoder& response_decoder_;
+  ConnectionPool::Callbacks& callbacks_;
+  // The stream info of the upstream connection cannot be read from this worker. Only the protocol
+  // and the timing of the forwarded stream are provided.
+  StreamInfo::StreamInfoImpl stream_info_;
+  uint32_t buffer_limit_{};
+  bool above_high_watermark_{};
+  bool local_end_stream_{};
+  bool remote_end_stream_{};
+};
+
+using OriginStreamPtr = std::unique_ptr<OriginStream>;
+
+/**
+ * The owner half of a forwarded stream. It attaches to the connection pool of the worker owning
+ * the connection like any other stream, and relays the events of the upstream stream to the
+ * origin half.
+ */
+class OwnerStream : public StreamDecoder,
+                    public StreamCallbacks,
+                    public ConnectionPool::Callbacks,
+                    public LinkedObject<OwnerStream>,
+                    public Event::DeferredDeletable {
+public:
+  OwnerStream(SharedConnPoolImpl& parent, SharedStreamLinkSharedPtr link);
+  ~OwnerStream() override;
+
+  /**
+   * Create the upstream stream. The stream must already be owned by the parent.
+   */
+  void attach(ConnectionPool::Instance& pool);
+
+  /**
+   * Drop the stream as its parent is destroyed, reporting this to the origin half.
+   */
+  void onParentDestroyed();
+
+  // Events of the origin half.
+  void encode100ContinueHeaders(const HeaderMap& headers);
+  void encodeHeaders(const HeaderMap& headers, bool end_stream);
+  void encodeData(Buffer::Instance& data, bool end_stream);
+  void encodeTrailers(const HeaderMap& trailers);
+  void encodeMetadata(const MetadataMapVector& metadata_map_vector);
+  void readDisable(bool disable);
+  void resetStream(StreamResetReason reason);
+  void onResponseBytesDecoded();
+
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&& headers) override;
+  void decodeHeaders(HeaderMapPtr&& headers, bool end_stream) override;
+  void decodeData(Buffer::Instance& data, bool end_stream) override;
+  void decodeTrailers(HeaderMapPtr&& trailers) override;
+  void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+  // Http::StreamCallbacks
+  void onResetStream(StreamResetReason reason,
+                     absl::string_view transport_failure_reason) override;
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
+  // ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                     absl::string_view transport_failure_reason,
+                     Upstream::HostDescriptionConstSharedPtr host) override;
+  void onPoolReady(StreamEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                   const StreamInfo::StreamInfo& info) override;
+
+private:
+  void onLocalEndStream();
+  void onRemoteEndStream();
+  void destroy();
+
+  SharedConnPoolImpl& parent_;
+  const SharedStreamLinkSharedPtr link_;
+  ConnectionPool::Cancellable* handle_{};
+  StreamEncoder* encoder_{};
+  uint32_t buffer_limit_{};
+  bool above_high_watermark_{};
+  bool local_end_stream_{};
+  bool remote_end_stream_{};
+};
+
+using OwnerStreamPtr = std::unique_ptr<OwnerStream>;
+
+/**
+ * Connection pool of the worker which owns the connections to a host when HTTP/2 connections are
+ * shared between workers. It wraps the worker's regular connection pool: local streams are passed
+ * through, and the streams forwarded by other workers are attached to it as well.
+ */
+class SharedConnPoolImpl : public ConnectionPool::Instance, Logger::Loggable<Logger::Id::pool> {
+public:
+  SharedConnPoolImpl(Event::Dispatcher& dispatcher, ConnectionPool::InstancePtr pool);
+  ~SharedConnPoolImpl() override;
+
+  /**
+   * Picks the worker owning the connections to a host which a worker uses. The owners of a host
+   * are consecutive workers, starting at a position derived from the host so that the connections
+   * of different hosts are spread over the workers, and the other workers are spread over them.
+   * @param host_hash supplies a hash of the host.
+   * @param worker_index supplies the index of the worker, which is less than num_workers.
+   * @param num_workers supplies the number of workers.
+   * @param owners_per_host supplies the number of workers owning connections to each host.
+   * @return uint32_t the index of the owning worker, which is worker_index if it is an owner.
+   */
+  static uint32_t ownerWorker(uint64_t host_hash, uint32_t worker_index, uint32_t num_workers,
+                              uint32_t owners_per_host);
+
+  /**
+   * Attach a stream forwarded by another worker. Must be called on the dispatcher of this pool.
+   * @param link supplies the link of the forwarded stream.
+   */
+  void attachForwardedStream(SharedStreamLinkSharedPtr link);
+
+  // Http::ConnectionPool::Instance
+  Http::Protocol protocol() const override { return pool_->protocol(); }
+  void addDrainedCallback(DrainedCb cb) override;
+  void drainConnections() override { pool_->drainConnections(); }
+  bool hasActiveConnections() const override { return pool_->hasActiveConnections(); }
+  ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override {
+    return pool_->newStream(response_decoder, callbacks);
+  }
+  Upstream::HostDescriptionConstSharedPtr host() const override { return pool_->host(); }
+
+private:
+  friend class OwnerStream;
+
+  Event::Dispatcher& dispatcher_;
+  ConnectionPool::InstancePtr pool_;
+  std::list<OwnerStreamPtr> forwarded_streams_;
+  bool draining_{};
+};
+
+/**
+ * Connection pool of a worker which does not own the connections to a host when HTTP/2
+ * connections are shared between workers. Its streams are forwarded to the SharedConnPoolImpl of
+ * the owning worker, and the events of each stream are posted between the two dispatchers.
+ */
+class ForwardingConnPoolImpl : public ConnectionPool::Instance,
+                               Logger::Loggable<Logger::Id::pool> {
+public:
+  /**
+   * Locates the pool of the owning worker. It is run on the owner's dispatcher, through the
+   * owner's dispatcher handle so that it only runs while the owner is alive, and returns
+   * nullptr if the pool is not available, for example because the host has been removed.
+   */
+  using OwnerPoolLocator = std::function<SharedConnPoolImpl*()>;
+
+  ForwardingConnPoolImpl(Event::Dispatcher& dispatcher, DispatcherHandleSharedPtr dispatcher_handle,
+                         DispatcherHandleSharedPtr owner_dispatcher,
+                         Upstream::HostConstSharedPtr host, Http::Protocol protocol,
+                         OwnerPoolLocator locator);
+  ~ForwardingConnPoolImpl() override;
+
+  // Http::ConnectionPool::Instance
+  Http::Protocol protocol() const override { return protocol_; }
+  void addDrainedCallback(DrainedCb cb) override;
+  // The connections are drained by the owning worker, which sees the same host events.
+  void drainConnections() override {}
+  bool hasActiveConnections() const override { return !streams_.empty(); }
+  ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override;
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+
+private:
+  friend class OriginStream;
+
+  void checkForDrained();
+
+  Event::Dispatcher& dispatcher_;
+  const DispatcherHandleSharedPtr dispatcher_handle_;
+  const DispatcherHandleSharedPtr owner_dispatcher_;
+  const Upstream::HostConstSharedPtr host_;
+  const Http::Protocol protocol_;
+  const std::shared_ptr<const OwnerPoolLocator> locator_;
+  std::list<OriginStreamPtr> streams_;
+  std::list<DrainedCb> drained_callbacks_;
+};
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
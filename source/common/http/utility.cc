@@ -283,6 +283,17 @@ Utility::parseHttp1Settings(const envoy::api::v2::core::Http1ProtocolOptions& co
     ret.header_key_format_ = Http1Settings::HeaderKeyFormat::Default;
   }
 
+  switch (config.parser()) {
+  case envoy::api::v2::core::Http1ProtocolOptions::HTTP_PARSER:
+    ret.parser_impl_ = Http1Settings::ParserImpl::HttpParser;
+    break;
+  case envoy::api::v2::core::Http1ProtocolOptions::VECTORIZED:
+    ret.parser_impl_ = Http1Settings::ParserImpl::Vectorized;
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
   return ret;
 }
 
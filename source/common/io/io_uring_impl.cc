@@ -0,0 +1,264 @@
+#include "common/io/io_uring_impl.h"
+
+#ifdef ENVOY_IO_URING_SUPPORTED
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+// Defined by kernel headers since 5.8; older kernels never set it.
+#ifndef IORING_SQ_CQ_OVERFLOW
+#define IORING_SQ_CQ_OVERFLOW (1U << 1)
+#endif
+
+namespace Envoy {
+namespace Io {
+
+namespace {
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int ring_fd, unsigned opcode, const void* arg, unsigned nr_args) {
+  return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+}
+
+template <class T> T* ringField(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+}
+
+// Returns nullptr if the mapping fails, with errno set.
+void* mapRing(int ring_fd, size_t size, off_t offset) {
+  void* ring =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, offset);
+  return ring != MAP_FAILED ? ring : nullptr;
+}
+
+} // namespace
+
+IoUringImpl::IoUringImpl(uint32_t io_uring_size) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = ioUringSetup(io_uring_size, &params);
+  if (ring_fd_ < 0) {
+    throw EnvoyException(fmt::format("unable to create io_uring: {}", strerror(errno)));
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    sq_ring_ = cq_ring_ = mapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+  } else {
+    sq_ring_ = mapRing(ring_fd_, sq_ring_size_, IORING_OFF_SQ_RING);
+    if (sq_ring_ != nullptr) {
+      cq_ring_ = mapRing(ring_fd_, cq_ring_size_, IORING_OFF_CQ_RING);
+    }
+  }
+  if (cq_ring_ != nullptr) {
+    sq_.sqes_ = static_cast<io_uring_sqe*>(mapRing(ring_fd_, sqes_size_, IORING_OFF_SQES));
+  }
+  if (sq_.sqes_ == nullptr) {
+    // The destructor does not run for a constructor which throws.
+    const int error = errno;
+    release();
+    throw EnvoyException(fmt::format("unable to map io_uring: {}", strerror(error)));
+  }
+
+  sq_.head_ = ringField<unsigned>(sq_ring_, params.sq_off.head);
+  sq_.tail_ = ringField<unsigned>(sq_ring_, params.sq_off.tail);
+  sq_.ring_mask_ = ringField<unsigned>(sq_ring_, params.sq_off.ring_mask);
+  sq_.ring_entries_ = ringField<unsigned>(sq_ring_, params.sq_off.ring_entries);
+  sq_.flags_ = ringField<unsigned>(sq_ring_, params.sq_off.flags);
+  sq_.array_ = ringField<unsigned>(sq_ring_, params.sq_off.array);
+  cq_.head_ = ringField<unsigned>(cq_ring_, params.cq_off.head);
+  cq_.tail_ = ringField<unsigned>(cq_ring_, params.cq_off.tail);
+  cq_.ring_mask_ = ringField<unsigned>(cq_ring_, params.cq_off.ring_mask);
+  cq_.cqes_ = ringField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+  sqe_tail_ = *sq_.tail_;
+}
+
+IoUringImpl::~IoUringImpl() { release(); }
+
+void IoUringImpl::release() {
+  if (sq_.sqes_ != nullptr) {
+    munmap(sq_.sqes_, sqes_size_);
+  }
+  if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  if (sq_ring_ != nullptr) {
+    munmap(sq_ring_, sq_ring_size_);
+  }
+  if (event_fd_ != -1) {
+    ::close(event_fd_);
+  }
+  ::close(ring_fd_);
+}
+
+bool IoUringImpl::isAvailable() {
+  static const bool available = []() {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int ring_fd = ioUringSetup(2, &params);
+    if (ring_fd < 0) {
+      return false;
+    }
+    ::close(ring_fd);
+    return true;
+  }();
+  return available;
+}
+
+int IoUringImpl::registerEventfd() {
+  ASSERT(event_fd_ == -1);
+  event_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (event_fd_ < 0 ||
+      ioUringRegister(ring_fd_, IORING_REGISTER_EVENTFD, &event_fd_, 1) < 0) {
+    throw EnvoyException(fmt::format("unable to register io_uring eventfd: {}", strerror(errno)));
+  }
+  return event_fd_;
+}
+
+void IoUringImpl::forEveryCompletion(const CompletionCb& completion_cb) {
+  // The eventfd is not read: every completion signals it again, which is all an edge triggered
+  // poller needs, and the read would cost a system call per event loop iteration.
+  while (true) {
+    unsigned head = *cq_.head_;
+    const unsigned tail = __atomic_load_n(cq_.tail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+      const io_uring_cqe& cqe = cq_.cqes_[head & *cq_.ring_mask_];
+      void* user_data = reinterpret_cast<void*>(cqe.user_data);
+      const int32_t result = cqe.res;
+      // Release the entry before running the callback, which may consume further completions.
+      head++;
+      __atomic_store_n(cq_.head_, head, __ATOMIC_RELEASE);
+      completion_cb(user_data, result);
+    }
+
+    // With more requests in flight than the completion queue holds, the kernel keeps the excess
+    // completions aside until asked to move them into the now empty queue.
+    if ((__atomic_load_n(sq_.flags_, __ATOMIC_ACQUIRE) & IORING_SQ_CQ_OVERFLOW) == 0) {
+      return;
+    }
+    ioUringEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+  }
+}
+
+io_uring_sqe* IoUringImpl::nextSqe() {
+  const unsigned head = __atomic_load_n(sq_.head_, __ATOMIC_ACQUIRE);
+  if (sqe_tail_ - head >= *sq_.ring_entries_) {
+    return nullptr;
+  }
+  const unsigned index = sqe_tail_ & *sq_.ring_mask_;
+  sq_.array_[index] = index;
+  sqe_tail_++;
+  io_uring_sqe* sqe = &sq_.sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+IoUringResult IoUringImpl::prepareReadv(int fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                        void* user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_READV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = nr_vecs;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareWritev(int fd, const struct iovec* iovecs, unsigned nr_vecs,
+                                         void* user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_WRITEV;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(iovecs);
+  sqe->len = nr_vecs;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareAccept(int fd, struct sockaddr* remote_addr,
+                                         socklen_t* remote_addr_len, void* user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(remote_addr);
+  sqe->addr2 = reinterpret_cast<uint64_t>(remote_addr_len);
+  sqe->accept_flags = SOCK_NONBLOCK;
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::preparePollAdd(int fd, uint32_t events, void* user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = fd;
+  // Every kernel reads the 16 bit field, which holds all of the poll(2) events; 5.9 and later read
+  // it as part of poll32_events.
+  sqe->poll_events = static_cast<uint16_t>(events);
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::prepareCancel(void* cancelled_user_data, void* user_data) {
+  io_uring_sqe* sqe = nextSqe();
+  if (sqe == nullptr) {
+    return IoUringResult::Busy;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = reinterpret_cast<uint64_t>(cancelled_user_data);
+  sqe->user_data = reinterpret_cast<uint64_t>(user_data);
+  return IoUringResult::Ok;
+}
+
+IoUringResult IoUringImpl::submit() {
+  // The kernel only reads the tail, it never writes it.
+  __atomic_store_n(sq_.tail_, sqe_tail_, __ATOMIC_RELEASE);
+  const unsigned to_submit = sqe_tail_ - __atomic_load_n(sq_.head_, __ATOMIC_ACQUIRE);
+  if (to_submit == 0) {
+    return IoUringResult::Ok;
+  }
+  const int rc = ioUringEnter(ring_fd_, to_submit, 0, 0);
+  if (rc < 0) {
+    return errno == EAGAIN || errno == EBUSY ? IoUringResult::Busy : IoUringResult::Failed;
+  }
+  return IoUringResult::Ok;
+}
+
+} // namespace Io
+} // namespace Envoy
+
+#endif // ENVOY_IO_URING_SUPPORTED
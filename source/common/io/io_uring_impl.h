@@ -0,0 +1,106 @@
+#pragma once
+
+// io_uring is only available on Linux, and only usable when building against the headers of
+// Linux 5.5 or later, which define the io_uring system calls and every opcode, feature and
+// register operation used by IoUringImpl. IORING_FEAT_NODROP appeared in the same release as
+// IORING_OP_ACCEPT and IORING_OP_ASYNC_CANCEL. Those, and IORING_REGISTER_EVENTFD in recent
+// headers, are enumerators and cannot be tested for directly.
+// IoUringWorker::create() returns nullptr when ENVOY_IO_URING_SUPPORTED is not defined.
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) &&                               \
+    defined(__NR_io_uring_register) && defined(IORING_FEAT_SINGLE_MMAP) &&                         \
+    defined(IORING_FEAT_NODROP)
+#define ENVOY_IO_URING_SUPPORTED 1
+#endif
+#endif
+#endif
+
+#ifdef ENVOY_IO_URING_SUPPORTED
+
+#include <cstddef>
+#include <cstdint>
+
+#include "envoy/common/io_uring.h"
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Io {
+
+/**
+ * IoUring implementation on top of the raw io_uring_setup(2)/io_uring_enter(2) system calls and
+ * the rings shared with the kernel.
+ */
+class IoUringImpl : public IoUring, NonCopyable {
+public:
+  /**
+   * @param io_uring_size supplies the number of submission queue entries. The kernel rounds it up
+   *        to a power of two.
+   * @throw EnvoyException if the ring cannot be created.
+   */
+  explicit IoUringImpl(uint32_t io_uring_size);
+  ~IoUringImpl() override;
+
+  /**
+   * @return bool whether the running kernel supports io_uring and allows this process to use it.
+   */
+  static bool isAvailable();
+
+  // Io::IoUring
+  int registerEventfd() override;
+  void forEveryCompletion(const CompletionCb& completion_cb) override;
+  IoUringResult prepareReadv(int fd, const struct iovec* iovecs, unsigned nr_vecs,
+                             void* user_data) override;
+  IoUringResult prepareWritev(int fd, const struct iovec* iovecs, unsigned nr_vecs,
+                              void* user_data) override;
+  IoUringResult prepareAccept(int fd, struct sockaddr* remote_addr, socklen_t* remote_addr_len,
+                              void* user_data) override;
+  IoUringResult preparePollAdd(int fd, uint32_t events, void* user_data) override;
+  IoUringResult prepareCancel(void* cancelled_user_data, void* user_data) override;
+  IoUringResult submit() override;
+
+private:
+  // Views into the ring buffers shared with the kernel.
+  struct SubmissionQueue {
+    unsigned* head_;
+    unsigned* tail_;
+    unsigned* ring_mask_;
+    unsigned* ring_entries_;
+    unsigned* flags_;
+    unsigned* array_;
+    io_uring_sqe* sqes_{};
+  };
+
+  struct CompletionQueue {
+    unsigned* head_;
+    unsigned* tail_;
+    unsigned* ring_mask_;
+    io_uring_cqe* cqes_;
+  };
+
+  // Returns the next free submission queue entry, zeroed, or nullptr if the queue is full.
+  io_uring_sqe* nextSqe();
+  // Unmaps whatever part of the rings is mapped and closes the file descriptors.
+  void release();
+
+  int ring_fd_;
+  int event_fd_{-1};
+  SubmissionQueue sq_;
+  CompletionQueue cq_;
+  // Tail of the submission queue including the entries which have not been submitted yet.
+  unsigned sqe_tail_;
+  void* sq_ring_{};
+  size_t sq_ring_size_;
+  // Equal to sq_ring_ if the kernel maps both rings at once.
+  void* cq_ring_{};
+  size_t cq_ring_size_;
+  size_t sqes_size_;
+};
+
+} // namespace Io
+} // namespace Envoy
+
+#endif // ENVOY_IO_URING_SUPPORTED
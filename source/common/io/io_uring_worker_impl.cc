@@ -0,0 +1,703 @@
+#include "common/io/io_uring_worker_impl.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/common/macros.h"
+#include "common/io/io_uring_impl.h"
+
+#ifdef ENVOY_IO_URING_SUPPORTED
+#include <poll.h>
+#endif
+
+namespace Envoy {
+namespace Io {
+
+namespace {
+std::atomic<uint32_t> io_uring_size{0};
+} // namespace
+
+void IoUringWorker::setIoUringSize(uint32_t size) { io_uring_size = size; }
+
+#ifdef ENVOY_IO_URING_SUPPORTED
+
+constexpr uint64_t IoUringSocket::ReadBufferSize;
+constexpr uint64_t IoUringSocket::MaxWriteBufferSize;
+constexpr uint64_t IoUringSocket::MaxWriteIovecs;
+constexpr uint32_t IoUringAcceptor::MaxAcceptsInFlight;
+
+IoUringSocket::IoUringSocket(IoUringWorker& parent, Network::IoHandlePtr&& io_handle)
+    : parent_(parent), io_handle_(std::move(io_handle)), fd_(io_handle_->fd()) {}
+
+Api::SysCallSizeResult IoUringSocket::read(Buffer::Instance& buffer, uint64_t max_length) {
+  ASSERT(!closed_);
+  startRing();
+  if (read_buffer_.length() == 0) {
+    return noDataResult();
+  }
+
+  // Whole slices are moved rather than copied.
+  const uint64_t bytes_read = std::min(read_buffer_.length(), max_length);
+  buffer.move(read_buffer_, bytes_read);
+  if (read_buffer_.length() == 0) {
+    submitRead();
+  }
+  return {static_cast<ssize_t>(bytes_read), 0};
+}
+
+Api::SysCallSizeResult IoUringSocket::readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                            uint64_t num_slice) {
+  ASSERT(!closed_);
+  startRing();
+  if (read_buffer_.length() == 0) {
+    return noDataResult();
+  }
+
+  uint64_t bytes_read = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_read < max_length && read_buffer_.length() != 0;
+       i++) {
+    const uint64_t length = std::min(
+        {static_cast<uint64_t>(slices[i].len_), max_length - bytes_read, read_buffer_.length()});
+    read_buffer_.copyOut(0, length, slices[i].mem_);
+    read_buffer_.drain(length);
+    bytes_read += length;
+  }
+  if (read_buffer_.length() == 0) {
+    submitRead();
+  }
+  return {static_cast<ssize_t>(bytes_read), 0};
+}
+
+Api::SysCallSizeResult IoUringSocket::noDataResult() {
+  if (read_error_ != 0) {
+    return {-1, read_error_};
+  }
+  if (read_eof_) {
+    return {0, 0};
+  }
+  if (!read_in_flight_) {
+    submitRead();
+  }
+  return {-1, EAGAIN};
+}
+
+Api::SysCallSizeResult IoUringSocket::write(Buffer::Instance& buffer) {
+  ASSERT(!closed_);
+  startRing();
+  if (write_error_ != 0) {
+    return {-1, write_error_};
+  }
+  if (buffer.length() == 0) {
+    return {0, 0};
+  }
+
+  const uint64_t length =
+      std::min(buffer.length(), MaxWriteBufferSize - write_buffer_.length());
+  if (length == 0) {
+    write_blocked_ = true;
+    return {-1, EAGAIN};
+  }
+  // Whole slices are moved rather than copied.
+  write_buffer_.move(buffer, length);
+  if (!write_in_flight_) {
+    submitWrite();
+  }
+  return {static_cast<ssize_t>(length), 0};
+}
+
+Api::SysCallSizeResult IoUringSocket::writev(const Buffer::RawSlice* slices, uint64_t num_slice) {
+  ASSERT(!closed_);
+  startRing();
+  if (write_error_ != 0) {
+    return {-1, write_error_};
+  }
+
+  uint64_t bytes_written = 0;
+  bool full = false;
+  for (uint64_t i = 0; i < num_slice && !full; i++) {
+    const uint64_t space = MaxWriteBufferSize - write_buffer_.length();
+    const uint64_t length = std::min(static_cast<uint64_t>(slices[i].len_), space);
+    full = length < slices[i].len_;
+    write_buffer_.add(slices[i].mem_, length);
+    bytes_written += length;
+  }
+  if (bytes_written == 0 && full) {
+    write_blocked_ = true;
+    return {-1, EAGAIN};
+  }
+  if (!write_in_flight_ && write_buffer_.length() != 0) {
+    submitWrite();
+  }
+  return {static_cast<ssize_t>(bytes_written), 0};
+}
+
+Api::SysCallIntResult IoUringSocket::shutdown(int how) {
+  ASSERT(!closed_);
+  if (how != SHUT_RD && write_in_flight_) {
+    // Shutting down writes now would drop the buffered data, which is always being written out
+    // while there is any.
+    pending_shutdown_ = pending_shutdown_.has_value() && pending_shutdown_.value() != how
+                            ? SHUT_RDWR
+                            : how;
+    return {0, 0};
+  }
+  const int rc = ::shutdown(fd_, how);
+  return {rc, rc != -1 ? 0 : errno};
+}
+
+void IoUringSocket::discardPendingWrites() {
+  ASSERT(!closed_);
+  discard_writes_ = true;
+  pending_shutdown_.reset();
+  if (write_in_flight_) {
+    // The queued write still references the buffer, which is drained once it has completed.
+    submitCancel(write_request_, cancel_write_request_);
+  } else {
+    write_buffer_.drain(write_buffer_.length());
+  }
+}
+
+void IoUringSocket::close() {
+  ASSERT(!closed_);
+  // Buffered data is always being written out, and maybeFinishClose() waits for it.
+  ASSERT(write_in_flight_ || write_buffer_.length() == 0);
+  closed_ = true;
+  if (file_event_ != nullptr) {
+    file_event_->socket_ = nullptr;
+    file_event_ = nullptr;
+  }
+  if (read_in_flight_) {
+    submitCancel(read_request_, cancel_read_request_);
+  }
+  if (poll_in_flight_) {
+    submitCancel(poll_request_, cancel_poll_request_);
+  }
+  maybeFinishClose();
+}
+
+void IoUringSocket::setFileEvent(IoUringFileEvent* file_event) {
+  if (file_event_ != nullptr && file_event_ != file_event) {
+    file_event_->socket_ = nullptr;
+  }
+  file_event_ = file_event;
+}
+
+void IoUringSocket::startRing() {
+  if (ring_started_) {
+    return;
+  }
+  ring_started_ = true;
+  if (file_event_ != nullptr && file_event_->edge_triggered_) {
+    file_event_->stopPolling();
+  }
+}
+
+void IoUringSocket::onFileEventEnabled(uint32_t events) {
+  ASSERT(file_event_ != nullptr && !file_event_->polling_);
+  uint32_t ready_events = 0;
+  if (events & Event::FileReadyType::Read) {
+    if (read_buffer_.length() != 0 || read_eof_ || read_error_ != 0) {
+      ready_events |= Event::FileReadyType::Read;
+    } else if (!read_in_flight_) {
+      submitRead();
+    }
+  } else if (events & Event::FileReadyType::Closed) {
+    if (read_eof_ || read_error_ != 0) {
+      ready_events |= Event::FileReadyType::Closed;
+    } else if (read_buffer_.length() == 0) {
+      // The queued read completes with the end of the stream if the peer closes the connection.
+      if (!read_in_flight_) {
+        submitRead();
+      }
+    } else if (!poll_in_flight_) {
+      submitPoll();
+    }
+  }
+  if ((events & Event::FileReadyType::Write) && !write_blocked_) {
+    ready_events |= Event::FileReadyType::Write;
+  }
+  if (ready_events != 0) {
+    file_event_->activate(ready_events);
+  }
+}
+
+void IoUringSocket::submitRead() {
+  ASSERT(!read_in_flight_ && read_buffer_.length() == 0);
+  // The data is read straight into a slice of the buffer read() moves it out of.
+  read_buffer_.reserve(ReadBufferSize, &read_reservation_, 1);
+  read_iovec_.iov_base = read_reservation_.mem_;
+  read_iovec_.iov_len = read_reservation_.len_;
+  read_in_flight_ = true;
+  parent_.prepare([this](IoUring& io_uring) {
+    return io_uring.prepareReadv(fd_, &read_iovec_, 1, &read_request_);
+  });
+}
+
+void IoUringSocket::submitWrite() {
+  ASSERT(!write_in_flight_);
+  Buffer::RawSlice slices[MaxWriteIovecs];
+  const uint64_t num_slices = write_buffer_.getRawSlices(slices, MaxWriteIovecs);
+  uint64_t num_iovecs = 0;
+  for (uint64_t i = 0; i < std::min(num_slices, MaxWriteIovecs); i++) {
+    if (slices[i].len_ != 0) {
+      write_iovecs_[num_iovecs].iov_base = slices[i].mem_;
+      write_iovecs_[num_iovecs].iov_len = slices[i].len_;
+      num_iovecs++;
+    }
+  }
+  write_in_flight_ = true;
+  parent_.prepare([this, num_iovecs](IoUring& io_uring) {
+    return io_uring.prepareWritev(fd_, write_iovecs_, num_iovecs, &write_request_);
+  });
+}
+
+void IoUringSocket::submitPoll() {
+  ASSERT(!poll_in_flight_);
+  poll_in_flight_ = true;
+  parent_.prepare([this](IoUring& io_uring) {
+    return io_uring.preparePollAdd(fd_, POLLRDHUP, &poll_request_);
+  });
+}
+
+void IoUringSocket::submitCancel(IoUringRequest& request, IoUringRequest& cancel_request) {
+  cancels_in_flight_++;
+  parent_.prepare([&request, &cancel_request](IoUring& io_uring) {
+    return io_uring.prepareCancel(&request, &cancel_request);
+  });
+}
+
+void IoUringSocket::onRequestCompleted(IoUringRequest& request, int32_t result) {
+  if (&request == &read_request_) {
+    onReadCompleted(result);
+  } else if (&request == &write_request_) {
+    onWriteCompleted(result);
+  } else if (&request == &poll_request_) {
+    onPollCompleted(result);
+  } else {
+    ASSERT(&request == &cancel_read_request_ || &request == &cancel_write_request_ ||
+           &request == &cancel_poll_request_);
+    cancels_in_flight_--;
+    maybeFinishClose();
+  }
+}
+
+void IoUringSocket::onReadCompleted(int32_t result) {
+  read_in_flight_ = false;
+  if (closed_) {
+    maybeFinishClose();
+    return;
+  }
+
+  if (result > 0) {
+    read_reservation_.len_ = result;
+    read_buffer_.commit(&read_reservation_, 1);
+  } else if (result == 0) {
+    read_eof_ = true;
+  } else if (result == -EAGAIN || result == -EINTR) {
+    submitRead();
+    return;
+  } else {
+    read_error_ = -result;
+  }
+  onReadReady();
+}
+
+void IoUringSocket::onWriteCompleted(int32_t result) {
+  write_in_flight_ = false;
+  if (discard_writes_) {
+    write_buffer_.drain(write_buffer_.length());
+    if (closed_) {
+      maybeFinishClose();
+    }
+    return;
+  }
+  if (result == -EAGAIN || result == -EINTR) {
+    submitWrite();
+    return;
+  }
+  if (result < 0) {
+    ENVOY_LOG(debug, "io_uring write to fd {} failed: {}", fd_, strerror(-result));
+    write_error_ = -result;
+    write_buffer_.drain(write_buffer_.length());
+  } else {
+    write_buffer_.drain(result);
+  }
+
+  if (write_buffer_.length() != 0) {
+    submitWrite();
+    return;
+  }
+  if (pending_shutdown_.has_value()) {
+    ::shutdown(fd_, pending_shutdown_.value());
+    pending_shutdown_.reset();
+  }
+  if (closed_) {
+    maybeFinishClose();
+  } else if (write_blocked_ || write_error_ != 0) {
+    write_blocked_ = false;
+    onWriteReady();
+  }
+}
+
+void IoUringSocket::onPollCompleted(int32_t result) {
+  poll_in_flight_ = false;
+  if (closed_) {
+    maybeFinishClose();
+    return;
+  }
+
+  // The peer closed the connection or the socket failed. Only of interest while reads are
+  // disabled; otherwise the queued read reports it.
+  ENVOY_LOG(trace, "io_uring poll of fd {} completed: {}", fd_, result);
+  if (file_event_ != nullptr && !file_event_->polling_ &&
+      (file_event_->enabled_events_ & Event::FileReadyType::Closed) &&
+      !(file_event_->enabled_events_ & Event::FileReadyType::Read)) {
+    file_event_->activate(Event::FileReadyType::Closed);
+  }
+}
+
+void IoUringSocket::onReadReady() {
+  if (file_event_ == nullptr) {
+    return;
+  }
+  if (file_event_->polling_) {
+    file_event_->activate(Event::FileReadyType::Read);
+    return;
+  }
+
+  const uint32_t enabled_events = file_event_->enabled_events_;
+  if (enabled_events & Event::FileReadyType::Read) {
+    file_event_->activate(Event::FileReadyType::Read);
+  } else if (enabled_events & Event::FileReadyType::Closed) {
+    if (read_eof_ || read_error_ != 0) {
+      file_event_->activate(Event::FileReadyType::Closed);
+    } else if (!poll_in_flight_) {
+      // Data arrived while reads are disabled; keep watching for the peer closing the connection.
+      submitPoll();
+    }
+  }
+}
+
+void IoUringSocket::onWriteReady() {
+  if (file_event_ != nullptr &&
+      (file_event_->polling_ || (file_event_->enabled_events_ & Event::FileReadyType::Write))) {
+    file_event_->activate(Event::FileReadyType::Write);
+  }
+}
+
+void IoUringSocket::maybeFinishClose() {
+  if (closed_ && !read_in_flight_ && !write_in_flight_ && !poll_in_flight_ &&
+      cancels_in_flight_ == 0) {
+    io_handle_->close();
+    parent_.removeSocket(*this);
+  }
+}
+
+IoUringFileEvent::IoUringFileEvent(IoUringSocket& socket, Event::FileEventPtr&& file_event,
+                                   Event::FileTriggerType trigger, uint32_t events)
+    : socket_(&socket), file_event_(std::move(file_event)),
+      edge_triggered_(trigger == Event::FileTriggerType::Edge), enabled_events_(events) {
+  socket.setFileEvent(this);
+  if (socket.ring_started_ && edge_triggered_) {
+    stopPolling();
+  }
+}
+
+IoUringFileEvent::~IoUringFileEvent() {
+  if (socket_ != nullptr) {
+    socket_->setFileEvent(nullptr);
+  }
+}
+
+void IoUringFileEvent::setEnabled(uint32_t events) {
+  enabled_events_ = events;
+  if (polling_) {
+    file_event_->setEnabled(events);
+  } else if (socket_ != nullptr) {
+    socket_->onFileEventEnabled(events);
+  }
+}
+
+void IoUringFileEvent::stopPolling() {
+  ASSERT(polling_ && edge_triggered_);
+  polling_ = false;
+  // Removes the epoll registration. The libevent event can still be activated.
+  file_event_->setEnabled(0);
+  // The caller is reading or writing right now, so it needn't be told that it may write.
+  socket_->onFileEventEnabled(enabled_events_ & ~Event::FileReadyType::Write);
+}
+
+IoUringAcceptor::IoUringAcceptor(IoUringWorker& parent, int fd, AcceptCb accept_cb)
+    : parent_(parent), fd_(fd), accept_cb_(std::move(accept_cb)) {
+  for (AcceptRequest& request : accept_requests_) {
+    request.handler_ = this;
+    request.cancel_request_.handler_ = this;
+  }
+}
+
+void IoUringAcceptor::enable() {
+  ASSERT(!closed_);
+  enabled_ = true;
+  for (AcceptRequest& request : accept_requests_) {
+    // Accepts being cancelled are queued again when they complete.
+    if (!request.in_flight_) {
+      submitAccept(request);
+    }
+  }
+}
+
+void IoUringAcceptor::disable() {
+  enabled_ = false;
+  for (AcceptRequest& request : accept_requests_) {
+    if (request.in_flight_ && !request.cancel_in_flight_) {
+      request.cancel_in_flight_ = true;
+      parent_.prepare([&request](IoUring& io_uring) {
+        return io_uring.prepareCancel(&request, &request.cancel_request_);
+      });
+    }
+  }
+}
+
+void IoUringAcceptor::close() {
+  ASSERT(!closed_);
+  closed_ = true;
+  disable();
+  maybeFinishClose();
+}
+
+void IoUringAcceptor::onRequestCompleted(IoUringRequest& request, int32_t result) {
+  for (AcceptRequest& accept_request : accept_requests_) {
+    if (&request == &accept_request) {
+      onAcceptCompleted(accept_request, result);
+      return;
+    }
+    if (&request == &accept_request.cancel_request_) {
+      accept_request.cancel_in_flight_ = false;
+      maybeFinishClose();
+      return;
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void IoUringAcceptor::submitAccept(AcceptRequest& request) {
+  request.remote_addr_len_ = sizeof(request.remote_addr_);
+  request.in_flight_ = true;
+  parent_.prepare([this, &request](IoUring& io_uring) {
+    return io_uring.prepareAccept(fd_, reinterpret_cast<sockaddr*>(&request.remote_addr_),
+                                  &request.remote_addr_len_, &request);
+  });
+}
+
+void IoUringAcceptor::onAcceptCompleted(AcceptRequest& request, int32_t result) {
+  if (result >= 0) {
+    if (closed_) {
+      ::close(result);
+    } else {
+      accept_cb_(result, reinterpret_cast<const sockaddr*>(&request.remote_addr_),
+                 request.remote_addr_len_);
+    }
+  } else if (result != -ECANCELED && result != -EAGAIN && result != -EINTR &&
+             result != -ECONNABORTED) {
+    // The errors accept(2) can't be retried after. As with the libevent listener, this can happen
+    // if we run out of FDs or memory, and we just crash.
+    PANIC(fmt::format("listener accept failure: {}", strerror(-result)));
+  }
+
+  // Only idle now, so that the callback closing the acceptor doesn't delete it.
+  request.in_flight_ = false;
+  if (closed_) {
+    maybeFinishClose();
+  } else if (enabled_) {
+    submitAccept(request);
+  }
+}
+
+void IoUringAcceptor::maybeFinishClose() {
+  if (!closed_) {
+    return;
+  }
+  for (const AcceptRequest& request : accept_requests_) {
+    if (request.in_flight_ || request.cancel_in_flight_) {
+      return;
+    }
+  }
+  parent_.removeAcceptor(*this);
+}
+
+IoUringWorker::IoUringWorker(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher)
+    : io_uring_(std::move(io_uring)) {
+  eventfd_event_ = dispatcher.createFileEvent(
+      io_uring_->registerEventfd(), [this](uint32_t) { onEventfdReady(); },
+      Event::FileTriggerType::Edge, Event::FileReadyType::Read);
+}
+
+IoUringWorker::~IoUringWorker() {
+  // Tear down the ring first, so that the kernel is done with the buffers of the requests which
+  // are still queued before the sockets owning them are deleted.
+  pending_requests_.clear();
+  reaped_completions_.clear();
+  eventfd_event_.reset();
+  io_uring_.reset();
+  sockets_.clear();
+  acceptors_.clear();
+}
+
+IoUringWorkerPtr IoUringWorker::create(Event::Dispatcher& dispatcher) {
+  const uint32_t size = io_uring_size;
+  if (size == 0 || !IoUringImpl::isAvailable()) {
+    return nullptr;
+  }
+  return std::make_unique<IoUringWorker>(std::make_unique<IoUringImpl>(size), dispatcher);
+}
+
+IoUringSocket& IoUringWorker::addSocket(Network::IoHandlePtr&& io_handle) {
+  const int fd = io_handle->fd();
+  auto socket = std::make_unique<IoUringSocket>(*this, std::move(io_handle));
+  IoUringSocket& socket_ref = *socket;
+  const bool inserted = sockets_.emplace(fd, std::move(socket)).second;
+  RELEASE_ASSERT(inserted, fmt::format("fd {} is already managed by io_uring", fd));
+  return socket_ref;
+}
+
+IoUringAcceptor& IoUringWorker::addAcceptor(int fd, IoUringAcceptor::AcceptCb accept_cb) {
+  auto acceptor = std::make_unique<IoUringAcceptor>(*this, fd, std::move(accept_cb));
+  IoUringAcceptor& acceptor_ref = *acceptor;
+  acceptors_.emplace(&acceptor_ref, std::move(acceptor));
+  return acceptor_ref;
+}
+
+Event::FileEventPtr IoUringWorker::wrapFileEvent(int fd, Event::FileEventPtr&& file_event,
+                                                 Event::FileTriggerType trigger,
+                                                 uint32_t events) {
+  const auto it = sockets_.find(fd);
+  if (it == sockets_.end() || it->second->closed_) {
+    return std::move(file_event);
+  }
+  return std::make_unique<IoUringFileEvent>(*it->second, std::move(file_event), trigger, events);
+}
+
+void IoUringWorker::submit() {
+  // Requests parked while the submission queue was full go first, in the order they were made.
+  while (!pending_requests_.empty() && tryPrepare(pending_requests_.front())) {
+    pending_requests_.pop_front();
+  }
+  if (io_uring_->submit() == IoUringResult::Failed) {
+    ENVOY_LOG(error, "io_uring submission failed: {}", strerror(errno));
+  }
+}
+
+template <class Prepare> void IoUringWorker::prepare(Prepare prepare_fn) {
+  // Once a request is parked, later ones are parked behind it, so that cancellations are never
+  // queued before the requests they cancel.
+  if (pending_requests_.empty() && tryPrepare(prepare_fn)) {
+    return;
+  }
+  ENVOY_LOG(debug, "io_uring submission queue is full, {} requests parked",
+            pending_requests_.size() + 1);
+  pending_requests_.emplace_back(std::move(prepare_fn));
+}
+
+template <class Prepare> bool IoUringWorker::tryPrepare(const Prepare& prepare_fn) {
+  IoUringResult result = prepare_fn(*io_uring_);
+  if (result == IoUringResult::Busy) {
+    // The submission queue is full; hand it to the kernel now to make room. The kernel refuses
+    // new submissions while completions wait for room in the completion queue, so reap them first
+    // in that case.
+    if (io_uring_->submit() == IoUringResult::Busy) {
+      reapCompletions();
+      io_uring_->submit();
+    }
+    result = prepare_fn(*io_uring_);
+  }
+  return result == IoUringResult::Ok;
+}
+
+void IoUringWorker::reapCompletions() {
+  const size_t num_reaped = reaped_completions_.size();
+  io_uring_->forEveryCompletion([this](void* user_data, int32_t result) {
+    reaped_completions_.emplace_back(static_cast<IoUringRequest*>(user_data), result);
+  });
+  if (reaped_completions_.size() != num_reaped) {
+    // The handler queuing the request may be in the middle of an operation, so the completions
+    // are only delivered from the event loop.
+    eventfd_event_->activate(Event::FileReadyType::Read);
+  }
+}
+
+void IoUringWorker::onEventfdReady() {
+  // Completions reaped while queuing requests are older than those still in the ring.
+  std::vector<std::pair<IoUringRequest*, int32_t>> reaped_completions;
+  reaped_completions.swap(reaped_completions_);
+  for (const auto& completion : reaped_completions) {
+    completion.first->handler_->onRequestCompleted(*completion.first, completion.second);
+  }
+  io_uring_->forEveryCompletion([](void* user_data, int32_t result) {
+    auto* request = static_cast<IoUringRequest*>(user_data);
+    request->handler_->onRequestCompleted(*request, result);
+  });
+}
+
+void IoUringWorker::removeSocket(IoUringSocket& socket) { sockets_.erase(socket.fd()); }
+
+void IoUringWorker::removeAcceptor(IoUringAcceptor& acceptor) { acceptors_.erase(&acceptor); }
+
+#else // ENVOY_IO_URING_SUPPORTED
+
+// create() never returns a worker without io_uring support, so none of its sockets and acceptors
+// exist either.
+
+IoUringWorkerPtr IoUringWorker::create(Event::Dispatcher&) { return nullptr; }
+
+IoUringWorker::~IoUringWorker() = default;
+
+IoUringSocket& IoUringWorker::addSocket(Network::IoHandlePtr&&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+IoUringAcceptor& IoUringWorker::addAcceptor(int, IoUringAcceptor::AcceptCb) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+Event::FileEventPtr IoUringWorker::wrapFileEvent(int, Event::FileEventPtr&&, Event::FileTriggerType,
+                                                 uint32_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void IoUringWorker::submit() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+Api::SysCallSizeResult IoUringSocket::read(Buffer::Instance&, uint64_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+Api::SysCallSizeResult IoUringSocket::readv(uint64_t, Buffer::RawSlice*, uint64_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+Api::SysCallSizeResult IoUringSocket::write(Buffer::Instance&) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+Api::SysCallSizeResult IoUringSocket::writev(const Buffer::RawSlice*, uint64_t) {
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+Api::SysCallIntResult IoUringSocket::shutdown(int) { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void IoUringSocket::discardPendingWrites() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void IoUringSocket::close() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void IoUringAcceptor::enable() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void IoUringAcceptor::disable() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+void IoUringAcceptor::close() { NOT_REACHED_GCOVR_EXCL_LINE; }
+
+#endif // ENVOY_IO_URING_SUPPORTED
+
+} // namespace Io
+} // namespace Envoy
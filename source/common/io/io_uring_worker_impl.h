@@ -0,0 +1,394 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "envoy/api/os_sys_calls_common.h"
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/io_uring.h"
+#include "envoy/common/pure.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/event/file_event.h"
+#include "envoy/network/io_handle.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Io {
+
+class IoUringFileEvent;
+class IoUringRequestHandler;
+class IoUringWorker;
+
+/**
+ * User data of a queued request. The worker passes the completion of the request to its handler.
+ */
+struct IoUringRequest {
+  IoUringRequestHandler* handler_;
+};
+
+/**
+ * Owner of io_uring requests.
+ */
+class IoUringRequestHandler {
+public:
+  virtual ~IoUringRequestHandler() = default;
+
+  /**
+   * Called when one of the requests of the handler has completed.
+   * @param request supplies the request.
+   * @param result supplies the result of the operation, see Io::CompletionCb.
+   */
+  virtual void onRequestCompleted(IoUringRequest& request, int32_t result) PURE;
+};
+
+/**
+ * A stream socket whose reads and writes are performed by the io_uring of an IoUringWorker.
+ *
+ * The socket keeps one read of up to ReadBufferSize bytes queued whenever the previous data has
+ * been consumed. read() moves the completed data into the caller's buffer, and write() moves up
+ * to MaxWriteBufferSize bytes out of the caller's buffer, which the ring then writes out; neither
+ * copies full buffer slices. Both only start once the socket is first read from or written to
+ * through this class, so transport sockets which use the file descriptor directly, and connects
+ * in progress, keep working unchanged.
+ *
+ * From then on the readiness of an edge triggered file event of the socket is derived from the
+ * completions rather than polled by libevent, see IoUringFileEvent.
+ *
+ * The socket outlives close() until all of its requests have completed and buffered writes have
+ * been flushed. Only then is the underlying handle closed.
+ */
+class IoUringSocket : public IoUringRequestHandler,
+                      NonCopyable,
+                      protected Logger::Loggable<Logger::Id::io> {
+public:
+  static constexpr uint64_t ReadBufferSize = 16384;
+  static constexpr uint64_t MaxWriteBufferSize = 65536;
+  static constexpr uint64_t MaxWriteIovecs = 16;
+
+  IoUringSocket(IoUringWorker& parent, Network::IoHandlePtr&& io_handle);
+
+  int fd() const { return fd_; }
+
+  /**
+   * Move completed reads into the buffer, as Buffer::Instance::read() would.
+   * @return the number of bytes moved, 0 at the end of the stream, or -1 and errno. errno is
+   *         EAGAIN if there is no data yet; the file event becomes ready for reading when there is.
+   */
+  Api::SysCallSizeResult read(Buffer::Instance& buffer, uint64_t max_length);
+
+  /**
+   * Copy completed reads into the slices, as readv(2) would.
+   * @return @see read().
+   */
+  Api::SysCallSizeResult readv(uint64_t max_length, Buffer::RawSlice* slices, uint64_t num_slice);
+
+  /**
+   * Move data out of the buffer for writing, as Buffer::Instance::write() would.
+   * @return the number of bytes accepted, or -1 and errno. errno is EAGAIN if the write buffer is
+   *         full; the file event becomes ready for writing when it has drained.
+   */
+  Api::SysCallSizeResult write(Buffer::Instance& buffer);
+
+  /**
+   * Copy the slices for writing, as writev(2) would.
+   * @return @see write().
+   */
+  Api::SysCallSizeResult writev(const Buffer::RawSlice* slices, uint64_t num_slice);
+
+  /**
+   * Shut down the socket, as shutdown(2) would. Shutting down writes is deferred until the data
+   * buffered by write() has been written out, so that the end of the stream follows it.
+   * @return 0, or -1 and errno.
+   */
+  Api::SysCallIntResult shutdown(int how);
+
+  /**
+   * Drop the data buffered by write() which has not been written out yet, cancelling the queued
+   * write, as ConnectionCloseType::NoFlush requires. A pending shutdown of writes is not
+   * performed. The socket is expected to be closed right after.
+   */
+  void discardPendingWrites();
+
+  /**
+   * Cancel the queued read and close the handle once all requests have completed and the buffered
+   * writes have been written out, as with ConnectionCloseType::FlushWrite, unless
+   * discardPendingWrites() was called. The socket deletes itself then and must not be used after
+   * this call.
+   */
+  void close();
+
+  /**
+   * @return IoUringFileEvent* the file event of the socket, or nullptr.
+   */
+  IoUringFileEvent* fileEvent() const { return file_event_; }
+
+  // Io::IoUringRequestHandler
+  void onRequestCompleted(IoUringRequest& request, int32_t result) override;
+
+private:
+  friend class IoUringFileEvent;
+  friend class IoUringWorker;
+
+  // Called by the file event.
+  void setFileEvent(IoUringFileEvent* file_event);
+  void onFileEventEnabled(uint32_t events);
+
+  // Switches the file event over to the ring on the first read or write.
+  void startRing();
+  void submitRead();
+  void submitWrite();
+  void submitPoll();
+  void submitCancel(IoUringRequest& request, IoUringRequest& cancel_request);
+  void onReadCompleted(int32_t result);
+  void onWriteCompleted(int32_t result);
+  void onPollCompleted(int32_t result);
+  void onReadReady();
+  void onWriteReady();
+  // The result of reading with no data buffered.
+  Api::SysCallSizeResult noDataResult();
+  // Closes the handle and deletes the socket if it is closed and idle.
+  void maybeFinishClose();
+
+  IoUringWorker& parent_;
+  Network::IoHandlePtr io_handle_;
+  const int fd_;
+  IoUringFileEvent* file_event_{};
+  bool ring_started_{};
+
+  IoUringRequest read_request_{this};
+  IoUringRequest write_request_{this};
+  IoUringRequest poll_request_{this};
+  IoUringRequest cancel_read_request_{this};
+  IoUringRequest cancel_write_request_{this};
+  IoUringRequest cancel_poll_request_{this};
+
+  // Completed reads, and the reservation the queued read fills.
+  Buffer::OwnedImpl read_buffer_;
+  Buffer::RawSlice read_reservation_;
+  struct iovec read_iovec_;
+  int read_error_{};
+  bool read_eof_{};
+  bool read_in_flight_{};
+
+  Buffer::OwnedImpl write_buffer_;
+  struct iovec write_iovecs_[MaxWriteIovecs];
+  int write_error_{};
+  bool write_in_flight_{};
+  // Whether write() returned EAGAIN since the write buffer last drained.
+  bool write_blocked_{};
+  // The shutdown(2) to perform once the write buffer has drained.
+  absl::optional<int> pending_shutdown_;
+  // Whether discardPendingWrites() was called.
+  bool discard_writes_{};
+
+  // Whether a poll for the peer closing the connection is queued.
+  bool poll_in_flight_{};
+  uint32_t cancels_in_flight_{};
+  bool closed_{};
+};
+
+/**
+ * FileEvent of an IoUringSocket.
+ *
+ * Until the socket starts using the ring, and for level triggered events, this forwards to the
+ * libevent based event. Afterwards an edge triggered event no longer has its file descriptor
+ * polled: the socket activates the libevent event, which costs no system call, when a completion
+ * makes it ready for one of the enabled events, and setEnabled() activates it right away for the
+ * events it is already ready for, as re-arming an edge triggered epoll registration would.
+ */
+class IoUringFileEvent : public Event::FileEvent {
+public:
+  IoUringFileEvent(IoUringSocket& socket, Event::FileEventPtr&& file_event,
+                   Event::FileTriggerType trigger, uint32_t events);
+  ~IoUringFileEvent() override;
+
+  // Event::FileEvent
+  void activate(uint32_t events) override { file_event_->activate(events); }
+  void setEnabled(uint32_t events) override;
+
+private:
+  friend class IoUringSocket;
+
+  // Called by the socket when it starts using the ring.
+  void stopPolling();
+
+  // Null once the socket is closed.
+  IoUringSocket* socket_;
+  Event::FileEventPtr file_event_;
+  const bool edge_triggered_;
+  uint32_t enabled_events_;
+  bool polling_{true};
+};
+
+/**
+ * A listening socket whose connections are accepted by the io_uring of an IoUringWorker, with
+ * MaxAcceptsInFlight accepts queued at a time instead of polling the socket and calling accept(2)
+ * until it would block.
+ */
+class IoUringAcceptor : public IoUringRequestHandler,
+                        NonCopyable,
+                        protected Logger::Loggable<Logger::Id::io> {
+public:
+  static constexpr uint32_t MaxAcceptsInFlight = 8;
+
+  /**
+   * Called with every accepted, non-blocking socket and the address of its peer. Ownership of the
+   * file descriptor is transferred to the callback.
+   */
+  using AcceptCb =
+      std::function<void(int fd, const sockaddr* remote_addr, socklen_t remote_addr_len)>;
+
+  IoUringAcceptor(IoUringWorker& parent, int fd, AcceptCb accept_cb);
+
+  /**
+   * Start accepting connections.
+   */
+  void enable();
+
+  /**
+   * Stop accepting connections. Sockets accepted before the queued accepts are cancelled are still
+   * passed to the callback.
+   */
+  void disable();
+
+  /**
+   * Stop accepting connections for good. The acceptor deletes itself once all of its requests have
+   * completed, closing the sockets they accepted, and must not be used after this call. The
+   * listening socket must stay open until then.
+   */
+  void close();
+
+  // Io::IoUringRequestHandler
+  void onRequestCompleted(IoUringRequest& request, int32_t result) override;
+
+private:
+  struct AcceptRequest : public IoUringRequest {
+    sockaddr_storage remote_addr_;
+    socklen_t remote_addr_len_;
+    IoUringRequest cancel_request_;
+    bool in_flight_{};
+    bool cancel_in_flight_{};
+  };
+
+  void submitAccept(AcceptRequest& request);
+  void onAcceptCompleted(AcceptRequest& request, int32_t result);
+  // Deletes the acceptor if it is closed and idle.
+  void maybeFinishClose();
+
+  IoUringWorker& parent_;
+  const int fd_;
+  AcceptCb accept_cb_;
+  AcceptRequest accept_requests_[MaxAcceptsInFlight];
+  bool enabled_{};
+  bool closed_{};
+};
+
+/**
+ * Per dispatcher owner of an io_uring and of the sockets using it. Requests queued during an event
+ * loop iteration are submitted together by submit(), right before the event loop polls, and
+ * completions are reaped when the eventfd of the ring is signalled.
+ */
+class IoUringWorker : NonCopyable, protected Logger::Loggable<Logger::Id::io> {
+public:
+  IoUringWorker(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher);
+  ~IoUringWorker();
+
+  /**
+   * Set the submission queue size of the rings of workers created afterwards.
+   * @param io_uring_size supplies the size, or 0 to not use io_uring.
+   */
+  static void setIoUringSize(uint32_t io_uring_size);
+
+  /**
+   * @return std::unique_ptr<IoUringWorker> a worker for the dispatcher, or nullptr if io_uring is
+   *         disabled or not supported by the kernel.
+   */
+  static std::unique_ptr<IoUringWorker> create(Event::Dispatcher& dispatcher);
+
+  /**
+   * Start managing a stream socket.
+   * @param io_handle supplies the handle of the socket, which is transferred to the worker.
+   * @return IoUringSocket& the socket, valid until it is closed.
+   */
+  IoUringSocket& addSocket(Network::IoHandlePtr&& io_handle);
+
+  /**
+   * Start accepting connections on a listening socket.
+   * @param fd supplies the listening socket, which stays owned by the caller.
+   * @param accept_cb supplies the callback invoked with every accepted connection.
+   * @return IoUringAcceptor& the acceptor, valid until it is closed.
+   */
+  IoUringAcceptor& addAcceptor(int fd, IoUringAcceptor::AcceptCb accept_cb);
+
+  /**
+   * Make the file event of one of the worker's sockets driven by its completions.
+   * @param fd supplies the file descriptor the event was created for.
+   * @param file_event supplies the event.
+   * @param trigger supplies the trigger type the event was created with.
+   * @param events supplies the events the event was created with.
+   * @return Event::FileEventPtr the event to use in its place.
+   */
+  Event::FileEventPtr wrapFileEvent(int fd, Event::FileEventPtr&& file_event,
+                                    Event::FileTriggerType trigger, uint32_t events);
+
+  /**
+   * Hand the requests queued since the last call to the kernel. Called by the dispatcher before
+   * every poll of the event loop.
+   */
+  void submit();
+
+  /**
+   * @return uint64_t the number of sockets which have not been finally closed yet.
+   */
+  uint64_t numSockets() const { return sockets_.size(); }
+
+  /**
+   * @return uint64_t the number of acceptors which have not been finally closed yet.
+   */
+  uint64_t numAcceptors() const { return acceptors_.size(); }
+
+private:
+  friend class IoUringAcceptor;
+  friend class IoUringSocket;
+
+  using PrepareFn = std::function<IoUringResult(IoUring&)>;
+
+  // Queue a request, submitting the queue first if it is full. If there is still no room, the
+  // request is parked until the next submit().
+  template <class Prepare> void prepare(Prepare prepare_fn);
+  // @return whether the request was queued, after making room if the queue was full.
+  template <class Prepare> bool tryPrepare(const Prepare& prepare_fn);
+  // Consume the completions in the ring without delivering them yet, which lets the kernel post
+  // the completions it is holding back and accept submissions again.
+  void reapCompletions();
+  void onEventfdReady();
+  void removeSocket(IoUringSocket& socket);
+  void removeAcceptor(IoUringAcceptor& acceptor);
+
+  IoUringPtr io_uring_;
+  Event::FileEventPtr eventfd_event_;
+  absl::flat_hash_map<int, std::unique_ptr<IoUringSocket>> sockets_;
+  absl::flat_hash_map<IoUringAcceptor*, std::unique_ptr<IoUringAcceptor>> acceptors_;
+  // Requests which did not fit into the submission queue, in the order they were made.
+  std::list<PrepareFn> pending_requests_;
+  // Completions consumed by reapCompletions() and not delivered yet.
+  std::vector<std::pair<IoUringRequest*, int32_t>> reaped_completions_;
+};
+
+using IoUringWorkerPtr = std::unique_ptr<IoUringWorker>;
+
+} // namespace Io
+} // namespace Envoy
@@ -125,6 +125,10 @@ void ConnectionImpl::close(ConnectionCloseType type) {
         file_event_->setEnabled(enable_half_close_ ? 0 : Event::FileReadyType::Closed);
       }
     } else {
+      if (type == ConnectionCloseType::NoFlush) {
+        // Nor is the data the IoHandle buffers itself written out after the socket is closed.
+        ioHandle().discardPendingWrites();
+      }
       closeSocket(ConnectionEvent::LocalClose);
     }
   } else {
@@ -192,6 +196,7 @@ void ConnectionImpl::closeSocket(ConnectionEvent close_type) {
 
   ENVOY_CONN_LOG(debug, "closing socket: {}", *this, static_cast<uint32_t>(close_type));
   transport_socket_->closeSocket(close_type);
+  bypass_callbacks_ = nullptr;
 
   // Drain input and output buffers.
   updateReadBufferStats(0, 0);
@@ -289,6 +294,10 @@ void ConnectionImpl::readDisable(bool disable) {
     // If readDisable is called on a closed connection in error, do not crash.
     return;
   }
+  if (bypass_callbacks_ != nullptr) {
+    // The owner of the bypass reads from the socket at its own pace.
+    return;
+  }
 
   ENVOY_CONN_LOG(trace, "readDisable: enabled={} disable={}", *this, read_enabled_, disable);
 
@@ -369,6 +378,7 @@ void ConnectionImpl::write(Buffer::Instance& data, bool end_stream) {
 
 void ConnectionImpl::write(Buffer::Instance& data, bool end_stream, bool through_filter_chain) {
   ASSERT(!end_stream || enable_half_close_);
+  ASSERT(bypass_callbacks_ == nullptr);
 
   if (write_end_stream_) {
     // It is an API violation to write more data after writing end_stream, but a duplicate
@@ -476,6 +486,11 @@ void ConnectionImpl::onFileEvent(uint32_t events) {
     return;
   }
 
+  if (bypass_callbacks_ != nullptr) {
+    bypass_callbacks_->onSocketEvent(events);
+    return;
+  }
+
   if (events & Event::FileReadyType::Closed) {
     // We never ask for both early close and read at the same time. If we are reading, we want to
     // consume all available data.
@@ -665,16 +680,41 @@ absl::string_view ConnectionImpl::transportFailureReason() const {
   return transport_socket_->failureReason();
 }
 
+bool ConnectionImpl::canBypassTransportSocket() const {
+  return state() == State::Open && !connecting_ && file_event_ != nullptr &&
+         bypass_callbacks_ == nullptr && transport_socket_->passThrough() &&
+         ioHandle().supportsSplice() && filter_manager_.hasSingleReadFilter() &&
+         read_buffer_.length() == 0 && write_buffer_->length() == 0 && !read_end_stream_ &&
+         !write_end_stream_;
+}
+
+IoHandle& ConnectionImpl::bypassTransportSocket(BypassCallbacks& callbacks) {
+  ASSERT(canBypassTransportSocket());
+  ENVOY_CONN_LOG(debug, "bypassing transport socket", *this);
+  bypass_callbacks_ = &callbacks;
+  // Reads may have been disabled. Registering the events again also reports the current readiness
+  // of the socket, so data which is already waiting in the socket is not missed.
+  file_event_->setEnabled(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  return ioHandle();
+}
+
 ClientConnectionImpl::ClientConnectionImpl(
     Event::Dispatcher& dispatcher, const Address::InstanceConstSharedPtr& remote_address,
     const Network::Address::InstanceConstSharedPtr& source_address,
     Network::TransportSocketPtr&& transport_socket,
     const Network::ConnectionSocket::OptionsSharedPtr& options)
-    : ConnectionImpl(dispatcher, std::make_unique<ClientSocketImpl>(remote_address),
-                     std::move(transport_socket), false) {
+    : ClientConnectionImpl(dispatcher, std::make_unique<ClientSocketImpl>(remote_address),
+                           source_address, std::move(transport_socket), options) {}
+
+ClientConnectionImpl::ClientConnectionImpl(
+    Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
+    const Network::Address::InstanceConstSharedPtr& source_address,
+    Network::TransportSocketPtr&& transport_socket,
+    const Network::ConnectionSocket::OptionsSharedPtr& options)
+    : ConnectionImpl(dispatcher, std::move(socket), std::move(transport_socket), false) {
   // There are no meaningful socket options or source address semantics for
   // non-IP sockets, so skip.
-  if (remote_address->ip() != nullptr) {
+  if (socket_->remoteAddress()->ip() != nullptr) {
     if (!Network::Socket::applyOptions(options, *socket_,
                                        envoy::api::v2::core::SocketOption::STATE_PREBIND)) {
       // Set a special error state to ensure asynchronous close to give the owner of the
@@ -95,6 +95,8 @@ public:
   StreamInfo::StreamInfo& streamInfo() override { return stream_info_; }
   const StreamInfo::StreamInfo& streamInfo() const override { return stream_info_; }
   absl::string_view transportFailureReason() const override;
+  bool canBypassTransportSocket() const override;
+  IoHandle& bypassTransportSocket(BypassCallbacks& callbacks) override;
 
   // Network::FilterManagerConnection
   void rawWrite(Buffer::Instance& data, bool end_stream) override;
@@ -209,6 +211,8 @@ private:
   uint64_t last_write_buffer_size_{};
   std::unique_ptr<ConnectionStats> connection_stats_;
   Buffer::Instance* current_write_buffer_{};
+  // Set once bypassTransportSocket() has been called; receives all socket events from then on.
+  BypassCallbacks* bypass_callbacks_{};
   uint32_t read_disable_count_{0};
   bool read_enabled_ : 1;
   bool above_high_watermark_ : 1;
@@ -231,6 +235,11 @@ public:
                        const Address::InstanceConstSharedPtr& source_address,
                        Network::TransportSocketPtr&& transport_socket,
                        const Network::ConnectionSocket::OptionsSharedPtr& options);
+  // Connects a socket already created for its remote address.
+  ClientConnectionImpl(Event::Dispatcher& dispatcher, ConnectionSocketPtr&& socket,
+                       const Address::InstanceConstSharedPtr& source_address,
+                       Network::TransportSocketPtr&& transport_socket,
+                       const Network::ConnectionSocket::OptionsSharedPtr& options);
 
   // Network::ClientConnection
   void connect() override;
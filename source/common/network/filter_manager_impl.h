@@ -109,6 +109,13 @@ public:
   void onRead();
   FilterStatus onWrite();
 
+  /**
+   * @return bool whether there is at most a single read filter and no write filter.
+   */
+  bool hasSingleReadFilter() const {
+    return upstream_filters_.size() <= 1 && downstream_filters_.empty();
+  }
+
 private:
   struct ActiveReadFilter : public ReadFilterCallbacks, LinkedObject<ActiveReadFilter> {
     ActiveReadFilter(FilterManagerImpl& parent, ReadFilterSharedPtr filter)
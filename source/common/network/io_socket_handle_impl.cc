@@ -6,6 +6,7 @@
 #include "envoy/buffer/buffer.h"
 
 #include "common/api/os_sys_calls_impl.h"
+#include "common/common/macros.h"
 #include "common/common/stack_array.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
@@ -73,6 +74,14 @@ Api::IoCallUint64Result IoSocketHandleImpl::writev(const Buffer::RawSlice* slice
   return sysCallResultToIoCallResult(result);
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::read(Buffer::Instance& buffer, uint64_t max_length) {
+  return buffer.read(*this, max_length);
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::write(Buffer::Instance& buffer) {
+  return buffer.write(*this);
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendto(const Buffer::RawSlice& slice, int flags,
                                                    const Address::Instance& address) {
   const auto* address_base = dynamic_cast<const Address::InstanceBase*>(&address);
@@ -84,6 +93,45 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendto(const Buffer::RawSlice& slice
   return sysCallResultToIoCallResult(result);
 }
 
+namespace {
+
+// Space for the control message carrying the source address of a sent message.
+size_t sourceAddressControlSpace() {
+  const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
+  // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
+  const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
+  return (space_v4 < space_v6) ? space_v6 : space_v4;
+}
+
+// Fills in the control message carrying the source address of a sent message.
+// @return the space used by the control message.
+size_t setSourceAddress(cmsghdr* cmsg, const Address::Ip* self_ip) {
+  if (self_ip->version() == Address::IpVersion::v4) {
+    cmsg->cmsg_level = IPPROTO_IP;
+#ifndef IP_SENDSRCADDR
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
+    cmsg->cmsg_type = IP_PKTINFO;
+    auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi_ifindex = 0;
+    pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
+#else
+    cmsg->cmsg_type = IP_SENDSRCADDR;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
+    *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip->ipv4()->address();
+#endif
+  } else if (self_ip->version() == Address::IpVersion::v6) {
+    cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
+    pktinfo->ipi6_ifindex = 0;
+    *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
+  }
+  return CMSG_SPACE(cmsg->cmsg_len - CMSG_LEN(0));
+}
+
+} // namespace
+
 Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slices,
                                                     uint64_t num_slice, int flags,
                                                     const Address::Ip* self_ip,
@@ -117,10 +165,7 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   } else {
-    const size_t space_v6 = CMSG_SPACE(sizeof(in6_pktinfo));
-    // FreeBSD only needs in_addr size, but allocates more to unify code in two platforms.
-    const size_t space_v4 = CMSG_SPACE(sizeof(in_pktinfo));
-    const size_t cmsg_space = (space_v4 < space_v6) ? space_v6 : space_v4;
+    const size_t cmsg_space = sourceAddressControlSpace();
     // kSpaceForIp should be big enough to hold both IPv4 and IPv6 packet info.
     STACK_ARRAY(cbuf, char, cmsg_space);
     memset(cbuf.begin(), 0, cmsg_space);
@@ -130,32 +175,90 @@ Api::IoCallUint64Result IoSocketHandleImpl::sendmsg(const Buffer::RawSlice* slic
     cmsghdr* const cmsg = CMSG_FIRSTHDR(&message);
     RELEASE_ASSERT(cmsg != nullptr, fmt::format("cbuf with size {} is not enough, cmsghdr size {}",
                                                 sizeof(cbuf), sizeof(cmsghdr)));
-    if (self_ip->version() == Address::IpVersion::v4) {
-      cmsg->cmsg_level = IPPROTO_IP;
-#ifndef IP_SENDSRCADDR
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_pktinfo));
-      cmsg->cmsg_type = IP_PKTINFO;
-      auto pktinfo = reinterpret_cast<in_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi_ifindex = 0;
-      pktinfo->ipi_spec_dst.s_addr = self_ip->ipv4()->address();
-#else
-      cmsg->cmsg_type = IP_SENDSRCADDR;
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in_addr));
-      *(reinterpret_cast<struct in_addr*>(CMSG_DATA(cmsg))).s_addr = self_ip->ipv4()->address();
-#endif
-    } else if (self_ip->version() == Address::IpVersion::v6) {
-      cmsg->cmsg_len = CMSG_LEN(sizeof(in6_pktinfo));
-      cmsg->cmsg_level = IPPROTO_IPV6;
-      cmsg->cmsg_type = IPV6_PKTINFO;
-      auto pktinfo = reinterpret_cast<in6_pktinfo*>(CMSG_DATA(cmsg));
-      pktinfo->ipi6_ifindex = 0;
-      *(reinterpret_cast<absl::uint128*>(pktinfo->ipi6_addr.s6_addr)) = self_ip->ipv6()->address();
-    }
+    setSourceAddress(cmsg, self_ip);
     const Api::SysCallSizeResult result = os_syscalls.sendmsg(fd_, &message, flags);
     return sysCallResultToIoCallResult(result);
   }
 }
 
+Api::IoCallUint64Result IoSocketHandleImpl::sendmmsg(const SendMsgInput* messages,
+                                                     uint64_t num_messages) {
+#ifdef __linux__
+  uint64_t num_iovecs = 0;
+  for (uint64_t i = 0; i < num_messages; i++) {
+    num_iovecs += messages[i].num_slice_;
+  }
+  // The batch sizes are limited by the max_batch_size of the listener configurations, which keeps
+  // these arrays small.
+  STACK_ARRAY(iov, iovec, num_iovecs);
+  STACK_ARRAY(mmsg, mmsghdr, num_messages);
+  // Room for the source address and the segment size of every message.
+  const size_t cmsg_space = sourceAddressControlSpace() + CMSG_SPACE(sizeof(uint16_t));
+  STACK_ARRAY(cbuf, char, cmsg_space * num_messages);
+  memset(cbuf.begin(), 0, cmsg_space * num_messages);
+
+  iovec* next_iov = iov.begin();
+  for (uint64_t i = 0; i < num_messages; i++) {
+    const SendMsgInput& input = messages[i];
+    const auto* address_base = dynamic_cast<const Address::InstanceBase*>(input.peer_address_);
+    msghdr& message = mmsg[i].msg_hdr;
+    memset(&mmsg[i], 0, sizeof(mmsghdr));
+    message.msg_name = const_cast<sockaddr*>(address_base->sockAddr());
+    message.msg_namelen = address_base->sockAddrLen();
+    message.msg_iov = next_iov;
+    for (uint64_t j = 0; j < input.num_slice_; j++) {
+      if (input.slices_[j].mem_ != nullptr && input.slices_[j].len_ != 0) {
+        next_iov->iov_base = input.slices_[j].mem_;
+        next_iov->iov_len = input.slices_[j].len_;
+        next_iov++;
+        message.msg_iovlen++;
+      }
+    }
+
+    if (input.self_ip_ == nullptr && input.gso_size_ == 0) {
+      continue;
+    }
+    char* control = cbuf.begin() + i * cmsg_space;
+    message.msg_control = control;
+    size_t control_length = 0;
+    if (input.self_ip_ != nullptr) {
+      control_length += setSourceAddress(reinterpret_cast<cmsghdr*>(control), input.self_ip_);
+    }
+    if (input.gso_size_ != 0) {
+      auto* cmsg = reinterpret_cast<cmsghdr*>(control + control_length);
+      cmsg->cmsg_level = SOL_UDP;
+      cmsg->cmsg_type = UDP_SEGMENT;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+      *reinterpret_cast<uint16_t*>(CMSG_DATA(cmsg)) = input.gso_size_;
+      control_length += CMSG_SPACE(sizeof(uint16_t));
+    }
+    message.msg_controllen = control_length;
+  }
+
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult result =
+      os_syscalls.sendmmsg(fd_, mmsg.begin(), static_cast<unsigned int>(num_messages), 0);
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{result.rc_, result.errno_});
+#else
+  UNREFERENCED_PARAMETER(messages);
+  UNREFERENCED_PARAMETER(num_messages);
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, ENOSYS});
+#endif
+}
+
+bool IoSocketHandleImpl::supportsMmsg() const {
+  return Api::OsSysCallsSingleton::get().supportsMmsg();
+}
+
+bool IoSocketHandleImpl::supportsSplice() const {
+  return Api::OsSysCallsSingleton::get().supportsSplice();
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::shutdown(int how) {
+  const int rc = ::shutdown(fd_, how);
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{rc, rc != -1 ? 0 : errno});
+}
+
 Api::IoCallUint64Result
 IoSocketHandleImpl::sysCallResultToIoCallResult(const Api::SysCallSizeResult& result) {
   if (result.rc_ >= 0) {
@@ -220,15 +323,30 @@ absl::optional<uint32_t> maybeGetPacketsDroppedFromHeader(
   return absl::nullopt;
 }
 
+absl::optional<uint64_t> maybeGetGsoSizeFromHeader(const struct cmsghdr& cmsg) {
+#ifdef UDP_GRO
+  if (cmsg.cmsg_level == SOL_UDP && cmsg.cmsg_type == UDP_GRO) {
+    return *reinterpret_cast<const int*>(CMSG_DATA(&cmsg));
+  }
+#else
+  UNREFERENCED_PARAMETER(cmsg);
+#endif
+  return absl::nullopt;
+}
+
+// The minimum cmsg buffer size to filled in destination address, packets dropped and the size of
+// coalesced datagrams when receiving a packet. It is possible for a received packet to contain
+// both IPv4 and IPv6 addresses.
+size_t recvMsgControlSpace() {
+  return CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
+         CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int));
+}
+
 Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
                                                     const uint64_t num_slice, uint32_t self_port,
                                                     RecvMsgOutput& output) {
 
-  // The minimum cmsg buffer size to filled in destination address and packets dropped when
-  // receiving a packet. It is possible for a received packet to contain both IPv4 and IPv6
-  // addresses.
-  const size_t cmsg_space = CMSG_SPACE(sizeof(int)) + CMSG_SPACE(sizeof(struct in_pktinfo)) +
-                            CMSG_SPACE(sizeof(struct in6_pktinfo));
+  const size_t cmsg_space = recvMsgControlSpace();
   STACK_ARRAY(cbuf, char, cmsg_space);
   memset(cbuf.begin(), 0, cmsg_space);
 
@@ -260,6 +378,57 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
     return sysCallResultToIoCallResult(result);
   }
 
+  parseRecvMsgHeader(hdr, self_port, output);
+  return sysCallResultToIoCallResult(result);
+}
+
+Api::IoCallUint64Result IoSocketHandleImpl::recvmmsg(Buffer::RawSlice* slices,
+                                                     uint64_t num_packets, uint32_t self_port,
+                                                     RecvMsgOutput* output) {
+#ifdef __linux__
+  const size_t cmsg_space = recvMsgControlSpace();
+  // As in sendmmsg(), num_packets is at most the max_batch_size of the listener.
+  STACK_ARRAY(cbuf, char, cmsg_space * num_packets);
+  memset(cbuf.begin(), 0, cmsg_space * num_packets);
+  STACK_ARRAY(iov, iovec, num_packets);
+  STACK_ARRAY(peer_addrs, sockaddr_storage, num_packets);
+  STACK_ARRAY(mmsg, mmsghdr, num_packets);
+  for (uint64_t i = 0; i < num_packets; i++) {
+    iov[i].iov_base = slices[i].mem_;
+    iov[i].iov_len = slices[i].len_;
+    memset(&mmsg[i], 0, sizeof(mmsghdr));
+    msghdr& hdr = mmsg[i].msg_hdr;
+    hdr.msg_name = &peer_addrs[i];
+    hdr.msg_namelen = sizeof(sockaddr_storage);
+    hdr.msg_iov = &iov[i];
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = cbuf.begin() + i * cmsg_space;
+    hdr.msg_controllen = cmsg_space;
+  }
+
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  const Api::SysCallIntResult result = os_sys_calls.recvmmsg(
+      fd_, mmsg.begin(), static_cast<unsigned int>(num_packets), 0, nullptr);
+  if (result.rc_ <= 0) {
+    return sysCallResultToIoCallResult(Api::SysCallSizeResult{result.rc_, result.errno_});
+  }
+
+  for (int i = 0; i < result.rc_; i++) {
+    slices[i].len_ = mmsg[i].msg_len;
+    parseRecvMsgHeader(mmsg[i].msg_hdr, self_port, output[i]);
+  }
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{result.rc_, 0});
+#else
+  UNREFERENCED_PARAMETER(slices);
+  UNREFERENCED_PARAMETER(num_packets);
+  UNREFERENCED_PARAMETER(self_port);
+  UNREFERENCED_PARAMETER(output);
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{-1, ENOSYS});
+#endif
+}
+
+void IoSocketHandleImpl::parseRecvMsgHeader(const msghdr& hdr, uint32_t self_port,
+                                            RecvMsgOutput& output) {
   RELEASE_ASSERT((hdr.msg_flags & MSG_CTRUNC) == 0,
                  fmt::format("Incorrectly set control message length: {}", hdr.msg_controllen));
   RELEASE_ASSERT(hdr.msg_namelen > 0,
@@ -269,20 +438,23 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
     // address. Though dual stack may be disabled, it's still okay to assume the
     // address is from a dual stack socket. This is because mapped-v6 address
     // must come from a dual stack socket. An actual v6 address can come from
-    // both dual stack socket and v6 only socket. If |peer_addr| is an actual v6
+    // both dual stack socket and v6 only socket. If the peer address is an actual v6
     // address and the socket is actually v6 only, the returned address will be
     // regarded as a v6 address from dual stack socket. However, this address is not going to be
     // used to create socket. Wrong knowledge of dual stack support won't hurt.
     output.peer_address_ =
-        Address::addressFromSockAddr(peer_addr, hdr.msg_namelen, /*v6only=*/false);
+        Address::addressFromSockAddr(*static_cast<const sockaddr_storage*>(hdr.msg_name),
+                                     hdr.msg_namelen, /*v6only=*/false);
   } catch (const EnvoyException& e) {
     PANIC(fmt::format("Invalid remote address for fd: {}, error: {}", fd_, e.what()));
   }
 
-  // Get overflow, local and peer addresses from control message.
+  // Get overflow, local and peer addresses and the size of coalesced datagrams from control
+  // message.
   if (hdr.msg_controllen > 0) {
     struct cmsghdr* cmsg;
-    for (cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+    for (cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr;
+         cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg)) {
       if (output.local_address_ == nullptr) {
         try {
           Address::InstanceConstSharedPtr addr = maybeGetDstAddressFromHeader(*cmsg, self_port);
@@ -295,6 +467,11 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
           PANIC(fmt::format("Invalid destination address for fd: {}, error: {}", fd_, e.what()));
         }
       }
+      absl::optional<uint64_t> maybe_gso_size = maybeGetGsoSizeFromHeader(*cmsg);
+      if (maybe_gso_size) {
+        output.gso_size_ = *maybe_gso_size;
+        continue;
+      }
       if (output.dropped_packets_ != nullptr) {
         absl::optional<uint32_t> maybe_dropped = maybeGetPacketsDroppedFromHeader(*cmsg);
         if (maybe_dropped) {
@@ -303,7 +480,6 @@ Api::IoCallUint64Result IoSocketHandleImpl::recvmsg(Buffer::RawSlice* slices,
       }
     }
   }
-  return sysCallResultToIoCallResult(result);
 }
 
 } // namespace Network
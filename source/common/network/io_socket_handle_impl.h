@@ -31,6 +31,10 @@ public:
 
   Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
 
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+
   Api::IoCallUint64Result sendto(const Buffer::RawSlice& slice, int flags,
                                  const Address::Instance& address) override;
 
@@ -41,10 +45,27 @@ public:
   Api::IoCallUint64Result recvmsg(Buffer::RawSlice* slices, const uint64_t num_slice,
                                   uint32_t self_port, RecvMsgOutput& output) override;
 
-private:
+  Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                   uint32_t self_port, RecvMsgOutput* output) override;
+
+  Api::IoCallUint64Result sendmmsg(const SendMsgInput* messages, uint64_t num_messages) override;
+
+  bool supportsMmsg() const override;
+
+  bool supportsSplice() const override;
+
+  Api::IoCallUint64Result shutdown(int how) override;
+
+  // Written data is never buffered.
+  void discardPendingWrites() override {}
+
+protected:
   // Converts a SysCallSizeResult to IoCallUint64Result.
   Api::IoCallUint64Result sysCallResultToIoCallResult(const Api::SysCallSizeResult& result);
 
+  // Fills in the output of recvmsg() or recvmmsg() from a received message header.
+  void parseRecvMsgHeader(const msghdr& hdr, uint32_t self_port, RecvMsgOutput& output);
+
   int fd_;
 };
 
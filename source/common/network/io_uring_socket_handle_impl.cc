@@ -0,0 +1,48 @@
+#include "common/network/io_uring_socket_handle_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (socket_ != nullptr) {
+    IoUringSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  ASSERT(socket_ != nullptr);
+  socket_->close();
+  socket_ = nullptr;
+  fd_ = -1;
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  return sysCallResultToIoCallResult(socket_->readv(max_length, slices, num_slice));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  return sysCallResultToIoCallResult(socket_->writev(slices, num_slice));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      uint64_t max_length) {
+  return sysCallResultToIoCallResult(socket_->read(buffer, max_length));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  return sysCallResultToIoCallResult(socket_->write(buffer));
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::shutdown(int how) {
+  const Api::SysCallIntResult result = socket_->shutdown(how);
+  return sysCallResultToIoCallResult(Api::SysCallSizeResult{result.rc_, result.errno_});
+}
+
+} // namespace Network
+} // namespace Envoy
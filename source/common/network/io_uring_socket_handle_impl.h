@@ -0,0 +1,40 @@
+#pragma once
+
+#include "common/io/io_uring_worker_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * IoHandle for stream sockets whose reads and writes go through the io_uring of the dispatcher's
+ * Io::IoUringWorker instead of individual system calls.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  explicit IoUringSocketHandleImpl(Io::IoUringSocket& socket)
+      : IoSocketHandleImpl(socket.fd()), socket_(&socket) {}
+
+  // Hand the socket back to the worker if close() hasn't been called yet.
+  ~IoUringSocketHandleImpl() override;
+
+  // Network::IoHandle
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  // Shutting down writes waits for the writes buffered by the ring.
+  Api::IoCallUint64Result shutdown(int how) override;
+  void discardPendingWrites() override { socket_->discardPendingWrites(); }
+  // The ring may have a read of the file descriptor queued.
+  bool supportsSplice() const override { return false; }
+
+private:
+  // Null after close(), when the socket may already have been deleted by its worker.
+  Io::IoUringSocket* socket_;
+};
+
+} // namespace Network
+} // namespace Envoy
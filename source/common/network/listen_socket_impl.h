@@ -179,6 +179,9 @@ public:
   ClientSocketImpl(const Address::InstanceConstSharedPtr& remote_address)
       : ConnectionSocketImpl(remote_address->socket(Address::SocketType::Stream), nullptr,
                              remote_address) {}
+  // Takes a stream socket created for the remote address.
+  ClientSocketImpl(IoHandlePtr&& io_handle, const Address::InstanceConstSharedPtr& remote_address)
+      : ConnectionSocketImpl(std::move(io_handle), nullptr, remote_address) {}
 };
 
 } // namespace Network
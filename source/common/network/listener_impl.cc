@@ -1,5 +1,6 @@
 #include "common/network/listener_impl.h"
 
+#include <sys/socket.h>
 #include <sys/un.h>
 
 #include "envoy/common/exception.h"
@@ -11,6 +12,7 @@
 #include "common/event/file_event_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_handle_impl.h"
+#include "common/network/io_uring_socket_handle_impl.h"
 
 #include "event2/listener.h"
 
@@ -19,16 +21,25 @@ namespace Network {
 
 void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
                                   int remote_addr_len, void* arg) {
-  ListenerImpl* listener = static_cast<ListenerImpl*>(arg);
+  static_cast<ListenerImpl*>(arg)->onAccept(fd, remote_addr, remote_addr_len);
+}
 
-  // Create the IoSocketHandleImpl for the fd here.
-  IoHandlePtr io_handle = std::make_unique<IoSocketHandleImpl>(fd);
+void ListenerImpl::onAccept(int fd, const sockaddr* remote_addr, socklen_t remote_addr_len) {
+  // Create the IoHandle for the fd here. Its reads and writes go through io_uring if the worker
+  // has a ring.
+  Io::IoUringWorker* io_uring_worker = dispatcher_.ioUringWorker();
+  IoHandlePtr io_handle;
+  if (io_uring_worker != nullptr) {
+    io_handle = std::make_unique<IoUringSocketHandleImpl>(
+        io_uring_worker->addSocket(std::make_unique<IoSocketHandleImpl>(fd)));
+  } else {
+    io_handle = std::make_unique<IoSocketHandleImpl>(fd);
+  }
 
   // Get the local address from the new socket if the listener is listening on IP ANY
   // (e.g., 0.0.0.0 for IPv4) (local_address_ is nullptr in this case).
   const Address::InstanceConstSharedPtr& local_address =
-      listener->local_address_ ? listener->local_address_
-                               : listener->getLocalAddress(io_handle->fd());
+      local_address_ ? local_address_ : getLocalAddress(io_handle->fd());
 
   // The accept() call that filled in remote_addr doesn't fill in more than the sa_family field
   // for Unix domain sockets; apparently there isn't a mechanism in the kernel to get the
@@ -43,17 +54,34 @@ void ListenerImpl::listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr*
           : Address::addressFromSockAddr(*reinterpret_cast<const sockaddr_storage*>(remote_addr),
                                          remote_addr_len,
                                          local_address->ip()->version() == Address::IpVersion::v6);
-  listener->cb_.onAccept(
+  cb_.onAccept(
       std::make_unique<AcceptedSocketImpl>(std::move(io_handle), local_address, remote_address));
 }
 
 void ListenerImpl::setupServerSocket(Event::DispatcherImpl& dispatcher, Socket& socket) {
-  listener_.reset(
-      evconnlistener_new(&dispatcher.base(), listenCallback, this, 0, -1, socket.ioHandle().fd()));
-
-  if (!listener_) {
-    throw CreateListenerException(
-        fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
+  Io::IoUringWorker* io_uring_worker = dispatcher.ioUringWorker();
+  if (io_uring_worker != nullptr) {
+    // The ring accepts several connections at a time, and the socket isn't polled. Listen with the
+    // backlog evconnlistener_new() uses.
+    if (::listen(socket.ioHandle().fd(), 128) != 0) {
+      throw CreateListenerException(
+          fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
+    }
+    acceptor_ = &io_uring_worker->addAcceptor(
+        socket.ioHandle().fd(),
+        [this](int fd, const sockaddr* remote_addr, socklen_t remote_addr_len) {
+          onAccept(fd, remote_addr, remote_addr_len);
+        });
+    acceptor_->enable();
+  } else {
+    listener_.reset(evconnlistener_new(&dispatcher.base(), listenCallback, this, 0, -1,
+                                       socket.ioHandle().fd()));
+
+    if (!listener_) {
+      throw CreateListenerException(
+          fmt::format("cannot listen on socket: {}", socket.localAddress()->asString()));
+    }
+    evconnlistener_set_error_cb(listener_.get(), errorCallback);
   }
 
   if (!Network::Socket::applyOptions(socket.options(), socket,
@@ -61,8 +89,6 @@ void ListenerImpl::setupServerSocket(Event::DispatcherImpl& dispatcher, Socket&
     throw CreateListenerException(fmt::format("cannot set post-listen socket option on socket: {}",
                                               socket.localAddress()->asString()));
   }
-
-  evconnlistener_set_error_cb(listener_.get(), errorCallback);
 }
 
 ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, ListenerCallbacks& cb,
@@ -73,6 +99,12 @@ ListenerImpl::ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, Li
   }
 }
 
+ListenerImpl::~ListenerImpl() {
+  if (acceptor_ != nullptr) {
+    acceptor_->close();
+  }
+}
+
 void ListenerImpl::errorCallback(evconnlistener*, void*) {
   // We should never get an error callback. This can happen if we run out of FDs or memory. In those
   // cases just crash.
@@ -82,12 +114,16 @@ void ListenerImpl::errorCallback(evconnlistener*, void*) {
 void ListenerImpl::enable() {
   if (listener_.get()) {
     evconnlistener_enable(listener_.get());
+  } else if (acceptor_ != nullptr) {
+    acceptor_->enable();
   }
 }
 
 void ListenerImpl::disable() {
   if (listener_.get()) {
     evconnlistener_disable(listener_.get());
+  } else if (acceptor_ != nullptr) {
+    acceptor_->disable();
   }
 }
 
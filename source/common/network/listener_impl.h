@@ -1,5 +1,7 @@
 #pragma once
 
+#include "common/io/io_uring_worker_impl.h"
+
 #include "base_listener_impl.h"
 
 namespace Envoy {
@@ -13,6 +15,7 @@ class ListenerImpl : public BaseListenerImpl {
 public:
   ListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, ListenerCallbacks& cb,
                bool bind_to_port);
+  ~ListenerImpl() override;
 
   void disable() override;
   void enable() override;
@@ -26,8 +29,11 @@ private:
   static void listenCallback(evconnlistener*, evutil_socket_t fd, sockaddr* remote_addr,
                              int remote_addr_len, void* arg);
   static void errorCallback(evconnlistener* listener, void* context);
+  void onAccept(int fd, const sockaddr* remote_addr, socklen_t remote_addr_len);
 
   Event::Libevent::ListenerPtr listener_;
+  // Accepts instead of listener_ if the dispatcher has an io_uring.
+  Io::IoUringAcceptor* acceptor_{};
 };
 
 } // namespace Network
@@ -21,6 +21,7 @@ public:
   IoResult doRead(Buffer::Instance& buffer) override;
   IoResult doWrite(Buffer::Instance& buffer, bool end_stream) override;
   Ssl::ConnectionInfoConstSharedPtr ssl() const override { return nullptr; }
+  bool passThrough() const override { return true; }
 
 private:
   TransportSocketCallbacks* callbacks_{};
@@ -0,0 +1,125 @@
+#include "common/network/splice_forwarder.h"
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include "envoy/api/os_sys_calls.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+// The size of a pipe unless changed with F_SETPIPE_SZ.
+constexpr uint32_t DefaultPipeCapacity = 65536;
+
+#ifdef __linux__
+constexpr unsigned int SpliceFlags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+#else
+constexpr unsigned int SpliceFlags = 0;
+#endif
+
+// Resizes the pipe, rounded up to a power of two pages by the kernel. Unprivileged processes
+// cannot exceed /proc/sys/fs/pipe-max-size; the pipe keeps its size then.
+uint32_t setPipeCapacity(int pipe_fd, uint32_t pipe_size) {
+#ifdef F_SETPIPE_SZ
+  if (pipe_size != 0) {
+    const int rc = ::fcntl(pipe_fd, F_SETPIPE_SZ, pipe_size);
+    if (rc > 0) {
+      return rc;
+    }
+  }
+#else
+  UNREFERENCED_PARAMETER(pipe_fd);
+  UNREFERENCED_PARAMETER(pipe_size);
+#endif
+  return DefaultPipeCapacity;
+}
+
+} // namespace
+
+SpliceForwarderPtr SpliceForwarder::create(uint32_t pipe_size) {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  if (!os_sys_calls.supportsSplice()) {
+    return nullptr;
+  }
+  int pipe_fds[2];
+  const Api::SysCallIntResult result = os_sys_calls.pipe(pipe_fds);
+  if (result.rc_ != 0) {
+    ENVOY_LOG(debug, "unable to create pipe for splicing: {}", strerror(result.errno_));
+    return nullptr;
+  }
+  const uint32_t pipe_capacity = setPipeCapacity(pipe_fds[1], pipe_size);
+  return SpliceForwarderPtr{new SpliceForwarder(pipe_fds[0], pipe_fds[1], pipe_capacity)};
+}
+
+SpliceForwarder::SpliceForwarder(int pipe_read_fd, int pipe_write_fd, uint32_t pipe_capacity)
+    : pipe_read_fd_(pipe_read_fd), pipe_write_fd_(pipe_write_fd), pipe_capacity_(pipe_capacity) {}
+
+SpliceForwarder::~SpliceForwarder() {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  os_sys_calls.close(pipe_read_fd_);
+  os_sys_calls.close(pipe_write_fd_);
+}
+
+SpliceForwarder::Result SpliceForwarder::forward(IoHandle& source, IoHandle& destination,
+                                                 uint64_t max_bytes_read) {
+  auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Result result;
+  while (true) {
+    // Flush the pipe first, the source can only be read from once it has room again.
+    while (pipe_length_ > 0) {
+      const Api::SysCallSizeResult rc =
+          os_sys_calls.splice(pipe_read_fd_, destination.fd(), pipe_length_, SpliceFlags);
+      if (rc.rc_ < 0) {
+        if (rc.errno_ != EAGAIN) {
+          ENVOY_LOG(debug, "splice to fd {} failed: {}", destination.fd(), strerror(rc.errno_));
+          result.error_ = rc.errno_;
+        }
+        // Otherwise the destination is full; resume when it becomes writable.
+        return result;
+      }
+      pipe_length_ -= rc.rc_;
+      result.bytes_written_ += rc.rc_;
+    }
+
+    if (source_end_stream_) {
+      if (!end_stream_written_) {
+        // As with a connection's end of stream, a failure only happens on a failed connection and
+        // is detected by the next splice.
+        destination.shutdown(SHUT_WR);
+        end_stream_written_ = true;
+      }
+      return result;
+    }
+
+    if (result.bytes_read_ >= max_bytes_read) {
+      result.yielded_ = true;
+      return result;
+    }
+
+    const Api::SysCallSizeResult rc =
+        os_sys_calls.splice(source.fd(), pipe_write_fd_, pipe_capacity_, SpliceFlags);
+    if (rc.rc_ < 0) {
+      if (rc.errno_ != EAGAIN) {
+        ENVOY_LOG(debug, "splice from fd {} failed: {}", source.fd(), strerror(rc.errno_));
+        result.error_ = rc.errno_;
+      }
+      return result;
+    }
+    if (rc.rc_ == 0) {
+      source_end_stream_ = true;
+    }
+    pipe_length_ += rc.rc_;
+    result.bytes_read_ += rc.rc_;
+  }
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "envoy/network/io_handle.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Network {
+
+class SpliceForwarder;
+using SpliceForwarderPtr = std::unique_ptr<SpliceForwarder>;
+
+/**
+ * Moves the data of one direction of a proxied TCP stream from a source to a destination socket
+ * with splice(2) through a pipe, so that it is never copied to user space. The amount of data in
+ * flight is bounded by the size of the pipe: once the destination stops accepting data, the pipe
+ * fills up and the kernel applies back pressure to the source.
+ */
+class SpliceForwarder : NonCopyable, protected Logger::Loggable<Logger::Id::connection> {
+public:
+  struct Result {
+    uint64_t bytes_read_{};
+    uint64_t bytes_written_{};
+    // errno of a failed splice from the source or to the destination, or 0.
+    int error_{};
+    // Whether the call stopped reading because it reached max_bytes_read while the source and the
+    // destination may still be ready. Edge triggered events will not report them again, so the
+    // caller has to call forward() again later.
+    bool yielded_{};
+  };
+
+  /**
+   * @param pipe_size supplies the requested size of the pipe in bytes, or 0 for the default size.
+   * @return SpliceForwarderPtr a forwarder, or nullptr if splice(2) is not supported or the pipe
+   *         cannot be created.
+   */
+  static SpliceForwarderPtr create(uint32_t pipe_size);
+
+  ~SpliceForwarder();
+
+  /**
+   * Write the data held in the pipe to the destination and then move data from the source to the
+   * destination until either of them would block or max_bytes_read have been read. Once the
+   * source reaches the end of the stream and the pipe has been flushed, the destination is shut
+   * down for writing.
+   * @param source supplies the socket to read from. It must be the same for every call.
+   * @param destination supplies the socket to write to. It must be the same for every call.
+   * @param max_bytes_read supplies the number of bytes after which the call stops reading from
+   *        the source, so that a busy stream does not hold up the other events of the worker. Up
+   *        to one pipe capacity more may be read.
+   * @return Result the data moved by this call.
+   */
+  Result forward(IoHandle& source, IoHandle& destination, uint64_t max_bytes_read);
+
+  /**
+   * @return bool whether the end of the stream has been forwarded to the destination.
+   */
+  bool endStream() const { return end_stream_written_; }
+
+private:
+  SpliceForwarder(int pipe_read_fd, int pipe_write_fd, uint32_t pipe_capacity);
+
+  const int pipe_read_fd_;
+  const int pipe_write_fd_;
+  const uint32_t pipe_capacity_;
+  // Number of bytes read from the source which are still in the pipe.
+  uint64_t pipe_length_{};
+  bool source_end_stream_{};
+  bool end_stream_written_{};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include <sys/un.h>
 
+#include <algorithm>
 #include <cerrno>
 #include <csetjmp>
 #include <cstring>
@@ -27,9 +28,31 @@
 namespace Envoy {
 namespace Network {
 
+namespace {
+
+// Limits of the kernel on the messages sent with UDP_SEGMENT.
+constexpr uint64_t MaxGsoSegments = 64;
+constexpr uint64_t MaxGsoMessageSize = 65507;
+
+bool sameLocalIp(const Address::Ip* lhs, const Address::Ip* rhs) {
+  if (lhs == rhs) {
+    return true;
+  }
+  if (lhs == nullptr || rhs == nullptr || lhs->version() != rhs->version()) {
+    return false;
+  }
+  return lhs->version() == Address::IpVersion::v4
+             ? lhs->ipv4()->address() == rhs->ipv4()->address()
+             : lhs->ipv6()->address() == rhs->ipv6()->address();
+}
+
+} // namespace
+
 UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket,
-                                 UdpListenerCallbacks& cb, TimeSource& time_source)
-    : BaseListenerImpl(dispatcher, socket), cb_(cb), time_source_(time_source) {
+                                 UdpListenerCallbacks& cb, TimeSource& time_source,
+                                 const UdpListenerBatchConfig& batch_config)
+    : BaseListenerImpl(dispatcher, socket), cb_(cb), time_source_(time_source),
+      batch_config_(batch_config) {
   file_event_ = dispatcher_.createFileEvent(
       socket.ioHandle().fd(), [this](uint32_t events) -> void { onSocketEvent(events); },
       Event::FileTriggerType::Edge, Event::FileReadyType::Read | Event::FileReadyType::Write);
@@ -41,6 +64,24 @@ UdpListenerImpl::UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& sock
     throw CreateListenerException(fmt::format("cannot set post-bound socket option on socket: {}",
                                               socket.localAddress()->asString()));
   }
+
+#ifdef __linux__
+  if (batch_config_.enable_udp_offload_) {
+    auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+    int segment_size = 0;
+    socklen_t segment_size_length = sizeof(segment_size);
+    gso_supported_ = os_sys_calls
+                         .getsockopt(socket.ioHandle().fd(), SOL_UDP, UDP_SEGMENT, &segment_size,
+                                     &segment_size_length)
+                         .rc_ == 0;
+    const int enable_gro = 1;
+    gro_enabled_ = os_sys_calls
+                       .setsockopt(socket.ioHandle().fd(), SOL_UDP, UDP_GRO, &enable_gro,
+                                   sizeof(enable_gro))
+                       .rc_ == 0;
+    ENVOY_UDP_LOG(debug, "UDP offload: GSO {}, GRO {}", gso_supported_, gro_enabled_);
+  }
+#endif
 }
 
 UdpListenerImpl::~UdpListenerImpl() {
@@ -72,8 +113,12 @@ void UdpListenerImpl::handleReadCallback() {
   do {
     uint32_t old_packets_dropped = packets_dropped_;
     MonotonicTime receive_time = time_source_.monotonicTime();
+    const bool batched = batch_config_.max_batch_size_ > 1 || gro_enabled_;
     Api::IoCallUint64Result result =
-        Utility::readFromSocket(socket_, *this, receive_time, &packets_dropped_);
+        batched ? Utility::readPacketsFromSocket(socket_, recv_storage_, *this, receive_time,
+                                                 batch_config_.max_batch_size_, gro_enabled_,
+                                                 &packets_dropped_)
+                : Utility::readFromSocket(socket_, *this, receive_time, &packets_dropped_);
 
     if (!result.ok()) {
       // No more to read or encountered a system error.
@@ -87,7 +132,7 @@ void UdpListenerImpl::handleReadCallback() {
       return;
     }
 
-    if (result.rc_ == 0) {
+    if (!batched && result.rc_ == 0) {
       // TODO(conqerAtapple): Is zero length packet interesting? If so add stats
       // for it. Otherwise remove the warning log below.
       ENVOY_UDP_LOG(trace, "received 0-length packet");
@@ -142,5 +187,109 @@ Api::IoCallUint64Result UdpListenerImpl::send(const UdpSendData& send_data) {
   return send_result;
 }
 
+Api::IoCallUint64Result UdpListenerImpl::sendBatch(const UdpSendData* data,
+                                                   uint64_t num_packets) {
+  ENVOY_UDP_LOG(trace, "sendBatch {} packets", num_packets);
+  const bool use_mmsg = batch_config_.max_batch_size_ > 1 && socket_.ioHandle().supportsMmsg();
+  uint64_t packets_sent = 0;
+  while (packets_sent < num_packets) {
+    const uint64_t batch_size =
+        use_mmsg ? std::min(num_packets - packets_sent,
+                            static_cast<uint64_t>(batch_config_.max_batch_size_))
+                 : 1;
+    Api::IoCallUint64Result send_result =
+        use_mmsg ? sendmmsg(data + packets_sent, batch_size) : send(data[packets_sent]);
+    if (!send_result.ok()) {
+      if (packets_sent == 0) {
+        return send_result;
+      }
+      break;
+    }
+    const uint64_t batch_sent = use_mmsg ? send_result.rc_ : 1;
+    packets_sent += batch_sent;
+    if (batch_sent < batch_size) {
+      break;
+    }
+  }
+  return Api::IoCallUint64Result(packets_sent,
+                                 Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+}
+
+Api::IoCallUint64Result UdpListenerImpl::sendmmsg(const UdpSendData* data, uint64_t num_packets) {
+  uint64_t num_slices = 0;
+  for (uint64_t i = 0; i < num_packets; i++) {
+    num_slices += data[i].buffer_.getRawSlices(nullptr, 0);
+  }
+  STACK_ARRAY(slices, Buffer::RawSlice, num_slices);
+  STACK_ARRAY(messages, IoHandle::SendMsgInput, num_packets);
+  STACK_ARRAY(packets_per_message, uint64_t, num_packets);
+
+  // Consecutive packets to the same peer become the segments of one message if GSO is supported.
+  uint64_t num_messages = 0;
+  Buffer::RawSlice* next_slice = slices.begin();
+  for (uint64_t i = 0; i < num_packets;) {
+    const UdpSendData& first = data[i];
+    IoHandle::SendMsgInput& message = messages[num_messages];
+    message.slices_ = next_slice;
+    message.num_slice_ = 0;
+    message.self_ip_ = first.local_ip_;
+    message.peer_address_ = &first.peer_address_;
+    message.gso_size_ = 0;
+    uint64_t message_size = 0;
+    uint64_t num_segments = 0;
+    do {
+      const uint64_t packet_slices =
+          data[i].buffer_.getRawSlices(next_slice, num_slices - (next_slice - slices.begin()));
+      next_slice += packet_slices;
+      message.num_slice_ += packet_slices;
+      message_size += data[i].buffer_.length();
+      num_segments++;
+      i++;
+    } while (gso_supported_ && i < num_packets &&
+             canAppendSegment(first, data[i], message_size, num_segments));
+    if (num_segments > 1) {
+      message.gso_size_ = first.buffer_.length();
+    }
+    packets_per_message[num_messages++] = num_segments;
+  }
+
+  Api::IoCallUint64Result send_result(
+      /*rc=*/0, /*err=*/Api::IoErrorPtr(nullptr, IoSocketError::deleteIoError));
+  do {
+    send_result = socket_.ioHandle().sendmmsg(messages.begin(), num_messages);
+  } while (!send_result.ok() &&
+           // Send again if interrupted.
+           send_result.err_->getErrorCode() == Api::IoError::IoErrorCode::Interrupt);
+  if (!send_result.ok()) {
+    ENVOY_UDP_LOG(debug, "sendmmsg failed with error code {}: {}",
+                  static_cast<int>(send_result.err_->getErrorCode()),
+                  send_result.err_->getErrorDetails());
+    return send_result;
+  }
+
+  ENVOY_UDP_LOG(trace, "sendmmsg sent {} of {} messages", send_result.rc_, num_messages);
+  uint64_t packets_sent = 0;
+  for (uint64_t i = 0; i < send_result.rc_; i++) {
+    for (uint64_t j = 0; j < packets_per_message[i]; j++) {
+      Buffer::Instance& buffer = data[packets_sent++].buffer_;
+      buffer.drain(buffer.length());
+    }
+  }
+  return Api::IoCallUint64Result(packets_sent, std::move(send_result.err_));
+}
+
+bool UdpListenerImpl::canAppendSegment(const UdpSendData& first, const UdpSendData& packet,
+                                       uint64_t message_size, uint64_t num_segments) const {
+  const uint64_t segment_size = first.buffer_.length();
+  // All segments but the last have the size of the first one, so a message ends after a shorter
+  // segment.
+  return segment_size != 0 && message_size == num_segments * segment_size &&
+         num_segments < MaxGsoSegments && packet.buffer_.length() != 0 &&
+         packet.buffer_.length() <= segment_size &&
+         message_size + packet.buffer_.length() <= MaxGsoMessageSize &&
+         packet.peer_address_ == first.peer_address_ &&
+         sameLocalIp(packet.local_ip_, first.local_ip_);
+}
+
 } // namespace Network
 } // namespace Envoy
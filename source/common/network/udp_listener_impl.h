@@ -23,7 +23,7 @@ class UdpListenerImpl : public BaseListenerImpl,
                         protected Logger::Loggable<Logger::Id::udp> {
 public:
   UdpListenerImpl(Event::DispatcherImpl& dispatcher, Socket& socket, UdpListenerCallbacks& cb,
-                  TimeSource& time_source);
+                  TimeSource& time_source, const UdpListenerBatchConfig& batch_config = {});
 
   ~UdpListenerImpl() override;
 
@@ -35,6 +35,7 @@ public:
   Event::Dispatcher& dispatcher() override;
   const Address::InstanceConstSharedPtr& localAddress() const override;
   Api::IoCallUint64Result send(const UdpSendData& data) override;
+  Api::IoCallUint64Result sendBatch(const UdpSendData* data, uint64_t num_packets) override;
 
   void processPacket(Address::InstanceConstSharedPtr local_address,
                      Address::InstanceConstSharedPtr peer_address, Buffer::InstancePtr buffer,
@@ -54,9 +55,21 @@ protected:
 
 private:
   void onSocketEvent(short flags);
+  // Send up to max_batch_size_ packets with one sendmmsg() call and drain the ones sent.
+  // @return rc_ = the number of packets sent, or the error of sendmmsg().
+  Api::IoCallUint64Result sendmmsg(const UdpSendData* data, uint64_t num_packets);
+  // Whether the packet may be sent as another segment of the GSO message starting with |first|.
+  bool canAppendSegment(const UdpSendData& first, const UdpSendData& packet,
+                        uint64_t message_size, uint64_t num_segments) const;
 
   TimeSource& time_source_;
   Event::FileEventPtr file_event_;
+  const UdpListenerBatchConfig batch_config_;
+  // Whether the kernel supports UDP_SEGMENT on the socket.
+  bool gso_supported_{};
+  // Whether the kernel coalesces received datagrams with UDP_GRO.
+  bool gro_enabled_{};
+  UdpRecvMmsgStorage recv_storage_;
 };
 
 } // namespace Network
@@ -529,6 +529,27 @@ Api::IoCallUint64Result Utility::writeToSocket(Network::Socket& socket, Buffer::
   return send_result;
 }
 
+namespace {
+
+void passPayloadToProcessor(uint64_t bytes_read, Buffer::InstancePtr buffer,
+                            Address::InstanceConstSharedPtr peer_address,
+                            Address::InstanceConstSharedPtr local_address,
+                            UdpPacketProcessor& udp_packet_processor, MonotonicTime receive_time) {
+  RELEASE_ASSERT(peer_address != nullptr,
+                 fmt::format("Unable to get remote address, local address: {} ",
+                             local_address->asString()));
+
+  // Unix domain sockets are not supported
+  RELEASE_ASSERT(peer_address->type() == Address::Type::Ip,
+                 fmt::format("Unsupported remote address: {} local address: {}, receive size: "
+                             "{}",
+                             peer_address->asString(), local_address->asString(), bytes_read));
+  udp_packet_processor.processPacket(std::move(local_address), std::move(peer_address),
+                                     std::move(buffer), receive_time);
+}
+
+} // namespace
+
 Api::IoCallUint64Result Utility::readFromSocket(Network::Socket& socket,
                                                 UdpPacketProcessor& udp_packet_processor,
                                                 MonotonicTime receive_time,
@@ -554,19 +575,90 @@ Api::IoCallUint64Result Utility::readFromSocket(Network::Socket& socket,
 
   ENVOY_LOG_MISC(trace, "recvmsg bytes {}", result.rc_);
 
-  RELEASE_ASSERT(output.peer_address_ != nullptr,
-                 fmt::format("Unable to get remote address for fd: {}, local address: {} ",
-                             socket.ioHandle().fd(), socket.localAddress()->asString()));
+  passPayloadToProcessor(result.rc_, std::move(buffer), std::move(output.peer_address_),
+                         std::move(output.local_address_), udp_packet_processor, receive_time);
+  return result;
+}
+
+Api::IoCallUint64Result Utility::readPacketsFromSocket(Network::Socket& socket,
+                                                       UdpRecvMmsgStorage& storage,
+                                                       UdpPacketProcessor& udp_packet_processor,
+                                                       MonotonicTime receive_time,
+                                                       uint32_t max_packets, bool use_gro,
+                                                       uint32_t* packets_dropped) {
+  const uint32_t self_port = socket.localAddress()->ip()->port();
+  if (use_gro) {
+    Buffer::OwnedImpl buffer;
+    Buffer::RawSlice slice;
+    const uint64_t num_slices = buffer.reserve(MAX_UDP_GRO_MESSAGE_SIZE, &slice, 1);
+    ASSERT(num_slices == 1);
+
+    IoHandle::RecvMsgOutput output(packets_dropped);
+    Api::IoCallUint64Result result =
+        socket.ioHandle().recvmsg(&slice, num_slices, self_port, output);
+    if (!result.ok()) {
+      return result;
+    }
 
-  // Unix domain sockets are not supported
-  RELEASE_ASSERT(output.peer_address_->type() == Address::Type::Ip,
-                 fmt::format("Unsupported remote address: {} local address: {}, receive size: "
-                             "{}",
-                             output.peer_address_->asString(), socket.localAddress()->asString(),
-                             result.rc_));
-  udp_packet_processor.processPacket(std::move(output.local_address_),
-                                     std::move(output.peer_address_), std::move(buffer),
-                                     receive_time);
+    RELEASE_ASSERT(output.local_address_ != nullptr, "fail to get local address from IP header");
+    slice.len_ = std::min(slice.len_, static_cast<size_t>(result.rc_));
+    buffer.commit(&slice, 1);
+    ENVOY_LOG_MISC(trace, "recvmsg bytes {} with gso_size {}", result.rc_, output.gso_size_);
+
+    // Split the message back into the datagrams the kernel coalesced.
+    const uint64_t gso_size = output.gso_size_ != 0 ? output.gso_size_ : buffer.length();
+    uint64_t num_packets = 0;
+    do {
+      Buffer::InstancePtr packet = std::make_unique<Buffer::OwnedImpl>();
+      const uint64_t packet_size = std::min(gso_size, buffer.length());
+      packet->move(buffer, packet_size);
+      passPayloadToProcessor(packet_size, std::move(packet), output.peer_address_,
+                             output.local_address_, udp_packet_processor, receive_time);
+      num_packets++;
+    } while (buffer.length() != 0);
+    return Api::IoCallUint64Result(num_packets, std::move(result.err_));
+  }
+
+  if (max_packets <= 1 || !socket.ioHandle().supportsMmsg()) {
+    Api::IoCallUint64Result result =
+        readFromSocket(socket, udp_packet_processor, receive_time, packets_dropped);
+    return Api::IoCallUint64Result(result.ok() ? 1 : 0, std::move(result.err_));
+  }
+
+  // Buffers whose packet was not received in the previous call keep their reserved space. Their
+  // slices and outputs are only modified by recvmmsg() when a packet is received into them.
+  const uint64_t max_packet_size = udp_packet_processor.maxPacketSize();
+  storage.buffers_.resize(max_packets);
+  storage.slices_.resize(max_packets);
+  storage.output_.resize(max_packets, IoHandle::RecvMsgOutput(packets_dropped));
+  for (uint32_t i = 0; i < max_packets; i++) {
+    if (storage.buffers_[i] != nullptr) {
+      continue;
+    }
+    storage.buffers_[i] = std::make_unique<Buffer::OwnedImpl>();
+    const uint64_t num_slices =
+        storage.buffers_[i]->reserve(max_packet_size, &storage.slices_[i], 1);
+    ASSERT(num_slices == 1);
+    // Packets longer than the maximum packet size are truncated as with readFromSocket().
+    storage.slices_[i].len_ =
+        std::min(storage.slices_[i].len_, static_cast<size_t>(max_packet_size));
+    storage.output_[i] = IoHandle::RecvMsgOutput(packets_dropped);
+  }
+  Api::IoCallUint64Result result = socket.ioHandle().recvmmsg(
+      storage.slices_.data(), max_packets, self_port, storage.output_.data());
+  if (!result.ok()) {
+    return result;
+  }
+
+  ENVOY_LOG_MISC(trace, "recvmmsg packets {}", result.rc_);
+  for (uint64_t i = 0; i < result.rc_; i++) {
+    IoHandle::RecvMsgOutput& output = storage.output_[i];
+    RELEASE_ASSERT(output.local_address_ != nullptr, "fail to get local address from IP header");
+    storage.buffers_[i]->commit(&storage.slices_[i], 1);
+    passPayloadToProcessor(storage.slices_[i].len_, std::move(storage.buffers_[i]),
+                           std::move(output.peer_address_), std::move(output.local_address_),
+                           udp_packet_processor, receive_time);
+  }
   return result;
 }
 
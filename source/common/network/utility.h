@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <list>
 #include <string>
+#include <vector>
 
 #include "envoy/api/v2/core/address.pb.h"
 #include "envoy/network/connection.h"
@@ -57,6 +58,21 @@ public:
 
 static const uint64_t MAX_UDP_PACKET_SIZE = 1500;
 
+// The maximum size of the datagrams the kernel coalesces into one message with UDP_GRO.
+static const uint64_t MAX_UDP_GRO_MESSAGE_SIZE = 65536;
+
+/**
+ * The receive buffers of Utility::readPacketsFromSocket(). A reader keeps them across calls, so
+ * that each call only allocates buffers in place of those whose packets it passed on.
+ */
+struct UdpRecvMmsgStorage {
+  // The buffers with space reserved for a packet, or nullptr once their packet was passed on.
+  std::vector<Buffer::InstancePtr> buffers_;
+  // The space reserved in each buffer.
+  std::vector<Buffer::RawSlice> slices_;
+  std::vector<IoHandle::RecvMsgOutput> output_;
+};
+
 /**
  * Common network utility routines.
  */
@@ -314,6 +330,30 @@ public:
                                                 MonotonicTime receive_time,
                                                 uint32_t* packets_dropped);
 
+  /**
+   * Read multiple packets from given UDP socket with one system call and pass each of them to
+   * given UdpPacketProcessor. If |use_gro| is set, reads one message of datagrams coalesced by the
+   * kernel, which requires UDP_GRO to be enabled on the socket. Otherwise reads up to
+   * |max_packets| packets with recvmmsg(). Falls back to readFromSocket() if neither is possible.
+   * @param socket is the UDP socket to read from.
+   * @param storage is the buffers to read into with recvmmsg(), reused across calls.
+   * @param udp_packet_processor is the callback to receive the packets.
+   * @param receive_time is the timestamp passed to udp_packet_processor for the
+   * receive time of the packets.
+   * @param max_packets is the maximum number of packets to read with recvmmsg().
+   * @param use_gro whether to read datagrams coalesced with UDP_GRO.
+   * @param packets_dropped is the output parameter for number of packets dropped in kernel. If the
+   * caller is not interested in it, nullptr can be passed in.
+   * @return the result of the system call, with rc_ the number of packets passed to
+   * udp_packet_processor upon success.
+   */
+  static Api::IoCallUint64Result readPacketsFromSocket(Network::Socket& socket,
+                                                       UdpRecvMmsgStorage& storage,
+                                                       UdpPacketProcessor& udp_packet_processor,
+                                                       MonotonicTime receive_time,
+                                                       uint32_t max_packets, bool use_gro,
+                                                       uint32_t* packets_dropped);
+
 private:
   static void throwWithMalformedIp(const std::string& ip_address);
 
@@ -29,6 +29,7 @@
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/router/retry_state_impl.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "extensions/filters/http/well_known_names.h"
 
@@ -902,19 +903,42 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     hedge_policy_ = virtual_host.hedge_policy();
   }
 
+  if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.compiled_route_matching")) {
+    path_match_index_ = std::make_unique<PathMatchIndex>();
+  }
+
   for (const auto& route : virtual_host.routes()) {
+    const uint32_t position = routes_.size();
+    const bool case_sensitive =
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(route.match(), case_sensitive, true);
     switch (route.match().path_specifier_case()) {
     case envoy::api::v2::route::RouteMatch::kPrefix: {
       routes_.emplace_back(new PrefixRouteEntryImpl(*this, route, factory_context, validator));
+      if (path_match_index_ != nullptr) {
+        path_match_index_->addPrefix(route.match().prefix(), case_sensitive, position);
+      }
       break;
     }
     case envoy::api::v2::route::RouteMatch::kPath: {
       routes_.emplace_back(new PathRouteEntryImpl(*this, route, factory_context, validator));
+      if (path_match_index_ != nullptr) {
+        path_match_index_->addPath(route.match().path(), case_sensitive, position);
+      }
+      break;
+    }
+    case envoy::api::v2::route::RouteMatch::kRegex: {
+      routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context, validator));
+      if (path_match_index_ != nullptr) {
+        // std::regex syntax is not compatible with RE2, so these are always evaluated.
+        path_match_index_->addUnindexed(position);
+      }
       break;
     }
-    case envoy::api::v2::route::RouteMatch::kRegex:
     case envoy::api::v2::route::RouteMatch::kSafeRegex: {
       routes_.emplace_back(new RegexRouteEntryImpl(*this, route, factory_context, validator));
+      if (path_match_index_ != nullptr) {
+        path_match_index_->addRegex(route.match().safe_regex().regex(), position);
+      }
       break;
     }
     case envoy::api::v2::route::RouteMatch::PATH_SPECIFIER_NOT_SET:
@@ -932,6 +956,10 @@ VirtualHostImpl::VirtualHostImpl(const envoy::api::v2::route::VirtualHost& virtu
     }
   }
 
+  if (path_match_index_ != nullptr) {
+    path_match_index_->compile();
+  }
+
   for (const auto& virtual_cluster : virtual_host.virtual_clusters()) {
     virtual_clusters_.push_back(VirtualClusterEntry(virtual_cluster, stat_name_pool_));
   }
@@ -974,25 +1002,21 @@ const RouteSpecificFilterConfig* VirtualHostImpl::perFilterConfig(const std::str
 }
 
 const VirtualHostImpl* RouteMatcher::findWildcardVirtualHost(
-    const std::string& host, const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts,
-    RouteMatcher::SubstringFunction substring_function) const {
+    absl::string_view host,
+    const RouteMatcher::WildcardVirtualHosts& wildcard_virtual_hosts) const {
   // We do a longest wildcard match against the host that's passed in
   // (e.g. foo-bar.baz.com should match *-bar.baz.com before matching *.baz.com for suffix
-  // wildcards). This is done by scanning the length => wildcards map looking for every wildcard
-  // whose size is < length.
-  for (const auto& iter : wildcard_virtual_hosts) {
-    const uint32_t wildcard_length = iter.first;
-    const auto& wildcard_map = iter.second;
-    // >= because *.foo.com shouldn't match .foo.com.
-    if (wildcard_length >= host.size()) {
-      continue;
-    }
-    const auto& match = wildcard_map.find(substring_function(host, wildcard_length));
-    if (match != wildcard_map.end()) {
-      return match->second.get();
-    }
-  }
-  return nullptr;
+  // wildcards). Walking the tree visits every wildcard that is a prefix of the (possibly reversed)
+  // host from shortest to longest, so the last one visited wins.
+  const VirtualHostImpl* virtual_host = nullptr;
+  wildcard_virtual_hosts.forEachPrefix(
+      host, false, [&](size_t wildcard_length, const VirtualHostSharedPtr& candidate) {
+        // < because *.foo.com shouldn't match .foo.com.
+        if (candidate != nullptr && wildcard_length < host.size()) {
+          virtual_host = candidate.get();
+        }
+      });
+  return virtual_host;
 }
 
 RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_config,
@@ -1011,13 +1035,15 @@ RouteMatcher::RouteMatcher(const envoy::api::v2::RouteConfiguration& route_confi
         }
         default_virtual_host_ = virtual_host;
       } else if (!domain.empty() && '*' == domain[0]) {
-        duplicate_found = !wildcard_virtual_host_suffixes_[domain.size() - 1]
-                               .emplace(domain.substr(1), virtual_host)
-                               .second;
+        VirtualHostSharedPtr& entry = wildcard_virtual_host_suffixes_.getOrCreate(
+            std::string(domain.rbegin(), domain.rend() - 1));
+        duplicate_found = entry != nullptr;
+        entry = virtual_host;
       } else if (!domain.empty() && '*' == domain[domain.size() - 1]) {
-        duplicate_found = !wildcard_virtual_host_prefixes_[domain.size() - 1]
-                               .emplace(domain.substr(0, domain.size() - 1), virtual_host)
-                               .second;
+        VirtualHostSharedPtr& entry = wildcard_virtual_host_prefixes_.getOrCreate(
+            absl::string_view(domain).substr(0, domain.size() - 1));
+        duplicate_found = entry != nullptr;
+        entry = virtual_host;
       } else {
         duplicate_found = !virtual_hosts_.emplace(domain, virtual_host).second;
       }
@@ -1048,6 +1074,23 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const Http::HeaderMap&
     return SSL_REDIRECT_ROUTE;
   }
 
+  // With a compiled index only the routes whose path criterion may match are evaluated, still in
+  // configuration order so that the first matching route wins.
+  if (path_match_index_ != nullptr && headers.Path() != nullptr) {
+    const Http::HeaderString& path = headers.Path()->value();
+    const size_t path_only_length = path.size() - Http::Utility::findQueryStringStart(path).size();
+    PathMatchIndex::Positions candidates;
+    path_match_index_->candidates(path.getStringView(), path_only_length, candidates);
+    for (const uint32_t position : candidates) {
+      RouteConstSharedPtr route_entry =
+          routes_[position]->matches(headers, stream_info, random_value);
+      if (nullptr != route_entry) {
+        return route_entry;
+      }
+    }
+    return nullptr;
+  }
+
   // Check for a route that matches the request.
   for (const RouteEntryImplBaseConstSharedPtr& route : routes_) {
     RouteConstSharedPtr route_entry = route->matches(headers, stream_info, random_value);
@@ -1075,17 +1118,15 @@ const VirtualHostImpl* RouteMatcher::findVirtualHost(const Http::HeaderMap& head
     return iter->second.get();
   }
   if (!wildcard_virtual_host_suffixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_suffixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(h.size() - l); });
+    const std::string reversed_host(host.rbegin(), host.rend());
+    const VirtualHostImpl* vhost =
+        findWildcardVirtualHost(reversed_host, wildcard_virtual_host_suffixes_);
     if (vhost != nullptr) {
       return vhost;
     }
   }
   if (!wildcard_virtual_host_prefixes_.empty()) {
-    const VirtualHostImpl* vhost = findWildcardVirtualHost(
-        host, wildcard_virtual_host_prefixes_,
-        [](const std::string& h, int l) -> std::string { return h.substr(0, l); });
+    const VirtualHostImpl* vhost = findWildcardVirtualHost(host, wildcard_virtual_host_prefixes_);
     if (vhost != nullptr) {
       return vhost;
     }
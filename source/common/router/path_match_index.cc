@@ -0,0 +1,105 @@
+#include "common/router/path_match_index.h"
+
+#include <algorithm>
+
+#include "common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+PathMatchIndex::PathMatchIndex()
+    : regex_set_(std::make_unique<re2::RE2::Set>(re2::RE2::Quiet, re2::RE2::ANCHOR_BOTH)) {}
+
+void PathMatchIndex::addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t position) {
+  ASSERT(!compiled_);
+  if (case_sensitive) {
+    case_sensitive_routes_.getOrCreate(prefix).prefix_routes_.push_back(position);
+  } else {
+    case_insensitive_routes_.getOrCreate(absl::AsciiStrToLower(prefix))
+        .prefix_routes_.push_back(position);
+  }
+}
+
+void PathMatchIndex::addPath(absl::string_view path, bool case_sensitive, uint32_t position) {
+  ASSERT(!compiled_);
+  if (case_sensitive) {
+    case_sensitive_routes_.getOrCreate(path).path_routes_.push_back(position);
+  } else {
+    case_insensitive_routes_.getOrCreate(absl::AsciiStrToLower(path))
+        .path_routes_.push_back(position);
+  }
+}
+
+void PathMatchIndex::addRegex(const std::string& regex, uint32_t position) {
+  ASSERT(!compiled_);
+  // The route has already validated the regex, but if the set refuses it for any reason we
+  // still have a correct (if slower) answer by always considering the route.
+  if (regex_set_->Add(regex, nullptr) < 0) {
+    addUnindexed(position);
+    return;
+  }
+  regex_routes_.push_back(position);
+}
+
+void PathMatchIndex::addUnindexed(uint32_t position) {
+  ASSERT(!compiled_);
+  unindexed_routes_.push_back(position);
+}
+
+void PathMatchIndex::compile() {
+  ASSERT(!compiled_);
+  compiled_ = true;
+  if (regex_routes_.empty() || !regex_set_->Compile()) {
+    unindexed_routes_.insert(unindexed_routes_.end(), regex_routes_.begin(), regex_routes_.end());
+    regex_routes_.clear();
+    regex_set_.reset();
+  }
+  std::sort(unindexed_routes_.begin(), unindexed_routes_.end());
+}
+
+void PathMatchIndex::candidates(absl::string_view path, size_t path_only_length,
+                                Positions& positions) const {
+  ASSERT(compiled_);
+  ASSERT(path_only_length <= path.size());
+  positions.clear();
+  positions.insert(positions.end(), unindexed_routes_.begin(), unindexed_routes_.end());
+
+  collect(case_sensitive_routes_, path, path_only_length, false, positions);
+  if (!case_insensitive_routes_.empty()) {
+    collect(case_insensitive_routes_, path, path_only_length, true, positions);
+  }
+
+  if (regex_set_ != nullptr) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    const absl::string_view path_only = path.substr(0, path_only_length);
+    if (regex_set_->Match(re2::StringPiece(path_only.data(), path_only.size()), &matches,
+                          &error_info)) {
+      for (const int match : matches) {
+        positions.push_back(regex_routes_[match]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // The DFA gave up (e.g. it ran out of memory). Fall back to evaluating every regex route.
+      positions.insert(positions.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  std::sort(positions.begin(), positions.end());
+}
+
+void PathMatchIndex::collect(const RadixTree<Routes>& tree, absl::string_view path,
+                             size_t path_only_length, bool ignore_case, Positions& positions) {
+  // Prefix routes match anywhere along the full path, while exact path routes only match at the
+  // node reached by the path without its query string.
+  tree.forEachPrefix(path, ignore_case, [&](size_t depth, const Routes& routes) {
+    positions.insert(positions.end(), routes.prefix_routes_.begin(), routes.prefix_routes_.end());
+    if (depth == path_only_length) {
+      positions.insert(positions.end(), routes.path_routes_.begin(), routes.path_routes_.end());
+    }
+  });
+}
+
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/common/non_copyable.h"
+#include "common/common/radix_tree.h"
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * A compiled index over the path match criteria of an ordered list of routes. Given a request
+ * path, it returns the positions of every route whose path criterion may match, in ascending
+ * order, so that callers can preserve first-match-wins semantics while only evaluating the
+ * remaining (header, query parameter, runtime, etc.) criteria of plausible routes.
+ *
+ * Prefix and exact path routes are stored in a radix tree (one per case sensitivity), safe regex
+ * routes are combined into a single anchored RE2::Set and anything else is always returned as a
+ * candidate. The index may return false positives but never false negatives.
+ */
+class PathMatchIndex : NonCopyable {
+public:
+  PathMatchIndex();
+
+  /**
+   * Index a prefix route.
+   * @param prefix supplies the path prefix to match.
+   * @param case_sensitive supplies whether the prefix comparison is case sensitive.
+   * @param position supplies the position of the route in the virtual host.
+   */
+  void addPrefix(absl::string_view prefix, bool case_sensitive, uint32_t position);
+
+  /**
+   * Index an exact path route. The path is compared against the request path without its query
+   * string.
+   * @param path supplies the path to match.
+   * @param case_sensitive supplies whether the path comparison is case sensitive.
+   * @param position supplies the position of the route in the virtual host.
+   */
+  void addPath(absl::string_view path, bool case_sensitive, uint32_t position);
+
+  /**
+   * Index a RE2 regex route. The regex is fully matched against the request path without its query
+   * string.
+   * @param regex supplies the RE2 regular expression.
+   * @param position supplies the position of the route in the virtual host.
+   */
+  void addRegex(const std::string& regex, uint32_t position);
+
+  /**
+   * Add a route whose path criterion cannot be indexed. It will be returned for every lookup.
+   * @param position supplies the position of the route in the virtual host.
+   */
+  void addUnindexed(uint32_t position);
+
+  /**
+   * Finalize the index. Must be called once after all routes have been added and before any
+   * lookup.
+   */
+  void compile();
+
+  // Candidate route positions. Lookups usually yield a handful of candidates, which are kept inline
+  // so that matching a request does not allocate.
+  using Positions = absl::InlinedVector<uint32_t, 16>;
+
+  /**
+   * Find the routes whose path criterion may match the request path.
+   * @param path supplies the full :path header value, including any query string.
+   * @param path_only_length supplies the length of the path without the query string.
+   * @param positions supplies the container to fill with candidate route positions. On return it
+   *        is sorted in ascending order.
+   */
+  void candidates(absl::string_view path, size_t path_only_length, Positions& positions) const;
+
+private:
+  struct Routes {
+    std::vector<uint32_t> prefix_routes_;
+    std::vector<uint32_t> path_routes_;
+  };
+
+  static void collect(const RadixTree<Routes>& tree, absl::string_view path,
+                      size_t path_only_length, bool ignore_case, Positions& positions);
+
+  RadixTree<Routes> case_sensitive_routes_;
+  // Keys are stored in lower case.
+  RadixTree<Routes> case_insensitive_routes_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // Maps RE2::Set pattern indexes to route positions.
+  std::vector<uint32_t> regex_routes_;
+  std::vector<uint32_t> unindexed_routes_;
+  bool compiled_{};
+};
+
+using PathMatchIndexPtr = std::unique_ptr<PathMatchIndex>;
+
+} // namespace Router
+} // namespace Envoy
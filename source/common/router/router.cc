@@ -1,5 +1,6 @@
 #include "common/router/router.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -751,6 +752,7 @@ void Filter::onResponseTimeout() {
 
       chargeUpstreamAbort(timeout_response_code_, false, *upstream_request);
     }
+    putResponseTime(*upstream_request, true);
     upstream_request->resetStream();
   }
 
@@ -789,6 +791,8 @@ void Filter::onSoftPerTryTimeout(UpstreamRequest& upstream_request) {
 }
 
 void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
+  // A hedged request may still complete, and then records its actual response time too.
+  putResponseTime(upstream_request, true);
   if (hedging_params_.hedge_on_per_try_timeout_) {
     onSoftPerTryTimeout(upstream_request);
     return;
@@ -816,6 +820,30 @@ void Filter::onPerTryTimeout(UpstreamRequest& upstream_request) {
                          StreamInfo::ResponseCodeDetails::get().UpstreamPerTryTimeout);
 }
 
+void Filter::putResponseTime(UpstreamRequest& upstream_request, bool failed) {
+  if (cluster_->lbType() != Upstream::LoadBalancerType::PeakEwma ||
+      upstream_request.upstream_host_ == nullptr) {
+    return;
+  }
+  // Time spent waiting for the rest of the downstream request is not the host's.
+  MonotonicTime start = upstream_request.start_time_;
+  if (DateUtil::timePointValid(downstream_request_complete_time_)) {
+    start = std::max(start, downstream_request_complete_time_);
+  }
+  const MonotonicTime now = callbacks_->dispatcher().timeSource().monotonicTime();
+  std::chrono::microseconds response_time =
+      std::chrono::duration_cast<std::chrono::microseconds>(now - start);
+  if (failed) {
+    // Otherwise a host which resets requests right away would look fast.
+    const std::chrono::milliseconds timeout = timeout_.per_try_timeout_.count() > 0
+                                                  ? timeout_.per_try_timeout_
+                                                  : timeout_.global_timeout_;
+    response_time =
+        std::max(response_time, std::chrono::duration_cast<std::chrono::microseconds>(timeout));
+  }
+  upstream_request.upstream_host_->responseTimeEstimator().putResponseTime(response_time, now);
+}
+
 void Filter::updateOutlierDetection(Upstream::Outlier::Result result,
                                     UpstreamRequest& upstream_request,
                                     absl::optional<uint64_t> code) {
@@ -916,6 +944,10 @@ void Filter::onUpstreamReset(Http::StreamResetReason reset_reason,
   // config param set to true.
   updateOutlierDetection(Upstream::Outlier::Result::LocalOriginConnectFailed, upstream_request,
                          absl::nullopt);
+  // Requests rejected by the circuit breakers never reached the host.
+  if (reset_reason != Http::StreamResetReason::Overflow) {
+    putResponseTime(upstream_request, true);
+  }
 
   if (maybeRetryReset(reset_reason, upstream_request)) {
     return;
@@ -1214,6 +1246,8 @@ void Filter::onUpstreamComplete(UpstreamRequest& upstream_request) {
   }
   callbacks_->streamInfo().setUpstreamTiming(final_upstream_request_->upstream_timing_);
 
+  putResponseTime(upstream_request, false);
+
   if (config_.emit_dynamic_stats_ && !callbacks_->streamInfo().healthCheck() &&
       DateUtil::timePointValid(downstream_request_complete_time_)) {
     Event::Dispatcher& dispatcher = callbacks_->dispatcher();
@@ -1354,6 +1388,7 @@ uint32_t Filter::numRequestsAwaitingHeaders() {
 Filter::UpstreamRequest::UpstreamRequest(Filter& parent, Http::ConnectionPool::Instance& pool)
     : parent_(parent), conn_pool_(pool), grpc_rq_success_deferred_(false),
       stream_info_(pool.protocol(), parent_.callbacks_->dispatcher().timeSource()),
+      start_time_(parent_.callbacks_->dispatcher().timeSource().monotonicTime()),
       calling_encode_headers_(false), upstream_canary_(false), decode_complete_(false),
       encode_complete_(false), encode_trailers_(false), retried_(false), awaiting_headers_(true),
       outlier_detection_timeout_recorded_(false),
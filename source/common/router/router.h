@@ -469,6 +469,9 @@ private:
     Tracing::SpanPtr span_;
     StreamInfo::StreamInfoImpl stream_info_;
     StreamInfo::UpstreamTiming upstream_timing_;
+    // When the upstream request was created, which is later than the downstream request for
+    // retries and hedged requests.
+    const MonotonicTime start_time_;
     // Copies of upstream headers/trailers. These are only set if upstream
     // access logging is configured.
     Http::HeaderMapPtr upstream_headers_;
@@ -542,6 +545,9 @@ private:
   // TODO(soya3129): Save metadata for retry, redirect and shadowing case.
   bool setupRetry();
   bool setupRedirect(const Http::HeaderMap& headers, UpstreamRequest& upstream_request);
+  // Feeds the response time of the upstream request to the estimator of its host if the cluster
+  // uses the peak EWMA load balancer. Failed requests count as taking at least their timeout.
+  void putResponseTime(UpstreamRequest& upstream_request, bool failed);
   void updateOutlierDetection(Upstream::Outlier::Result result, UpstreamRequest& upstream_request,
                               absl::optional<uint64_t> code);
   void doRetry();
@@ -21,30 +21,36 @@ namespace Envoy {
 namespace Stats {
 
 AllocatorImpl::~AllocatorImpl() {
-  ASSERT(counters_.empty());
-  ASSERT(gauges_.empty());
+  for (const Shard& shard : shards_) {
+    ASSERT(shard.counters_.empty());
+    ASSERT(shard.gauges_.empty());
+  }
 }
 
 void AllocatorImpl::removeCounterFromSet(Counter* counter) {
-  Thread::LockGuard lock(mutex_);
-  const size_t count = counters_.erase(counter->statName());
+  Shard& counter_shard = shard(counter->statName());
+  Thread::LockGuard lock(counter_shard.mutex_);
+  const size_t count = counter_shard.counters_.erase(counter->statName());
   ASSERT(count == 1);
 }
 
 void AllocatorImpl::removeGaugeFromSet(Gauge* gauge) {
-  Thread::LockGuard lock(mutex_);
-  const size_t count = gauges_.erase(gauge->statName());
+  Shard& gauge_shard = shard(gauge->statName());
+  Thread::LockGuard lock(gauge_shard.mutex_);
+  const size_t count = gauge_shard.gauges_.erase(gauge->statName());
   ASSERT(count == 1);
 }
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void AllocatorImpl::debugPrint() {
-  Thread::LockGuard lock(mutex_);
-  for (Counter* counter : counters_) {
-    ENVOY_LOG_MISC(info, "counter: {}", symbolTable().toString(counter->statName()));
-  }
-  for (Gauge* gauge : gauges_) {
-    ENVOY_LOG_MISC(info, "gauge: {}", symbolTable().toString(gauge->statName()));
+  for (Shard& shard : shards_) {
+    Thread::LockGuard lock(shard.mutex_);
+    for (Counter* counter : shard.counters_) {
+      ENVOY_LOG_MISC(info, "counter: {}", symbolTable().toString(counter->statName()));
+    }
+    for (Gauge* gauge : shard.gauges_) {
+      ENVOY_LOG_MISC(info, "gauge: {}", symbolTable().toString(gauge->statName()));
+    }
   }
 }
 #endif
@@ -142,20 +148,26 @@ public:
   // Stats::Gauge
   void add(uint64_t amount) override {
     value_ += amount;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void dec() override { sub(1); }
   void inc() override { add(1); }
   void set(uint64_t value) override {
     value_ = value;
-    flags_ |= Flags::Used;
+    flags_ |= Flags::Used | Flags::Changed;
   }
   void sub(uint64_t amount) override {
     ASSERT(value_ >= amount);
     ASSERT(used() || amount == 0);
     value_ -= amount;
+    // Gauges are mostly decremented when they have already changed during the flush interval, so
+    // check the flag first to avoid another atomic read-modify-write in that case.
+    if (!(flags_ & Flags::Changed)) {
+      flags_ |= Flags::Changed;
+    }
   }
   uint64_t value() const override { return value_; }
+  bool latchChanged() override { return flags_.fetch_and(~Flags::Changed) & Flags::Changed; }
 
   ImportMode importMode() const override {
     if (flags_ & Flags::NeverImport) {
@@ -196,28 +208,30 @@ public:
 
 CounterSharedPtr AllocatorImpl::makeCounter(StatName name, absl::string_view tag_extracted_name,
                                             const std::vector<Tag>& tags) {
-  Thread::LockGuard lock(mutex_);
-  ASSERT(gauges_.find(name) == gauges_.end());
-  auto iter = counters_.find(name);
-  if (iter != counters_.end()) {
+  Shard& counter_shard = shard(name);
+  Thread::LockGuard lock(counter_shard.mutex_);
+  ASSERT(counter_shard.gauges_.find(name) == counter_shard.gauges_.end());
+  auto iter = counter_shard.counters_.find(name);
+  if (iter != counter_shard.counters_.end()) {
     return CounterSharedPtr(*iter);
   }
   auto counter = CounterSharedPtr(new CounterImpl(name, *this, tag_extracted_name, tags));
-  counters_.insert(counter.get());
+  counter_shard.counters_.insert(counter.get());
   return counter;
 }
 
 GaugeSharedPtr AllocatorImpl::makeGauge(StatName name, absl::string_view tag_extracted_name,
                                         const std::vector<Tag>& tags,
                                         Gauge::ImportMode import_mode) {
-  Thread::LockGuard lock(mutex_);
-  ASSERT(counters_.find(name) == counters_.end());
-  auto iter = gauges_.find(name);
-  if (iter != gauges_.end()) {
+  Shard& gauge_shard = shard(name);
+  Thread::LockGuard lock(gauge_shard.mutex_);
+  ASSERT(gauge_shard.counters_.find(name) == gauge_shard.counters_.end());
+  auto iter = gauge_shard.gauges_.find(name);
+  if (iter != gauge_shard.gauges_.end()) {
     return GaugeSharedPtr(*iter);
   }
   auto gauge = GaugeSharedPtr(new GaugeImpl(name, *this, tag_extracted_name, tags, import_mode));
-  gauges_.insert(gauge.get());
+  gauge_shard.gauges_.insert(gauge.get());
   return gauge;
 }
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "envoy/stats/allocator.h"
@@ -54,16 +55,27 @@ private:
   // StatNamePtr's own StatNamePtrHash and StatNamePtrCompare operators.
   template <class StatType>
   using StatSet = absl::flat_hash_set<StatType*, HeapStatHash, HeapStatCompare>;
-  StatSet<Counter> counters_ GUARDED_BY(mutex_);
-  StatSet<Gauge> gauges_ GUARDED_BY(mutex_);
 
-  SymbolTable& symbol_table_;
+  // The stats are spread over shards by the hash of their names, each with its own lock, so that
+  // threads allocating or freeing different stats rarely contend.
+  struct Shard {
+    // A mutex is needed here to protect the sets from both alloc() and free() operations. alloc()
+    // operations are called from any thread creating a stat, and free() operations are made from
+    // the destructors of the individual stat objects, which are not protected by locks.
+    Thread::MutexBasicLockable mutex_;
+    StatSet<Counter> counters_ GUARDED_BY(mutex_);
+    StatSet<Gauge> gauges_ GUARDED_BY(mutex_);
+  };
+
+  static constexpr size_t NumShards = 16;
 
-  // A mutex is needed here to protect both the stats_ object from both
-  // alloc() and free() operations. Although alloc() operations are called under existing locking,
-  // free() operations are made from the destructors of the individual stat objects, which are not
-  // protected by locks.
-  Thread::MutexBasicLockable mutex_;
+  Shard& shard(StatName name) {
+    // The sets hash the low bits of the name hash, so the shard is picked from the high bits.
+    return shards_[(name.hash() >> 32) % NumShards];
+  }
+
+  std::array<Shard, NumShards> shards_;
+  SymbolTable& symbol_table_;
 };
 
 } // namespace Stats
@@ -19,6 +19,7 @@
 #include "common/common/utility.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
 
@@ -115,6 +116,13 @@ public:
     }
     return encodeHelper(absl::StrJoin(strings, "."));
   }
+  bool startsWith(StatName stat_name, StatName prefix) const override {
+    const absl::string_view name = toStringView(stat_name);
+    const absl::string_view prefix_str = toStringView(prefix);
+    return prefix_str.empty() ||
+           (absl::StartsWith(name, prefix_str) &&
+            (name.size() == prefix_str.size() || name[prefix_str.size()] == '.'));
+  }
 
 #ifndef ENVOY_CONFIG_COVERAGE
   void debugPrint() const override {}
@@ -359,6 +359,14 @@ bool SymbolTableImpl::lessThan(const StatName& a, const StatName& b) const {
   return av.size() < bv.size();
 }
 
+bool SymbolTableImpl::startsWith(StatName stat_name, StatName prefix) const {
+  // Symbols are encoded with a prefix-free variable length encoding, so a byte prefix that is a
+  // complete encoding of the prefix symbols is also a prefix of the symbols of the stat name.
+  const uint64_t prefix_size = prefix.dataSize();
+  return prefix_size <= stat_name.dataSize() &&
+         memcmp(stat_name.data(), prefix.data(), prefix_size) == 0;
+}
+
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTableImpl::debugPrint() const {
   Thread::LockGuard lock(lock_);
@@ -1,5 +1,6 @@
 #include "common/stats/tag_producer_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -7,9 +8,23 @@
 #include "common/common/utility.h"
 #include "common/stats/tag_extractor_impl.h"
 
+#include "absl/strings/str_replace.h"
+
 namespace Envoy {
 namespace Stats {
 
+namespace {
+
+// Rewrites a tag extractor regex for RE2::Set, which then matches a superset of the stat names
+// the regex matches. The default regexes use the lookahead assertion "(?=\.)", which RE2 does not
+// support, and which only restricts the matches, so it is dropped. RE2 refuses any other
+// unsupported syntax, in which case the extractor falls back to its own regex.
+std::string setRegex(absl::string_view regex) {
+  return absl::StrReplaceAll(regex, {{"(?=\\.)", ""}});
+}
+
+} // namespace
+
 TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v2::StatsConfig& config) {
   // To check name conflict.
   reserveResources(config);
@@ -32,13 +47,16 @@ TagProducerImpl::TagProducerImpl(const envoy::config::metrics::v2::StatsConfig&
               "No regex specified for tag specifier and no default regex for name: '{}'", name));
         }
       } else {
-        addExtractor(Stats::TagExtractorImpl::createTagExtractor(name, tag_specifier.regex()));
+        addExtractor(Stats::TagExtractorImpl::createTagExtractor(name, tag_specifier.regex()),
+                     tag_specifier.regex());
       }
     } else if (tag_specifier.tag_value_case() ==
                envoy::config::metrics::v2::TagSpecifier::kFixedValue) {
       default_tags_.emplace_back(Stats::Tag{name, tag_specifier.fixed_value()});
     }
   }
+
+  compileExtractors();
 }
 
 int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
@@ -46,38 +64,83 @@ int TagProducerImpl::addExtractorsMatching(absl::string_view name) {
   for (const auto& desc : Config::TagNames::get().descriptorVec()) {
     if (desc.name_ == name) {
       addExtractor(
-          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_),
+          desc.regex_);
       ++num_found;
     }
   }
   return num_found;
 }
 
-void TagProducerImpl::addExtractor(TagExtractorPtr extractor) {
-  const absl::string_view prefix = extractor->prefixToken();
-  if (prefix.empty()) {
-    tag_extractors_without_prefix_.emplace_back(std::move(extractor));
-  } else {
-    tag_extractor_prefix_map_[prefix].emplace_back(std::move(extractor));
+void TagProducerImpl::addExtractor(TagExtractorPtr extractor, const std::string& regex) {
+  pending_extractors_.push_back({std::move(extractor), regex});
+}
+
+void TagProducerImpl::compileExtractors() {
+  std::stable_partition(pending_extractors_.begin(), pending_extractors_.end(),
+                        [](const ExtractorEntry& entry) -> bool {
+                          return entry.extractor_->prefixToken().empty();
+                        });
+
+  re2::RE2::Options options;
+  // Stat names are matched byte by byte, like std::regex does, rather than as UTF-8.
+  options.set_encoding(re2::RE2::Options::EncodingLatin1);
+  options.set_log_errors(false);
+  extractor_set_ = std::make_unique<re2::RE2::Set>(options, re2::RE2::UNANCHORED);
+  tag_extractors_.reserve(pending_extractors_.size());
+  for (ExtractorEntry& entry : pending_extractors_) {
+    const uint32_t index = tag_extractors_.size();
+    if (extractor_set_->Add(setRegex(entry.regex_), nullptr) < 0) {
+      fallback_extractors_.push_back(index);
+    } else {
+      set_extractors_.push_back(index);
+    }
+    tag_extractors_.emplace_back(std::move(entry.extractor_));
+  }
+  pending_extractors_.clear();
+
+  if (set_extractors_.empty() || !extractor_set_->Compile()) {
+    fallback_extractors_.insert(fallback_extractors_.end(), set_extractors_.begin(),
+                                set_extractors_.end());
+    std::sort(fallback_extractors_.begin(), fallback_extractors_.end());
+    set_extractors_.clear();
+    extractor_set_.reset();
   }
 }
 
 void TagProducerImpl::forEachExtractorMatching(
     absl::string_view stat_name, std::function<void(const TagExtractorPtr&)> f) const {
-  IntervalSetImpl<size_t> remove_characters;
-  for (const TagExtractorPtr& tag_extractor : tag_extractors_without_prefix_) {
-    f(tag_extractor);
+  std::vector<uint32_t> indices;
+  if (extractor_set_ != nullptr) {
+    std::vector<int> matches;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (extractor_set_->Match(re2::StringPiece(stat_name.data(), stat_name.size()), &matches,
+                              &error_info)) {
+      for (const int match : matches) {
+        indices.push_back(set_extractors_[match]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // The DFA gave up (e.g. it ran out of memory). Fall back to trying every extractor.
+      indices.insert(indices.end(), set_extractors_.begin(), set_extractors_.end());
+    }
   }
-  const absl::string_view::size_type dot = stat_name.find('.');
-  if (dot != std::string::npos) {
-    const absl::string_view token = absl::string_view(stat_name.data(), dot);
-    const auto iter = tag_extractor_prefix_map_.find(token);
-    if (iter != tag_extractor_prefix_map_.end()) {
-      for (const TagExtractorPtr& tag_extractor : iter->second) {
-        f(tag_extractor);
+
+  if (!fallback_extractors_.empty()) {
+    const absl::string_view::size_type dot = stat_name.find('.');
+    const absl::string_view token =
+        dot == absl::string_view::npos ? absl::string_view() : stat_name.substr(0, dot);
+    for (const uint32_t index : fallback_extractors_) {
+      const absl::string_view prefix = tag_extractors_[index]->prefixToken();
+      if (prefix.empty() || prefix == token) {
+        indices.push_back(index);
       }
     }
   }
+
+  std::sort(indices.begin(), indices.end());
+  for (const uint32_t index : indices) {
+    f(tag_extractors_[index]);
+  }
 }
 
 std::string TagProducerImpl::produceTags(absl::string_view metric_name,
@@ -102,7 +165,8 @@ TagProducerImpl::addDefaultExtractors(const envoy::config::metrics::v2::StatsCon
     for (const auto& desc : Config::TagNames::get().descriptorVec()) {
       names.emplace(desc.name_);
       addExtractor(
-          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+          Stats::TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_),
+          desc.regex_);
     }
   }
   return names;
@@ -17,15 +17,17 @@
 #include "common/config/well_known_names.h"
 #include "common/protobuf/protobuf.h"
 
-#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "re2/set.h"
 
 namespace Envoy {
 namespace Stats {
 
 /**
  * Organizes a collection of TagExtractors so that stat-names can be processed without
- * iterating through all extractors.
+ * iterating through all extractors. The regexes of all the extractors are compiled into a
+ * single RE2::Set, which finds the extractors matching a stat-name in one scan. Only those
+ * extractors then run their own regexes, to extract the tag values out of their capture groups.
  */
 class TagProducerImpl : public TagProducer {
 public:
@@ -44,11 +46,18 @@ private:
   friend class DefaultTagRegexTester;
 
   /**
-   * Adds a TagExtractor to the collection of tags, tracking prefixes to help make
-   * produceTags run efficiently by trying only extractors that have a chance to match.
+   * Adds a TagExtractor to the collection of tags. The extractor is not applied to stat-names
+   * until compileExtractors() has been called.
    * @param extractor TagExtractorPtr the extractor to add.
+   * @param regex const std::string& the regex the extractor was created from.
    */
-  void addExtractor(TagExtractorPtr extractor);
+  void addExtractor(TagExtractorPtr extractor, const std::string& regex);
+
+  /**
+   * Compiles the regexes of all added extractors into extractor_set_. Extractors whose regexes
+   * RE2 cannot parse are tried on every stat-name whose first token matches their prefix.
+   */
+  void compileExtractors();
 
   /**
    * Adds all default extractors matching the specified tag name. In this model,
@@ -81,10 +90,13 @@ private:
    * callback f for each one. This is broken out this way to reduce code redundancy
    * during testing, where we want to verify that extraction is order-independent.
    * The possibly-matching-extractors list is computed by:
-   *   1. Finding the first '.' separated token in stat_name.
-   *   2. Collecting the TagExtractors whose regexes have that same prefix "^prefix\\."
-   *   3. Collecting also the TagExtractors whose regexes don't start with any prefix.
-   * In the future, we may also do substring searches in some cases.
+   *   1. Matching stat_name against extractor_set_, which yields the TagExtractors whose
+   *      regexes, with lookahead assertions removed, match stat_name.
+   *   2. Collecting also the TagExtractors which could not be compiled into extractor_set_,
+   *      and whose regexes either have the prefix "^prefix\\." of the first '.' separated
+   *      token in stat_name, or don't start with any prefix.
+   * The extractors are visited in the order in which they were added, the ones without a
+   * prefix first.
    * See DefaultTagRegexTester::produceTagsReverse in test/common/stats/stats_impl_test.cc.
    *
    * @param stat_name const std::string& the stat name.
@@ -93,12 +105,22 @@ private:
   void forEachExtractorMatching(absl::string_view stat_name,
                                 std::function<void(const TagExtractorPtr&)> f) const;
 
-  std::vector<TagExtractorPtr> tag_extractors_without_prefix_;
-
-  // Maps a prefix word extracted out of a regex to a vector of TagExtractors. Note that
-  // the storage for the prefix string is owned by the TagExtractor, which, depending on
-  // implementation, may need make a copy of the prefix.
-  absl::flat_hash_map<absl::string_view, std::vector<TagExtractorPtr>> tag_extractor_prefix_map_;
+  struct ExtractorEntry {
+    TagExtractorPtr extractor_;
+    std::string regex_;
+  };
+
+  // The extractors and their regexes until they are compiled.
+  std::vector<ExtractorEntry> pending_extractors_;
+
+  // All the extractors, the ones without a prefix first. The indices in set_extractors_ and
+  // fallback_extractors_ refer to this vector.
+  std::vector<TagExtractorPtr> tag_extractors_;
+  std::unique_ptr<re2::RE2::Set> extractor_set_;
+  // Maps the indices of the regexes in extractor_set_ to indices in tag_extractors_.
+  std::vector<uint32_t> set_extractors_;
+  // Indices of the extractors which are not in extractor_set_.
+  std::vector<uint32_t> fallback_extractors_;
   std::vector<Tag> default_tags_;
 };
 
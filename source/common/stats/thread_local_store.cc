@@ -49,6 +49,7 @@ void ThreadLocalStoreImpl::setStatsMatcher(StatsMatcherPtr&& stats_matcher) {
   // be no copies in TLS caches.
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
+    Thread::LockGuard scope_lock(scope->central_cache_.lock_);
     removeRejectedStats(scope->central_cache_.counters_, deleted_counters_);
     removeRejectedStats(scope->central_cache_.gauges_, deleted_gauges_);
     removeRejectedStats(scope->central_cache_.histograms_, deleted_histograms_);
@@ -95,6 +96,7 @@ std::vector<CounterSharedPtr> ThreadLocalStoreImpl::counters() const {
   StatNameHashSet names;
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
+    Thread::LockGuard scope_lock(scope->central_cache_.lock_);
     for (auto& counter : scope->central_cache_.counters_) {
       if (names.insert(counter.first).second) {
         ret.push_back(counter.second);
@@ -118,6 +120,7 @@ std::vector<GaugeSharedPtr> ThreadLocalStoreImpl::gauges() const {
   StatNameHashSet names;
   Thread::LockGuard lock(lock_);
   for (ScopeImpl* scope : scopes_) {
+    Thread::LockGuard scope_lock(scope->central_cache_.lock_);
     for (auto& gauge_iter : scope->central_cache_.gauges_) {
       const GaugeSharedPtr& gauge = gauge_iter.second;
       if (gauge->importMode() != Gauge::ImportMode::Uninitialized &&
@@ -139,6 +142,7 @@ std::vector<ParentHistogramSharedPtr> ThreadLocalStoreImpl::histograms() const {
   // in histograms with duplicate names, but until shared storage is implemented it's ultimately
   // less confusing for users who have such configs.
   for (ScopeImpl* scope : scopes_) {
+    Thread::LockGuard scope_lock(scope->central_cache_.lock_);
     for (const auto& name_histogram_pair : scope->central_cache_.histograms_) {
       const ParentHistogramSharedPtr& parent_hist = name_histogram_pair.second;
       ret.push_back(parent_hist);
@@ -208,7 +212,10 @@ void ThreadLocalStoreImpl::releaseScopeCrossThread(ScopeImpl* scope) {
   //
   // We use a raw pointer here as it's easier to capture it in the lambda.
   auto rejected_stats = new StatNameStorageSet;
-  rejected_stats->swap(scope->central_cache_.rejected_stats_);
+  {
+    Thread::LockGuard scope_lock(scope->central_cache_.lock_);
+    rejected_stats->swap(scope->central_cache_.rejected_stats_);
+  }
 
   // This can happen from any thread. We post() back to the main thread which will initiate the
   // cache flush operation.
@@ -285,38 +292,44 @@ private:
 };
 
 bool ThreadLocalStoreImpl::checkAndRememberRejection(StatName name,
-                                                     StatNameStorageSet& central_rejected_stats,
+                                                     CentralCacheEntry& central_cache,
                                                      StatNameHashSet* tls_rejected_stats) {
   if (stats_matcher_->acceptsAll()) {
     return false;
   }
 
-  auto iter = central_rejected_stats.find(name);
-  const StatNameStorage* rejected_name = nullptr;
-  if (iter != central_rejected_stats.end()) {
-    rejected_name = &(*iter);
-  } else {
-    if (rejects(name)) {
-      auto insertion = central_rejected_stats.insert(StatNameStorage(name, symbolTable()));
-      const StatNameStorage& rejected_name_ref = *(insertion.first);
-      rejected_name = &rejected_name_ref;
+  {
+    Thread::LockGuard lock(central_cache.lock_);
+    auto iter = central_cache.rejected_stats_.find(name);
+    if (iter != central_cache.rejected_stats_.end()) {
+      if (tls_rejected_stats != nullptr) {
+        tls_rejected_stats->insert(iter->statName());
+      }
+      return true;
     }
   }
-  if (rejected_name != nullptr) {
-    if (tls_rejected_stats != nullptr) {
-      tls_rejected_stats->insert(rejected_name->statName());
-    }
-    return true;
+
+  // The matcher elaborates the name, so it runs without holding the lock.
+  if (!rejects(name)) {
+    return false;
   }
-  return false;
+
+  Thread::LockGuard lock(central_cache.lock_);
+  auto iter = central_cache.rejected_stats_.find(name);
+  if (iter == central_cache.rejected_stats_.end()) {
+    iter = central_cache.rejected_stats_.insert(StatNameStorage(name, symbolTable())).first;
+  }
+  if (tls_rejected_stats != nullptr) {
+    tls_rejected_stats->insert(iter->statName());
+  }
+  return true;
 }
 
 template <class StatType>
 StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
     StatName name, StatMap<RefcountPtr<StatType>>& central_cache_map,
-    StatNameStorageSet& central_rejected_stats, MakeStatFn<StatType> make_stat,
-    StatMap<RefcountPtr<StatType>>* tls_cache, StatNameHashSet* tls_rejected_stats,
-    StatType& null_stat) {
+    MakeStatFn<StatType> make_stat, StatMap<RefcountPtr<StatType>>* tls_cache,
+    StatNameHashSet* tls_rejected_stats, StatType& null_stat) {
 
   if (tls_rejected_stats != nullptr &&
       tls_rejected_stats->find(name) != tls_rejected_stats->end()) {
@@ -331,32 +344,40 @@ StatType& ThreadLocalStoreImpl::ScopeImpl::safeMakeStat(
     }
   }
 
-  // We must now look in the central store so we must be locked. We grab a reference to the
-  // central store location. It might contain nothing. In this case, we allocate a new stat.
-  Thread::LockGuard lock(parent_.lock_);
-  auto iter = central_cache_map.find(name);
-  RefcountPtr<StatType>* central_ref = nullptr;
-  if (iter != central_cache_map.end()) {
-    central_ref = &(iter->second);
-  } else if (parent_.checkAndRememberRejection(name, central_rejected_stats, tls_rejected_stats)) {
+  // We must now look in the central store, which we must lock for that. It might not contain the
+  // stat, in which case we allocate a new one.
+  RefcountPtr<StatType> stat;
+  {
+    Thread::LockGuard lock(central_cache_.lock_);
+    auto iter = central_cache_map.find(name);
+    if (iter != central_cache_map.end()) {
+      stat = iter->second;
+    }
+  }
+
+  if (stat == nullptr) {
     // Note that again we do the name-rejection lookup on the untruncated name.
-    return null_stat;
-  } else {
+    if (parent_.checkAndRememberRejection(name, central_cache_, tls_rejected_stats)) {
+      return null_stat;
+    }
+
+    // Other threads may create the same stat meanwhile. The allocator hands out a single stat
+    // per name, and the first stat inserted into the central store is kept.
     TagExtraction extraction(parent_, name);
-    RefcountPtr<StatType> stat =
+    RefcountPtr<StatType> new_stat =
         make_stat(parent_.alloc_, name, extraction.tagExtractedName(), extraction.tags());
-    ASSERT(stat != nullptr);
-    central_ref = &central_cache_map[stat->statName()];
-    *central_ref = stat;
+    ASSERT(new_stat != nullptr);
+    Thread::LockGuard lock(central_cache_.lock_);
+    stat = central_cache_map.emplace(new_stat->statName(), new_stat).first->second;
   }
 
   // If we have a TLS cache, insert the stat.
   if (tls_cache) {
-    tls_cache->insert(std::make_pair((*central_ref)->statName(), *central_ref));
+    tls_cache->insert(std::make_pair(stat->statName(), stat));
   }
 
-  // Finally we return the reference.
-  return **central_ref;
+  // Finally we return the reference, which the central store keeps alive.
+  return *stat;
 }
 
 template <class StatType>
@@ -399,7 +420,7 @@ Counter& ThreadLocalStoreImpl::ScopeImpl::counterFromStatName(StatName name) {
   }
 
   return safeMakeStat<Counter>(
-      final_stat_name, central_cache_.counters_, central_cache_.rejected_stats_,
+      final_stat_name, central_cache_.counters_,
       [](Allocator& allocator, StatName name, absl::string_view tag_extracted_name,
          const std::vector<Tag>& tags) -> CounterSharedPtr {
         return allocator.makeCounter(name, tag_extracted_name, tags);
@@ -449,7 +470,7 @@ Gauge& ThreadLocalStoreImpl::ScopeImpl::gaugeFromStatName(StatName name,
   }
 
   Gauge& gauge = safeMakeStat<Gauge>(
-      final_stat_name, central_cache_.gauges_, central_cache_.rejected_stats_,
+      final_stat_name, central_cache_.gauges_,
       [import_mode](Allocator& allocator, StatName name, absl::string_view tag_extracted_name,
                     const std::vector<Tag>& tags) -> GaugeSharedPtr {
         return allocator.makeGauge(name, tag_extracted_name, tags, import_mode);
@@ -491,38 +512,46 @@ Histogram& ThreadLocalStoreImpl::ScopeImpl::histogramFromStatName(StatName name,
     }
   }
 
-  Thread::LockGuard lock(parent_.lock_);
-  auto iter = central_cache_.histograms_.find(final_stat_name);
-  ParentHistogramImplSharedPtr* central_ref = nullptr;
-  if (iter != central_cache_.histograms_.end()) {
-    central_ref = &iter->second;
-  } else if (parent_.checkAndRememberRejection(final_stat_name, central_cache_.rejected_stats_,
-                                               tls_rejected_stats)) {
-    return parent_.null_histogram_;
-  } else {
-    TagExtraction extraction(parent_, final_stat_name);
+  // See comments in safeMakeStat(), which this follows.
+  ParentHistogramImplSharedPtr stat;
+  {
+    Thread::LockGuard lock(central_cache_.lock_);
+    auto iter = central_cache_.histograms_.find(final_stat_name);
+    if (iter != central_cache_.histograms_.end()) {
+      stat = iter->second;
+    }
+  }
 
-    RefcountPtr<ParentHistogramImpl> stat(new ParentHistogramImpl(
+  if (stat == nullptr) {
+    if (parent_.checkAndRememberRejection(final_stat_name, central_cache_, tls_rejected_stats)) {
+      return parent_.null_histogram_;
+    }
+
+    TagExtraction extraction(parent_, final_stat_name);
+    RefcountPtr<ParentHistogramImpl> new_stat(new ParentHistogramImpl(
         final_stat_name, unit, parent_, *this, extraction.tagExtractedName(), extraction.tags()));
-    central_ref = &central_cache_.histograms_[stat->statName()];
-    *central_ref = stat;
+    Thread::LockGuard lock(central_cache_.lock_);
+    stat = central_cache_.histograms_.emplace(new_stat->statName(), new_stat).first->second;
   }
 
   if (tls_cache != nullptr) {
-    tls_cache->insert(std::make_pair((*central_ref)->statName(), *central_ref));
+    tls_cache->insert(std::make_pair(stat->statName(), stat));
   }
-  return **central_ref;
+  return *stat;
 }
 
 OptionalCounter ThreadLocalStoreImpl::ScopeImpl::findCounter(StatName name) const {
+  Thread::LockGuard lock(central_cache_.lock_);
   return findStatLockHeld<Counter>(name, central_cache_.counters_);
 }
 
 OptionalGauge ThreadLocalStoreImpl::ScopeImpl::findGauge(StatName name) const {
+  Thread::LockGuard lock(central_cache_.lock_);
   return findStatLockHeld<Gauge>(name, central_cache_.gauges_);
 }
 
 OptionalHistogram ThreadLocalStoreImpl::ScopeImpl::findHistogram(StatName name) const {
+  Thread::LockGuard lock(central_cache_.lock_);
   auto iter = central_cache_.histograms_.find(name);
   if (iter == central_cache_.histograms_.end()) {
     return absl::nullopt;
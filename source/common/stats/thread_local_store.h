@@ -246,7 +246,12 @@ private:
     StatNameHashSet rejected_stats_;
   };
 
+  // Each scope has a lock of its own for its central cache, which is only held to look up and
+  // insert stats. Threads which miss their TLS caches extract the tags of new stats, match them
+  // against the stats matcher and allocate them without holding it, so that creating stats
+  // neither serializes all threads on the store nor on the expensive parts of the creation.
   struct CentralCacheEntry {
+    mutable Thread::MutexBasicLockable lock_;
     StatMap<CounterSharedPtr> counters_;
     StatMap<GaugeSharedPtr> gauges_;
     StatMap<ParentHistogramImplSharedPtr> histograms_;
@@ -298,7 +303,9 @@ private:
     /**
      * Makes a stat either by looking it up in the central cache,
      * generating it from the parent allocator, or as a last
-     * result, creating it with the heap allocator.
+     * result, creating it with the heap allocator. The stat is created
+     * without holding the lock of the central cache, so concurrent
+     * creations of the same stat race to insert it, and the first one wins.
      *
      * @param name the full name of the stat (not tag extracted).
      * @param central_cache_map a map from name to the desired object in the central cache.
@@ -308,7 +315,6 @@ private:
      */
     template <class StatType>
     StatType& safeMakeStat(StatName name, StatMap<RefcountPtr<StatType>>& central_cache_map,
-                           StatNameStorageSet& central_rejected_stats,
                            MakeStatFn<StatType> make_stat,
                            StatMap<RefcountPtr<StatType>>* tls_cache,
                            StatNameHashSet* tls_rejected_stats, StatType& null_stat);
@@ -316,7 +322,7 @@ private:
     /**
      * Looks up an existing stat, populating the local cache if necessary. Does
      * not check the TLS or rejects, and does not create a stat if it does not
-     * exist.
+     * exist. The lock of central_cache_ must be held.
      *
      * @param name the full name of the stat (not tag extracted).
      * @param central_cache_map a map from name to the desired object in the central cache.
@@ -324,7 +330,8 @@ private:
      */
     template <class StatType>
     absl::optional<std::reference_wrapper<const StatType>>
-    findStatLockHeld(StatName name, StatMap<RefcountPtr<StatType>>& central_cache_map) const;
+    findStatLockHeld(StatName name, StatMap<RefcountPtr<StatType>>& central_cache_map) const
+        EXCLUSIVE_LOCKS_REQUIRED(central_cache_.lock_);
 
     void extractTagsAndTruncate(StatName& name,
                                 std::unique_ptr<StatNameManagedStorage>& truncated_name_storage,
@@ -357,12 +364,14 @@ private:
   bool rejectsAll() const { return stats_matcher_->rejectsAll(); }
   template <class StatMapClass, class StatListClass>
   void removeRejectedStats(StatMapClass& map, StatListClass& list);
-  bool checkAndRememberRejection(StatName name, StatNameStorageSet& central_rejected_stats,
+  bool checkAndRememberRejection(StatName name, CentralCacheEntry& central_cache,
                                  StatNameHashSet* tls_rejected_stats);
 
   Allocator& alloc_;
   Event::Dispatcher* main_thread_dispatcher_{};
   ThreadLocal::SlotPtr tls_;
+  // Guards the set of scopes. When both are needed, it is taken before the lock of the central
+  // cache of a scope.
   mutable Thread::MutexBasicLockable lock_;
   absl::flat_hash_set<ScopeImpl*> scopes_ GUARDED_BY(lock_);
   ScopePtr default_scope_;
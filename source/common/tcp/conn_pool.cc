@@ -1,5 +1,7 @@
 #include "common/tcp/conn_pool.h"
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -60,6 +62,10 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 
 void ConnPoolImpl::assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks) {
   ASSERT(conn.wrapper_ == nullptr);
+  if (conn.prefetched_) {
+    host_->cluster().stats().upstream_cx_prefetch_used_.inc();
+    conn.prefetched_ = false;
+  }
   conn.wrapper_ = std::make_shared<ConnectionWrapper>(conn);
 
   callbacks.onPoolReady(std::make_unique<ConnectionDataImpl>(conn.wrapper_),
@@ -85,11 +91,33 @@ void ConnPoolImpl::createNewConnection() {
   conn->moveIntoList(std::move(conn), pending_conns_);
 }
 
+void ConnPoolImpl::prefetchConnections() {
+  const float ratio = host_->cluster().perUpstreamPrefetchRatio();
+  const uint64_t min_warm = host_->cluster().perUpstreamMinWarmConnections();
+  if ((ratio <= 1.0 && min_warm == 0) || !drained_callbacks_.empty()) {
+    return;
+  }
+
+  // Keep enough connections, whether connecting or connected, to serve the assigned and pending
+  // requests times the prefetch ratio, so that the next requests of a burst find a connection
+  // ready. The warm reserve covers the first requests of a burst after the pool has been idle.
+  const uint64_t requests = busy_conns_.size() + pending_requests_.size();
+  const uint64_t target = std::max(static_cast<uint64_t>(std::ceil(requests * ratio)), min_warm);
+  while (pending_conns_.size() + ready_conns_.size() + busy_conns_.size() < target &&
+         host_->cluster().resourceManager(priority_).connections().canCreate()) {
+    ENVOY_LOG(debug, "prefetching a connection");
+    createNewConnection();
+    pending_conns_.front()->prefetched_ = true;
+    host_->cluster().stats().upstream_cx_prefetch_total_.inc();
+  }
+}
+
 ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbacks& callbacks) {
   if (!ready_conns_.empty()) {
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
     assignConnection(*busy_conns_.front(), callbacks);
+    prefetchConnections();
     return nullptr;
   }
 
@@ -109,7 +137,9 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
-    return pending_requests_.front().get();
+    ConnectionPool::Cancellable* cancellable = pending_requests_.front().get();
+    prefetchConnections();
+    return cancellable;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
@@ -127,6 +157,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
 
     ActiveConnPtr removed;
     bool check_for_drained = true;
+    bool connect_failure = false;
     if (conn.wrapper_ != nullptr) {
       if (!conn.wrapper_->released_) {
         Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -144,6 +175,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
       // The only time this happens is if we actually saw a connect failure.
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
+      connect_failure = true;
       removed = conn.removeFromList(pending_conns_);
 
       // Raw connect failures should never happen under normal circumstances. If we have an upstream
@@ -179,6 +211,12 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
       createNewConnection();
     }
 
+    // Replace connections of the warm reserve which the upstream closed. Connect failures and
+    // local closes, such as the ones of the pool's destructor, are not retried here.
+    if (event == Network::ConnectionEvent::RemoteClose && !connect_failure) {
+      prefetchConnections();
+    }
+
     if (check_for_drained) {
       checkForDrained();
     }
@@ -388,6 +426,9 @@ ConnPoolImpl::ActiveConn::~ActiveConn() {
   if (wrapper_) {
     wrapper_->invalidate();
   }
+  if (prefetched_) {
+    parent_.host_->cluster().stats().upstream_cx_prefetch_wasted_.inc();
+  }
 
   parent_.host_->cluster().stats().upstream_cx_active_.dec();
   parent_.host_->stats().cx_active_.dec();
@@ -116,6 +116,8 @@ protected:
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
     bool timed_out_;
+    // Whether the connection was prefetched and has not been assigned yet.
+    bool prefetched_{};
   };
 
   using ActiveConnPtr = std::unique_ptr<ActiveConn>;
@@ -142,6 +144,7 @@ protected:
   virtual void onConnReleased(ActiveConn& conn);
   virtual void onConnDestroyed(ActiveConn& conn);
   void onUpstreamReady();
+  void prefetchConnections();
   void processIdleConnection(ActiveConn& conn, bool new_connection, bool delay);
   void checkForDrained();
 
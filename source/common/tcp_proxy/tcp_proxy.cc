@@ -72,7 +72,7 @@ Config::Config(const envoy::config::filter::network::tcp_proxy::v2::TcpProxy& co
     : max_connect_attempts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_connect_attempts, 1)),
       upstream_drain_manager_slot_(context.threadLocal().allocateSlot()),
       shared_config_(std::make_shared<SharedConfig>(config, context)),
-      random_generator_(context.random()) {
+      random_generator_(context.random()), enable_splice_(config.enable_splice()) {
 
   upstream_drain_manager_slot_->set([](Event::Dispatcher&) {
     return ThreadLocal::ThreadLocalObjectSharedPtr(new UpstreamDrainManager());
@@ -468,6 +468,11 @@ Network::FilterStatus Filter::onData(Buffer::Instance& data, bool end_stream) {
 }
 
 void Filter::onDownstreamEvent(Network::ConnectionEvent event) {
+  if (event == Network::ConnectionEvent::RemoteClose ||
+      event == Network::ConnectionEvent::LocalClose) {
+    stopSplicing();
+  }
+
   if (upstream_conn_data_) {
     if (event == Network::ConnectionEvent::RemoteClose) {
       upstream_conn_data_->connection().close(Network::ConnectionCloseType::FlushWrite);
@@ -516,6 +521,7 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
 
   if (event == Network::ConnectionEvent::RemoteClose ||
       event == Network::ConnectionEvent::LocalClose) {
+    stopSplicing();
     upstream_conn_data_.reset();
     disableIdleTimer();
 
@@ -557,7 +563,110 @@ void Filter::onUpstreamEvent(Network::ConnectionEvent event) {
             upstream_callbacks->onBytesSent();
           });
     }
+
+    maybeStartSplicing();
+  }
+}
+
+void Filter::maybeStartSplicing() {
+  if (!config_->spliceEnabled()) {
+    return;
+  }
+
+  Network::Connection& downstream = read_callbacks_->connection();
+  Network::Connection& upstream = upstream_conn_data_->connection();
+  if (!downstream.canBypassTransportSocket() || !upstream.canBypassTransportSocket()) {
+    ENVOY_CONN_LOG(debug, "unable to splice, proxying through buffers", downstream);
+    return;
+  }
+
+  // The pipes are created first, bypassing the connections cannot be undone.
+  downstream_to_upstream_ = Network::SpliceForwarder::create(downstream.bufferLimit());
+  upstream_to_downstream_ = Network::SpliceForwarder::create(upstream.bufferLimit());
+  if (downstream_to_upstream_ == nullptr || upstream_to_downstream_ == nullptr) {
+    ENVOY_CONN_LOG(debug, "unable to create pipes, proxying through buffers", downstream);
+    stopSplicing();
+    return;
+  }
+
+  ENVOY_CONN_LOG(debug, "splicing", downstream);
+  config_->stats().downstream_cx_splice_total_.inc();
+  splice_resume_timer_ = downstream.dispatcher().createTimer([this]() { onSpliceResume(); });
+  downstream_io_handle_ = &downstream.bypassTransportSocket(downstream_splice_callbacks_);
+  upstream_io_handle_ = &upstream.bypassTransportSocket(upstream_splice_callbacks_);
+}
+
+void Filter::onSpliceEvent(bool downstream, uint32_t events) {
+  // A readable socket is the source of one direction, a writable one the destination of the other.
+  if (events & Event::FileReadyType::Read) {
+    splice(downstream);
+  }
+  // Splicing may have closed the connections.
+  if (downstream_to_upstream_ != nullptr && (events & Event::FileReadyType::Write)) {
+    splice(!downstream);
+  }
+}
+
+void Filter::onSpliceResume() {
+  if (resume_from_downstream_) {
+    resume_from_downstream_ = false;
+    splice(true);
+  }
+  // Splicing may have closed the connections.
+  if (downstream_to_upstream_ != nullptr && resume_from_upstream_) {
+    resume_from_upstream_ = false;
+    splice(false);
+  }
+}
+
+void Filter::splice(bool from_downstream) {
+  Network::SpliceForwarder& forwarder =
+      from_downstream ? *downstream_to_upstream_ : *upstream_to_downstream_;
+  Network::IoHandle& source = from_downstream ? *downstream_io_handle_ : *upstream_io_handle_;
+  Network::IoHandle& destination = from_downstream ? *upstream_io_handle_ : *downstream_io_handle_;
+  const Network::SpliceForwarder::Result result =
+      forwarder.forward(source, destination, MaxSplicedBytesPerEvent);
+  ENVOY_CONN_LOG(trace, "spliced {} bytes from {}stream, {} bytes written",
+                 read_callbacks_->connection(), result.bytes_read_,
+                 from_downstream ? "down" : "up", result.bytes_written_);
+
+  // The connections do not see the data, account for it like they would.
+  Upstream::ClusterStats& cluster_stats = read_callbacks_->upstreamHost()->cluster().stats();
+  if (from_downstream) {
+    getStreamInfo().addBytesReceived(result.bytes_read_);
+    config_->stats().downstream_cx_rx_bytes_total_.add(result.bytes_read_);
+    cluster_stats.upstream_cx_tx_bytes_total_.add(result.bytes_written_);
+  } else {
+    getStreamInfo().addBytesSent(result.bytes_written_);
+    config_->stats().downstream_cx_tx_bytes_total_.add(result.bytes_written_);
+    cluster_stats.upstream_cx_rx_bytes_total_.add(result.bytes_read_);
+  }
+  if (result.bytes_read_ > 0 || result.bytes_written_ > 0) {
+    resetIdleTimer();
+  }
+
+  if (result.error_ != 0 ||
+      (downstream_to_upstream_->endStream() && upstream_to_downstream_->endStream())) {
+    // Nothing is left to flush. This results in also closing the upstream connection.
+    read_callbacks_->connection().close(Network::ConnectionCloseType::NoFlush);
+    return;
+  }
+
+  if (result.yielded_) {
+    (from_downstream ? resume_from_downstream_ : resume_from_upstream_) = true;
+    splice_resume_timer_->enableTimer(std::chrono::milliseconds(0));
+  }
+}
+
+void Filter::stopSplicing() {
+  if (splice_resume_timer_ != nullptr) {
+    // Not destroyed, this may run from its callback.
+    splice_resume_timer_->disableTimer();
   }
+  downstream_to_upstream_.reset();
+  upstream_to_downstream_.reset();
+  downstream_io_handle_ = nullptr;
+  upstream_io_handle_ = nullptr;
 }
 
 void Filter::onIdleTimeout() {
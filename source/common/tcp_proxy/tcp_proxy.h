@@ -25,6 +25,7 @@
 #include "common/network/cidr_range.h"
 #include "common/network/filter_impl.h"
 #include "common/network/hash_policy.h"
+#include "common/network/splice_forwarder.h"
 #include "common/network/utility.h"
 #include "common/stream_info/stream_info_impl.h"
 #include "common/upstream/load_balancer_impl.h"
@@ -38,6 +39,7 @@ namespace TcpProxy {
 #define ALL_TCP_PROXY_STATS(COUNTER, GAUGE)                                                        \
   COUNTER(downstream_cx_no_route)                                                                  \
   COUNTER(downstream_cx_rx_bytes_total)                                                            \
+  COUNTER(downstream_cx_splice_total)                                                              \
   COUNTER(downstream_cx_total)                                                                     \
   COUNTER(downstream_cx_tx_bytes_total)                                                            \
   COUNTER(downstream_flow_control_paused_reading_total)                                            \
@@ -115,6 +117,7 @@ public:
     return cluster_metadata_match_criteria_.get();
   }
   const Network::HashPolicy* hashPolicy() { return hash_policy_.get(); }
+  bool spliceEnabled() const { return enable_splice_; }
 
 private:
   struct Route {
@@ -152,6 +155,7 @@ private:
   std::unique_ptr<const Router::MetadataMatchCriteria> cluster_metadata_match_criteria_;
   Runtime::RandomGenerator& random_generator_;
   std::unique_ptr<const Network::HashPolicyImpl> hash_policy_;
+  const bool enable_splice_;
 };
 
 using ConfigSharedPtr = std::shared_ptr<Config>;
@@ -264,6 +268,17 @@ protected:
     bool on_high_watermark_called_{false};
   };
 
+  // Receives the socket events of one of the connections once both are spliced.
+  struct SpliceCallbacks : public Network::BypassCallbacks {
+    SpliceCallbacks(Filter& parent, bool downstream) : parent_(parent), downstream_(downstream) {}
+
+    // Network::BypassCallbacks
+    void onSocketEvent(uint32_t events) override { parent_.onSpliceEvent(downstream_, events); }
+
+    Filter& parent_;
+    const bool downstream_;
+  };
+
   enum class UpstreamFailureReason {
     ConnectFailed,
     NoHealthyUpstream,
@@ -289,6 +304,16 @@ protected:
   void onIdleTimeout();
   void resetIdleTimer();
   void disableIdleTimer();
+  // The bytes one direction splices before letting the worker handle other events.
+  static constexpr uint64_t MaxSplicedBytesPerEvent = 1024 * 1024;
+
+  // Switch both connections to moving data with splice(2) if the configuration and the
+  // connections allow it. Data keeps going through the connections otherwise.
+  void maybeStartSplicing();
+  void onSpliceEvent(bool downstream, uint32_t events);
+  void onSpliceResume();
+  void splice(bool from_downstream);
+  void stopSplicing();
 
   const ConfigSharedPtr config_;
   Upstream::ClusterManager& cluster_manager_;
@@ -301,6 +326,18 @@ protected:
                                                           // read filter.
   StreamInfo::StreamInfoImpl stream_info_;
   Network::TransportSocketOptionsSharedPtr transport_socket_options_;
+  SpliceCallbacks downstream_splice_callbacks_{*this, true};
+  SpliceCallbacks upstream_splice_callbacks_{*this, false};
+  // The sockets of the connections and the forwarders of both directions while splicing.
+  Network::IoHandle* downstream_io_handle_{};
+  Network::IoHandle* upstream_io_handle_{};
+  Network::SpliceForwarderPtr downstream_to_upstream_;
+  Network::SpliceForwarderPtr upstream_to_downstream_;
+  // Resumes the directions which stopped after MaxSplicedBytesPerEvent on the next event loop
+  // iteration, as their sockets will not signal again.
+  Event::TimerPtr splice_resume_timer_;
+  bool resume_from_downstream_{};
+  bool resume_from_upstream_{};
   uint32_t connect_attempts_{};
   bool connecting_{};
 };
@@ -110,11 +110,20 @@ void InstanceImpl::registerThread(Event::Dispatcher& dispatcher, bool main_threa
     thread_local_data_.dispatcher_ = &dispatcher;
   } else {
     ASSERT(!containsReference(registered_threads_, dispatcher));
+    const uint32_t worker_index = registered_threads_.size();
     registered_threads_.push_back(dispatcher);
-    dispatcher.post([&dispatcher] { thread_local_data_.dispatcher_ = &dispatcher; });
+    dispatcher.post([&dispatcher, worker_index] {
+      thread_local_data_.dispatcher_ = &dispatcher;
+      thread_local_data_.worker_index_ = worker_index;
+    });
   }
 }
 
+uint32_t InstanceImpl::workerCount() {
+  ASSERT(std::this_thread::get_id() == main_thread_id_);
+  return registered_threads_.size();
+}
+
 // Puts the slot into a deferred delete container, the slot will be destructed when its out-going
 // callback reference count goes to 0.
 void InstanceImpl::recycle(std::unique_ptr<SlotImpl>&& slot) {
@@ -29,6 +29,8 @@ public:
   void shutdownGlobalThreading() override;
   void shutdownThread() override;
   Event::Dispatcher& dispatcher() override;
+  absl::optional<uint32_t> workerIndex() override { return thread_local_data_.worker_index_; }
+  uint32_t workerCount() override;
 
 private:
   struct SlotImpl : public Slot {
@@ -72,6 +74,7 @@ private:
 
   struct ThreadLocalData {
     Event::Dispatcher* dispatcher_{};
+    absl::optional<uint32_t> worker_index_;
     std::vector<ThreadLocalObjectSharedPtr> data_;
   };
 
@@ -1,11 +1,13 @@
 #include "common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "envoy/admin/v2alpha/config_dump.pb.h"
@@ -17,6 +19,7 @@
 #include "common/common/assert.h"
 #include "common/common/enum_to_int.h"
 #include "common/common/fmt.h"
+#include "common/common/hash.h"
 #include "common/common/utility.h"
 #include "common/config/new_grpc_mux_impl.h"
 #include "common/config/resources.h"
@@ -29,6 +32,7 @@
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
 #include "common/router/shadow_writer_impl.h"
+#include "common/runtime/runtime_impl.h"
 #include "common/tcp/conn_pool.h"
 #include "common/upstream/cds_api_impl.h"
 #include "common/upstream/load_balancer_impl.h"
@@ -42,6 +46,11 @@ namespace Envoy {
 namespace Upstream {
 namespace {
 
+// The first byte of the pool hash keys of HTTP/2 pools whose connections are shared between
+// workers. This keeps them apart from the regular pools, which start with the protocol.
+constexpr uint8_t SharedHttp2PoolKey = 0x80;
+constexpr uint8_t ForwardingHttp2PoolKey = 0x81;
+
 void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
                          const Network::Socket::OptionsSharedPtr& to_add) {
   if (to_add != nullptr) {
@@ -49,6 +58,26 @@ void addOptionsIfNotNull(Network::Socket::OptionsSharedPtr& options,
   }
 }
 
+// Removes the hosts of to_cancel from hosts. Returns the hosts of to_cancel which were not found.
+HostVector cancelHosts(HostVector& hosts, const HostVector& to_cancel) {
+  if (hosts.empty() || to_cancel.empty()) {
+    return to_cancel;
+  }
+  std::unordered_set<HostSharedPtr> remaining(to_cancel.begin(), to_cancel.end());
+  hosts.erase(std::remove_if(hosts.begin(), hosts.end(),
+                             [&remaining](const HostSharedPtr& host) {
+                               return remaining.erase(host) > 0;
+                             }),
+              hosts.end());
+  HostVector not_found;
+  for (const auto& host : to_cancel) {
+    if (remaining.count(host) > 0) {
+      not_found.push_back(host);
+    }
+  }
+  return not_found;
+}
+
 } // namespace
 
 void ClusterManagerInitHelper::addCluster(Cluster& cluster) {
@@ -200,8 +229,9 @@ ClusterManagerImpl::ClusterManagerImpl(
     Server::Admin& admin, ProtobufMessage::ValidationContext& validation_context, Api::Api& api,
     Http::Context& http_context)
     : factory_(factory), runtime_(runtime), stats_(stats), tls_(tls.allocateSlot()),
-      random_(random), bind_config_(bootstrap.cluster_manager().upstream_bind_config()),
-      local_info_(local_info), cm_stats_(generateStats(stats)),
+      random_(random), lb_table_builder_(api.threadFactory()),
+      bind_config_(bootstrap.cluster_manager().upstream_bind_config()), local_info_(local_info),
+      cm_stats_(generateStats(stats)),
       init_helper_(*this, [this](Cluster& cluster) { onClusterInit(cluster); }),
       config_tracker_entry_(
           admin.getConfigTracker().add("clusters", [this] { return dumpClusterConfigs(); })),
@@ -300,9 +330,11 @@ ClusterManagerImpl::ClusterManagerImpl(
 
   // Once the initial set of static bootstrap clusters are created (including the local cluster),
   // we can instantiate the thread local cluster manager.
-  tls_->set([this, local_cluster_name](
+  worker_cluster_managers_.publish(std::make_shared<WorkerClusterManagers>(tls.workerCount()));
+  tls_->set([this, tls = &tls, local_cluster_name](
                 Event::Dispatcher& dispatcher) -> ThreadLocal::ThreadLocalObjectSharedPtr {
-    return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_name);
+    return std::make_shared<ThreadLocalClusterManagerImpl>(*this, dispatcher, local_cluster_name,
+                                                           tls->workerIndex());
   });
 
   // We can now potentially create the CDS API once the backing cluster exists.
@@ -354,13 +386,20 @@ void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
   }
 
   // Now setup for cross-thread updates.
+  // The connection pools are drained with the coalesced membership update, after the workers
+  // removed the hosts from their load balancers.
   cluster.prioritySet().addMemberUpdateCb(
       [&cluster, this](const HostVector&, const HostVector& hosts_removed) -> void {
         if (cluster.info()->lbConfig().close_connections_on_host_set_change()) {
-          for (const auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
-            // This will drain all tcp and http connection pools.
-            postThreadLocalDrainConnections(cluster, host_set->hosts());
-          }
+          mergeThreadLocalClusterUpdate(
+              cluster.info()->name(), [&cluster](PendingThreadLocalUpdate& pending) -> void {
+                for (const auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
+                  // This will drain all tcp and http connection pools.
+                  pending.hosts_to_drain_.insert(pending.hosts_to_drain_.end(),
+                                                 host_set->hosts().begin(),
+                                                 host_set->hosts().end());
+                }
+              });
         } else {
           // TODO(snowp): Should this be subject to merge windows?
 
@@ -369,7 +408,12 @@ void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
           // enabled, this case will be covered by first `if` statement, where all
           // connection pools are drained.
           if (!hosts_removed.empty()) {
-            postThreadLocalDrainConnections(cluster, hosts_removed);
+            mergeThreadLocalClusterUpdate(cluster.info()->name(),
+                                          [&hosts_removed](PendingThreadLocalUpdate& pending) {
+                                            pending.hosts_to_drain_.insert(
+                                                pending.hosts_to_drain_.end(),
+                                                hosts_removed.begin(), hosts_removed.end());
+                                          });
           }
         }
       });
@@ -407,17 +451,22 @@ void ClusterManagerImpl::onClusterInit(Cluster& cluster) {
     // If an update was not scheduled for later, deliver it immediately.
     if (!scheduled) {
       cm_stats_.cluster_updated_.inc();
-      postThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
+      scheduleThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
     }
   });
 
   // Finally, if the cluster has any hosts, post updates cross-thread so the per-thread load
-  // balancers are ready.
+  // balancers are ready. This is not deferred, so that the workers never see the cluster without
+  // its hosts.
+  HostSetDeltasByPriority deltas;
   for (auto& host_set : cluster.prioritySet().hostSetsPerPriority()) {
     if (host_set->hosts().empty()) {
       continue;
     }
-    postThreadLocalClusterUpdate(cluster, host_set->priority(), host_set->hosts(), HostVector{});
+    deltas[host_set->priority()].hosts_added_ = host_set->hosts();
+  }
+  if (!deltas.empty()) {
+    postThreadLocalClusterUpdate(cluster, deltas);
   }
 }
 
@@ -489,7 +538,7 @@ void ClusterManagerImpl::applyUpdates(const Cluster& cluster, uint32_t priority,
   static const HostVector hosts_added;
   static const HostVector hosts_removed;
 
-  postThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
+  scheduleThreadLocalClusterUpdate(cluster, priority, hosts_added, hosts_removed);
 
   cm_stats_.cluster_updated_via_merge_.inc();
   updates.timer_enabled_ = false;
@@ -580,7 +629,78 @@ bool ClusterManagerImpl::addOrUpdateCluster(const envoy::api::v2::Cluster& clust
   return true;
 }
 
+void ClusterManagerImpl::scheduleThreadLocalClusterUpdate(const Cluster& cluster,
+                                                          uint32_t priority,
+                                                          const HostVector& hosts_added,
+                                                          const HostVector& hosts_removed) {
+  // During large EDS bursts a cluster can be updated many times before the workers get to run.
+  // Rather than posting every update to every worker, which would then refresh its load balancer
+  // for each of them, merge the updates of a cluster and post them once the main thread's current
+  // event loop iteration is done.
+  const std::string& cluster_name = cluster.info()->name();
+  if (pending_thread_local_updates_.count(cluster_name) > 0) {
+    cm_stats_.cluster_updated_coalesced_.inc();
+  }
+
+  // Unlike with the merge window, hosts can be merged here: a removal must only be reported for
+  // hosts the workers know about, and a host added and removed again before the flush was never
+  // posted to them.
+  auto merge = [priority, &hosts_added, &hosts_removed](PendingThreadLocalUpdate& pending) -> void {
+    HostSetDelta& delta = pending.deltas_[priority];
+    HostVector new_hosts_removed = cancelHosts(delta.hosts_added_, hosts_removed);
+    HostVector new_hosts_added = cancelHosts(delta.hosts_removed_, hosts_added);
+    delta.hosts_removed_.insert(delta.hosts_removed_.end(), new_hosts_removed.begin(),
+                                new_hosts_removed.end());
+    delta.hosts_added_.insert(delta.hosts_added_.end(), new_hosts_added.begin(),
+                              new_hosts_added.end());
+  };
+  mergeThreadLocalClusterUpdate(cluster_name, merge);
+}
+
+void ClusterManagerImpl::mergeThreadLocalClusterUpdate(
+    const std::string& cluster_name, const std::function<void(PendingThreadLocalUpdate&)>& merge) {
+  auto pending = pending_thread_local_updates_.find(cluster_name);
+  if (pending != pending_thread_local_updates_.end()) {
+    merge(*pending->second);
+    return;
+  }
+
+  auto update = std::make_shared<PendingThreadLocalUpdate>();
+  merge(*update);
+  pending_thread_local_updates_.emplace(cluster_name, update);
+  // The entry is dropped when its cluster is removed or replaced, and with the cluster manager,
+  // which may be destroyed before the main dispatcher runs the flush.
+  std::weak_ptr<PendingThreadLocalUpdate> handle = update;
+  dispatcher_.post([this, cluster_name, handle]() -> void {
+    if (!handle.expired()) {
+      flushThreadLocalClusterUpdates(cluster_name);
+    }
+  });
+}
+
+void ClusterManagerImpl::flushThreadLocalClusterUpdates(const std::string& cluster_name) {
+  auto pending = pending_thread_local_updates_.find(cluster_name);
+  ASSERT(pending != pending_thread_local_updates_.end());
+  const PendingThreadLocalUpdateSharedPtr update = std::move(pending->second);
+  pending_thread_local_updates_.erase(pending);
+
+  auto cluster = active_clusters_.find(cluster_name);
+  ASSERT(cluster != active_clusters_.end());
+  if (!update->deltas_.empty()) {
+    postThreadLocalClusterUpdate(*cluster->second->cluster_, update->deltas_);
+  }
+  // Workers run posted callbacks in order, so the drained hosts are no longer load balanced to.
+  if (!update->hosts_to_drain_.empty()) {
+    postThreadLocalDrainConnections(*cluster->second->cluster_, update->hosts_to_drain_);
+  }
+}
+
 void ClusterManagerImpl::createOrUpdateThreadLocalCluster(ClusterData& cluster) {
+  // The workers are about to get a new cluster, which is populated with all of its hosts once it
+  // is initialized. Pending updates of the cluster it replaces would no longer apply, and the
+  // connection pools of its hosts are drained when the workers destroy it.
+  pending_thread_local_updates_.erase(cluster.cluster_->info()->name());
+
   tls_->runOnAllThreads([this, new_cluster = cluster.cluster_->info(),
                          thread_aware_lb_factory = cluster.loadBalancerFactory()]() -> void {
     ThreadLocalClusterManagerImpl& cluster_manager =
@@ -637,6 +757,7 @@ bool ClusterManagerImpl::removeCluster(const std::string& cluster_name) {
     updateClusterCounts();
     // Cancel any pending merged updates.
     updates_map_.erase(cluster_name);
+    pending_thread_local_updates_.erase(cluster_name);
   }
 
   return removed;
@@ -697,16 +818,17 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
   // If an LB is thread aware, create it here. The LB is not initialized until cluster pre-init
   // finishes. For RingHash/Maglev don't create the LB here if subset balancing is enabled,
   // because the thread_aware_lb_ field takes precedence over the subset lb).
+  std::unique_ptr<ThreadAwareLoadBalancerBase> hashing_lb;
   if (cluster_reference.info()->lbType() == LoadBalancerType::RingHash) {
     if (!cluster_reference.info()->lbSubsetInfo().isEnabled()) {
-      cluster_entry_it->second->thread_aware_lb_ = std::make_unique<RingHashLoadBalancer>(
+      hashing_lb = std::make_unique<RingHashLoadBalancer>(
           cluster_reference.prioritySet(), cluster_reference.info()->stats(),
           cluster_reference.info()->statsScope(), runtime_, random_,
           cluster_reference.info()->lbRingHashConfig(), cluster_reference.info()->lbConfig());
     }
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::Maglev) {
     if (!cluster_reference.info()->lbSubsetInfo().isEnabled()) {
-      cluster_entry_it->second->thread_aware_lb_ = std::make_unique<MaglevLoadBalancer>(
+      hashing_lb = std::make_unique<MaglevLoadBalancer>(
           cluster_reference.prioritySet(), cluster_reference.info()->stats(),
           cluster_reference.info()->statsScope(), runtime_, random_,
           cluster_reference.info()->lbConfig());
@@ -714,6 +836,13 @@ void ClusterManagerImpl::loadCluster(const envoy::api::v2::Cluster& cluster,
   } else if (cluster_reference.info()->lbType() == LoadBalancerType::ClusterProvided) {
     cluster_entry_it->second->thread_aware_lb_ = std::move(new_cluster_pair.second);
   }
+  if (hashing_lb != nullptr) {
+    // Rebuilding the tables of large clusters takes a while; keep it off the main thread.
+    if (Runtime::runtimeFeatureEnabled("envoy.reloadable_features.thread_aware_lb_build_async")) {
+      hashing_lb->setTableBuilder(lb_table_builder_);
+    }
+    cluster_entry_it->second->thread_aware_lb_ = std::move(hashing_lb);
+  }
 
   updateClusterCounts();
 }
@@ -742,6 +871,18 @@ void ClusterManagerImpl::updateClusterCounts() {
   cm_stats_.warming_clusters_.set(warming_clusters_.size());
 }
 
+void ClusterManagerImpl::setWorkerClusterManager(uint32_t worker_index,
+                                                 WorkerClusterManager worker) {
+  Thread::LockGuard lock(worker_cluster_managers_lock_);
+  auto workers = std::make_shared<WorkerClusterManagers>(*worker_cluster_managers_.get());
+  if (worker_index >= workers->size()) {
+    // The worker was registered after the cluster manager was created.
+    workers->resize(worker_index + 1);
+  }
+  (*workers)[worker_index] = std::move(worker);
+  worker_cluster_managers_.publish(std::move(workers));
+}
+
 ThreadLocalCluster* ClusterManagerImpl::get(absl::string_view cluster) {
   auto& cluster_manager = tls_->getTyped<ThreadLocalClusterManagerImpl>();
 
@@ -788,18 +929,20 @@ void ClusterManagerImpl::postThreadLocalDrainConnections(const Cluster& cluster,
   });
 }
 
-void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
-                                                      const HostVector& hosts_added,
-                                                      const HostVector& hosts_removed) {
-  const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[priority];
-
-  tls_->runOnAllThreads([this, name = cluster.info()->name(), priority,
-                         update_params = HostSetImpl::updateHostsParams(*host_set),
-                         locality_weights = host_set->localityWeights(), hosts_added, hosts_removed,
-                         overprovisioning_factor = host_set->overprovisioningFactor()]() {
-    ThreadLocalClusterManagerImpl::updateClusterMembership(
-        name, priority, update_params, locality_weights, hosts_added, hosts_removed, *tls_,
-        overprovisioning_factor);
+void ClusterManagerImpl::postThreadLocalClusterUpdate(const Cluster& cluster,
+                                                      const HostSetDeltasByPriority& deltas) {
+  // The updates are shared by all workers rather than copied for each of them.
+  auto updates = std::make_shared<std::vector<ThreadLocalClusterManagerImpl::HostSetUpdate>>();
+  updates->reserve(deltas.size());
+  for (const auto& delta : deltas) {
+    const auto& host_set = cluster.prioritySet().hostSetsPerPriority()[delta.first];
+    updates->push_back({delta.first, HostSetImpl::updateHostsParams(*host_set),
+                        host_set->localityWeights(), delta.second.hosts_added_,
+                        delta.second.hosts_removed_, host_set->overprovisioningFactor()});
+  }
+
+  tls_->runOnAllThreads([this, name = cluster.info()->name(), updates]() {
+    ThreadLocalClusterManagerImpl::updateClusterMembership(name, *updates, *tls_);
   });
 }
 
@@ -886,8 +1029,14 @@ ProtobufTypes::MessagePtr ClusterManagerImpl::dumpClusterConfigs() {
 
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ThreadLocalClusterManagerImpl(
     ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
-    const absl::optional<std::string>& local_cluster_name)
-    : parent_(parent), thread_local_dispatcher_(dispatcher) {
+    const absl::optional<std::string>& local_cluster_name, absl::optional<uint32_t> worker_index)
+    : parent_(parent), thread_local_dispatcher_(dispatcher), worker_index_(worker_index),
+      workers_(parent.worker_cluster_managers_) {
+  if (worker_index_.has_value()) {
+    dispatcher_handle_ = std::make_shared<Http::Http2::DispatcherHandle>(dispatcher);
+    parent.setWorkerClusterManager(worker_index_.value(), {dispatcher_handle_, this});
+  }
+
   // If local cluster is defined then we need to initialize it first.
   if (local_cluster_name) {
     ENVOY_LOG(debug, "adding TLS local cluster {}", local_cluster_name.value());
@@ -919,6 +1068,11 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::~ThreadLocalClusterManagerImp
   // the local cluster. This is because non-local clusters with a zone aware load balancer have a
   // member update callback registered with the local cluster.
   ENVOY_LOG(debug, "shutting down thread local cluster manager");
+  if (worker_index_.has_value()) {
+    // Drop the callbacks which other workers posted, or are about to post, to this one.
+    dispatcher_handle_->close();
+    parent_.setWorkerClusterManager(worker_index_.value(), {});
+  }
   destroying_ = true;
   host_http_conn_pool_map_.clear();
   host_tcp_conn_pool_map_.clear();
@@ -1057,22 +1211,25 @@ void ClusterManagerImpl::ThreadLocalClusterManagerImpl::removeHosts(const std::s
 }
 
 void ClusterManagerImpl::ThreadLocalClusterManagerImpl::updateClusterMembership(
-    const std::string& name, uint32_t priority, PrioritySet::UpdateHostsParams update_hosts_params,
-    LocalityWeightsConstSharedPtr locality_weights, const HostVector& hosts_added,
-    const HostVector& hosts_removed, ThreadLocal::Slot& tls, uint64_t overprovisioning_factor) {
+    const std::string& name, const std::vector<HostSetUpdate>& updates, ThreadLocal::Slot& tls) {
 
   ThreadLocalClusterManagerImpl& config = tls.getTyped<ThreadLocalClusterManagerImpl>();
 
   ASSERT(config.thread_local_clusters_.find(name) != config.thread_local_clusters_.end());
   const auto& cluster_entry = config.thread_local_clusters_[name];
-  ENVOY_LOG(debug, "membership update for TLS cluster {} added {} removed {}", name,
-            hosts_added.size(), hosts_removed.size());
-  cluster_entry->priority_set_.updateHosts(priority, std::move(update_hosts_params),
-                                           std::move(locality_weights), hosts_added, hosts_removed,
-                                           overprovisioning_factor);
-
-  // If an LB is thread aware, create a new worker local LB on membership changes.
-  if (cluster_entry->lb_factory_ != nullptr) {
+  for (const HostSetUpdate& update : updates) {
+    ENVOY_LOG(debug, "membership update for TLS cluster {} priority {} added {} removed {}", name,
+              update.priority_, update.hosts_added_.size(), update.hosts_removed_.size());
+    PrioritySet::UpdateHostsParams update_hosts_params = update.update_hosts_params_;
+    cluster_entry->priority_set_.updateHosts(
+        update.priority_, std::move(update_hosts_params), update.locality_weights_,
+        update.hosts_added_, update.hosts_removed_, update.overprovisioning_factor_);
+  }
+
+  // If an LB is thread aware, create a new worker local LB on membership changes unless it follows
+  // the tables the thread aware LB publishes. This is done once for all priorities that were
+  // updated.
+  if (cluster_entry->lb_factory_ != nullptr && cluster_entry->lb_factory_->recreateOnHostChange()) {
     ENVOY_LOG(debug, "re-creating local LB for TLS cluster {}", name);
     cluster_entry->lb_ = cluster_entry->lb_factory_->create();
   }
@@ -1141,6 +1298,81 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::getHttpConnPoolsContainer(
   return &container_iter->second;
 }
 
+const ClusterManagerImpl::WorkerClusterManager*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::http2ConnPoolOwner(const Host& host,
+                                                                     uint32_t owners_per_host) {
+  if (!worker_index_.has_value()) {
+    // The main thread does not share connections.
+    return nullptr;
+  }
+  const WorkerClusterManagers& workers = *workers_.get();
+  // Workers are indexed in the order in which the server registers them, so that all of them
+  // agree on the owners of a host, whichever worker starts first.
+  const uint32_t owner_index = Http::Http2::SharedConnPoolImpl::ownerWorker(
+      HashUtil::xxHash64(host.address()->asString()), worker_index_.value(), workers.size(),
+      owners_per_host);
+  if (owner_index == worker_index_.value()) {
+    return nullptr;
+  }
+  const WorkerClusterManager& owner = workers[owner_index];
+  // An owner which has not started yet, or which is shutting down, has no entry. This worker
+  // then uses connections of its own for the host.
+  return owner.cluster_manager_ != nullptr ? &owner : nullptr;
+}
+
+Http::Http2::SharedConnPoolImpl*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::sharedHttp2ConnPool(
+    const std::string& cluster_name, const HostConstSharedPtr& host, ResourcePriority priority,
+    const std::vector<uint8_t>& hash_key,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    const Network::TransportSocketOptionsSharedPtr& transport_socket_options) {
+  ConnPoolsContainer* container = getHttpConnPoolsContainer(host);
+  if (container == nullptr) {
+    // The host may have been removed on this worker in the meantime. Make sure not to allocate a
+    // container which would never be drained.
+    auto entry = thread_local_clusters_.find(cluster_name);
+    if (entry == thread_local_clusters_.end()) {
+      return nullptr;
+    }
+    const auto& host_sets = entry->second->priority_set_.hostSetsPerPriority();
+    const bool has_host = std::any_of(host_sets.begin(), host_sets.end(), [&host](const auto& set) {
+      return std::find(set->hosts().begin(), set->hosts().end(), host) != set->hosts().end();
+    });
+    if (!has_host) {
+      return nullptr;
+    }
+    container = getHttpConnPoolsContainer(host, true);
+  } else if (container->ready_to_drain_) {
+    return nullptr;
+  }
+
+  return sharedHttp2ConnPool(*container, host, priority, hash_key, options,
+                             transport_socket_options);
+}
+
+Http::Http2::SharedConnPoolImpl*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::sharedHttp2ConnPool(
+    ConnPoolsContainer& container, const HostConstSharedPtr& host, ResourcePriority priority,
+    const std::vector<uint8_t>& hash_key,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    const Network::TransportSocketOptionsSharedPtr& transport_socket_options) {
+  ASSERT(hash_key[0] == SharedHttp2PoolKey);
+  ConnPoolsContainer::ConnPools::OptPoolRef pool =
+      container.pools_->getPool(priority, hash_key, [&]() {
+        return std::make_unique<Http::Http2::SharedConnPoolImpl>(
+            thread_local_dispatcher_,
+            parent_.factory_.allocateConnPool(thread_local_dispatcher_, host, priority,
+                                              Http::Protocol::Http2, options,
+                                              transport_socket_options));
+      });
+
+  if (!pool.has_value()) {
+    return nullptr;
+  }
+  // Only shared pools are stored under the shared pool key.
+  return static_cast<Http::Http2::SharedConnPoolImpl*>(&pool.value().get());
+}
+
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
     ThreadLocalClusterManagerImpl& parent, ClusterInfoConstSharedPtr cluster,
     const LoadBalancerFactorySharedPtr& lb_factory)
@@ -1183,6 +1415,14 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::ClusterEntry(
                                                      parent.parent_.random_, cluster->lbConfig());
       break;
     }
+    case LoadBalancerType::PeakEwma: {
+      ASSERT(lb_factory_ == nullptr);
+      lb_ = std::make_unique<PeakEwmaLoadBalancer>(
+          priority_set_, parent_.local_priority_set_, cluster->stats(), parent.parent_.runtime_,
+          parent.parent_.random_, cluster->lbConfig(),
+          parent.thread_local_dispatcher_.timeSource());
+      break;
+    }
     case LoadBalancerType::ClusterProvided:
     case LoadBalancerType::RingHash:
     case LoadBalancerType::Maglev:
@@ -1241,6 +1481,13 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
     have_transport_socket_options = true;
   }
 
+  if (protocol == Http::Protocol::Http2 && cluster_info_->http2ConnectionSharingOwners() > 0) {
+    return sharedHttp2ConnPool(
+        host, priority, std::move(hash_key),
+        !upstream_options->empty() ? upstream_options : nullptr,
+        have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr);
+  }
+
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
@@ -1260,6 +1507,44 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::connPool(
   }
 }
 
+Http::ConnectionPool::Instance*
+ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::sharedHttp2ConnPool(
+    const HostConstSharedPtr& host, ResourcePriority priority, std::vector<uint8_t> hash_key,
+    const Network::ConnectionSocket::OptionsSharedPtr& options,
+    const Network::TransportSocketOptionsSharedPtr& transport_socket_options) {
+  const WorkerClusterManager* owner =
+      parent_.http2ConnPoolOwner(*host, cluster_info_->http2ConnectionSharingOwners());
+  ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
+
+  hash_key[0] = SharedHttp2PoolKey;
+  if (owner == nullptr) {
+    return parent_.sharedHttp2ConnPool(container, host, priority, hash_key, options,
+                                       transport_socket_options);
+  }
+
+  std::vector<uint8_t> forwarding_hash_key = hash_key;
+  forwarding_hash_key[0] = ForwardingHttp2PoolKey;
+  ConnPoolsContainer::ConnPools::OptPoolRef pool =
+      container.pools_->getPool(priority, forwarding_hash_key, [&]() {
+        // The locator runs on the owning worker, only while its cluster manager is alive, and
+        // must only capture state which is safe to access from there.
+        return std::make_unique<Http::Http2::ForwardingConnPoolImpl>(
+            parent_.thread_local_dispatcher_, parent_.dispatcher_handle_, owner->dispatcher_, host,
+            Http::Protocol::Http2,
+            [owner = owner->cluster_manager_, cluster_name = cluster_info_->name(), host, priority,
+             hash_key, options, transport_socket_options]() {
+              return owner->sharedHttp2ConnPool(cluster_name, host, priority, hash_key, options,
+                                                transport_socket_options);
+            });
+      });
+
+  if (pool.has_value()) {
+    return &(pool.value().get());
+  } else {
+    return nullptr;
+  }
+}
+
 Tcp::ConnectionPool::Instance*
 ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::tcpConnPool(
     ResourcePriority priority, LoadBalancerContext* context) {
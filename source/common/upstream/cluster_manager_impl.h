@@ -21,11 +21,15 @@
 #include "envoy/upstream/cluster_manager.h"
 
 #include "common/common/cleanup.h"
+#include "common/common/thread.h"
 #include "common/config/grpc_mux_impl.h"
 #include "common/config/subscription_factory_impl.h"
 #include "common/http/async_client_impl.h"
+#include "common/http/http2/shared_conn_pool.h"
+#include "common/upstream/lb_table_builder.h"
 #include "common/upstream/load_stats_reporter.h"
 #include "common/upstream/priority_conn_pool_map.h"
+#include "common/upstream/shared_lb_table.h"
 #include "common/upstream/upstream_impl.h"
 
 namespace Envoy {
@@ -157,6 +161,7 @@ private:
   COUNTER(cluster_modified)                                                                        \
   COUNTER(cluster_removed)                                                                         \
   COUNTER(cluster_updated)                                                                         \
+  COUNTER(cluster_updated_coalesced)                                                               \
   COUNTER(cluster_updated_via_merge)                                                               \
   COUNTER(update_merge_cancelled)                                                                  \
   COUNTER(update_out_of_merge_window)                                                              \
@@ -241,11 +246,33 @@ public:
 protected:
   virtual void postThreadLocalDrainConnections(const Cluster& cluster,
                                                const HostVector& hosts_removed);
-  virtual void postThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
-                                            const HostVector& hosts_added,
-                                            const HostVector& hosts_removed);
+  // The hosts added to and removed from the host set of a priority since the workers were last
+  // updated.
+  struct HostSetDelta {
+    HostVector hosts_added_;
+    HostVector hosts_removed_;
+  };
+  // Ordered so that the workers update the priorities in a deterministic order.
+  using HostSetDeltasByPriority = std::map<uint32_t, HostSetDelta>;
+
+  virtual void postThreadLocalClusterUpdate(const Cluster& cluster,
+                                            const HostSetDeltasByPriority& deltas);
 
 private:
+  struct ThreadLocalClusterManagerImpl;
+
+  // A worker which shares HTTP/2 connections. Its cluster manager must only be accessed on the
+  // worker, by callbacks posted through its dispatcher handle, which the worker closes before the
+  // cluster manager is destroyed.
+  struct WorkerClusterManager {
+    Http::Http2::DispatcherHandleSharedPtr dispatcher_;
+    ThreadLocalClusterManagerImpl* cluster_manager_{};
+  };
+
+  // Indexed by ThreadLocal::Instance::workerIndex(). The entry of a worker is empty until its
+  // cluster manager is created, and once it is destroyed.
+  using WorkerClusterManagers = std::vector<WorkerClusterManager>;
+
   /**
    * Thread local cached cluster data. Each thread local cluster gets updates from the parent
    * central dynamic cluster (if applicable). It maintains load balancer state and any created
@@ -309,6 +336,14 @@ private:
       Tcp::ConnectionPool::Instance* tcpConnPool(ResourcePriority priority,
                                                  LoadBalancerContext* context);
 
+      // Returns the pool of an HTTP/2 host whose connections are shared between workers. This is
+      // either the shared pool of this worker or a pool forwarding to the owning worker.
+      Http::ConnectionPool::Instance*
+      sharedHttp2ConnPool(const HostConstSharedPtr& host, ResourcePriority priority,
+                          std::vector<uint8_t> hash_key,
+                          const Network::ConnectionSocket::OptionsSharedPtr& options,
+                          const Network::TransportSocketOptionsSharedPtr& transport_socket_options);
+
       // Upstream::ThreadLocalCluster
       const PrioritySet& prioritySet() override { return priority_set_; }
       ClusterInfoConstSharedPtr info() override { return cluster_info_; }
@@ -328,8 +363,19 @@ private:
 
     using ClusterEntryPtr = std::unique_ptr<ClusterEntry>;
 
+    // The state of the host set of a priority, as posted to the workers.
+    struct HostSetUpdate {
+      uint32_t priority_;
+      PrioritySet::UpdateHostsParams update_hosts_params_;
+      LocalityWeightsConstSharedPtr locality_weights_;
+      HostVector hosts_added_;
+      HostVector hosts_removed_;
+      uint64_t overprovisioning_factor_;
+    };
+
     ThreadLocalClusterManagerImpl(ClusterManagerImpl& parent, Event::Dispatcher& dispatcher,
-                                  const absl::optional<std::string>& local_cluster_name);
+                                  const absl::optional<std::string>& local_cluster_name,
+                                  absl::optional<uint32_t> worker_index);
     ~ThreadLocalClusterManagerImpl() override;
     void drainConnPools(const HostVector& hosts);
     void drainConnPools(HostSharedPtr old_host, ConnPoolsContainer& container);
@@ -338,17 +384,31 @@ private:
     void removeTcpConn(const HostConstSharedPtr& host, Network::ClientConnection& connection);
     static void removeHosts(const std::string& name, const HostVector& hosts_removed,
                             ThreadLocal::Slot& tls);
-    static void updateClusterMembership(const std::string& name, uint32_t priority,
-                                        PrioritySet::UpdateHostsParams update_hosts_params,
-                                        LocalityWeightsConstSharedPtr locality_weights,
-                                        const HostVector& hosts_added,
-                                        const HostVector& hosts_removed, ThreadLocal::Slot& tls,
-                                        uint64_t overprovisioning_factor);
+    static void updateClusterMembership(const std::string& name,
+                                        const std::vector<HostSetUpdate>& updates,
+                                        ThreadLocal::Slot& tls);
     static void onHostHealthFailure(const HostSharedPtr& host, ThreadLocal::Slot& tls);
 
     ConnPoolsContainer* getHttpConnPoolsContainer(const HostConstSharedPtr& host,
                                                   bool allocate = false);
 
+    // Returns the worker owning the shared HTTP/2 connections to a host which this worker uses, or
+    // nullptr if this worker uses its own connections.
+    const WorkerClusterManager* http2ConnPoolOwner(const Host& host, uint32_t owners_per_host);
+    // Returns the shared HTTP/2 pool of this worker for a host, creating it if needed. The first
+    // variant is used for streams forwarded by other workers, and returns nullptr if the host is no
+    // longer part of the cluster on this worker.
+    Http::Http2::SharedConnPoolImpl*
+    sharedHttp2ConnPool(const std::string& cluster_name, const HostConstSharedPtr& host,
+                        ResourcePriority priority, const std::vector<uint8_t>& hash_key,
+                        const Network::ConnectionSocket::OptionsSharedPtr& options,
+                        const Network::TransportSocketOptionsSharedPtr& transport_socket_options);
+    Http::Http2::SharedConnPoolImpl*
+    sharedHttp2ConnPool(ConnPoolsContainer& container, const HostConstSharedPtr& host,
+                        ResourcePriority priority, const std::vector<uint8_t>& hash_key,
+                        const Network::ConnectionSocket::OptionsSharedPtr& options,
+                        const Network::TransportSocketOptionsSharedPtr& transport_socket_options);
+
     ClusterManagerImpl& parent_;
     Event::Dispatcher& thread_local_dispatcher_;
     absl::flat_hash_map<std::string, ClusterEntryPtr> thread_local_clusters_;
@@ -361,6 +421,10 @@ private:
 
     std::list<Envoy::Upstream::ClusterUpdateCallbacks*> update_callbacks_;
     const PrioritySet* local_priority_set_{};
+    // Set on workers only, as opposed to the main thread.
+    const absl::optional<uint32_t> worker_index_;
+    Http::Http2::DispatcherHandleSharedPtr dispatcher_handle_;
+    SharedLbTable<WorkerClusterManagers>::Reader workers_;
     bool destroying_{};
   };
 
@@ -436,12 +500,26 @@ private:
     MonotonicTime last_updated_;
   };
 
+  struct PendingThreadLocalUpdate {
+    HostSetDeltasByPriority deltas_;
+    // Hosts whose connection pools the workers drain once they applied the deltas, so that they
+    // do not create new connection pools for them from a stale host set.
+    HostVector hosts_to_drain_;
+  };
+  using PendingThreadLocalUpdateSharedPtr = std::shared_ptr<PendingThreadLocalUpdate>;
+
   using PendingUpdatesPtr = std::unique_ptr<PendingUpdates>;
   using PendingUpdatesByPriorityMap = std::unordered_map<uint32_t, PendingUpdatesPtr>;
   using PendingUpdatesByPriorityMapPtr = std::unique_ptr<PendingUpdatesByPriorityMap>;
   using ClusterUpdatesMap = std::unordered_map<std::string, PendingUpdatesByPriorityMapPtr>;
 
   void applyUpdates(const Cluster& cluster, uint32_t priority, PendingUpdates& updates);
+  void scheduleThreadLocalClusterUpdate(const Cluster& cluster, uint32_t priority,
+                                        const HostVector& hosts_added,
+                                        const HostVector& hosts_removed);
+  void mergeThreadLocalClusterUpdate(const std::string& cluster_name,
+                                     const std::function<void(PendingThreadLocalUpdate&)>& merge);
+  void flushThreadLocalClusterUpdates(const std::string& cluster_name);
   bool scheduleUpdate(const Cluster& cluster, uint32_t priority, bool mergeable,
                       const uint64_t timeout);
   void createOrUpdateThreadLocalCluster(ClusterData& cluster);
@@ -452,12 +530,20 @@ private:
   void onClusterInit(Cluster& cluster);
   void postThreadLocalHealthFailure(const HostSharedPtr& host);
   void updateClusterCounts();
+  void setWorkerClusterManager(uint32_t worker_index, WorkerClusterManager worker);
 
   ClusterManagerFactory& factory_;
   Runtime::Loader& runtime_;
   Stats::Store& stats_;
+  // The thread local cluster managers of the workers, which share HTTP/2 connections. These are
+  // registered by the thread local cluster managers themselves, so they must outlive tls_. The
+  // table is sized to the number of workers registered when the cluster manager is created.
+  Thread::MutexBasicLockable worker_cluster_managers_lock_;
+  SharedLbTable<WorkerClusterManagers> worker_cluster_managers_;
   ThreadLocal::SlotPtr tls_;
   Runtime::RandomGenerator& random_;
+  // Builds thread aware load balancer tables off the main thread. It must outlive the clusters.
+  LbTableBuilder lb_table_builder_;
 
 protected:
   ClusterMap active_clusters_;
@@ -478,6 +564,10 @@ private:
   Server::ConfigTracker::EntryOwnerPtr config_tracker_entry_;
   TimeSource& time_source_;
   ClusterUpdatesMap updates_map_;
+  // Host set updates which have not been posted to the workers yet, keyed by cluster name. They
+  // are posted once per main thread event loop iteration, see scheduleThreadLocalClusterUpdate().
+  // The posted flush only holds a weak reference to its entry, so erasing the entry cancels it.
+  std::unordered_map<std::string, PendingThreadLocalUpdateSharedPtr> pending_thread_local_updates_;
   Event::Dispatcher& dispatcher_;
   Http::Context& http_context_;
   Config::SubscriptionFactoryImpl subscription_factory_;
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
-#include <queue>
+#include <memory>
+#include <vector>
 
 #include "common/common/assert.h"
 
@@ -37,17 +39,17 @@ public:
         EDF_TRACE("Queue is empty.");
         return nullptr;
       }
-      const EdfEntry& edf_entry = queue_.top();
+      const EdfEntry& edf_entry = queue_.front();
       // Entry has been removed, let's see if there's another one.
       if (edf_entry.entry_.expired()) {
         EDF_TRACE("Entry has expired, repick.");
-        queue_.pop();
+        popEntry();
         continue;
       }
       std::shared_ptr<C> ret{edf_entry.entry_};
       ASSERT(edf_entry.deadline_ >= current_time_);
       current_time_ = edf_entry.deadline_;
-      queue_.pop();
+      popEntry();
       EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
       return ret;
     }
@@ -63,8 +65,25 @@ public:
     const double deadline = current_time_ + 1.0 / weight;
     EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
               static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
-    ASSERT(queue_.top().deadline_ >= current_time_);
+    queue_.push_back({deadline, order_offset_++, entry});
+    std::push_heap(queue_.begin(), queue_.end());
+    ASSERT(queue_.front().deadline_ >= current_time_);
+  }
+
+  /**
+   * Remove the entries for which the predicate returns true, as well as expired entries, in O(n)
+   * time. The remaining entries keep their deadlines, so the schedule carries on where it was
+   * instead of starting over as it would when rebuilding the scheduler.
+   * @param predicate supplies a function taking a const C& and returning bool.
+   */
+  template <class Predicate> void removeIf(Predicate predicate) {
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [&predicate](const EdfEntry& edf_entry) {
+                                  const std::shared_ptr<C> entry = edf_entry.entry_.lock();
+                                  return entry == nullptr || predicate(*entry);
+                                }),
+                 queue_.end());
+    std::make_heap(queue_.begin(), queue_.end());
   }
 
   /**
@@ -74,12 +93,17 @@ public:
   bool empty() const { return queue_.empty(); }
 
 private:
+  void popEntry() {
+    std::pop_heap(queue_.begin(), queue_.end());
+    queue_.pop_back();
+  }
+
   struct EdfEntry {
     double deadline_;
     // Tie breaker for entries with the same deadline. This is used to provide FIFO behavior.
     uint64_t order_offset_;
-    // We only hold a weak pointer, since we don't support a remove operator. This allows entries to
-    // be lazily unloaded from the queue.
+    // We only hold a weak pointer, so that entries whose owner has gone away are lazily unloaded
+    // from the queue without having to be removed explicitly.
     std::weak_ptr<C> entry_;
 
     // Flip < direction to make this a min queue.
@@ -96,8 +120,8 @@ private:
   // Offset used during addition to break ties when entries have the same weight but should reflect
   // FIFO insertion order in picks.
   uint64_t order_offset_{};
-  // Min priority queue for EDF.
-  std::priority_queue<EdfEntry> queue_;
+  // Min priority queue for EDF, kept as a heap so that entries can be removed in bulk.
+  std::vector<EdfEntry> queue_;
 };
 
 #undef EDF_DEBUG
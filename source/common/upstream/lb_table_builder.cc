@@ -0,0 +1,86 @@
+#include "common/upstream/lb_table_builder.h"
+
+#include <algorithm>
+
+#include "common/common/lock_guard.h"
+
+namespace Envoy {
+namespace Upstream {
+
+LbTableBuilder::LbTableBuilder(Thread::ThreadFactory& thread_factory)
+    : thread_factory_(thread_factory) {}
+
+LbTableBuilder::~LbTableBuilder() {
+  {
+    Thread::LockGuard lock(mutex_);
+    exit_ = true;
+    pending_builds_.clear();
+    build_event_.notifyOne();
+  }
+  if (thread_ != nullptr) {
+    thread_->join();
+  }
+}
+
+void LbTableBuilder::post(const void* owner, BuildCb build_cb) {
+  Thread::LockGuard lock(mutex_);
+  if (thread_ == nullptr) {
+    thread_ = thread_factory_.createThread([this]() -> void { threadRoutine(); });
+  }
+
+  auto it = std::find_if(pending_builds_.begin(), pending_builds_.end(),
+                         [owner](const PendingBuild& build) { return build.owner_ == owner; });
+  if (it != pending_builds_.end()) {
+    ENVOY_LOG(trace, "coalescing LB table build");
+    it->build_cb_ = std::move(build_cb);
+    return;
+  }
+  pending_builds_.push_back({owner, std::move(build_cb)});
+  build_event_.notifyOne();
+}
+
+void LbTableBuilder::cancel(const void* owner) {
+  Thread::LockGuard lock(mutex_);
+  pending_builds_.remove_if([owner](const PendingBuild& build) { return build.owner_ == owner; });
+  while (running_owner_ == owner) {
+    idle_event_.wait(mutex_);
+  }
+}
+
+void LbTableBuilder::waitForIdle() {
+  Thread::LockGuard lock(mutex_);
+  while (!pending_builds_.empty() || running_owner_ != nullptr) {
+    idle_event_.wait(mutex_);
+  }
+}
+
+void LbTableBuilder::threadRoutine() {
+  while (true) {
+    PendingBuild build;
+    {
+      Thread::LockGuard lock(mutex_);
+      while (!exit_ && pending_builds_.empty()) {
+        build_event_.wait(mutex_);
+      }
+      if (exit_) {
+        return;
+      }
+      build = std::move(pending_builds_.front());
+      pending_builds_.pop_front();
+      running_owner_ = build.owner_;
+    }
+
+    build.build_cb_();
+    // Destroy the callback, and with it the state it captured, before reporting completion.
+    build.build_cb_ = nullptr;
+
+    {
+      Thread::LockGuard lock(mutex_);
+      running_owner_ = nullptr;
+      idle_event_.notifyAll();
+    }
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <functional>
+#include <list>
+
+#include "envoy/thread/thread.h"
+
+#include "common/common/logger.h"
+#include "common/common/non_copyable.h"
+#include "common/common/thread.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Runs load balancing table builds (see SharedLbTable) on a dedicated background thread, so that
+ * the main thread is not blocked while large tables are computed. Builds are keyed by their owner:
+ * posting a build for an owner which has one pending replaces it, so that a burst of host set
+ * updates results in a single build of the latest state. Builds of the same owner never run
+ * concurrently and complete in the order they were posted.
+ *
+ * The thread is started lazily with the first build.
+ */
+class LbTableBuilder : NonCopyable, Logger::Loggable<Logger::Id::upstream> {
+public:
+  using BuildCb = std::function<void()>;
+
+  explicit LbTableBuilder(Thread::ThreadFactory& thread_factory);
+  ~LbTableBuilder();
+
+  /**
+   * Schedule a build. May only be called from the main thread.
+   * @param owner supplies the key identifying the table being built.
+   * @param build_cb supplies the build, which is run on the builder thread. It must publish the
+   *        table itself.
+   */
+  void post(const void* owner, BuildCb build_cb);
+
+  /**
+   * Drop the pending build of an owner and wait for its running build to complete, if any. Must
+   * be called before anything a build of the owner accesses is destroyed.
+   * @param owner supplies the key passed to post().
+   */
+  void cancel(const void* owner);
+
+  /**
+   * Block until all posted builds have completed.
+   */
+  void waitForIdle();
+
+private:
+  struct PendingBuild {
+    const void* owner_{};
+    BuildCb build_cb_;
+  };
+
+  void threadRoutine();
+
+  Thread::ThreadFactory& thread_factory_;
+  Thread::ThreadPtr thread_;
+  Thread::MutexBasicLockable mutex_;
+  Thread::CondVar build_event_;
+  Thread::CondVar idle_event_;
+  std::list<PendingBuild> pending_builds_ ABSL_GUARDED_BY(mutex_);
+  const void* running_owner_ ABSL_GUARDED_BY(mutex_){};
+  bool exit_ ABSL_GUARDED_BY(mutex_){};
+};
+
+using LbTableBuilderPtr = std::unique_ptr<LbTableBuilder>;
+
+} // namespace Upstream
+} // namespace Envoy
@@ -625,6 +625,34 @@ const HostVector& ZoneAwareLoadBalancerBase::hostSourceToHosts(HostsSource hosts
   }
 }
 
+constexpr uint32_t ZoneAwareLoadBalancerBase::MaxUnhealthyHostSkips;
+
+HostConstSharedPtr ZoneAwareLoadBalancerBase::chooseHostOnce(LoadBalancerContext* context) {
+  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context);
+  if (!hosts_source) {
+    return nullptr;
+  }
+
+  HostConstSharedPtr host = chooseHostFromSource(*hosts_source);
+  if (hosts_source->source_type_ == HostsSource::SourceType::AllHosts) {
+    // In panic mode unhealthy hosts are picked on purpose.
+    return host;
+  }
+
+  // The host sets are only updated some time after a host fails an active health check or is
+  // ejected by outlier detection. The health flags of the hosts are shared with the main thread
+  // and change right away though, so skip the hosts which are no longer healthy. This only covers
+  // the load balancers picking from host sources. Hosts which recover are not picked until the
+  // next host set update, and an unhealthy host is still returned after MaxUnhealthyHostSkips.
+  for (uint32_t i = 0; i < MaxUnhealthyHostSkips && host != nullptr &&
+                       host->health() == Host::Health::Unhealthy;
+       ++i) {
+    stats_.lb_unhealthy_host_skipped_.inc();
+    host = chooseHostFromSource(*hosts_source);
+  }
+  return host;
+}
+
 EdfLoadBalancerBase::EdfLoadBalancerBase(
     const PrioritySet& priority_set, const PrioritySet* local_priority_set, ClusterStats& stats,
     Runtime::Loader& runtime, Runtime::RandomGenerator& random,
@@ -632,11 +660,9 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
     : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                 common_config),
       seed_(random_.random()) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
-  // consistent with what other LB implementations do (e.g. thread aware).
-  // The downside of a full recompute is that time complexity is O(n * log n),
-  // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+  // The schedulers for a given host set are updated here on membership change. Rather than fully
+  // recomputing them in O(n * log n) time, the changes are applied to the existing schedulers, see
+  // updateScheduler().
   priority_set.addPriorityUpdateCb(
       [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
 }
@@ -649,41 +675,22 @@ void EdfLoadBalancerBase::initialize() {
 
 void EdfLoadBalancerBase::refresh(uint32_t priority) {
   const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
-    // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
+    auto& scheduler = scheduler_[source];
     refreshHostSource(source);
 
     // Check if the original host weights are equal and skip EDF creation if they are. When all
     // original weights are equal we can rely on unweighted host pick to do optimal round robin and
     // least-loaded host selection with lower memory and CPU overhead.
     if (hostWeightsAreEqual(hosts)) {
-      // Skip edf creation.
+      // Nuke existing scheduler if it exists and skip edf creation.
+      scheduler = Scheduler{};
       return;
     }
 
-    scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
-
-    // Populate scheduler with host list.
-    // TODO(mattklein123): We must build the EDF schedule even if all of the hosts are currently
-    // weighted 1. This is because currently we don't refresh host sets if only weights change.
-    // We should probably change this to refresh at all times. See the comment in
-    // BaseDynamicClusterImpl::updateDynamicHostList about this.
-    for (const auto& host : hosts) {
-      // We use a fixed weight here. While the weight may change without
-      // notification, this will only be stale until this host is next picked,
-      // at which point it is reinserted into the EdfScheduler with its new
-      // weight in chooseHost().
-      scheduler.edf_->add(hostWeight(*host), host);
-    }
-
-    // Cycle through hosts to achieve the intended offset behavior.
-    // TODO(htuch): Consider how we can avoid biasing towards earlier hosts in the schedule across
-    // refreshes for the weighted case.
-    if (!hosts.empty()) {
-      for (uint32_t i = 0; i < seed_ % hosts.size(); ++i) {
-        auto host = scheduler.edf_->pick();
-        scheduler.edf_->add(hostWeight(*host), host);
-      }
+    if (scheduler.edf_ == nullptr) {
+      buildScheduler(scheduler, hosts);
+    } else {
+      updateScheduler(scheduler, hosts);
     }
   };
 
@@ -708,12 +715,70 @@ void EdfLoadBalancerBase::refresh(uint32_t priority) {
   }
 }
 
-HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* context) {
-  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context);
-  if (!hosts_source) {
-    return nullptr;
+void EdfLoadBalancerBase::buildScheduler(Scheduler& scheduler, const HostVector& hosts) {
+  scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
+  scheduler.weights_.clear();
+  scheduler.weights_.reserve(hosts.size());
+
+  // Populate scheduler with host list.
+  // TODO(mattklein123): We must build the EDF schedule even if all of the hosts are currently
+  // weighted 1. This is because currently we don't refresh host sets if only weights change.
+  // We should probably change this to refresh at all times. See the comment in
+  // BaseDynamicClusterImpl::updateDynamicHostList about this.
+  for (const auto& host : hosts) {
+    // We use a fixed weight here. While the weight may change without
+    // notification, this will only be stale until this host is next picked,
+    // at which point it is reinserted into the EdfScheduler with its new
+    // weight in chooseHost().
+    scheduler.edf_->add(hostWeight(*host), host);
+    scheduler.weights_.emplace(host, host->weight());
+  }
+
+  // Cycle through hosts to achieve the intended offset behavior.
+  // TODO(htuch): Consider how we can avoid biasing towards earlier hosts in the schedule across
+  // refreshes for the weighted case.
+  if (!hosts.empty()) {
+    for (uint32_t i = 0; i < seed_ % hosts.size(); ++i) {
+      auto host = scheduler.edf_->pick();
+      scheduler.edf_->add(hostWeight(*host), host);
+    }
+  }
+}
+
+void EdfLoadBalancerBase::updateScheduler(Scheduler& scheduler, const HostVector& hosts) {
+  // Hosts which are new to the scheduler or whose original weight changed get a new entry, the
+  // entries of the other hosts keep their place in the schedule. This takes O(n) time to diff the
+  // host sets, plus O(m * log n) for m added or reweighted hosts, and an O(n) heap rebuild if any
+  // entries are stale.
+  absl::flat_hash_map<HostConstSharedPtr, uint32_t> weights;
+  weights.reserve(hosts.size());
+  HostVector hosts_to_add;
+  for (const auto& host : hosts) {
+    const uint32_t weight = host->weight();
+    weights.emplace(host, weight);
+    const auto it = scheduler.weights_.find(host.get());
+    if (it == scheduler.weights_.end() || it->second != weight) {
+      hosts_to_add.push_back(host);
+    }
+  }
+
+  if (hosts.size() - hosts_to_add.size() < scheduler.weights_.size()) {
+    // Some hosts have been removed or reweighted.
+    scheduler.edf_->removeIf([&scheduler, &weights](const Host& host) {
+      const auto new_weight = weights.find(&host);
+      const auto old_weight = scheduler.weights_.find(&host);
+      return new_weight == weights.end() || old_weight == scheduler.weights_.end() ||
+             new_weight->second != old_weight->second;
+    });
+  }
+  for (const auto& host : hosts_to_add) {
+    scheduler.edf_->add(hostWeight(*host), host);
   }
-  auto scheduler_it = scheduler_.find(*hosts_source);
+  scheduler.weights_ = std::move(weights);
+}
+
+HostConstSharedPtr EdfLoadBalancerBase::chooseHostFromSource(const HostsSource& hosts_source) {
+  auto scheduler_it = scheduler_.find(hosts_source);
   // We should always have a scheduler for any return value from
   // hostSourceToUse() via the construction in refresh();
   ASSERT(scheduler_it != scheduler_.end());
@@ -730,11 +795,11 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
     }
     return host;
   } else {
-    const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+    const HostVector& hosts_to_use = hostSourceToHosts(hosts_source);
     if (hosts_to_use.empty()) {
       return nullptr;
     }
-    return unweightedHostPick(hosts_to_use, *hosts_source);
+    return unweightedHostPick(hosts_to_use, hosts_source);
   }
 }
 
@@ -761,18 +826,47 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
-HostConstSharedPtr RandomLoadBalancer::chooseHostOnce(LoadBalancerContext* context) {
-  const absl::optional<HostsSource> hosts_source = hostSourceToUse(context);
-  if (!hosts_source) {
+HostConstSharedPtr RandomLoadBalancer::chooseHostFromSource(const HostsSource& hosts_source) {
+  const HostVector& hosts_to_use = hostSourceToHosts(hosts_source);
+  if (hosts_to_use.empty()) {
     return nullptr;
   }
 
-  const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
+  return hosts_to_use[random_.random() % hosts_to_use.size()];
+}
+
+constexpr double PeakEwmaLoadBalancer::UnknownLatencyPenalty;
+
+double PeakEwmaLoadBalancer::cost(const Host& host, MonotonicTime now) const {
+  const uint64_t active_rq = host.stats().rq_active_.value();
+  const double estimate = host.responseTimeEstimator().estimate(now);
+  if (estimate == 0) {
+    return active_rq == 0 ? 0 : UnknownLatencyPenalty + active_rq;
+  }
+  return estimate * (active_rq + 1);
+}
+
+HostConstSharedPtr PeakEwmaLoadBalancer::chooseHostFromSource(const HostsSource& hosts_source) {
+  const HostVector& hosts_to_use = hostSourceToHosts(hosts_source);
   if (hosts_to_use.empty()) {
     return nullptr;
   }
+  if (hosts_to_use.size() == 1) {
+    return hosts_to_use[0];
+  }
 
-  return hosts_to_use[random_.random() % hosts_to_use.size()];
+  // Pick two distinct hosts at random.
+  const uint64_t first = random_.random() % hosts_to_use.size();
+  uint64_t second = random_.random() % (hosts_to_use.size() - 1);
+  if (second >= first) {
+    ++second;
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  if (cost(*hosts_to_use[second], now) < cost(*hosts_to_use[first], now)) {
+    return hosts_to_use[second];
+  }
+  return hosts_to_use[first];
 }
 
 } // namespace Upstream
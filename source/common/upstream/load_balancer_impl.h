@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "envoy/api/v2/cds.pb.h"
+#include "envoy/common/time.h"
 #include "envoy/runtime/runtime.h"
 #include "envoy/upstream/load_balancer.h"
 #include "envoy/upstream/upstream.h"
@@ -13,6 +14,8 @@
 #include "common/protobuf/utility.h"
 #include "common/upstream/edf_scheduler.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -236,6 +239,19 @@ protected:
    */
   const HostVector& hostSourceToHosts(HostsSource hosts_source);
 
+  /**
+   * Pick a host out of the hosts of a hosts source.
+   * @return the host, or nullptr if the source has no hosts.
+   */
+  virtual HostConstSharedPtr chooseHostFromSource(const HostsSource& hosts_source) PURE;
+
+  // Upstream::LoadBalancerBase
+  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+
+  // The maximum number of hosts which are skipped in a pick because they have become unhealthy
+  // since the host sets were last updated.
+  static constexpr uint32_t MaxUnhealthyHostSkips = 8;
+
 private:
   enum class LocalityRoutingState {
     // Locality based routing is off.
@@ -347,15 +363,18 @@ public:
                       Runtime::RandomGenerator& random,
                       const envoy::api::v2::Cluster::CommonLbConfig& common_config);
 
-  // Upstream::LoadBalancerBase
-  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
-
 protected:
+  // Upstream::ZoneAwareLoadBalancerBase
+  HostConstSharedPtr chooseHostFromSource(const HostsSource& hosts_source) override;
+
   struct Scheduler {
     // EdfScheduler for weighted LB. The edf_ is only created when the original
     // host weights of 2 or more hosts differ. When not present, the
-    // implementation of chooseHostOnce falls back to unweightedHostPick.
+    // implementation of chooseHostFromSource falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<const Host>> edf_;
+    // Original weights of the hosts scheduled by edf_. Used to apply host set updates to edf_ in
+    // place rather than rebuilding it.
+    absl::flat_hash_map<HostConstSharedPtr, uint32_t> weights_;
   };
 
   void initialize();
@@ -369,6 +388,8 @@ protected:
 
 private:
   void refresh(uint32_t priority);
+  void buildScheduler(Scheduler& scheduler, const HostVector& hosts);
+  void updateScheduler(Scheduler& scheduler, const HostVector& hosts);
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
@@ -476,8 +497,44 @@ public:
       : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
                                   common_config) {}
 
-  // Upstream::LoadBalancerBase
-  HostConstSharedPtr chooseHostOnce(LoadBalancerContext* context) override;
+protected:
+  // Upstream::ZoneAwareLoadBalancerBase
+  HostConstSharedPtr chooseHostFromSource(const HostsSource& hosts_source) override;
+};
+
+/**
+ * Peak EWMA load balancer. Each host is assigned a cost of its estimated response time (a peak
+ * exponentially weighted moving average, see PeakEwmaEstimator) multiplied by its number of active
+ * requests plus one. Of two hosts chosen at random, the one with the lower cost is picked. This
+ * steers traffic away from hosts whose latency goes up before their requests start to queue,
+ * which least request alone cannot detect. Host weights are ignored.
+ *
+ * Picking a host costs O(1) regardless of the number of hosts. The estimates are updated by the
+ * router as responses complete, using lock free atomics shared by all workers.
+ */
+class PeakEwmaLoadBalancer : public ZoneAwareLoadBalancerBase {
+public:
+  PeakEwmaLoadBalancer(const PrioritySet& priority_set, const PrioritySet* local_priority_set,
+                       ClusterStats& stats, Runtime::Loader& runtime,
+                       Runtime::RandomGenerator& random,
+                       const envoy::api::v2::Cluster::CommonLbConfig& common_config,
+                       TimeSource& time_source)
+      : ZoneAwareLoadBalancerBase(priority_set, local_priority_set, stats, runtime, random,
+                                  common_config),
+        time_source_(time_source) {}
+
+  // Upstream::ZoneAwareLoadBalancerBase
+  HostConstSharedPtr chooseHostFromSource(const HostsSource& hosts_source) override;
+
+  // The cost of a host without a response time estimate but with requests in flight. It is higher
+  // than the cost of any responsive host, so that a new host is not flooded before its first
+  // response comes back.
+  static constexpr double UnknownLatencyPenalty = 1e12;
+
+private:
+  double cost(const Host& host, MonotonicTime now) const;
+
+  TimeSource& time_source_;
 };
 
 /**
@@ -84,6 +84,9 @@ public:
   Outlier::DetectorHostMonitor& outlierDetector() const override {
     return logical_host_->outlierDetector();
   }
+  ResponseTimeEstimator& responseTimeEstimator() const override {
+    return logical_host_->responseTimeEstimator();
+  }
   HostStats& stats() const override { return logical_host_->stats(); }
   const std::string& hostname() const override { return logical_host_->hostname(); }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
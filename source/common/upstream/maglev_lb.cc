@@ -3,6 +3,8 @@
 namespace Envoy {
 namespace Upstream {
 
+constexpr uint32_t MaglevTable::EmptyEntry;
+
 MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weights,
                          double max_normalized_weight, uint64_t table_size,
                          MaglevLoadBalancerStats& stats)
@@ -22,15 +24,18 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   // Implementation of pseudocode listing 1 in the paper (see header file for more info).
   std::vector<TableBuildEntry> table_build_entries;
   table_build_entries.reserve(normalized_host_weights.size());
+  hosts_.reserve(normalized_host_weights.size());
   for (const auto& host_weight : normalized_host_weights) {
     const auto& host = host_weight.first;
     const std::string& address = host->address()->asString();
-    table_build_entries.emplace_back(host, HashUtil::xxHash64(address) % table_size_,
+    table_build_entries.emplace_back(hosts_.size(), HashUtil::xxHash64(address) % table_size_,
                                      (HashUtil::xxHash64(address, 1) % (table_size_ - 1)) + 1,
                                      host_weight.second);
+    hosts_.push_back(host);
   }
 
-  table_.resize(table_size_);
+  // Build with wide indices and narrow them afterwards if possible.
+  std::vector<uint32_t> table(table_size_, EmptyEntry);
 
   // Iterate through the table build entries as many times as it takes to fill up the table.
   uint64_t table_index = 0;
@@ -46,12 +51,12 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
       }
       entry.target_weight_ += max_normalized_weight;
       uint64_t c = permutation(entry);
-      while (table_[c] != nullptr) {
+      while (table[c] != EmptyEntry) {
         entry.next_++;
         c = permutation(entry);
       }
 
-      table_[c] = entry.host_;
+      table[c] = entry.host_index_;
       entry.next_++;
       entry.count_++;
       table_index++;
@@ -68,18 +73,25 @@ MaglevTable::MaglevTable(const NormalizedHostWeightVector& normalized_host_weigh
   stats_.max_entries_per_host_.set(max_entries_per_host);
 
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (uint64_t i = 0; i < table_.size(); i++) {
-      ENVOY_LOG(trace, "maglev: i={} host={}", i, table_[i]->address()->asString());
+    for (uint64_t i = 0; i < table.size(); i++) {
+      ENVOY_LOG(trace, "maglev: i={} host={}", i, hosts_[table[i]]->address()->asString());
     }
   }
+
+  if (hosts_.size() <= std::numeric_limits<uint16_t>::max() + 1) {
+    table_.assign(table.begin(), table.end());
+  } else {
+    wide_table_ = std::move(table);
+  }
 }
 
 HostConstSharedPtr MaglevTable::chooseHost(uint64_t hash) const {
-  if (table_.empty()) {
+  if (hosts_.empty()) {
     return nullptr;
   }
 
-  return table_[hash % table_size_];
+  const uint64_t index = hash % table_size_;
+  return hosts_[table_.empty() ? wide_table_[index] : table_[index]];
 }
 
 uint64_t MaglevTable::permutation(const TableBuildEntry& entry) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include "envoy/stats/scope.h"
 #include "envoy/stats/stats_macros.h"
 
@@ -43,10 +45,10 @@ public:
 
 private:
   struct TableBuildEntry {
-    TableBuildEntry(const HostConstSharedPtr& host, uint64_t offset, uint64_t skip, double weight)
-        : host_(host), offset_(offset), skip_(skip), weight_(weight) {}
+    TableBuildEntry(uint32_t host_index, uint64_t offset, uint64_t skip, double weight)
+        : host_index_(host_index), offset_(offset), skip_(skip), weight_(weight) {}
 
-    HostConstSharedPtr host_;
+    const uint32_t host_index_;
     const uint64_t offset_;
     const uint64_t skip_;
     const double weight_;
@@ -57,8 +59,16 @@ private:
 
   uint64_t permutation(const TableBuildEntry& entry);
 
+  // Marks table entries which have not been assigned a host yet while building the table.
+  static constexpr uint32_t EmptyEntry = std::numeric_limits<uint32_t>::max();
+
   const uint64_t table_size_;
-  std::vector<HostConstSharedPtr> table_;
+  // The hosts in the table, which refers to them by their index. Storing 2 byte indices rather
+  // than shared pointers shrinks the default table from 1MiB to 128KiB. Clusters with more hosts
+  // than fit into 16 bits use 4 byte indices instead.
+  std::vector<HostConstSharedPtr> hosts_;
+  std::vector<uint16_t> table_;
+  std::vector<uint32_t> wide_table_;
   MaglevLoadBalancerStats& stats_;
 };
 
@@ -71,6 +81,7 @@ public:
                      Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                      const envoy::api::v2::Cluster::CommonLbConfig& common_config,
                      uint64_t table_size = MaglevTable::DefaultTableSize);
+  ~MaglevLoadBalancer() override { cancelTableBuild(); }
 
   const MaglevLoadBalancerStats& stats() const { return stats_; }
 
@@ -573,10 +573,12 @@ DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
   // threshold returned = 52
   double mean = success_rate_sum / valid_success_rate_hosts.size();
   double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
+  // This runs on the main thread for every host of large clusters, so avoid copying the hosts and
+  // calling std::pow() for each of them.
+  for (const HostSuccessRatePair& v : valid_success_rate_hosts) {
+    const double deviation = v.success_rate_ - mean;
+    variance += deviation * deviation;
+  }
   variance /= valid_success_rate_hosts.size();
   double stdev = std::sqrt(variance);
 
@@ -651,13 +653,15 @@ void DetectorImpl::processSuccessRateEjections(
     getSRNums(monitor_type) = successRateEjectionThreshold(
         success_rate_sum, valid_success_rate_hosts, success_rate_stdev_factor);
     const double success_rate_ejection_threshold = getSRNums(monitor_type).ejection_threshold_;
+    // All the success rate monitors of a type have the same ejection type, so there is no need to
+    // look up the monitor of each outlier.
+    const envoy::data::cluster::v2alpha::OutlierEjectionType type =
+        (monitor_type == DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin)
+            ? envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE
+            : envoy::data::cluster::v2alpha::OutlierEjectionType::SUCCESS_RATE_LOCAL_ORIGIN;
     for (const auto& host_success_rate_pair : valid_success_rate_hosts) {
       if (host_success_rate_pair.success_rate_ < success_rate_ejection_threshold) {
         stats_.ejections_success_rate_.inc(); // Deprecated.
-        const envoy::data::cluster::v2alpha::OutlierEjectionType type =
-            host_monitors_[host_success_rate_pair.host_]
-                ->getSRMonitor(monitor_type)
-                .getEjectionType();
         updateDetectedEjectionStats(type);
         ejectHost(host_success_rate_pair.host_, type);
       }
@@ -690,7 +694,7 @@ void DetectorImpl::processSuccessRateEjections(
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
-  for (auto host : host_monitors_) {
+  for (const auto& host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
     // Need to update the writer bucket to keep the data valid.
@@ -702,7 +706,11 @@ void DetectorImpl::onIntervalTimer() {
   }
 
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::ExternalOrigin);
-  processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  // Local origin results are only counted separately when the errors are split. Otherwise the
+  // local origin monitors have no data, and going through all the hosts once more would be a waste.
+  if (config_.splitExternalLocalOriginErrors()) {
+    processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
+  }
 
   armIntervalTimer();
 }
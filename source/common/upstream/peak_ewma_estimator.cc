@@ -0,0 +1,46 @@
+#include "common/upstream/peak_ewma_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Envoy {
+namespace Upstream {
+
+namespace {
+
+int64_t toNanoseconds(MonotonicTime time) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+PeakEwmaEstimator::PeakEwmaEstimator(std::chrono::nanoseconds decay_time)
+    : decay_time_ns_(std::max<double>(decay_time.count(), 1)) {}
+
+void PeakEwmaEstimator::putResponseTime(std::chrono::microseconds response_time,
+                                        MonotonicTime now) {
+  const int64_t now_ns = toNanoseconds(now);
+  const double sample = response_time.count();
+  const int64_t last_update_ns = last_update_ns_.exchange(now_ns, std::memory_order_relaxed);
+  const double weight =
+      now_ns > last_update_ns ? std::exp((last_update_ns - now_ns) / decay_time_ns_) : 1.0;
+
+  // Concurrent updates may interleave between the timestamp exchange and the swap below; each of
+  // them still gets applied, only with a slightly inexact decay.
+  double current = estimate_.load(std::memory_order_relaxed);
+  double updated;
+  do {
+    updated = sample > current ? sample : current * weight + sample * (1 - weight);
+  } while (!estimate_.compare_exchange_weak(current, updated, std::memory_order_relaxed));
+}
+
+double PeakEwmaEstimator::estimate(MonotonicTime now) const {
+  const double current = estimate_.load(std::memory_order_relaxed);
+  const int64_t elapsed_ns = toNanoseconds(now) - last_update_ns_.load(std::memory_order_relaxed);
+  // Without new responses the estimate decays towards zero, so that a host which had a latency
+  // spike eventually gets probed again.
+  return elapsed_ns > 0 ? current * std::exp(-elapsed_ns / decay_time_ns_) : current;
+}
+
+} // namespace Upstream
+} // namespace Envoy
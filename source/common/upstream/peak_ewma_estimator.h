@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "envoy/common/time.h"
+#include "envoy/upstream/host_description.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Peak exponentially weighted moving average of the response times of a host. A response time
+ * above the average replaces it right away, so that the estimate reacts to a latency spike with
+ * the first slow response. Faster responses, and the passing of time without any responses, decay
+ * the estimate with a time constant of decay_time. Lock free: updates from multiple workers are
+ * applied with a compare and swap loop.
+ */
+class PeakEwmaEstimator : public ResponseTimeEstimator {
+public:
+  explicit PeakEwmaEstimator(std::chrono::nanoseconds decay_time);
+
+  // Upstream::ResponseTimeEstimator
+  void putResponseTime(std::chrono::microseconds response_time, MonotonicTime now) override;
+  double estimate(MonotonicTime now) const override;
+
+private:
+  const double decay_time_ns_;
+  // Estimate in microseconds, as of last_update_ns_.
+  std::atomic<double> estimate_{0};
+  std::atomic<int64_t> last_update_ns_{0};
+};
+
+/**
+ * Estimator of hosts whose response times are not tracked.
+ */
+class ResponseTimeEstimatorNullImpl : public ResponseTimeEstimator {
+public:
+  // Upstream::ResponseTimeEstimator
+  void putResponseTime(std::chrono::microseconds, MonotonicTime) override {}
+  double estimate(MonotonicTime) const override { return 0; }
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -41,40 +41,36 @@ RingHashLoadBalancerStats RingHashLoadBalancer::generateStats(Stats::Scope& scop
 }
 
 HostConstSharedPtr RingHashLoadBalancer::Ring::chooseHost(uint64_t h) const {
-  if (ring_.empty()) {
+  if (hashes_.empty()) {
     return nullptr;
   }
 
-  // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c (ketama_get_server)
-  // I've generally kept the variable names to make the code easier to compare.
-  // NOTE: The algorithm depends on using signed integers for lowp, midp, and highp. Do not
-  //       change them!
-  int64_t lowp = 0;
-  int64_t highp = ring_.size();
-  while (true) {
-    int64_t midp = (lowp + highp) / 2;
-
-    if (midp == static_cast<int64_t>(ring_.size())) {
-      return ring_[0].host_;
-    }
-
-    uint64_t midval = ring_[midp].hash_;
-    uint64_t midval1 = midp == 0 ? 0 : ring_[midp - 1].hash_;
-
-    if (h <= midval && h > midval1) {
-      return ring_[midp].host_;
-    }
-
-    if (midval < h) {
-      lowp = midp + 1;
-    } else {
-      highp = midp - 1;
-    }
+  // Find the first entry whose hash is >= h, wrapping around to the first one if there is none.
+  // This matches ketama (https://github.com/RJ/ketama/blob/master/libketama/ketama.c,
+  // ketama_get_server). Walk down the implicit tree, going right whenever the entry is < h.
+  const uint64_t ring_size = hashes_.size() - 1;
+  uint64_t k = 1;
+  while (k <= ring_size) {
+    k = 2 * k + (hashes_[k] < h);
+  }
+  // The answer is the entry at which the walk went left for the last time: drop the trailing
+  // right turns and then the left turn itself. If the walk never went left, k ends up as 0.
+  while (k & 1) {
+    k >>= 1;
+  }
+  k >>= 1;
+  return hosts_[k == 0 ? first_host_index_ : host_indices_[k]];
+}
 
-    if (lowp > highp) {
-      return ring_[0].host_;
-    }
+uint64_t RingHashLoadBalancer::Ring::layOut(const std::vector<RingEntry>& sorted_ring, uint64_t i,
+                                            uint64_t k) {
+  if (k < hashes_.size()) {
+    i = layOut(sorted_ring, i, 2 * k);
+    hashes_[k] = sorted_ring[i].hash_;
+    host_indices_[k] = sorted_ring[i].host_index_;
+    i = layOut(sorted_ring, i + 1, 2 * k + 1);
   }
+  return i;
 }
 
 using HashFunction = envoy::api::v2::Cluster_RingHashLbConfig_HashFunction;
@@ -101,7 +97,9 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
 
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  std::vector<RingEntry> ring;
+  ring.reserve(ring_size);
+  hosts_.reserve(normalized_host_weights.size());
 
   // Populate the hash ring by walking through the (host, weight) pairs in normalized_host_weights,
   // and generating (scale * weight) hashes for each host. Since these aren't necessarily whole
@@ -127,6 +125,8 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
   uint64_t max_hashes_per_host = 0;
   for (const auto& entry : normalized_host_weights) {
     const auto& host = entry.first;
+    const uint32_t host_index = hosts_.size();
+    hosts_.push_back(host);
     const std::string& address_string = host->address()->asString();
     uint64_t offset_start = address_string.size();
 
@@ -158,7 +158,7 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
               : HashUtil::xxHash64(hash_key);
 
       ENVOY_LOG(trace, "ring hash: hash_key={} hash={}", hash_key.data(), hash);
-      ring_.push_back({hash, host});
+      ring.push_back({hash, host_index});
       ++i;
       ++current_hashes;
     }
@@ -166,16 +166,23 @@ RingHashLoadBalancer::Ring::Ring(const NormalizedHostWeightVector& normalized_ho
     max_hashes_per_host = std::max(i, max_hashes_per_host);
   }
 
-  std::sort(ring_.begin(), ring_.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
+  std::sort(ring.begin(), ring.end(), [](const RingEntry& lhs, const RingEntry& rhs) -> bool {
     return lhs.hash_ < rhs.hash_;
   });
   if (ENVOY_LOG_CHECK_LEVEL(trace)) {
-    for (const auto& entry : ring_) {
-      ENVOY_LOG(trace, "ring hash: host={} hash={}", entry.host_->address()->asString(),
-                entry.hash_);
+    for (const auto& entry : ring) {
+      ENVOY_LOG(trace, "ring hash: host={} hash={}",
+                hosts_[entry.host_index_]->address()->asString(), entry.hash_);
     }
   }
 
+  if (!ring.empty()) {
+    hashes_.resize(ring.size() + 1);
+    host_indices_.resize(ring.size() + 1);
+    layOut(ring, 0, 1);
+    first_host_index_ = ring[0].host_index_;
+  }
+
   stats_.size_.set(ring_size);
   stats_.min_hashes_per_host_.set(min_hashes_per_host);
   stats_.max_hashes_per_host_.set(max_hashes_per_host);
@@ -43,6 +43,7 @@ public:
                        Runtime::Loader& runtime, Runtime::RandomGenerator& random,
                        const absl::optional<envoy::api::v2::Cluster::RingHashLbConfig>& config,
                        const envoy::api::v2::Cluster::CommonLbConfig& common_config);
+  ~RingHashLoadBalancer() override { cancelTableBuild(); }
 
   const RingHashLoadBalancerStats& stats() const { return stats_; }
 
@@ -51,7 +52,7 @@ private:
 
   struct RingEntry {
     uint64_t hash_;
-    HostConstSharedPtr host_;
+    uint32_t host_index_;
   };
 
   struct Ring : public HashingLoadBalancer {
@@ -62,7 +63,19 @@ private:
     // ThreadAwareLoadBalancerBase::HashingLoadBalancer
     HostConstSharedPtr chooseHost(uint64_t hash) const override;
 
-    std::vector<RingEntry> ring_;
+    // Copies sorted_ring into the subtree of entry k in Eytzinger order by walking it in order,
+    // starting with element i. Returns the index of the first element not copied.
+    uint64_t layOut(const std::vector<RingEntry>& sorted_ring, uint64_t i, uint64_t k);
+
+    // The hosts on the ring, which refers to them by their index.
+    std::vector<HostConstSharedPtr> hosts_;
+    // The sorted ring in Eytzinger (breadth first) order, 1-indexed: the children of entry k are
+    // entries 2k and 2k + 1. The first steps of every lookup hit the same few cache lines, and the
+    // hashes are kept apart from the host indices so that a cache line holds 8 of them.
+    std::vector<uint64_t> hashes_;
+    std::vector<uint32_t> host_indices_;
+    // The index of the host with the lowest hash, which hashes past the end of the ring wrap to.
+    uint32_t first_host_index_{};
 
     RingHashLoadBalancerStats& stats_;
   };
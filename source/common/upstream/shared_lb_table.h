@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "common/common/non_copyable.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Publishes an immutable, versioned load balancing table (e.g. a hash ring or a Maglev table) to
+ * any number of worker threads. The table is computed once by a single writer, on the main thread
+ * or a background thread, and swapped in atomically. Workers never take a lock to pick a host:
+ * they read through a Reader which only reloads the table once the version has changed.
+ *
+ * Old tables stay alive until the last worker has moved on to a newer version.
+ */
+template <class Table> class SharedLbTable : NonCopyable {
+public:
+  using TableConstSharedPtr = std::shared_ptr<const Table>;
+
+  /**
+   * Worker local view of a SharedLbTable. A Reader must only be used by a single thread, and the
+   * SharedLbTable must outlive it.
+   */
+  class Reader {
+  public:
+    explicit Reader(const SharedLbTable& shared_table) : shared_table_(shared_table) {}
+
+    /**
+     * @return const Table* the most recently published table, or nullptr if no table has been
+     *         published yet. The pointer remains valid until the next call.
+     */
+    const Table* get() {
+      const uint64_t version = shared_table_.version();
+      if (version != version_) {
+        current_ = shared_table_.get();
+        version_ = version;
+      }
+      return current_.get();
+    }
+
+  private:
+    const SharedLbTable& shared_table_;
+    uint64_t version_{};
+    TableConstSharedPtr current_;
+  };
+
+  /**
+   * Replace the current table. May be called from any thread, but only from one at a time.
+   * @param table supplies the new table.
+   */
+  void publish(TableConstSharedPtr table) {
+    std::atomic_store(&table_, std::move(table));
+    // Readers that see the new version are guaranteed to load the new table (or a newer one).
+    version_.fetch_add(1, std::memory_order_release);
+  }
+
+  /**
+   * @return TableConstSharedPtr the most recently published table, or nullptr.
+   */
+  TableConstSharedPtr get() const { return std::atomic_load(&table_); }
+
+  /**
+   * @return uint64_t the number of tables published so far.
+   */
+  uint64_t version() const { return version_.load(std::memory_order_acquire); }
+
+private:
+  TableConstSharedPtr table_;
+  std::atomic<uint64_t> version_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
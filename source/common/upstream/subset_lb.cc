@@ -349,8 +349,16 @@ void SubsetLoadBalancer::processSubsets(
     const HostVector& hosts_added, const HostVector& hosts_removed,
     std::function<void(LbSubsetEntryPtr)> update_cb,
     std::function<void(LbSubsetEntryPtr, HostPredicate, const SubsetMetadata&, bool)> new_cb) {
+  struct ModifiedSubset {
+    LbSubsetEntryPtr entry_;
+    SubsetMetadata kvs_;
+    bool adding_hosts_;
+  };
   std::unordered_set<LbSubsetEntryPtr> subsets_modified;
+  std::vector<ModifiedSubset> modified_subsets;
 
+  // Create all the entries before invoking any callback, so that the host membership computed by
+  // the subset predicates is not invalidated by entries created later on.
   std::pair<const HostVector&, bool> steps[] = {{hosts_added, true}, {hosts_removed, false}};
   for (const auto& step : steps) {
     const auto& hosts = step.first;
@@ -361,30 +369,29 @@ void SubsetLoadBalancer::processSubsets(
         // For each host, for each subset key, attempt to extract the metadata corresponding to the
         // key from the host.
         std::vector<SubsetMetadata> all_kvs = extractSubsetMetadata(keys, *host);
-        for (const auto& kvs : all_kvs) {
+        for (auto& kvs : all_kvs) {
           // The host has metadata for each key, find or create its subset.
           auto entry = findOrCreateSubset(subsets_, kvs, 0);
-          if (entry != nullptr) {
-            if (subsets_modified.find(entry) != subsets_modified.end()) {
-              // We've already invoked the callback for this entry.
-              continue;
-            }
-            subsets_modified.emplace(entry);
-
-            if (entry->initialized()) {
-              update_cb(entry);
-            } else {
-              HostPredicate predicate = [this, kvs](const Host& host) -> bool {
-                return hostMatches(kvs, host);
-              };
-              new_cb(entry, predicate, kvs, adding_hosts);
-            }
+          if (entry != nullptr && subsets_modified.emplace(entry).second) {
+            modified_subsets.push_back({entry, std::move(kvs), adding_hosts});
           }
         }
       }
     }
   }
 
+  for (const auto& modified : modified_subsets) {
+    if (modified.entry_->initialized()) {
+      update_cb(modified.entry_);
+    } else {
+      const uint32_t subset_id = modified.entry_->id_;
+      HostPredicate predicate = [this, subset_id](const Host& host) -> bool {
+        return hostInSubset(host, subset_id);
+      };
+      new_cb(modified.entry_, predicate, modified.kvs_, modified.adding_hosts_);
+    }
+  }
+
   forEachSubset(subsets_, [&](LbSubsetEntryPtr entry) {
     if (subsets_modified.find(entry) != subsets_modified.end()) {
       // Already handled due to hosts being added or removed.
@@ -432,6 +439,11 @@ void SubsetLoadBalancer::update(uint32_t priority, const HostVector& hosts_added
           stats_.lb_subsets_created_.inc();
         }
       });
+
+  // Removed hosts may be freed once the update completes.
+  for (const auto& host : hosts_removed) {
+    host_subsets_.erase(host.get());
+  }
 }
 
 bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host) {
@@ -439,6 +451,28 @@ bool SubsetLoadBalancer::hostMatches(const SubsetMetadata& kvs, const Host& host
       kvs, *host.metadata(), Config::MetadataFilters::get().ENVOY_LB, list_as_any_);
 }
 
+// Returns whether the host belongs to the subset with the given id. The host's membership in all
+// subsets is computed on first use and cached until its metadata changes or subsets are added.
+bool SubsetLoadBalancer::hostInSubset(const Host& host, uint32_t subset_id) {
+  HostSubsetMembership& membership = host_subsets_[&host];
+  std::shared_ptr<envoy::api::v2::core::Metadata> metadata = host.metadata();
+  if (membership.metadata_ != metadata || membership.subsets_.size() != subset_count_) {
+    membership.metadata_ = std::move(metadata);
+    membership.subsets_.assign(subset_count_, false);
+    for (const auto& subset_selector : subset_selectors_) {
+      for (const auto& kvs : extractSubsetMetadata(subset_selector->selector_keys_, host)) {
+        const LbSubsetEntry* entry = findExistingSubset(kvs);
+        if (entry != nullptr) {
+          membership.subsets_[entry->id_] = true;
+        }
+      }
+    }
+  }
+
+  ASSERT(subset_id < membership.subsets_.size());
+  return membership.subsets_[subset_id];
+}
+
 // Iterates over subset_keys looking up values from the given host's metadata. Each key-value pair
 // is appended to kvs. Returns a non-empty value if the host has a value for each key.
 std::vector<SubsetLoadBalancer::SubsetMetadata>
@@ -546,6 +580,7 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
   if (!entry) {
     // Not found. Create an uninitialized entry.
     entry = std::make_shared<LbSubsetEntry>();
+    entry->id_ = subset_count_++;
     if (kv_it != subsets.end()) {
       ValueSubsetMap& value_subset_map = kv_it->second;
       value_subset_map.emplace(value, entry);
@@ -564,6 +599,26 @@ SubsetLoadBalancer::findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadat
   return findOrCreateSubset(entry->children_, kvs, idx);
 }
 
+// Like findOrCreateSubset, but returns nullptr rather than creating missing entries.
+const SubsetLoadBalancer::LbSubsetEntry*
+SubsetLoadBalancer::findExistingSubset(const SubsetMetadata& kvs) const {
+  const LbSubsetMap* subsets = &subsets_;
+  const LbSubsetEntry* entry = nullptr;
+  for (const auto& kv : kvs) {
+    const auto kv_it = subsets->find(kv.first);
+    if (kv_it == subsets->end()) {
+      return nullptr;
+    }
+    const auto vs_it = kv_it->second.find(HashedValue(kv.second));
+    if (vs_it == kv_it->second.end()) {
+      return nullptr;
+    }
+    entry = vs_it->second.get();
+    subsets = &entry->children_;
+  }
+  return entry;
+}
+
 // Invokes cb for each LbSubsetEntryPtr in subsets.
 void SubsetLoadBalancer::forEachSubset(LbSubsetMap& subsets,
                                        std::function<void(LbSubsetEntryPtr)> cb) {
@@ -636,8 +691,10 @@ SubsetLoadBalancer::PrioritySubsetImpl::PrioritySubsetImpl(const SubsetLoadBalan
 
   case LoadBalancerType::OriginalDst:
   case LoadBalancerType::ClusterProvided:
-    // LoadBalancerType::OriginalDst is blocked in the factory. LoadBalancerType::ClusterProvided
-    // is impossible because the subset LB returns a null load balancer from its factory.
+  case LoadBalancerType::PeakEwma:
+    // LoadBalancerType::OriginalDst is blocked in the factory. LoadBalancerType::PeakEwma is
+    // rejected by ClusterInfoImpl. LoadBalancerType::ClusterProvided is impossible because the
+    // subset LB returns a null load balancer from its factory.
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
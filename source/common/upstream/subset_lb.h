@@ -15,6 +15,7 @@
 #include "common/protobuf/utility.h"
 #include "common/upstream/upstream_impl.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
 
 namespace Envoy {
@@ -142,6 +143,9 @@ private:
 
     LbSubsetMap children_;
 
+    // Dense index of the entry within subsets_, used to look up host membership.
+    uint32_t id_{};
+
     // Only initialized if a match exists at this level.
     PrioritySubsetImplPtr priority_subset_;
   };
@@ -167,12 +171,14 @@ private:
   tryFindSelectorFallbackPolicy(LoadBalancerContext* context);
 
   bool hostMatches(const SubsetMetadata& kvs, const Host& host);
+  bool hostInSubset(const Host& host, uint32_t subset_id);
 
   LbSubsetEntryPtr
   findSubset(const std::vector<Router::MetadataMatchCriterionConstSharedPtr>& matches);
 
   LbSubsetEntryPtr findOrCreateSubset(LbSubsetMap& subsets, const SubsetMetadata& kvs,
                                       uint32_t idx);
+  const LbSubsetEntry* findExistingSubset(const SubsetMetadata& kvs) const;
   void forEachSubset(LbSubsetMap& subsets, std::function<void(LbSubsetEntryPtr)> cb);
 
   std::vector<SubsetMetadata> extractSubsetMetadata(const std::set<std::string>& subset_keys,
@@ -204,6 +210,17 @@ private:
 
   // Forms a trie-like structure. Requires lexically sorted Host and Route metadata.
   LbSubsetMap subsets_;
+  // Number of entries in subsets_. Entries are never removed.
+  uint32_t subset_count_{};
+
+  // The subsets of subsets_ a host belongs to, as a bitset indexed by LbSubsetEntry::id_. It is
+  // computed once from the host's metadata and reused by the predicates of all subsets, until the
+  // metadata changes or new subsets are created.
+  struct HostSubsetMembership {
+    std::shared_ptr<envoy::api::v2::core::Metadata> metadata_;
+    std::vector<bool> subsets_;
+  };
+  absl::flat_hash_map<const Host*, HostSubsetMembership> host_subsets_;
   // Forms a trie-like structure of lexically sorted keys+fallback policy from subset
   // selectors configuration
   SubsetSelectorMapPtr selectors_;
@@ -2,6 +2,9 @@
 
 #include <memory>
 
+#include "common/common/hash.h"
+#include "common/common/lock_guard.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -72,57 +75,146 @@ void normalizeWeights(const HostSet& host_set, bool in_panic,
 
 } // namespace
 
+ThreadAwareLoadBalancerBase::~ThreadAwareLoadBalancerBase() { cancelTableBuild(); }
+
 void ThreadAwareLoadBalancerBase::initialize() {
-  // TODO(mattklein123): In the future, once initialized and the initial LB is built, it would be
-  // better to use a background thread for computing LB updates. This has the substantial benefit
-  // that if the LB computation thread falls behind, host set updates can be trivially collapsed.
-  // I will look into doing this in a follow up. Doing everything using a background thread heavily
-  // complicated initialization as the load balancer would need its own initialized callback. I
-  // think the synchronous/asynchronous split is probably the best option.
+  // The initial tables are always built synchronously, so that the load balancer is usable as soon
+  // as the cluster is initialized. Later updates are built on the table builder if one was
+  // supplied. Workers keep using the previous tables until then, without the removed hosts, and
+  // builds for updates that arrive while one is pending are collapsed into one.
   priority_set_.addPriorityUpdateCb(
-      [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
+      [this](uint32_t, const HostVector& hosts_added, const HostVector& hosts_removed) -> void {
+        refresh(hosts_added, hosts_removed);
+      });
 
-  refresh();
+  refresh({}, {});
+  initialized_ = true;
 }
 
-void ThreadAwareLoadBalancerBase::refresh() {
-  auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
-      priority_set_.hostSetsPerPriority().size());
-  auto healthy_per_priority_load =
-      std::make_shared<HealthyLoad>(per_priority_load_.healthy_priority_load_);
-  auto degraded_per_priority_load =
-      std::make_shared<DegradedLoad>(per_priority_load_.degraded_priority_load_);
+void ThreadAwareLoadBalancerBase::cancelTableBuild() {
+  if (table_builder_ != nullptr) {
+    table_builder_->cancel(this);
+  }
+}
 
+void ThreadAwareLoadBalancerBase::refresh(const HostVector& hosts_added,
+                                          const HostVector& hosts_removed) {
+  // Snapshot everything the build needs on the main thread; the priority set and the state of
+  // LoadBalancerBase may change while the tables are being built.
+  std::vector<PerPriorityInput> inputs(priority_set_.hostSetsPerPriority().size());
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
-    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
-    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    PerPriorityInput& input = inputs[priority];
     // Copy panic flag from LoadBalancerBase. It is calculated when there is a change
     // in hosts set or hosts' health.
-    per_priority_state->global_panic_ = per_priority_panic_[priority];
+    input.global_panic_ = per_priority_panic_[priority];
 
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
-    NormalizedHostWeightVector normalized_host_weights;
-    double min_normalized_weight = 1.0;
-    double max_normalized_weight = 0.0;
-    normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
-                     min_normalized_weight, max_normalized_weight);
-    per_priority_state->current_lb_ =
-        createLoadBalancer(normalized_host_weights, min_normalized_weight, max_normalized_weight);
+    normalizeWeights(*host_set, input.global_panic_, input.normalized_host_weights_,
+                     input.min_normalized_weight_, input.max_normalized_weight_);
   }
 
-  {
-    absl::WriterMutexLock lock(&factory_->mutex_);
-    factory_->healthy_per_priority_load_ = healthy_per_priority_load;
-    factory_->degraded_per_priority_load_ = degraded_per_priority_load;
-    factory_->per_priority_state_ = per_priority_state_vector;
+  const uint64_t generation = ++generation_;
+  bool build_now = table_builder_ == nullptr || !initialized_;
+  if (!build_now) {
+    uint64_t num_hosts = 0;
+    for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
+      num_hosts += host_set->hosts().size();
+    }
+
+    Thread::LockGuard lock(built_table_lock_);
+    for (const HostSharedPtr& host : hosts_added) {
+      removed_hosts_.erase(host);
+    }
+    for (const HostSharedPtr& host : hosts_removed) {
+      removed_hosts_[host] = generation;
+    }
+    // Connection pools of removed hosts are drained right away, so workers must stop choosing them
+    // before the build completes. Rehashing the keys of removed hosts finds another host quickly
+    // while most of the hosts remain; otherwise build the tables right away.
+    build_now = removed_hosts_.size() > num_hosts;
+    if (!build_now) {
+      publishBuiltTable();
+    }
+  }
+
+  if (build_now) {
+    // A pending build would be of older inputs.
+    cancelTableBuild();
+    onTableBuilt(buildTable(inputs, per_priority_load_.healthy_priority_load_,
+                            per_priority_load_.degraded_priority_load_),
+                 generation);
+    return;
   }
+
+  table_builder_->post(this, [this, inputs = std::move(inputs),
+                              healthy_per_priority_load = per_priority_load_.healthy_priority_load_,
+                              degraded_per_priority_load =
+                                  per_priority_load_.degraded_priority_load_,
+                              generation]() -> void {
+    onTableBuilt(buildTable(inputs, healthy_per_priority_load, degraded_per_priority_load),
+                 generation);
+  });
+}
+
+void ThreadAwareLoadBalancerBase::onTableBuilt(std::shared_ptr<const Table>&& table,
+                                               uint64_t generation) {
+  Thread::LockGuard lock(built_table_lock_);
+  // Builds complete in the order of their updates, and cancelTableBuild() waits for the running
+  // one before a table is built on the main thread.
+  ASSERT(generation > built_generation_);
+  built_table_ = std::move(table);
+  built_generation_ = generation;
+  // The table was built from a priority set without the hosts removed up to its update.
+  for (auto it = removed_hosts_.begin(); it != removed_hosts_.end();) {
+    if (it->second <= generation) {
+      removed_hosts_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  publishBuiltTable();
+}
+
+void ThreadAwareLoadBalancerBase::publishBuiltTable() {
+  if (removed_hosts_.empty()) {
+    factory_->shared_table_->publish(built_table_);
+    return;
+  }
+
+  // Only the set of excluded hosts is copied; the hashing load balancers are shared.
+  auto table = std::make_shared<Table>(*built_table_);
+  for (const auto& removed_host : removed_hosts_) {
+    table->excluded_hosts_.insert(removed_host.first);
+  }
+  factory_->shared_table_->publish(std::move(table));
+}
+
+std::shared_ptr<const ThreadAwareLoadBalancerBase::Table>
+ThreadAwareLoadBalancerBase::buildTable(const std::vector<PerPriorityInput>& inputs,
+                                        const HealthyLoad& healthy_per_priority_load,
+                                        const DegradedLoad& degraded_per_priority_load) {
+  auto table = std::make_shared<Table>();
+  table->healthy_per_priority_load_ = healthy_per_priority_load;
+  table->degraded_per_priority_load_ = degraded_per_priority_load;
+  table->per_priority_state_.reserve(inputs.size());
+  for (const PerPriorityInput& input : inputs) {
+    auto per_priority_state = std::make_shared<PerPriorityState>();
+    per_priority_state->global_panic_ = input.global_panic_;
+    per_priority_state->current_lb_ =
+        createLoadBalancer(input.normalized_host_weights_, input.min_normalized_weight_,
+                           input.max_normalized_weight_);
+    table->per_priority_state_.push_back(std::move(per_priority_state));
+  }
+  return table;
 }
 
 HostConstSharedPtr
 ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* context) {
+  // The table is swapped in by the main thread or the table builder; only reload it if it changed.
+  const Table* table = table_.get();
   // Make sure we correctly return nullptr for any early chooseHost() calls.
-  if (per_priority_state_ == nullptr) {
+  if (table == nullptr) {
     return nullptr;
   }
 
@@ -136,26 +228,33 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
   const uint64_t h = hash ? hash.value() : random_.random();
 
   const uint32_t priority =
-      LoadBalancerBase::choosePriority(h, *healthy_per_priority_load_, *degraded_per_priority_load_)
+      LoadBalancerBase::choosePriority(h, table->healthy_per_priority_load_,
+                                       table->degraded_per_priority_load_)
           .first;
-  const auto& per_priority_state = (*per_priority_state_)[priority];
+  const auto& per_priority_state = table->per_priority_state_[priority];
   if (per_priority_state->global_panic_) {
     stats_.lb_healthy_panic_.inc();
   }
-  return per_priority_state->current_lb_->chooseHost(h);
+
+  HostConstSharedPtr host = per_priority_state->current_lb_->chooseHost(h);
+  // Keys of hosts which were removed since the table was built are rehashed until they reach a
+  // remaining host, the same one for the same key, until the rebuilt table is published.
+  uint64_t rehashed = h;
+  for (uint32_t i = 0; host != nullptr && table->excluded_hosts_.count(host) != 0; ++i) {
+    if (i == MaxExcludedHostRehashes) {
+      return nullptr;
+    }
+    rehashed = HashUtil::xxHash64(
+        absl::string_view(reinterpret_cast<const char*>(&rehashed), sizeof(rehashed)));
+    host = per_priority_state->current_lb_->chooseHost(rehashed);
+  }
+  return host;
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create() {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
-
-  // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
-  // threads. All complex processing has already been precalculated however.
-  absl::ReaderMutexLock lock(&mutex_);
-  lb->healthy_per_priority_load_ = healthy_per_priority_load_;
-  lb->degraded_per_priority_load_ = degraded_per_priority_load_;
-  lb->per_priority_state_ = per_priority_state_;
-
-  return lb;
+  // No locking is needed: the worker local load balancer reads the most recently published table,
+  // which is immutable, and picks up newer ones as they are published.
+  return std::make_unique<LoadBalancerImpl>(stats_, random_, shared_table_);
 }
 
 } // namespace Upstream
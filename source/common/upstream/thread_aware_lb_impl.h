@@ -1,8 +1,12 @@
 #pragma once
 
+#include "common/common/thread.h"
+#include "common/upstream/lb_table_builder.h"
 #include "common/upstream/load_balancer_impl.h"
+#include "common/upstream/shared_lb_table.h"
 
-#include "absl/synchronization/mutex.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -26,10 +30,21 @@ public:
   };
   using HashingLoadBalancerSharedPtr = std::shared_ptr<HashingLoadBalancer>;
 
+  ~ThreadAwareLoadBalancerBase() override;
+
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   void initialize() override;
 
+  /**
+   * Build the tables for host set updates after the initial one on the supplied builder rather
+   * than on the main thread. Workers keep using the previous tables until the build completes,
+   * except for the hosts which have been removed since they were built. Must be called before
+   * initialize().
+   * @param builder supplies the builder, which must outlive this load balancer.
+   */
+  void setTableBuilder(LbTableBuilder& builder) { table_builder_ = &builder; }
+
   // Upstream::LoadBalancerBase
   HostConstSharedPtr chooseHostOnce(LoadBalancerContext*) override {
     NOT_IMPLEMENTED_GCOVR_EXCL_LINE;
@@ -42,49 +57,96 @@ protected:
       : LoadBalancerBase(priority_set, stats, runtime, random, common_config),
         factory_(new LoadBalancerFactoryImpl(stats, random)) {}
 
+  /**
+   * Drop any pending table build and wait for a running one. Subclasses whose
+   * createLoadBalancer() accesses their own members must call this in their destructor.
+   */
+  void cancelTableBuild();
+
 private:
   struct PerPriorityState {
     std::shared_ptr<HashingLoadBalancer> current_lb_;
     bool global_panic_{};
   };
-  using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
+  using PerPriorityStateConstSharedPtr = std::shared_ptr<const PerPriorityState>;
+
+  // The input of a table build, snapshotted from the priority set on the main thread.
+  struct PerPriorityInput {
+    NormalizedHostWeightVector normalized_host_weights_;
+    double min_normalized_weight_{1.0};
+    double max_normalized_weight_{0.0};
+    bool global_panic_{};
+  };
+
+  // Everything workers need to choose a host, published as a whole after every host set update.
+  struct Table {
+    std::vector<PerPriorityStateConstSharedPtr> per_priority_state_;
+    // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
+    HealthyLoad healthy_per_priority_load_;
+    DegradedLoad degraded_per_priority_load_;
+    // The hosts which were removed after the hashing load balancers were built, and which must not
+    // be chosen anymore.
+    absl::flat_hash_set<HostConstSharedPtr> excluded_hosts_;
+  };
+  using SharedTable = SharedLbTable<Table>;
+
+  // The number of times a key which hashes to an excluded host is rehashed before giving up.
+  static constexpr uint32_t MaxExcludedHostRehashes = 16;
 
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(ClusterStats& stats, Runtime::RandomGenerator& random,
+                     std::shared_ptr<const SharedTable> shared_table)
+        : stats_(stats), random_(random), shared_table_(std::move(shared_table)),
+          table_(*shared_table_) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
 
     ClusterStats& stats_;
     Runtime::RandomGenerator& random_;
-    std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
-    std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
-    std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
+    const std::shared_ptr<const SharedTable> shared_table_;
+    SharedTable::Reader table_;
   };
 
   struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
     LoadBalancerFactoryImpl(ClusterStats& stats, Runtime::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+        : stats_(stats), random_(random), shared_table_(std::make_shared<SharedTable>()) {}
 
     // Upstream::LoadBalancerFactory
     LoadBalancerPtr create() override;
+    bool recreateOnHostChange() const override { return false; }
 
     ClusterStats& stats_;
     Runtime::RandomGenerator& random_;
-    absl::Mutex mutex_;
-    std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_ ABSL_GUARDED_BY(mutex_);
-    // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
-    std::shared_ptr<HealthyLoad> healthy_per_priority_load_ ABSL_GUARDED_BY(mutex_);
-    std::shared_ptr<DegradedLoad> degraded_per_priority_load_ ABSL_GUARDED_BY(mutex_);
+    const std::shared_ptr<SharedTable> shared_table_;
   };
 
   virtual HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
-  void refresh();
+  void refresh(const HostVector& hosts_added, const HostVector& hosts_removed);
+  std::shared_ptr<const Table> buildTable(const std::vector<PerPriorityInput>& inputs,
+                                          const HealthyLoad& healthy_per_priority_load,
+                                          const DegradedLoad& degraded_per_priority_load);
+  // Publishes the built table of a generation, unless a newer one has been built already.
+  void onTableBuilt(std::shared_ptr<const Table>&& table, uint64_t generation);
+  // Publishes the latest built table, excluding the hosts removed since it was built.
+  void publishBuiltTable() ABSL_EXCLUSIVE_LOCKS_REQUIRED(built_table_lock_);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
+  LbTableBuilder* table_builder_{};
+  bool initialized_{};
+  // The generation of the latest host set update, incremented on the main thread.
+  uint64_t generation_{};
+
+  // Published tables are derived from the latest built table by the main thread and the builder.
+  Thread::MutexBasicLockable built_table_lock_;
+  std::shared_ptr<const Table> built_table_ ABSL_GUARDED_BY(built_table_lock_);
+  uint64_t built_generation_ ABSL_GUARDED_BY(built_table_lock_){};
+  // The hosts removed from the priority set, by the generation of the update which removed them,
+  // which built_table_ may still contain.
+  absl::flat_hash_map<HostConstSharedPtr, uint64_t>
+      removed_hosts_ ABSL_GUARDED_BY(built_table_lock_);
 };
 
 } // namespace Upstream
@@ -239,6 +239,13 @@ HostDescriptionImpl::HostDescriptionImpl(
       health_check_config.port_value() == 0
           ? dest_address
           : Network::Utility::getAddressWithPort(*dest_address, health_check_config.port_value());
+  if (cluster->lbType() == LoadBalancerType::PeakEwma) {
+    const auto& peak_ewma_config = cluster->lbPeakEwmaConfig();
+    response_time_estimator_ = std::make_unique<PeakEwmaEstimator>(std::chrono::milliseconds(
+        peak_ewma_config.has_value()
+            ? PROTOBUF_GET_MS_OR_DEFAULT(peak_ewma_config.value(), decay_time, 10000)
+            : 10000));
+  }
 }
 
 Network::TransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFactory(
@@ -626,6 +633,15 @@ ClusterInfoImpl::ClusterInfoImpl(
     : runtime_(runtime), name_(config.name()), type_(config.type()),
       max_requests_per_connection_(
           PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_requests_per_connection, 0)),
+      per_upstream_prefetch_ratio_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+          config.prefetch_policy(), per_upstream_prefetch_ratio, 1.0)),
+      per_upstream_min_warm_connections_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.prefetch_policy(), min_warm_connections, 0)),
+      http2_connection_sharing_owners_(
+          config.has_http2_connection_sharing()
+              ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.http2_connection_sharing(),
+                                                owner_workers_per_host, 1)
+              : 0),
       max_response_headers_count_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           config.common_http_protocol_options(), max_headers_count,
           runtime_.snapshot().getInteger(Http::MaxResponseHeadersCountOverrideKey,
@@ -646,6 +662,7 @@ ClusterInfoImpl::ClusterInfoImpl(
       source_address_(getSourceAddress(config, bind_config)),
       lb_least_request_config_(config.least_request_lb_config()),
       lb_ring_hash_config_(config.ring_hash_lb_config()),
+      lb_peak_ewma_config_(config.peak_ewma_lb_config()),
       lb_original_dst_config_(config.original_dst_lb_config()), added_via_api_(added_via_api),
       lb_subset_(LoadBalancerSubsetInfoImpl(config.lb_subset_config())),
       metadata_(config.metadata()), typed_metadata_(config.metadata()),
@@ -701,6 +718,15 @@ ClusterInfoImpl::ClusterInfoImpl(
 
     lb_type_ = LoadBalancerType::ClusterProvided;
     break;
+  case envoy::api::v2::Cluster::PEAK_EWMA:
+    if (config.has_lb_subset_config()) {
+      throw EnvoyException(
+          fmt::format("cluster: LB policy {} cannot be combined with lb_subset_config",
+                      envoy::api::v2::Cluster_LbPolicy_Name(config.lb_policy())));
+    }
+
+    lb_type_ = LoadBalancerType::PeakEwma;
+    break;
   default:
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
@@ -41,6 +41,7 @@
 #include "common/stats/isolated_store_impl.h"
 #include "common/upstream/load_balancer_impl.h"
 #include "common/upstream/outlier_detection_impl.h"
+#include "common/upstream/peak_ewma_estimator.h"
 #include "common/upstream/resource_manager_impl.h"
 #include "common/upstream/transport_socket_match_impl.h"
 
@@ -116,6 +117,15 @@ public:
       return *null_outlier_detector;
     }
   }
+  ResponseTimeEstimator& responseTimeEstimator() const override {
+    if (response_time_estimator_) {
+      return *response_time_estimator_;
+    } else {
+      static ResponseTimeEstimatorNullImpl* null_response_time_estimator =
+          new ResponseTimeEstimatorNullImpl();
+      return *null_response_time_estimator;
+    }
+  }
   HostStats& stats() const override { return stats_; }
   const std::string& hostname() const override { return hostname_; }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
@@ -147,6 +157,7 @@ protected:
   mutable HostStats stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
+  std::unique_ptr<ResponseTimeEstimator> response_time_estimator_;
   std::atomic<uint32_t> priority_;
   Network::TransportSocketFactory& socket_factory_;
 };
@@ -203,21 +214,25 @@ public:
     outlier_detector_ = std::move(outlier_detector);
   }
   Host::Health health() const override {
+    // The flags are changed by the main thread while the workers read them, so read them once to
+    // get a consistent view.
+    const uint64_t health_flags = health_flags_.load(std::memory_order_relaxed);
+
     // If any of the unhealthy flags are set, host is unhealthy.
-    if (healthFlagGet(HealthFlag::FAILED_ACTIVE_HC) ||
-        healthFlagGet(HealthFlag::FAILED_OUTLIER_CHECK) ||
-        healthFlagGet(HealthFlag::FAILED_EDS_HEALTH)) {
+    if (health_flags & (enumToInt(HealthFlag::FAILED_ACTIVE_HC) |
+                        enumToInt(HealthFlag::FAILED_OUTLIER_CHECK) |
+                        enumToInt(HealthFlag::FAILED_EDS_HEALTH))) {
       return Host::Health::Unhealthy;
     }
 
     // If any of the degraded flags are set, host is degraded.
-    if (healthFlagGet(HealthFlag::DEGRADED_ACTIVE_HC) ||
-        healthFlagGet(HealthFlag::DEGRADED_EDS_HEALTH)) {
+    if (health_flags & (enumToInt(HealthFlag::DEGRADED_ACTIVE_HC) |
+                        enumToInt(HealthFlag::DEGRADED_EDS_HEALTH))) {
       return Host::Health::Degraded;
     }
 
     // The host must have no flags or be pending removal.
-    ASSERT(health_flags_ == 0 || healthFlagGet(HealthFlag::PENDING_DYNAMIC_REMOVAL));
+    ASSERT(health_flags == 0 || (health_flags & enumToInt(HealthFlag::PENDING_DYNAMIC_REMOVAL)));
     return Host::Health::Healthy;
   }
 
@@ -546,12 +561,23 @@ public:
   lbRingHashConfig() const override {
     return lb_ring_hash_config_;
   }
+  const absl::optional<envoy::api::v2::Cluster::PeakEwmaLbConfig>&
+  lbPeakEwmaConfig() const override {
+    return lb_peak_ewma_config_;
+  }
   const absl::optional<envoy::api::v2::Cluster::OriginalDstLbConfig>&
   lbOriginalDstConfig() const override {
     return lb_original_dst_config_;
   }
   bool maintenanceMode() const override;
   uint64_t maxRequestsPerConnection() const override { return max_requests_per_connection_; }
+  float perUpstreamPrefetchRatio() const override { return per_upstream_prefetch_ratio_; }
+  uint32_t perUpstreamMinWarmConnections() const override {
+    return per_upstream_min_warm_connections_;
+  }
+  uint32_t http2ConnectionSharingOwners() const override {
+    return http2_connection_sharing_owners_;
+  }
   uint32_t maxResponseHeadersCount() const override { return max_response_headers_count_; }
   const std::string& name() const override { return name_; }
   ResourceManager& resourceManager(ResourcePriority priority) const override;
@@ -596,6 +622,9 @@ private:
   const std::string name_;
   const envoy::api::v2::Cluster::DiscoveryType type_;
   const uint64_t max_requests_per_connection_;
+  const float per_upstream_prefetch_ratio_;
+  const uint32_t per_upstream_min_warm_connections_;
+  const uint32_t http2_connection_sharing_owners_;
   const uint32_t max_response_headers_count_;
   const std::chrono::milliseconds connect_timeout_;
   absl::optional<std::chrono::milliseconds> idle_timeout_;
@@ -615,6 +644,7 @@ private:
   LoadBalancerType lb_type_;
   absl::optional<envoy::api::v2::Cluster::LeastRequestLbConfig> lb_least_request_config_;
   absl::optional<envoy::api::v2::Cluster::RingHashLbConfig> lb_ring_hash_config_;
+  absl::optional<envoy::api::v2::Cluster::PeakEwmaLbConfig> lb_peak_ewma_config_;
   absl::optional<envoy::api::v2::Cluster::OriginalDstLbConfig> lb_original_dst_config_;
   const bool added_via_api_;
   LoadBalancerSubsetInfoImpl lb_subset_;
@@ -13,18 +13,21 @@ namespace Quic {
 ActiveQuicListener::ActiveQuicListener(Event::Dispatcher& dispatcher,
                                        Network::ConnectionHandler& parent,
                                        Network::ListenerConfig& listener_config,
-                                       const quic::QuicConfig& quic_config)
+                                       const quic::QuicConfig& quic_config,
+                                       const Network::UdpListenerBatchConfig& batch_config)
     : ActiveQuicListener(dispatcher, parent,
-                         dispatcher.createUdpListener(listener_config.socket(), *this),
-                         listener_config, quic_config) {}
+                         dispatcher.createUdpListener(listener_config.socket(), *this,
+                                                      batch_config),
+                         listener_config, quic_config, batch_config.max_batch_size_) {}
 
 ActiveQuicListener::ActiveQuicListener(Event::Dispatcher& dispatcher,
                                        Network::ConnectionHandler& parent,
                                        Network::UdpListenerPtr&& listener,
                                        Network::ListenerConfig& listener_config,
-                                       const quic::QuicConfig& quic_config)
+                                       const quic::QuicConfig& quic_config, uint32_t max_batch_size)
     : ActiveQuicListener(dispatcher, parent,
-                         std::make_unique<EnvoyQuicPacketWriter>(listener_config.socket()),
+                         std::make_unique<EnvoyQuicPacketWriter>(listener_config.socket(),
+                                                                 *listener, max_batch_size),
                          std::move(listener), listener_config, quic_config) {}
 
 ActiveQuicListener::ActiveQuicListener(Event::Dispatcher& dispatcher,
@@ -34,7 +37,7 @@ ActiveQuicListener::ActiveQuicListener(Event::Dispatcher& dispatcher,
                                        Network::ListenerConfig& listener_config,
                                        const quic::QuicConfig& quic_config)
     : Server::ConnectionHandlerImpl::ActiveListenerImplBase(parent, listener_config),
-      udp_listener_(std::move(listener)), dispatcher_(dispatcher),
+      udp_listener_(std::move(listener)), writer_(writer.get()), dispatcher_(dispatcher),
       version_manager_(quic::CurrentSupportedVersions()) {
   quic::QuicRandom* const random = quic::QuicRandom::GetInstance();
   random->RandBytes(random_seed_, sizeof(random_seed_));
@@ -79,6 +82,13 @@ void ActiveQuicListener::onData(Network::UdpRecvData& data) {
 }
 
 void ActiveQuicListener::onWriteReady(const Network::Socket& /*socket*/) {
+  if (writer_->IsBatchMode()) {
+    // Send the packets buffered when the socket blocked before any connection writes new ones.
+    writer_->SetWritable();
+    if (writer_->Flush().status != quic::WRITE_STATUS_OK) {
+      return;
+    }
+  }
   quic_dispatcher_->OnCanWrite();
 }
 
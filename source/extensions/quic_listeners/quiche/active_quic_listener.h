@@ -20,11 +20,12 @@ class ActiveQuicListener : public Network::UdpListenerCallbacks,
                            Logger::Loggable<Logger::Id::quic> {
 public:
   ActiveQuicListener(Event::Dispatcher& dispatcher, Network::ConnectionHandler& parent,
-                     Network::ListenerConfig& listener_config, const quic::QuicConfig& quic_config);
+                     Network::ListenerConfig& listener_config, const quic::QuicConfig& quic_config,
+                     const Network::UdpListenerBatchConfig& batch_config);
 
   ActiveQuicListener(Event::Dispatcher& dispatcher, Network::ConnectionHandler& parent,
                      Network::UdpListenerPtr&& listener, Network::ListenerConfig& listener_config,
-                     const quic::QuicConfig& quic_config);
+                     const quic::QuicConfig& quic_config, uint32_t max_batch_size);
 
   // TODO(#7465): Make this a callback.
   void onListenerShutdown();
@@ -50,6 +51,8 @@ private:
                      const quic::QuicConfig& quic_config);
 
   Network::UdpListenerPtr udp_listener_;
+  // Owned by quic_dispatcher_.
+  quic::QuicPacketWriter* writer_;
   uint8_t random_seed_[16];
   std::unique_ptr<quic::QuicCryptoServerConfig> crypto_config_;
   Event::Dispatcher& dispatcher_;
@@ -78,13 +81,16 @@ public:
     int32_t max_streams = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_concurrent_streams, 100);
     quic_config_.SetMaxIncomingBidirectionalStreamsToSend(max_streams);
     quic_config_.SetMaxIncomingUnidirectionalStreamsToSend(max_streams);
+    batch_config_.max_batch_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_size, 1);
+    batch_config_.enable_udp_offload_ = config.enable_udp_offload();
   }
 
   // Network::ActiveUdpListenerFactory.
   Network::ConnectionHandler::ActiveListenerPtr
   createActiveUdpListener(Network::ConnectionHandler& parent, Event::Dispatcher& disptacher,
                           Network::ListenerConfig& config) const override {
-    return std::make_unique<ActiveQuicListener>(disptacher, parent, config, quic_config_);
+    return std::make_unique<ActiveQuicListener>(disptacher, parent, config, quic_config_,
+                                                batch_config_);
   }
   bool isTransportConnectionless() const override { return false; }
 
@@ -92,6 +98,7 @@ private:
   friend class ActiveQuicListenerFactoryPeer;
 
   quic::QuicConfig quic_config_;
+  Network::UdpListenerBatchConfig batch_config_;
 };
 
 } // namespace Quic
@@ -2,6 +2,8 @@
 
 #include <sys/socket.h>
 
+#include <vector>
+
 #pragma GCC diagnostic push
 
 // QUICHE allows unused parameters.
@@ -22,6 +24,12 @@ namespace Quic {
 EnvoyQuicPacketWriter::EnvoyQuicPacketWriter(Network::Socket& socket)
     : write_blocked_(false), socket_(socket) {}
 
+EnvoyQuicPacketWriter::EnvoyQuicPacketWriter(Network::Socket& socket,
+                                             Network::UdpListener& listener,
+                                             uint32_t max_batch_size)
+    : write_blocked_(false), socket_(socket), listener_(&listener),
+      max_batch_size_(max_batch_size) {}
+
 quic::WriteResult EnvoyQuicPacketWriter::WritePacket(const char* buffer, size_t buf_len,
                                                      const quic::QuicIpAddress& self_ip,
                                                      const quic::QuicSocketAddress& peer_address,
@@ -29,26 +37,87 @@ quic::WriteResult EnvoyQuicPacketWriter::WritePacket(const char* buffer, size_t
   ASSERT(options == nullptr, "Per packet option is not supported yet.");
   ASSERT(!write_blocked_, "Cannot write while IO handle is blocked.");
 
-  Buffer::RawSlice slice;
-  slice.mem_ = const_cast<char*>(buffer);
-  slice.len_ = buf_len;
   quic::QuicSocketAddress self_address(self_ip, /*port=*/0);
   Network::Address::InstanceConstSharedPtr local_addr =
       quicAddressToEnvoyAddressInstance(self_address);
   Network::Address::InstanceConstSharedPtr remote_addr =
       quicAddressToEnvoyAddressInstance(peer_address);
+
+  if (IsBatchMode()) {
+    if (buffered_packets_.size() >= max_batch_size_) {
+      quic::WriteResult result = Flush();
+      if (result.status != quic::WRITE_STATUS_OK) {
+        return result;
+      }
+    }
+    buffered_packets_.emplace_back();
+    BufferedPacket& packet = buffered_packets_.back();
+    packet.local_address_ = std::move(local_addr);
+    packet.peer_address_ = std::move(remote_addr);
+    packet.buffer_.add(buffer, buf_len);
+    // Nothing is written until the batch is flushed.
+    return {quic::WRITE_STATUS_OK, 0};
+  }
+
+  Buffer::RawSlice slice;
+  slice.mem_ = const_cast<char*>(buffer);
+  slice.len_ = buf_len;
   Api::IoCallUint64Result result = Network::Utility::writeToSocket(
       socket_, &slice, 1, local_addr == nullptr ? nullptr : local_addr->ip(), *remote_addr);
   if (result.ok()) {
     return {quic::WRITE_STATUS_OK, static_cast<int>(result.rc_)};
   }
-  quic::WriteStatus status = result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again
+  return writeResultFromError(*result.err_);
+}
+
+quic::WriteResult EnvoyQuicPacketWriter::Flush() {
+  if (buffered_packets_.empty()) {
+    return {quic::WRITE_STATUS_OK, 0};
+  }
+  if (write_blocked_) {
+    return {quic::WRITE_STATUS_BLOCKED, static_cast<int>(Api::IoError::IoErrorCode::Again)};
+  }
+
+  std::vector<Network::UdpSendData> send_data;
+  send_data.reserve(buffered_packets_.size());
+  uint64_t bytes_buffered = 0;
+  for (BufferedPacket& packet : buffered_packets_) {
+    bytes_buffered += packet.buffer_.length();
+    send_data.push_back(Network::UdpSendData{
+        packet.local_address_ == nullptr ? nullptr : packet.local_address_->ip(),
+        *packet.peer_address_, packet.buffer_});
+  }
+  Api::IoCallUint64Result result = listener_->sendBatch(send_data.data(), send_data.size());
+  if (!result.ok()) {
+    const quic::WriteResult write_result = writeResultFromError(*result.err_);
+    if (write_result.status == quic::WRITE_STATUS_ERROR) {
+      // The connection is closed upon a write error; the buffered packets won't be retried.
+      buffered_packets_.clear();
+    }
+    return write_result;
+  }
+
+  // sendBatch() drains the buffers of the packets it sent.
+  for (uint64_t i = 0; i < result.rc_; i++) {
+    buffered_packets_.pop_front();
+  }
+  if (!buffered_packets_.empty()) {
+    // The socket couldn't take the whole batch. The rest is sent upon the next Flush() once the
+    // socket is writable.
+    write_blocked_ = true;
+    return {quic::WRITE_STATUS_BLOCKED, static_cast<int>(Api::IoError::IoErrorCode::Again)};
+  }
+  return {quic::WRITE_STATUS_OK, static_cast<int>(bytes_buffered)};
+}
+
+quic::WriteResult EnvoyQuicPacketWriter::writeResultFromError(const Api::IoError& err) {
+  quic::WriteStatus status = err.getErrorCode() == Api::IoError::IoErrorCode::Again
                                  ? quic::WRITE_STATUS_BLOCKED
                                  : quic::WRITE_STATUS_ERROR;
   if (quic::IsWriteBlockedStatus(status)) {
     write_blocked_ = true;
   }
-  return {status, static_cast<int>(result.err_->getErrorCode())};
+  return {status, static_cast<int>(err.getErrorCode())};
 }
 
 } // namespace Quic
@@ -10,14 +10,23 @@
 
 #pragma GCC diagnostic pop
 
+#include <deque>
+
 #include "envoy/network/listener.h"
 
+#include "common/buffer/buffer_impl.h"
+
 namespace Envoy {
 namespace Quic {
 
+// Writes QUIC packets to the listen socket. If constructed with a batch size greater than 1, the
+// writer is in batch mode: packets are buffered and sent with UdpListener::sendBatch() once the
+// batch is full or upon Flush().
 class EnvoyQuicPacketWriter : public quic::QuicPacketWriter {
 public:
   EnvoyQuicPacketWriter(Network::Socket& socket);
+  EnvoyQuicPacketWriter(Network::Socket& socket, Network::UdpListener& listener,
+                        uint32_t max_batch_size);
 
   quic::WriteResult WritePacket(const char* buffer, size_t buf_len,
                                 const quic::QuicIpAddress& self_address,
@@ -31,19 +40,33 @@ public:
   GetMaxPacketSize(const quic::QuicSocketAddress& /*peer_address*/) const override {
     return quic::kMaxOutgoingPacketSize;
   }
-  // Currently this writer doesn't support pacing offload or batch writing.
+  // Currently this writer doesn't support pacing offload.
   bool SupportsReleaseTime() const override { return false; }
-  bool IsBatchMode() const override { return false; }
+  bool IsBatchMode() const override { return max_batch_size_ > 1; }
   char* GetNextWriteLocation(const quic::QuicIpAddress& /*self_address*/,
                              const quic::QuicSocketAddress& /*peer_address*/) override {
     return nullptr;
   }
-  quic::WriteResult Flush() override { return {quic::WRITE_STATUS_OK, 0}; }
+  quic::WriteResult Flush() override;
+
+  uint64_t numBufferedPackets() const { return buffered_packets_.size(); }
 
 private:
-  // Modified by WritePacket() to indicate underlying IoHandle status.
+  struct BufferedPacket {
+    Network::Address::InstanceConstSharedPtr local_address_;
+    Network::Address::InstanceConstSharedPtr peer_address_;
+    Buffer::OwnedImpl buffer_;
+  };
+
+  quic::WriteResult writeResultFromError(const Api::IoError& err);
+
+  // Modified by WritePacket() and Flush() to indicate underlying IoHandle status.
   bool write_blocked_;
   Network::Socket& socket_;
+  // Only set in batch mode.
+  Network::UdpListener* listener_{};
+  const uint32_t max_batch_size_{1};
+  std::deque<BufferedPacket> buffered_packets_;
 };
 
 } // namespace Quic
@@ -33,6 +33,20 @@ public:
     }
     return io_handle_.writev(slices, num_slice);
   }
+  Api::IoCallUint64Result read(Buffer::Instance& buffer, uint64_t max_length) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.read(buffer, max_length);
+  }
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.write(buffer);
+  }
   Api::IoCallUint64Result sendto(const Buffer::RawSlice& slice, int flags,
                                  const Network::Address::Instance& address) override {
     if (closed_) {
@@ -58,6 +72,35 @@ public:
     }
     return io_handle_.recvmsg(slices, num_slice, self_port, output);
   }
+  Api::IoCallUint64Result recvmmsg(Buffer::RawSlice* slices, uint64_t num_packets,
+                                   uint32_t self_port, RecvMsgOutput* output) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.recvmmsg(slices, num_packets, self_port, output);
+  }
+  Api::IoCallUint64Result sendmmsg(const SendMsgInput* messages, uint64_t num_messages) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.sendmmsg(messages, num_messages);
+  }
+  bool supportsMmsg() const override { return io_handle_.supportsMmsg(); }
+  bool supportsSplice() const override { return io_handle_.supportsSplice(); }
+  Api::IoCallUint64Result shutdown(int how) override {
+    if (closed_) {
+      return Api::IoCallUint64Result(0, Api::IoErrorPtr(new Network::IoSocketError(EBADF),
+                                                        Network::IoSocketError::deleteIoError));
+    }
+    return io_handle_.shutdown(how);
+  }
+  void discardPendingWrites() override {
+    if (!closed_) {
+      io_handle_.discardPendingWrites();
+    }
+  }
 
 private:
   Network::IoHandle& io_handle_;
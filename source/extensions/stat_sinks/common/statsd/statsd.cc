@@ -43,24 +43,27 @@ void Writer::write(const std::string& message) {
 
 UdpStatsdSink::UdpStatsdSink(ThreadLocal::SlotAllocator& tls,
                              Network::Address::InstanceConstSharedPtr address, const bool use_tag,
-                             const std::string& prefix)
-    : tls_(tls.allocateSlot()), server_address_(std::move(address)), use_tag_(use_tag),
-      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix) {
+                             const std::string& prefix, const bool skip_unchanged_metrics)
+    : tls_(tls.allocateSlot()), server_address_(std::move(address)),
+      flush_writer_(std::make_shared<Writer>(server_address_)), use_tag_(use_tag),
+      prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      skip_unchanged_metrics_(skip_unchanged_metrics) {
   tls_->set([this](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr {
     return std::make_shared<Writer>(this->server_address_);
   });
 }
 
 void UdpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
-  Writer& writer = tls_->getTyped<Writer>();
-  for (const auto& counter : snapshot.counters()) {
+  Writer& writer = *flush_writer_;
+  for (const auto& counter :
+       skip_unchanged_metrics_ ? snapshot.changedCounters() : snapshot.counters()) {
     if (counter.counter_.get().used()) {
       writer.write(fmt::format("{}.{}:{}|c{}", prefix_, getName(counter.counter_.get()),
                                counter.delta_, buildTagStr(counter.counter_.get().tags())));
     }
   }
 
-  for (const auto& gauge : snapshot.gauges()) {
+  for (const auto& gauge : skip_unchanged_metrics_ ? snapshot.changedGauges() : snapshot.gauges()) {
     if (gauge.get().used()) {
       writer.write(fmt::format("{}.{}:{}|g{}", prefix_, getName(gauge.get()), gauge.get().value(),
                                buildTagStr(gauge.get().tags())));
@@ -105,8 +108,9 @@ const std::string UdpStatsdSink::buildTagStr(const std::vector<Stats::Tag>& tags
 TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
                              const std::string& cluster_name, ThreadLocal::SlotAllocator& tls,
                              Upstream::ClusterManager& cluster_manager, Stats::Scope& scope,
-                             const std::string& prefix)
-    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix), tls_(tls.allocateSlot()),
+                             const std::string& prefix, const bool skip_unchanged_metrics)
+    : prefix_(prefix.empty() ? Statsd::getDefaultPrefix() : prefix),
+      skip_unchanged_metrics_(skip_unchanged_metrics), tls_(tls.allocateSlot()),
       cluster_manager_(cluster_manager),
       cx_overflow_stat_(scope.counterFromStatName(
           Stats::StatNameManagedStorage("statsd.cx_overflow", scope.symbolTable()).statName())) {
@@ -121,13 +125,14 @@ TcpStatsdSink::TcpStatsdSink(const LocalInfo::LocalInfo& local_info,
 void TcpStatsdSink::flush(Stats::MetricSnapshot& snapshot) {
   TlsSink& tls_sink = tls_->getTyped<TlsSink>();
   tls_sink.beginFlush(true);
-  for (const auto& counter : snapshot.counters()) {
+  for (const auto& counter :
+       skip_unchanged_metrics_ ? snapshot.changedCounters() : snapshot.counters()) {
     if (counter.counter_.get().used()) {
       tls_sink.flushCounter(counter.counter_.get().name(), counter.delta_);
     }
   }
 
-  for (const auto& gauge : snapshot.gauges()) {
+  for (const auto& gauge : skip_unchanged_metrics_ ? snapshot.changedGauges() : snapshot.gauges()) {
     if (gauge.get().used()) {
       tls_sink.flushGauge(gauge.get().name(), gauge.get().value());
     }
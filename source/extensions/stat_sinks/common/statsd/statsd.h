@@ -46,18 +46,22 @@ private:
 class UdpStatsdSink : public Stats::Sink {
 public:
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, Network::Address::InstanceConstSharedPtr address,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix());
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                const bool skip_unchanged_metrics = false);
   // For testing.
   UdpStatsdSink(ThreadLocal::SlotAllocator& tls, const std::shared_ptr<Writer>& writer,
-                const bool use_tag, const std::string& prefix = getDefaultPrefix())
-      : tls_(tls.allocateSlot()), use_tag_(use_tag),
-        prefix_(prefix.empty() ? getDefaultPrefix() : prefix) {
+                const bool use_tag, const std::string& prefix = getDefaultPrefix(),
+                const bool skip_unchanged_metrics = false)
+      : tls_(tls.allocateSlot()), flush_writer_(writer), use_tag_(use_tag),
+        prefix_(prefix.empty() ? getDefaultPrefix() : prefix),
+        skip_unchanged_metrics_(skip_unchanged_metrics) {
     tls_->set(
         [writer](Event::Dispatcher&) -> ThreadLocal::ThreadLocalObjectSharedPtr { return writer; });
   }
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot& snapshot) override;
+  bool flushOnMainThread() const override { return false; }
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override;
 
   // Called in unit test to validate writer construction and address.
@@ -71,9 +75,13 @@ private:
 
   ThreadLocal::SlotPtr tls_;
   Network::Address::InstanceConstSharedPtr server_address_;
+  // Flushes have a writer of their own, so that they can run on any thread.
+  std::shared_ptr<Writer> flush_writer_;
   const bool use_tag_;
   // Prefix for all flushed stats.
   const std::string prefix_;
+  // Whether flushes only emit the counters and gauges which changed since the previous flush.
+  const bool skip_unchanged_metrics_;
 };
 
 /**
@@ -83,9 +91,12 @@ class TcpStatsdSink : public Stats::Sink {
 public:
   TcpStatsdSink(const LocalInfo::LocalInfo& local_info, const std::string& cluster_name,
                 ThreadLocal::SlotAllocator& tls, Upstream::ClusterManager& cluster_manager,
-                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix());
+                Stats::Scope& scope, const std::string& prefix = getDefaultPrefix(),
+                const bool skip_unchanged_metrics = false);
 
   // Stats::Sink
+  // The connection is owned by the thread local sink of the flushing thread, which only the main
+  // thread and the workers have, so flush() stays on the main thread.
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram& histogram, uint64_t value) override {
     // For statsd histograms are all timers.
@@ -131,6 +142,8 @@ private:
 
   // Prefix for all flushed stats.
   const std::string prefix_;
+  // Whether flushes only emit the counters and gauges which changed since the previous flush.
+  const bool skip_unchanged_metrics_;
 
   Upstream::ClusterInfoConstSharedPtr cluster_info_;
   ThreadLocal::SlotPtr tls_;
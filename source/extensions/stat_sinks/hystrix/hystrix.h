@@ -50,6 +50,7 @@ public:
   HystrixSink(Server::Instance& server, uint64_t num_buckets);
   Http::Code handlerHystrixEventStream(absl::string_view, Http::HeaderMap& response_headers,
                                        Buffer::Instance&, Server::AdminStream& admin_stream);
+  // The event streams are admin connections of the main thread, so flush() stays on it.
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override{};
 
@@ -75,6 +75,7 @@ public:
   // MetricsService::Sink
   MetricsServiceSink(const GrpcMetricsStreamerSharedPtr& grpc_metrics_streamer,
                      TimeSource& time_system);
+  // The gRPC stream belongs to the main thread, so flush() stays on it.
   void flush(Stats::MetricSnapshot& snapshot) override;
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
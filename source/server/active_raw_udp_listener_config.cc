@@ -1,5 +1,9 @@
 #include "server/active_raw_udp_listener_config.h"
 
+#include "envoy/api/v2/listener/raw_udp_config.pb.h"
+
+#include "common/protobuf/utility.h"
+
 #include "server/connection_handler_impl.h"
 #include "server/well_known_names.h"
 
@@ -10,17 +14,21 @@ Network::ConnectionHandler::ActiveListenerPtr
 ActiveRawUdpListenerFactory::createActiveUdpListener(Network::ConnectionHandler& parent,
                                                      Event::Dispatcher& dispatcher,
                                                      Network::ListenerConfig& config) const {
-  return std::make_unique<ActiveUdpListener>(parent, dispatcher, config);
+  return std::make_unique<ActiveUdpListener>(parent, dispatcher, config, batch_config_);
 }
 
 ProtobufTypes::MessagePtr ActiveRawUdpListenerConfigFactory::createEmptyConfigProto() {
-  return std::make_unique<ProtobufWkt::Empty>();
+  return std::make_unique<envoy::api::v2::listener::RawUdpListenerConfig>();
 }
 
 Network::ActiveUdpListenerFactoryPtr
 ActiveRawUdpListenerConfigFactory::createActiveUdpListenerFactory(
-    const Protobuf::Message& /*message*/) {
-  return std::make_unique<Server::ActiveRawUdpListenerFactory>();
+    const Protobuf::Message& message) {
+  auto& config = dynamic_cast<const envoy::api::v2::listener::RawUdpListenerConfig&>(message);
+  Network::UdpListenerBatchConfig batch_config;
+  batch_config.max_batch_size_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_batch_size, 1);
+  batch_config.enable_udp_offload_ = config.enable_udp_offload();
+  return std::make_unique<Server::ActiveRawUdpListenerFactory>(batch_config);
 }
 
 std::string ActiveRawUdpListenerConfigFactory::name() { return UdpListenerNames::get().RawUdp; }
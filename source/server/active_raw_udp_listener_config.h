@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/network/connection_handler.h"
+#include "envoy/network/listener.h"
 #include "envoy/registry/registry.h"
 #include "envoy/server/active_udp_listener_config.h"
 
@@ -9,11 +10,17 @@ namespace Server {
 
 class ActiveRawUdpListenerFactory : public Network::ActiveUdpListenerFactory {
 public:
+  explicit ActiveRawUdpListenerFactory(const Network::UdpListenerBatchConfig& batch_config)
+      : batch_config_(batch_config) {}
+
   Network::ConnectionHandler::ActiveListenerPtr
   createActiveUdpListener(Network::ConnectionHandler& parent, Event::Dispatcher& disptacher,
                           Network::ListenerConfig& config) const override;
 
   bool isTransportConnectionless() const override { return true; }
+
+private:
+  const Network::UdpListenerBatchConfig batch_config_;
 };
 
 // This class uses a protobuf config to create a UDP listener factory which
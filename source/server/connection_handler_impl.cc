@@ -403,8 +403,10 @@ ConnectionHandlerImpl::ActiveTcpConnection::~ActiveTcpConnection() {
 }
 
 ActiveUdpListener::ActiveUdpListener(Network::ConnectionHandler& parent,
-                                     Event::Dispatcher& dispatcher, Network::ListenerConfig& config)
-    : ActiveUdpListener(parent, dispatcher.createUdpListener(config.socket(), *this), config) {}
+                                     Event::Dispatcher& dispatcher, Network::ListenerConfig& config,
+                                     const Network::UdpListenerBatchConfig& batch_config)
+    : ActiveUdpListener(parent, dispatcher.createUdpListener(config.socket(), *this, batch_config),
+                        config) {}
 
 ActiveUdpListener::ActiveUdpListener(Network::ConnectionHandler& parent,
                                      Network::UdpListenerPtr&& listener,
@@ -51,8 +51,11 @@
 #include "common/stats/histogram_impl.h"
 #include "common/upstream/host_utility.h"
 
+#include "server/http/prometheus_stats.h"
+
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/strings/match.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -140,6 +143,10 @@ const char AdminHtmlEnd[] = R"(
 
 const std::regex PromRegex("[^a-zA-Z0-9_]");
 
+const char PrometheusProtobufContentType[] =
+    "application/vnd.google.protobuf; proto=io.prometheus.client.MetricFamily; "
+    "encoding=delimited";
+
 const uint64_t RecentLookupsCapacity = 100;
 
 void populateFallbackResponseHeaders(Http::Code code, Http::HeaderMap& header_map) {
@@ -176,6 +183,18 @@ bool filterParam(Http::Utility::QueryParams params, Buffer::Instance& response,
   return true;
 }
 
+// Helper method to determine whether a Prometheus server asks for the protobuf exposition format.
+bool acceptsPrometheusProtobuf(const Http::HeaderMap& request_headers) {
+  const Http::HeaderEntry* accept = request_headers.Accept();
+  if (accept == nullptr) {
+    return false;
+  }
+  const absl::string_view value = accept->value().getStringView();
+  return absl::StrContains(value, "application/vnd.google.protobuf") &&
+         absl::StrContains(value, "proto=io.prometheus.client.MetricFamily") &&
+         absl::StrContains(value, "encoding=delimited");
+}
+
 // Helper method to get the format parameter
 absl::optional<std::string> formatParam(Http::Utility::QueryParams params) {
   return (params.find("format") != params.end()) ? absl::optional<std::string>{params.at("format")}
@@ -796,6 +815,11 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
   Http::Code rc = Http::Code::OK;
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(url);
 
+  const auto format_value = formatParam(params);
+  if (format_value.has_value() && format_value.value() == "prometheus") {
+    return handlerPrometheusStats(url, response_headers, response, admin_stream);
+  }
+
   const bool used_only = params.find("usedonly") != params.end();
   absl::optional<std::regex> regex;
   if (!filterParam(params, response, regex)) {
@@ -816,14 +840,12 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
     }
   }
 
-  if (const auto format_value = formatParam(params)) {
+  if (format_value.has_value()) {
     if (format_value.value() == "json") {
       response_headers.insertContentType().value().setReference(
           Http::Headers::get().ContentTypeValues.Json);
       response.add(
           AdminImpl::statsAsJson(all_stats, server_.stats().histograms(), used_only, regex));
-    } else if (format_value.value() == "prometheus") {
-      return handlerPrometheusStats(url, response_headers, response, admin_stream);
     } else {
       response.add("usage: /stats?format=json  or /stats?format=prometheus \n");
       response.add("\n");
@@ -849,17 +871,39 @@ Http::Code AdminImpl::handlerStats(absl::string_view url, Http::HeaderMap& respo
   return rc;
 }
 
-Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query, Http::HeaderMap&,
-                                             Buffer::Instance& response, AdminStream&) {
+Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query,
+                                             Http::HeaderMap& response_headers,
+                                             Buffer::Instance& response,
+                                             AdminStream& admin_stream) {
   const Http::Utility::QueryParams params = Http::Utility::parseQueryString(path_and_query);
   const bool used_only = params.find("usedonly") != params.end();
   absl::optional<std::regex> regex;
   if (!filterParam(params, response, regex)) {
     return Http::Code::BadRequest;
   }
-  PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
-                                              server_.stats().histograms(), response, used_only,
-                                              regex);
+  const auto prefix = params.find("prefix");
+
+  PrometheusStatsWriter::Format format = PrometheusStatsWriter::Format::Text;
+  if (acceptsPrometheusProtobuf(admin_stream.getRequestHeaders())) {
+    format = PrometheusStatsWriter::Format::Protobuf;
+    response_headers.insertContentType().value().setReference(PrometheusProtobufContentType);
+  }
+
+  // The first chunk is part of the handler response. Any further chunks are streamed once the
+  // handler returns, so that the whole exposition is never buffered at once. Requests made
+  // through request() have no stream to continue, and get all the chunks right away.
+  auto writer = std::make_unique<PrometheusStatsWriter>(
+      server_.stats().symbolTable(), format, server_.stats().counters(), server_.stats().gauges(),
+      server_.stats().histograms(), used_only, regex,
+      prefix == params.end() ? absl::string_view() : absl::string_view(prefix->second));
+  if (writer->nextChunk(response)) {
+    if (admin_stream.hasDecoderFilterCallbacks()) {
+      PrometheusStatsStream::start(std::move(writer), admin_stream);
+    } else {
+      while (writer->nextChunk(response)) {
+      }
+    }
+  }
   return Http::Code::OK;
 }
 
@@ -0,0 +1,337 @@
+#include "server/http/prometheus_stats.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+#include "common/protobuf/protobuf.h"
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/strip.h"
+
+namespace Envoy {
+namespace Server {
+
+PrometheusStatsWriter::PrometheusStatsWriter(
+    Stats::SymbolTable& symbol_table, Format format,
+    std::vector<Stats::CounterSharedPtr>&& counters, std::vector<Stats::GaugeSharedPtr>&& gauges,
+    std::vector<Stats::ParentHistogramSharedPtr>&& histograms, bool used_only,
+    const absl::optional<std::regex>& regex, absl::string_view prefix)
+    : symbol_table_(symbol_table), format_(format), counters_(std::move(counters)),
+      gauges_(std::move(gauges)), histograms_(std::move(histograms)) {
+  while (absl::ConsumeSuffix(&prefix, ".")) {
+  }
+  Stats::StatNameManagedStorage prefix_storage(prefix, symbol_table_);
+  addFamilies(counters_, StatType::Counter, used_only, regex, prefix_storage.statName());
+  addFamilies(gauges_, StatType::Gauge, used_only, regex, prefix_storage.statName());
+  addFamilies(histograms_, StatType::Histogram, used_only, regex, prefix_storage.statName());
+  // Only needed to build the families.
+  family_indexes_.clear();
+  tag_extracted_family_indexes_.clear();
+}
+
+template <class StatSharedPtr>
+void PrometheusStatsWriter::addFamilies(const std::vector<StatSharedPtr>& stats, StatType type,
+                                        bool used_only, const absl::optional<std::regex>& regex,
+                                        Stats::StatName prefix) {
+  for (uint32_t i = 0; i < stats.size(); ++i) {
+    const auto& stat = *stats[i];
+    // The prefix is checked first, as it does not need the elaborated name.
+    if (!symbol_table_.startsWith(stat.statName(), prefix) || (used_only && !stat.used()) ||
+        (regex.has_value() && !std::regex_search(stat.name(), regex.value()))) {
+      continue;
+    }
+    // Distinct tag-extracted names, possibly of stats of different types, may sanitize to the same
+    // name. Prometheus rejects a second TYPE line for a name, so stats of the same type share a
+    // family and those of another type are left out.
+    auto it = tag_extracted_family_indexes_.find(stat.tagExtractedStatName());
+    if (it == tag_extracted_family_indexes_.end()) {
+      std::string name = sanitizeName(
+          absl::StrCat("envoy_", symbol_table_.toString(stat.tagExtractedStatName())));
+      const auto result = family_indexes_.emplace(name, families_.size());
+      if (result.second) {
+        families_.emplace_back(std::move(name), type);
+      }
+      it = tag_extracted_family_indexes_.emplace(stat.tagExtractedStatName(), result.first->second)
+               .first;
+    }
+    Family& family = families_[it->second];
+    if (family.type_ != type) {
+      ENVOY_LOG(debug, "not writing stat {}, its prometheus name {} has another type",
+                stat.name(), family.name_);
+      continue;
+    }
+    family.stats_.push_back(i);
+  }
+}
+
+bool PrometheusStatsWriter::nextChunk(Buffer::Instance& response) {
+  const uint64_t start_length = response.length();
+  while (family_index_ < families_.size() && chunk_.size() < ChunkSize &&
+         response.length() - start_length < ChunkSize) {
+    const Family& family = families_[family_index_];
+    if (format_ == Format::Protobuf) {
+      writeProtobufFamily(family, response);
+      ++family_index_;
+      continue;
+    }
+
+    writeTextMetric(family, stat_index_);
+    if (++stat_index_ == family.stats_.size()) {
+      ++family_index_;
+      stat_index_ = 0;
+    }
+  }
+
+  if (!chunk_.empty()) {
+    response.add(chunk_);
+    chunk_.clear();
+  }
+  return family_index_ < families_.size();
+}
+
+std::string PrometheusStatsWriter::sanitizeName(absl::string_view name) {
+  // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
+  // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
+  std::string sanitized;
+  sanitized.reserve(name.size() + 1);
+  if (!name.empty() && absl::ascii_isdigit(name[0])) {
+    sanitized.push_back('_');
+  }
+  for (const char c : name) {
+    sanitized.push_back(absl::ascii_isalnum(c) || c == '_' ? c : '_');
+  }
+  return sanitized;
+}
+
+const Stats::Metric& PrometheusStatsWriter::metric(StatType type, uint32_t index) const {
+  switch (type) {
+  case StatType::Counter:
+    return *counters_[index];
+  case StatType::Gauge:
+    return *gauges_[index];
+  case StatType::Histogram:
+    return *histograms_[index];
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+const std::string& PrometheusStatsWriter::tagName(Stats::StatName name) {
+  auto it = tag_names_.find(name);
+  if (it == tag_names_.end()) {
+    it = tag_names_.emplace(name, sanitizeName(symbol_table_.toString(name))).first;
+  }
+  return it->second;
+}
+
+const std::string& PrometheusStatsWriter::tagValue(Stats::StatName name) {
+  auto it = tag_values_.find(name);
+  if (it == tag_values_.end()) {
+    it = tag_values_.emplace(name, symbol_table_.toString(name)).first;
+  }
+  return it->second;
+}
+
+const std::vector<std::string>&
+PrometheusStatsWriter::bucketBounds(const std::vector<double>& buckets) {
+  if (buckets != buckets_) {
+    buckets_ = buckets;
+    bucket_bounds_.clear();
+    for (const double bucket : buckets) {
+      // See PrometheusStatsFormatter::statsAsPrometheus() for the choice of the format.
+      bucket_bounds_.push_back(fmt::format("{:.32g}", bucket));
+    }
+  }
+  return bucket_bounds_;
+}
+
+void PrometheusStatsWriter::formatTags(const Stats::Metric& metric) {
+  tags_.clear();
+  metric.iterateTagStatNames([this](Stats::StatName name, Stats::StatName value) -> bool {
+    if (!tags_.empty()) {
+      tags_.push_back(',');
+    }
+    absl::StrAppend(&tags_, tagName(name), "=\"", tagValue(value), "\"");
+    return true;
+  });
+}
+
+void PrometheusStatsWriter::writeTextMetric(const Family& family, uint32_t index) {
+  const std::string& name = family.name_;
+  if (index == 0) {
+    absl::string_view type;
+    switch (family.type_) {
+    case StatType::Counter:
+      type = "counter";
+      break;
+    case StatType::Gauge:
+      type = "gauge";
+      break;
+    case StatType::Histogram:
+      type = "histogram";
+      break;
+    }
+    absl::StrAppend(&chunk_, "# TYPE ", name, " ", type, "\n");
+  }
+
+  const uint32_t stat_index = family.stats_[index];
+  switch (family.type_) {
+  case StatType::Counter: {
+    const Stats::Counter& counter = *counters_[stat_index];
+    formatTags(counter);
+    absl::StrAppend(&chunk_, name, "{", tags_, "} ", counter.value(), "\n");
+    break;
+  }
+  case StatType::Gauge: {
+    const Stats::Gauge& gauge = *gauges_[stat_index];
+    formatTags(gauge);
+    absl::StrAppend(&chunk_, name, "{", tags_, "} ", gauge.value(), "\n");
+    break;
+  }
+  case StatType::Histogram: {
+    const Stats::ParentHistogram& histogram = *histograms_[stat_index];
+    formatTags(histogram);
+    const absl::string_view separator = tags_.empty() ? "" : ",";
+    const Stats::HistogramStatistics& stats = histogram.cumulativeStatistics();
+    const std::vector<std::string>& bounds = bucketBounds(stats.supportedBuckets());
+    const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+    for (size_t i = 0; i < bounds.size(); ++i) {
+      absl::StrAppend(&chunk_, name, "_bucket{", tags_, separator, "le=\"", bounds[i], "\"} ",
+                      computed_buckets[i], "\n");
+    }
+    absl::StrAppend(&chunk_, name, "_bucket{", tags_, separator, "le=\"+Inf\"} ",
+                    stats.sampleCount(), "\n");
+    absl::StrAppend(&chunk_, name, "_sum{", tags_, "} ", fmt::format("{:.32g}", stats.sampleSum()),
+                    "\n");
+    absl::StrAppend(&chunk_, name, "_count{", tags_, "} ", stats.sampleCount(), "\n");
+    break;
+  }
+  }
+}
+
+void PrometheusStatsWriter::writeProtobufFamily(const Family& family,
+                                                Buffer::Instance& response) {
+  family_proto_.Clear();
+  family_proto_.set_name(family.name_);
+  switch (family.type_) {
+  case StatType::Counter:
+    family_proto_.set_type(io::prometheus::client::MetricType::COUNTER);
+    break;
+  case StatType::Gauge:
+    family_proto_.set_type(io::prometheus::client::MetricType::GAUGE);
+    break;
+  case StatType::Histogram:
+    family_proto_.set_type(io::prometheus::client::MetricType::HISTOGRAM);
+    break;
+  }
+
+  for (const uint32_t stat_index : family.stats_) {
+    io::prometheus::client::Metric* metric_proto = family_proto_.add_metric();
+    metric(family.type_, stat_index).iterateTagStatNames(
+        [this, metric_proto](Stats::StatName name, Stats::StatName value) -> bool {
+          io::prometheus::client::LabelPair* label = metric_proto->add_label();
+          label->set_name(tagName(name));
+          label->set_value(tagValue(value));
+          return true;
+        });
+
+    switch (family.type_) {
+    case StatType::Counter:
+      metric_proto->mutable_counter()->set_value(counters_[stat_index]->value());
+      break;
+    case StatType::Gauge:
+      metric_proto->mutable_gauge()->set_value(gauges_[stat_index]->value());
+      break;
+    case StatType::Histogram: {
+      const Stats::HistogramStatistics& stats = histograms_[stat_index]->cumulativeStatistics();
+      io::prometheus::client::Histogram* histogram_proto = metric_proto->mutable_histogram();
+      histogram_proto->set_sample_count(stats.sampleCount());
+      histogram_proto->set_sample_sum(stats.sampleSum());
+      const std::vector<double>& supported_buckets = stats.supportedBuckets();
+      const std::vector<uint64_t>& computed_buckets = stats.computedBuckets();
+      for (size_t j = 0; j < supported_buckets.size(); ++j) {
+        io::prometheus::client::Bucket* bucket = histogram_proto->add_bucket();
+        bucket->set_upper_bound(supported_buckets[j]);
+        bucket->set_cumulative_count(computed_buckets[j]);
+      }
+      break;
+    }
+    }
+  }
+
+  // Serialize the varint length and the message straight into the response, as in
+  // Grpc::Common::serializeToGrpcFrame().
+  const uint32_t size = family_proto_.ByteSizeLong();
+  const uint32_t alloc_size = Protobuf::io::CodedOutputStream::VarintSize32(size) + size;
+  Buffer::RawSlice iovec;
+  response.reserve(alloc_size, &iovec, 1);
+  ASSERT(iovec.len_ >= alloc_size);
+  iovec.len_ = alloc_size;
+  uint8_t* current = reinterpret_cast<uint8_t*>(iovec.mem_);
+  current = Protobuf::io::CodedOutputStream::WriteVarint32ToArray(size, current);
+  family_proto_.SerializeWithCachedSizesToArray(current);
+  response.commit(&iovec, 1);
+}
+
+PrometheusStatsStream::PrometheusStatsStream(PrometheusStatsWriterPtr&& writer,
+                                             Http::StreamDecoderFilterCallbacks& callbacks)
+    : writer_(std::move(writer)), callbacks_(callbacks) {}
+
+void PrometheusStatsStream::start(PrometheusStatsWriterPtr&& writer, AdminStream& admin_stream) {
+  admin_stream.setEndStreamOnComplete(false);
+  auto stream = std::make_shared<PrometheusStatsStream>(std::move(writer),
+                                                        admin_stream.getDecoderFilterCallbacks());
+  stream->callbacks_.addDownstreamWatermarkCallbacks(*stream);
+  // The admin stream owns the stream until it is destroyed.
+  admin_stream.addOnDestroyCallback([stream]() -> void { stream->onDestroy(); });
+  stream->scheduleNextChunk();
+}
+
+void PrometheusStatsStream::onAboveWriteBufferHighWatermark() { ++high_watermark_count_; }
+
+void PrometheusStatsStream::onBelowWriteBufferLowWatermark() {
+  ASSERT(high_watermark_count_ > 0);
+  if (--high_watermark_count_ == 0) {
+    scheduleNextChunk();
+  }
+}
+
+void PrometheusStatsStream::scheduleNextChunk() {
+  if (scheduled_ || destroyed_ || writer_ == nullptr) {
+    return;
+  }
+  scheduled_ = true;
+  std::weak_ptr<PrometheusStatsStream> weak_this = shared_from_this();
+  callbacks_.dispatcher().post([weak_this]() -> void {
+    if (std::shared_ptr<PrometheusStatsStream> stream = weak_this.lock()) {
+      stream->writeNextChunk();
+    }
+  });
+}
+
+void PrometheusStatsStream::writeNextChunk() {
+  scheduled_ = false;
+  if (destroyed_) {
+    return;
+  }
+
+  Buffer::OwnedImpl chunk;
+  const bool more = writer_->nextChunk(chunk);
+  if (!more) {
+    // Release the stats before the end of the stream.
+    writer_.reset();
+  }
+  callbacks_.encodeData(chunk, !more);
+  if (more && high_watermark_count_ == 0) {
+    scheduleNextChunk();
+  }
+}
+
+void PrometheusStatsStream::onDestroy() {
+  destroyed_ = true;
+  writer_.reset();
+  callbacks_.removeDownstreamWatermarkCallbacks(*this);
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "envoy/buffer/buffer.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/filter.h"
+#include "envoy/server/admin.h"
+#include "envoy/stats/histogram.h"
+#include "envoy/stats/stats.h"
+#include "envoy/stats/symbol_table.h"
+
+#include "common/common/logger.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "metrics.pb.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * Serializes counters, gauges and histograms in one of the Prometheus exposition formats, one
+ * bounded chunk at a time, so that the stats of a large server can be streamed without building
+ * the whole response in memory.
+ *
+ * Unlike PrometheusStatsFormatter, the stats are grouped by their sanitized tag-extracted name, so
+ * that all the samples of a metric follow its single TYPE line. The first stat of a name determines
+ * its type, and the stats of other types whose names sanitize to the same name are left out, as
+ * Prometheus rejects a metric with samples of several types.
+ * Metric names, tag names and tag values are converted to strings once per distinct StatName
+ * rather than once per stat.
+ *
+ * See: https://prometheus.io/docs/instrumenting/exposition_formats/
+ */
+class PrometheusStatsWriter : Logger::Loggable<Logger::Id::admin> {
+public:
+  enum class Format {
+    // Text format, version 0.0.4.
+    Text,
+    // Length-delimited io.prometheus.client.MetricFamily messages.
+    Protobuf,
+  };
+
+  /**
+   * @param symbol_table the symbol table of the stats.
+   * @param format the exposition format to write.
+   * @param counters, gauges, histograms the stats to write. They are kept alive until the writer
+   *        is destroyed.
+   * @param used_only only write the stats which have been used.
+   * @param regex if set, only write the stats whose names match it.
+   * @param prefix if not empty, only write the stats whose dot-separated name tokens start with the
+   *        tokens of prefix. This is matched against the encoded stat names.
+   */
+  PrometheusStatsWriter(Stats::SymbolTable& symbol_table, Format format,
+                        std::vector<Stats::CounterSharedPtr>&& counters,
+                        std::vector<Stats::GaugeSharedPtr>&& gauges,
+                        std::vector<Stats::ParentHistogramSharedPtr>&& histograms, bool used_only,
+                        const absl::optional<std::regex>& regex, absl::string_view prefix);
+
+  /**
+   * Appends the next chunk of serialized stats to the response. A chunk ends with the first metric
+   * which takes it past ChunkSize bytes, or in the protobuf format, which only writes whole metric
+   * families, with the first metric family which does.
+   * @param response the buffer to append the chunk to.
+   * @return bool true if there are more stats to write.
+   */
+  bool nextChunk(Buffer::Instance& response);
+
+  /**
+   * @return uint64_t the number of metric families, i.e. of unique metric names, to write.
+   */
+  uint64_t numFamilies() const { return families_.size(); }
+
+  /**
+   * Sanitizes a name according to Prometheus conventions, like PrometheusStatsFormatter, without
+   * using a regex.
+   */
+  static std::string sanitizeName(absl::string_view name);
+
+  // The size in bytes after which a chunk is complete.
+  static constexpr uint64_t ChunkSize = 64 * 1024;
+
+private:
+  enum class StatType { Counter, Gauge, Histogram };
+
+  // The stats of a type sharing a sanitized tag-extracted name.
+  struct Family {
+    Family(std::string&& name, StatType type) : name_(std::move(name)), type_(type) {}
+
+    std::string name_;
+    StatType type_;
+    // The indexes of the stats into the vector of their type.
+    std::vector<uint32_t> stats_;
+  };
+
+  template <class StatSharedPtr>
+  void addFamilies(const std::vector<StatSharedPtr>& stats, StatType type, bool used_only,
+                   const absl::optional<std::regex>& regex, Stats::StatName prefix);
+  const Stats::Metric& metric(StatType type, uint32_t index) const;
+  const std::string& tagName(Stats::StatName name);
+  const std::string& tagValue(Stats::StatName name);
+  const std::vector<std::string>& bucketBounds(const std::vector<double>& buckets);
+
+  void formatTags(const Stats::Metric& metric);
+  void writeTextMetric(const Family& family, uint32_t index);
+  void writeProtobufFamily(const Family& family, Buffer::Instance& response);
+
+  Stats::SymbolTable& symbol_table_;
+  const Format format_;
+  const std::vector<Stats::CounterSharedPtr> counters_;
+  const std::vector<Stats::GaugeSharedPtr> gauges_;
+  const std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+  std::vector<Family> families_;
+  // The indexes into families_ by sanitized name, and by tag-extracted name to only sanitize each
+  // name once.
+  absl::flat_hash_map<std::string, uint64_t> family_indexes_;
+  absl::flat_hash_map<Stats::StatName, uint64_t> tag_extracted_family_indexes_;
+
+  // The position of the next metric to write.
+  uint64_t family_index_{};
+  uint32_t stat_index_{};
+
+  // The sanitized tag names and the tag values by their StatNames, which are owned by the stats.
+  absl::flat_hash_map<Stats::StatName, std::string> tag_names_;
+  absl::flat_hash_map<Stats::StatName, std::string> tag_values_;
+  // The last histogram buckets, and their formatted upper bounds.
+  std::vector<double> buckets_;
+  std::vector<std::string> bucket_bounds_;
+
+  std::string chunk_;
+  std::string tags_;
+  io::prometheus::client::MetricFamily family_proto_;
+};
+
+using PrometheusStatsWriterPtr = std::unique_ptr<PrometheusStatsWriter>;
+
+/**
+ * Streams the chunks of a PrometheusStatsWriter as the body of an admin response. One chunk is
+ * written per dispatcher iteration, and the writes pause while the downstream connection is above
+ * its high watermark, so that the buffered part of the response stays bounded.
+ */
+class PrometheusStatsStream : public Http::DownstreamWatermarkCallbacks,
+                              public std::enable_shared_from_this<PrometheusStatsStream> {
+public:
+  PrometheusStatsStream(PrometheusStatsWriterPtr&& writer,
+                        Http::StreamDecoderFilterCallbacks& callbacks);
+
+  /**
+   * Writes the remaining chunks of a writer once the admin handler returns. The response is ended
+   * after the last chunk, or abandoned if the stream is destroyed first.
+   * @param writer the writer of the remaining chunks.
+   * @param admin_stream the stream of the admin handler.
+   */
+  static void start(PrometheusStatsWriterPtr&& writer, AdminStream& admin_stream);
+
+  // Http::DownstreamWatermarkCallbacks
+  void onAboveWriteBufferHighWatermark() override;
+  void onBelowWriteBufferLowWatermark() override;
+
+private:
+  void scheduleNextChunk();
+  void writeNextChunk();
+  void onDestroy();
+
+  PrometheusStatsWriterPtr writer_;
+  Http::StreamDecoderFilterCallbacks& callbacks_;
+  uint32_t high_watermark_count_{};
+  bool scheduled_{};
+  bool destroyed_{};
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -27,6 +27,7 @@
 #include "common/config/resources.h"
 #include "common/config/utility.h"
 #include "common/http/codes.h"
+#include "common/io/io_uring_worker_impl.h"
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
@@ -139,10 +140,16 @@ void InstanceImpl::failHealthcheck(bool fail) {
 }
 
 MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
+  // Every counter has to be latched to report its delta in counters(), so the changed subsets are
+  // collected during that walk rather than from a list of changed stats kept by the store.
   snapped_counters_ = store.counters();
   counters_.reserve(snapped_counters_.size());
   for (const auto& counter : snapped_counters_) {
-    counters_.push_back({counter->latch(), *counter});
+    const uint64_t delta = counter->latch();
+    counters_.push_back({delta, *counter});
+    if (delta > 0) {
+      changed_counters_.push_back({delta, *counter});
+    }
   }
 
   snapped_gauges_ = store.gauges();
@@ -150,6 +157,9 @@ MetricSnapshotImpl::MetricSnapshotImpl(Stats::Store& store) {
   for (const auto& gauge : snapped_gauges_) {
     ASSERT(gauge->importMode() != Stats::Gauge::ImportMode::Uninitialized);
     gauges_.push_back(*gauge);
+    if (gauge->latchChanged()) {
+      changed_gauges_.push_back(*gauge);
+    }
   }
 
   snapped_histograms_ = store.histograms();
@@ -171,6 +181,49 @@ void InstanceUtil::flushMetricsToSinks(const std::list<Stats::SinkPtr>& sinks,
   }
 }
 
+StatsFlushThread::StatsFlushThread(Api::Api& api, Event::Dispatcher& main_dispatcher)
+    : main_dispatcher_(main_dispatcher), dispatcher_(api.allocateDispatcher()) {
+  thread_ = api.threadFactory().createThread([this]() -> void {
+    ENVOY_LOG(debug, "stats flush thread entering dispatch loop");
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    ENVOY_LOG(debug, "stats flush thread exited dispatch loop");
+  });
+}
+
+StatsFlushThread::~StatsFlushThread() {
+  alive_.reset();
+  dispatcher_->exit();
+  thread_->join();
+}
+
+void StatsFlushThread::flush(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
+                             std::function<void()> done) {
+  dispatcher_->post([&sinks, &store, &main_dispatcher = main_dispatcher_,
+                     alive = std::weak_ptr<bool>(alive_), done]() -> void {
+    // See InstanceUtil::flushMetricsToSinks() for why the snapshot is built even without sinks.
+    auto snapshot = std::make_shared<MetricSnapshotImpl>(store);
+    for (const auto& sink : sinks) {
+      if (!sink->flushOnMainThread()) {
+        sink->flush(*snapshot);
+      }
+    }
+
+    // The snapshot is released on the main thread, like the stats it holds on to.
+    main_dispatcher.post([&sinks, snapshot = std::move(snapshot), alive, done]() -> void {
+      if (alive.expired()) {
+        // The thread was destroyed, and the sinks may be gone as well.
+        return;
+      }
+      for (const auto& sink : sinks) {
+        if (sink->flushOnMainThread()) {
+          sink->flush(*snapshot);
+        }
+      }
+      done();
+    });
+  });
+}
+
 void InstanceImpl::flushStats() {
   ENVOY_LOG(debug, "flushing stats");
   // If Envoy is not fully initialized, workers will not be started and mergeHistograms
@@ -204,8 +257,32 @@ void InstanceImpl::flushStatsInternal() {
       enumToInt(Utility::serverState(initManager().state(), healthCheckFailed())));
   server_stats_->stats_recent_lookups_.set(
       stats_store_.symbolTable().getRecentLookups([](absl::string_view, uint64_t) {}));
+  const Buffer::SlicePool::Stats slice_pool_stats = Buffer::SlicePool::stats();
+  server_stats_->buffer_slice_pool_hits_.add(slice_pool_stats.hits_ -
+                                              last_slice_pool_stats_.hits_);
+  server_stats_->buffer_slice_pool_misses_.add(slice_pool_stats.misses_ -
+                                                last_slice_pool_stats_.misses_);
+  last_slice_pool_stats_ = slice_pool_stats;
+  server_stats_->buffer_slice_pool_cached_bytes_.set(slice_pool_stats.cached_bytes_);
+
+  auto flush_timespan = std::make_shared<Stats::HistogramCompletableTimespanImpl>(
+      server_stats_->stats_flush_time_ms_, timeSource());
+  if (stats_flush_thread_ != nullptr) {
+    // The next flush is only scheduled once this one is done, so that flushes never overlap.
+    stats_flush_thread_->flush(config_.statsSinks(), stats_store_,
+                               [this, flush_timespan]() -> void {
+                                 flush_timespan->complete();
+                                 enableStatFlushTimer();
+                               });
+    return;
+  }
 
   InstanceUtil::flushMetricsToSinks(config_.statsSinks(), stats_store_);
+  flush_timespan->complete();
+  enableStatFlushTimer();
+}
+
+void InstanceImpl::enableStatFlushTimer() {
   // TODO(ramaraochavali): consider adding different flush interval for histograms.
   if (stat_flush_timer_ != nullptr) {
     stat_flush_timer_->enableTimer(config_.statsFlushInterval());
@@ -367,6 +444,17 @@ void InstanceImpl::initialize(const Options& options,
   heap_shrinker_ =
       std::make_unique<Memory::HeapShrinker>(*dispatcher_, *overload_manager_, stats_store_);
 
+  // Rings are created by each dispatcher the first time it listens or connects. The io_uring
+  // sockets keep buffer slices in flight, which the libevent buffers may move, so they are only
+  // used with the native buffer implementation.
+  if (bootstrap_.has_io_uring() && options.libeventBufferEnabled()) {
+    ENVOY_LOG(warn, "io_uring is disabled with the libevent buffer implementation");
+  }
+  Io::IoUringWorker::setIoUringSize(
+      bootstrap_.has_io_uring() && !options.libeventBufferEnabled()
+          ? PROTOBUF_GET_WRAPPED_OR_DEFAULT(bootstrap_.io_uring(), ring_size, 512)
+          : 0);
+
   // Workers get created first so they register for thread local updates.
   listener_manager_ = std::make_unique<ListenerManagerImpl>(
       *this, listener_component_factory_, worker_factory_, bootstrap_.enable_dispatcher_stats());
@@ -437,6 +525,9 @@ void InstanceImpl::initialize(const Options& options,
   // Just setup the timer.
   stat_flush_timer_ = dispatcher_->createTimer([this]() -> void { flushStats(); });
   stat_flush_timer_->enableTimer(config_.statsFlushInterval());
+  if (bootstrap_.stats_flush_on_dedicated_thread()) {
+    stats_flush_thread_ = std::make_unique<StatsFlushThread>(*api_, *dispatcher_);
+  }
 
   // GuardDog (deadlock detection) object and thread setup before workers are
   // started and before our own run() loop runs.
@@ -580,6 +671,11 @@ void InstanceImpl::terminate() {
     listener_manager_->stopWorkers();
   }
 
+  // Stop the stats flush thread so that the final flush runs inline. A flush in progress is dropped
+  // along with its main thread half, even if that is already posted, so it does not flush the
+  // remaining sinks nor re-arm the flush timer.
+  stats_flush_thread_.reset();
+
   // Only flush if we have not been hot restarted.
   if (stat_flush_timer_) {
     flushStats();
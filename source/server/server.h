@@ -8,6 +8,8 @@
 #include <memory>
 #include <string>
 
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
 #include "envoy/event/timer.h"
 #include "envoy/server/drain_manager.h"
 #include "envoy/server/guarddog.h"
@@ -17,9 +19,11 @@
 #include "envoy/ssl/context_manager.h"
 #include "envoy/stats/stats_macros.h"
 #include "envoy/stats/timespan.h"
+#include "envoy/thread/thread.h"
 #include "envoy/tracing/http_tracer.h"
 
 #include "common/access_log/access_log_manager_impl.h"
+#include "common/buffer/buffer_impl.h"
 #include "common/common/assert.h"
 #include "common/common/cleanup.h"
 #include "common/common/logger_delegates.h"
@@ -46,13 +50,18 @@
 namespace Envoy {
 namespace Server {
 
+class StatsFlushThread;
+
 /**
  * All server wide stats. @see stats_macros.h
  */
 #define ALL_SERVER_STATS(COUNTER, GAUGE, HISTOGRAM)                                                \
+  COUNTER(buffer_slice_pool_hits)                                                                  \
+  COUNTER(buffer_slice_pool_misses)                                                                \
   COUNTER(debug_assertion_failures)                                                                \
   COUNTER(dynamic_unknown_fields)                                                                  \
   COUNTER(static_unknown_fields)                                                                   \
+  GAUGE(buffer_slice_pool_cached_bytes, NeverImport)                                               \
   GAUGE(concurrency, NeverImport)                                                                  \
   GAUGE(days_until_first_cert_expiring, Accumulate)                                                \
   GAUGE(hot_restart_epoch, NeverImport)                                                            \
@@ -65,7 +74,8 @@ namespace Server {
   GAUGE(total_connections, Accumulate)                                                             \
   GAUGE(uptime, Accumulate)                                                                        \
   GAUGE(version, NeverImport)                                                                      \
-  HISTOGRAM(initialization_time_ms, Milliseconds)
+  HISTOGRAM(initialization_time_ms, Milliseconds)                                                  \
+  HISTOGRAM(stats_flush_time_ms, Milliseconds)
 
 struct ServerStats {
   ALL_SERVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT, GENERATE_HISTOGRAM_STRUCT)
@@ -242,6 +252,7 @@ private:
   ProtobufTypes::MessagePtr dumpBootstrapConfig();
   void flushStats();
   void flushStatsInternal();
+  void enableStatFlushTimer();
   void initialize(const Options& options, Network::Address::InstanceConstSharedPtr local_address,
                   ComponentFactory& component_factory, ListenerHooks& hooks);
   void loadServerFlags(const absl::optional<std::string>& flags_path);
@@ -271,6 +282,8 @@ private:
   time_t original_start_time_;
   Stats::StoreRoot& stats_store_;
   std::unique_ptr<ServerStats> server_stats_;
+  // The buffer slice pool totals at the last stats update, to add their increase to the counters.
+  Buffer::SlicePool::Stats last_slice_pool_stats_;
   Assert::ActionRegistrationPtr assert_action_registration_;
   ThreadLocal::Instance& thread_local_;
   Api::ApiPtr api_;
@@ -287,6 +300,7 @@ private:
   Configuration::MainImpl config_;
   Network::DnsResolverSharedPtr dns_resolver_;
   Event::TimerPtr stat_flush_timer_;
+  std::unique_ptr<StatsFlushThread> stats_flush_thread_;
   LocalInfo::LocalInfoPtr local_info_;
   DrainManagerPtr drain_manager_;
   AccessLog::AccessLogManagerImpl access_log_manager_;
@@ -343,6 +357,10 @@ public:
   const std::vector<std::reference_wrapper<const Stats::Gauge>>& gauges() override {
     return gauges_;
   };
+  const std::vector<CounterSnapshot>& changedCounters() override { return changed_counters_; }
+  const std::vector<std::reference_wrapper<const Stats::Gauge>>& changedGauges() override {
+    return changed_gauges_;
+  }
   const std::vector<std::reference_wrapper<const Stats::ParentHistogram>>& histograms() override {
     return histograms_;
   }
@@ -350,11 +368,42 @@ public:
 private:
   std::vector<Stats::CounterSharedPtr> snapped_counters_;
   std::vector<CounterSnapshot> counters_;
+  std::vector<CounterSnapshot> changed_counters_;
   std::vector<Stats::GaugeSharedPtr> snapped_gauges_;
   std::vector<std::reference_wrapper<const Stats::Gauge>> gauges_;
+  std::vector<std::reference_wrapper<const Stats::Gauge>> changed_gauges_;
   std::vector<Stats::ParentHistogramSharedPtr> snapped_histograms_;
   std::vector<std::reference_wrapper<const Stats::ParentHistogram>> histograms_;
 };
 
+/**
+ * Thread which builds the snapshots of the stats and flushes them to the sinks that do not need to
+ * be flushed on the main thread. The remaining sinks are flushed with the same snapshot on the main
+ * thread afterwards. This keeps large numbers of stats from stalling the main thread.
+ */
+class StatsFlushThread : Logger::Loggable<Logger::Id::main> {
+public:
+  StatsFlushThread(Api::Api& api, Event::Dispatcher& main_dispatcher);
+  ~StatsFlushThread();
+
+  /**
+   * Flush the stats of a store to sinks. Must be called on the main thread, and not again before
+   * the previous flush is done. A flush which is not done when the thread is destroyed is dropped,
+   * without running done, even if only its main thread half is left.
+   * @param sinks supplies the sinks to flush to, which must outlive the flush.
+   * @param store supplies the store being flushed.
+   * @param done supplies the callback run on the main thread once all the sinks are flushed.
+   */
+  void flush(const std::list<Stats::SinkPtr>& sinks, Stats::Store& store,
+             std::function<void()> done);
+
+private:
+  Event::Dispatcher& main_dispatcher_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::ThreadPtr thread_;
+  // Reset on destruction, so that the main thread half of a flush posted before does nothing.
+  std::shared_ptr<bool> alive_{std::make_shared<bool>(true)};
+};
+
 } // namespace Server
 } // namespace Envoy
@@ -365,6 +365,50 @@ BENCHMARK(BufferStartsWithMatch)
     ->Args({16384, 256})
     ->Args({65536, 4096});
 
+// Simulate the buffer traffic of a socket read loop: reserve space for a read of state.range(0)
+// bytes, commit it and drain it again, so that every iteration frees and allocates a slice.
+// state.range(1) selects whether the slice pool is emptied in each iteration, which measures
+// allocation from the heap for comparison.
+static void BufferReadCommitDrain(benchmark::State& state) {
+  const uint64_t read_size = state.range(0);
+  const bool release_pool = state.range(1) != 0;
+  Buffer::OwnedImpl buffer;
+  Buffer::RawSlice iovecs[2];
+  for (auto _ : state) {
+    const uint64_t num_reserved = buffer.reserve(read_size, iovecs, 2);
+    buffer.commit(iovecs, num_reserved);
+    buffer.drain(buffer.length());
+    if (release_pool) {
+      Buffer::SlicePool::releaseThreadCache();
+    }
+  }
+  benchmark::DoNotOptimize(buffer.length());
+  state.SetBytesProcessed(state.iterations() * read_size);
+}
+BENCHMARK(BufferReadCommitDrain)
+    ->Args({4096, 0})
+    ->Args({4096, 1})
+    ->Args({16384, 0})
+    ->Args({16384, 1})
+    ->Args({65536, 0})
+    ->Args({65536, 1});
+
+// Create and destroy a slice of state.range(0) bytes. state.range(1) is as for
+// BufferReadCommitDrain.
+static void BufferSliceCreate(benchmark::State& state) {
+  const uint64_t size = state.range(0);
+  const bool release_pool = state.range(1) != 0;
+  for (auto _ : state) {
+    Buffer::SlicePtr slice = Buffer::OwnedSlice::create(size);
+    benchmark::DoNotOptimize(slice->reservableSize());
+    slice.reset();
+    if (release_pool) {
+      Buffer::SlicePool::releaseThreadCache();
+    }
+  }
+}
+BENCHMARK(BufferSliceCreate)->Args({100, 0})->Args({100, 1})->Args({16384, 0})->Args({16384, 1});
+
 } // namespace Envoy
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
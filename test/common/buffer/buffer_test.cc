@@ -1,4 +1,5 @@
 #include <limits>
+#include <vector>
 
 #include "envoy/common/exception.h"
 
@@ -6,6 +7,7 @@
 
 #include "test/common/buffer/utility.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
 #include "gtest/gtest.h"
@@ -191,6 +193,73 @@ TEST_F(OwnedSliceTest, Drain) {
   EXPECT_EQ(original_size, slice->reservableSize());
 }
 
+TEST(SlicePoolTest, SizeClasses) {
+  EXPECT_EQ(4096, OwnedSlice::create(0)->reservableSize());
+  EXPECT_EQ(4096, OwnedSlice::create(4096)->reservableSize());
+  EXPECT_EQ(16384, OwnedSlice::create(4097)->reservableSize());
+  EXPECT_EQ(16384, OwnedSlice::create(16384)->reservableSize());
+  EXPECT_EQ(65536, OwnedSlice::create(65536)->reservableSize());
+  // Larger slices are rounded up to whole pages and not pooled.
+  const uint64_t large_size = OwnedSlice::create(65537)->reservableSize();
+  EXPECT_LE(65537, large_size);
+  EXPECT_GT(65536 + 4096, large_size);
+}
+
+TEST(SlicePoolTest, Reuse) {
+  SlicePool::releaseThreadCache();
+  const SlicePool::Stats before = SlicePool::stats();
+
+  auto slice = OwnedSlice::create(16384);
+  const void* storage = slice->reserve(1).mem_;
+  slice.reset();
+  EXPECT_EQ(16384, SlicePool::stats().cached_bytes_);
+
+  // The storage is reused by the next slice of the same size class, but not by other ones.
+  slice = OwnedSlice::create(10000);
+  EXPECT_EQ(storage, slice->reserve(1).mem_);
+  auto other_slice = OwnedSlice::create(100);
+  EXPECT_NE(storage, other_slice->reserve(1).mem_);
+
+  const SlicePool::Stats after = SlicePool::stats();
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+  EXPECT_EQ(before.misses_ + 2, after.misses_);
+  EXPECT_EQ(0, after.cached_bytes_);
+}
+
+TEST(SlicePoolTest, CacheLimit) {
+  SlicePool::releaseThreadCache();
+  std::vector<SlicePtr> slices;
+  for (uint64_t i = 0; i < 2 * SlicePool::MaxCachedBytesPerSizeClass / 65536; i++) {
+    slices.emplace_back(OwnedSlice::create(65536));
+    slices.emplace_back(OwnedSlice::create(1));
+  }
+  // Unpooled slices are never cached.
+  slices.emplace_back(OwnedSlice::create(100000));
+  slices.clear();
+  EXPECT_EQ(SlicePool::MaxCachedBytesPerSizeClass + SlicePool::MaxCachedBytesPerSizeClass / 8,
+            SlicePool::stats().cached_bytes_);
+
+  SlicePool::releaseThreadCache();
+  EXPECT_EQ(0, SlicePool::stats().cached_bytes_);
+}
+
+// Hits and misses are kept per thread and survive the exit of the thread.
+TEST(SlicePoolTest, OtherThread) {
+  SlicePool::releaseThreadCache();
+  const SlicePool::Stats before = SlicePool::stats();
+  Thread::ThreadPtr thread = Thread::threadFactoryForTest().createThread([]() {
+    OwnedSlice::create(1).reset();
+    OwnedSlice::create(1).reset();
+    EXPECT_EQ(4096, SlicePool::stats().cached_bytes_);
+  });
+  thread->join();
+
+  const SlicePool::Stats after = SlicePool::stats();
+  EXPECT_EQ(before.hits_ + 1, after.hits_);
+  EXPECT_EQ(before.misses_ + 1, after.misses_);
+  EXPECT_EQ(0, after.cached_bytes_);
+}
+
 TEST(UnownedSliceTest, CreateDelete) {
   constexpr char input[] = "hello world";
   bool release_callback_called = false;
@@ -342,6 +342,9 @@ TEST_P(OwnedImplTest, ReserveCommit) {
       return;
     }
 
+    // Capacity of the slice created for the first reservation.
+    const uint64_t slice1_size = OwnedSlice::create(1)->reservableSize();
+
     // Request a reservation that fits in the remaining space at the end of the last slice.
     num_reserved = buffer.reserve(1, iovecs, NumIovecs);
     EXPECT_EQ(1, num_reserved);
@@ -353,7 +356,7 @@ TEST_P(OwnedImplTest, ReserveCommit) {
     // Request a reservation that is too large to fit in the remaining space at the end of
     // the last slice, and allow the buffer to use only one slice. This should result in the
     // creation of a new slice within the buffer.
-    num_reserved = buffer.reserve(4096 - sizeof(OwnedSlice), iovecs, 1);
+    num_reserved = buffer.reserve(slice1_size, iovecs, 1);
     const void* slice2 = iovecs[0].mem_;
     EXPECT_EQ(1, num_reserved);
     EXPECT_NE(slice1, slice2);
@@ -361,7 +364,7 @@ TEST_P(OwnedImplTest, ReserveCommit) {
 
     // Request the same size reservation, but allow the buffer to use multiple slices. This
     // should result in the buffer splitting the reservation between its last two slices.
-    num_reserved = buffer.reserve(4096 - sizeof(OwnedSlice), iovecs, NumIovecs);
+    num_reserved = buffer.reserve(slice1_size, iovecs, NumIovecs);
     EXPECT_EQ(2, num_reserved);
     EXPECT_EQ(slice1, iovecs[0].mem_);
     EXPECT_EQ(slice2, iovecs[1].mem_);
@@ -442,13 +445,13 @@ TEST_P(OwnedImplTest, ReserveReuse) {
   const void* first_slice = iovecs[0].mem_;
 
   // Reserve more space and verify that it begins with the same slice from the last reservation.
-  num_reserved = buffer.reserve(16384, iovecs, NumIovecs);
+  num_reserved = buffer.reserve(32768, iovecs, NumIovecs);
   EXPECT_EQ(2, num_reserved);
   EXPECT_EQ(first_slice, iovecs[0].mem_);
   const void* second_slice = iovecs[1].mem_;
 
   // Repeat the last reservation and verify that it yields the same slices.
-  num_reserved = buffer.reserve(16384, iovecs, NumIovecs);
+  num_reserved = buffer.reserve(32768, iovecs, NumIovecs);
   EXPECT_EQ(2, num_reserved);
   EXPECT_EQ(first_slice, iovecs[0].mem_);
   EXPECT_EQ(second_slice, iovecs[1].mem_);
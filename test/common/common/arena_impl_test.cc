@@ -0,0 +1,114 @@
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "common/common/arena_impl.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+bool isAligned(const void* ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+TEST(ArenaImplTest, Empty) {
+  ArenaImpl arena;
+  EXPECT_EQ(0, arena.bytesAllocated());
+  EXPECT_EQ(0, arena.heapBlocks());
+}
+
+TEST(ArenaImplTest, Alignment) {
+  ArenaImpl arena;
+  void* a = arena.allocate(1, 1);
+  void* b = arena.allocate(8, 8);
+  void* c = arena.allocate(3, 2);
+  void* d = arena.allocate(16, 16);
+  void* e = arena.allocate(64, 64);
+  EXPECT_TRUE(isAligned(b, 8));
+  EXPECT_TRUE(isAligned(c, 2));
+  EXPECT_TRUE(isAligned(d, 16));
+  EXPECT_TRUE(isAligned(e, 64));
+  EXPECT_LT(a, b);
+  EXPECT_LT(b, c);
+  EXPECT_LT(c, d);
+  EXPECT_LT(d, e);
+  EXPECT_EQ(1, arena.heapBlocks());
+}
+
+TEST(ArenaImplTest, BlockGrowth) {
+  ArenaImpl arena;
+  // Fill the first block exactly, then spill into a second one twice its size.
+  arena.allocate(ArenaImpl::MinBlockSize, 1);
+  EXPECT_EQ(1, arena.heapBlocks());
+  arena.allocate(1, 1);
+  EXPECT_EQ(2, arena.heapBlocks());
+  arena.allocate(2 * ArenaImpl::MinBlockSize - 1, 1);
+  EXPECT_EQ(2, arena.heapBlocks());
+
+  // Allocations larger than the next block size get a block of their own.
+  char* large = static_cast<char*>(arena.allocate(4 * ArenaImpl::MaxBlockSize, 8));
+  memset(large, 0, 4 * ArenaImpl::MaxBlockSize);
+  EXPECT_EQ(3, arena.heapBlocks());
+  EXPECT_EQ(3 * ArenaImpl::MinBlockSize + 4 * ArenaImpl::MaxBlockSize, arena.bytesAllocated());
+}
+
+TEST(ArenaImplTest, InlineStorage) {
+  InlineArenaImpl<256> arena;
+  void* first = arena.allocate(200, 8);
+  EXPECT_TRUE(isAligned(first, 8));
+  EXPECT_EQ(0, arena.heapBlocks());
+  arena.allocate(56, 8);
+  EXPECT_EQ(0, arena.heapBlocks());
+  arena.allocate(1, 1);
+  EXPECT_EQ(1, arena.heapBlocks());
+}
+
+struct Counted {
+  Counted(int& live, std::string value) : live_(live), value_(std::move(value)) { live_++; }
+  ~Counted() { live_--; }
+
+  int& live_;
+  std::string value_;
+};
+
+TEST(ArenaImplTest, MakeShared) {
+  int live = 0;
+  InlineArenaImpl<512> arena;
+  {
+    std::shared_ptr<Counted> object = arena.makeShared<Counted>(live, "hello");
+    EXPECT_EQ(1, live);
+    EXPECT_EQ("hello", object->value_);
+    std::shared_ptr<Counted> copy = object;
+    object.reset();
+    EXPECT_EQ(1, live);
+  }
+  // The destructor runs when the last reference goes away, the memory stays in the arena.
+  EXPECT_EQ(0, live);
+  EXPECT_EQ(0, arena.heapBlocks());
+  EXPECT_GE(arena.bytesAllocated(), sizeof(Counted));
+}
+
+TEST(ArenaImplTest, Allocator) {
+  ArenaImpl arena;
+  ArenaAllocator<int> ints(arena);
+  ArenaAllocator<char> chars(ints);
+  EXPECT_TRUE(ints == chars);
+  EXPECT_FALSE(ints != chars);
+
+  ArenaImpl other_arena;
+  EXPECT_TRUE(ints != ArenaAllocator<int>(other_arena));
+
+  int* values = ints.allocate(4);
+  EXPECT_TRUE(isAligned(values, alignof(int)));
+  for (int i = 0; i < 4; i++) {
+    values[i] = i;
+  }
+  ints.deallocate(values, 4);
+  EXPECT_EQ(4 * sizeof(int), arena.bytesAllocated());
+}
+
+} // namespace
+} // namespace Envoy
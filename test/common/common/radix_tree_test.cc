@@ -0,0 +1,74 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/common/radix_tree.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::Pair;
+
+namespace Envoy {
+namespace {
+
+std::vector<std::pair<size_t, std::string>> prefixes(const RadixTree<std::string>& tree,
+                                                     absl::string_view key,
+                                                     bool ignore_case = false) {
+  std::vector<std::pair<size_t, std::string>> result;
+  tree.forEachPrefix(key, ignore_case, [&](size_t depth, const std::string& value) {
+    if (!value.empty()) {
+      result.emplace_back(depth, value);
+    }
+  });
+  return result;
+}
+
+TEST(RadixTreeTest, Empty) {
+  RadixTree<std::string> tree;
+  EXPECT_TRUE(tree.empty());
+  EXPECT_THAT(prefixes(tree, "foo"), ElementsAre());
+
+  tree.getOrCreate("foo");
+  EXPECT_FALSE(tree.empty());
+}
+
+TEST(RadixTreeTest, GetOrCreate) {
+  RadixTree<std::string> tree;
+  tree.getOrCreate("foo") = "a";
+  tree.getOrCreate("bar") = "b";
+  EXPECT_EQ("a", tree.getOrCreate("foo"));
+  EXPECT_EQ("b", tree.getOrCreate("bar"));
+  EXPECT_EQ("", tree.getOrCreate("ba"));
+  EXPECT_EQ("b", tree.getOrCreate("bar"));
+}
+
+TEST(RadixTreeTest, ForEachPrefix) {
+  RadixTree<std::string> tree;
+  tree.getOrCreate("") = "root";
+  tree.getOrCreate("foobar") = "a";
+  tree.getOrCreate("foo") = "b";
+  tree.getOrCreate("fox") = "c";
+  tree.getOrCreate("f") = "d";
+
+  EXPECT_THAT(prefixes(tree, "foobarbaz"),
+              ElementsAre(Pair(0, "root"), Pair(1, "d"), Pair(3, "b"), Pair(6, "a")));
+  EXPECT_THAT(prefixes(tree, "fooba"), ElementsAre(Pair(0, "root"), Pair(1, "d"), Pair(3, "b")));
+  EXPECT_THAT(prefixes(tree, "fox"), ElementsAre(Pair(0, "root"), Pair(1, "d"), Pair(3, "c")));
+  EXPECT_THAT(prefixes(tree, "fo"), ElementsAre(Pair(0, "root"), Pair(1, "d")));
+  EXPECT_THAT(prefixes(tree, "bar"), ElementsAre(Pair(0, "root")));
+  EXPECT_THAT(prefixes(tree, ""), ElementsAre(Pair(0, "root")));
+}
+
+TEST(RadixTreeTest, IgnoreCase) {
+  RadixTree<std::string> tree;
+  tree.getOrCreate("foo") = "a";
+
+  EXPECT_THAT(prefixes(tree, "FOO"), ElementsAre());
+  EXPECT_THAT(prefixes(tree, "FOO", true), ElementsAre(Pair(3, "a")));
+  EXPECT_THAT(prefixes(tree, "fOoBaR", true), ElementsAre(Pair(3, "a")));
+}
+
+} // namespace
+} // namespace Envoy
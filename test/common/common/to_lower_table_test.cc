@@ -26,5 +26,22 @@ TEST(ToLowerTableTest, All) {
     table.toLowerCase(input);
     EXPECT_EQ(input, "\x90hello\x90");
   }
+  {
+    // Long enough to exercise both the block-wise and byte-wise conversion.
+    std::string input("X-Forwarded-For-Some-Custom-Header@[`{\xc1\xda");
+    table.toLowerCase(input);
+    EXPECT_EQ(input, "x-forwarded-for-some-custom-header@[`{\xc1\xda");
+  }
+  {
+    // Every byte value, in 16 byte aligned blocks.
+    std::string input;
+    std::string expected;
+    for (int c = 0; c < 256; c++) {
+      input.push_back(static_cast<char>(c));
+      expected.push_back(static_cast<char>((c >= 'A' && c <= 'Z') ? c | 0x20 : c));
+    }
+    table.toLowerCase(input);
+    EXPECT_EQ(input, expected);
+  }
 }
 } // namespace Envoy
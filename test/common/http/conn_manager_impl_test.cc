@@ -443,6 +443,53 @@ TEST_F(HttpConnectionManagerImplTest, HeaderOnlyRequestAndResponse) {
   EXPECT_EQ(1U, listener_stats_.downstream_rq_completed_.value());
 }
 
+// Filters may opt into being allocated from the stream arena, in which case they are destroyed
+// along with the stream.
+TEST_F(HttpConnectionManagerImplTest, FilterAllocatedFromStreamArena) {
+  setup(false, "envoy-custom-server", false);
+
+  struct ArenaFilter : public NiceMock<MockStreamDecoderFilter> {
+    explicit ArenaFilter(bool& destroyed) : destroyed_(destroyed) {}
+    ~ArenaFilter() override { destroyed_ = true; }
+
+    bool& destroyed_;
+  };
+
+  bool filter_destroyed = false;
+  ArenaFilter* filter = nullptr;
+  EXPECT_CALL(filter_factory_, createFilterChain(_))
+      .WillOnce(Invoke([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        auto arena_filter = callbacks.streamArena().makeShared<ArenaFilter>(filter_destroyed);
+        EXPECT_CALL(*arena_filter, decodeHeaders(_, true))
+            .WillOnce(Return(FilterHeadersStatus::StopIteration));
+        filter = arena_filter.get();
+        callbacks.addStreamDecoderFilter(arena_filter);
+      }));
+
+  EXPECT_CALL(filter_callbacks_.connection_.dispatcher_, deferredDelete_(_));
+
+  NiceMock<MockStreamEncoder> encoder;
+  EXPECT_CALL(*codec_, dispatch(_)).WillOnce(Invoke([&](Buffer::Instance& data) -> void {
+    StreamDecoder* decoder = &conn_manager_->newStream(encoder);
+    HeaderMapPtr headers{
+        new TestHeaderMapImpl{{":authority", "host"}, {":path", "/"}, {":method", "GET"}}};
+    decoder->decodeHeaders(std::move(headers), true);
+
+    HeaderMapPtr response_headers{new TestHeaderMapImpl{{":status", "200"}}};
+    filter->callbacks_->encodeHeaders(std::move(response_headers), true);
+    data.drain(4);
+  }));
+
+  Buffer::OwnedImpl fake_input("1234");
+  conn_manager_->onData(fake_input, false);
+  EXPECT_EQ(1U, stats_.named_.downstream_rq_2xx_.value());
+
+  // The stream, and with it the filter, is only gone once deferred deletion has run.
+  EXPECT_FALSE(filter_destroyed);
+  filter_callbacks_.connection_.dispatcher_.clearDeferredDeleteList();
+  EXPECT_TRUE(filter_destroyed);
+}
+
 TEST_F(HttpConnectionManagerImplTest, 100ContinueResponse) {
   proxy_100_continue_ = true;
   setup(false, "envoy-custom-server", false);
@@ -64,7 +64,29 @@ static void HeaderMapImplGet(benchmark::State& state) {
   }
   benchmark::DoNotOptimize(successes);
 }
-BENCHMARK(HeaderMapImplGet)->Arg(0)->Arg(1)->Arg(10)->Arg(50);
+BENCHMARK(HeaderMapImplGet)->Arg(0)->Arg(1)->Arg(10)->Arg(50)->Arg(100);
+
+/**
+ * Measure the speed of building a map with state.range(0) dummy headers and then looking up a few
+ * custom headers in it, which is what most filter chains do with a request. This includes the cost
+ * of building the hash index for large maps.
+ */
+static void HeaderMapImplPopulateAndGet(benchmark::State& state) {
+  const LowerCaseString keys[] = {LowerCaseString("x-tenant-id"),
+                                  LowerCaseString("x-request-priority"),
+                                  LowerCaseString("dummy-key-5")};
+  size_t successes = 0;
+  for (auto _ : state) {
+    HeaderMapImpl headers;
+    addDummyHeaders(headers, state.range(0));
+    headers.addCopy(keys[0], "tenant");
+    for (const LowerCaseString& key : keys) {
+      successes += (headers.get(key) != nullptr);
+    }
+  }
+  benchmark::DoNotOptimize(successes);
+}
+BENCHMARK(HeaderMapImplPopulateAndGet)->Arg(0)->Arg(10)->Arg(20)->Arg(50);
 
 /**
  * Measure the retrieval speed of a header for which HeaderMapImpl is expected to
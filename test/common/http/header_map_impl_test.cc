@@ -1,12 +1,16 @@
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/http/header_map_impl.h"
 #include "common/http/header_utility.h"
 
 #include "test/test_common/printers.h"
+#include "test/test_common/thread_factory_for_test.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 using ::testing::InSequence;
@@ -839,6 +843,79 @@ TEST(HeaderMapImplTest, Get) {
   }
 }
 
+// Lookups in maps with at least HashIndexMinHeaders headers go through the hash index, which must
+// give the same answers as the linear scan while the map is modified.
+TEST(HeaderMapImplTest, GetWithHashIndex) {
+  TestHeaderMapImpl headers;
+  for (size_t i = 0; i < HeaderMapImpl::HashIndexMinHeaders; i++) {
+    headers.addCopy(absl::StrCat("x-header-", i), absl::StrCat("value-", i));
+  }
+  headers.addCopy("x-header-0", "duplicate");
+  headers.insertPath().value(std::string("/"));
+  ASSERT_GT(headers.size(), HeaderMapImpl::HashIndexMinHeaders);
+
+  // The first entry with a key is returned.
+  EXPECT_EQ("value-0", headers.get(LowerCaseString("x-header-0"))->value().getStringView());
+  EXPECT_EQ("value-7", headers.get(LowerCaseString("x-header-7"))->value().getStringView());
+  EXPECT_EQ("/", headers.get(LowerCaseString(":path"))->value().getStringView());
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("foo")));
+
+  // Entries added after the index was built are found.
+  headers.addCopy("foo", "bar");
+  headers.addReferenceKey(LowerCaseString("x-header-1"), "later");
+  headers.insertMethod().value(std::string("GET"));
+  EXPECT_EQ("bar", headers.get(LowerCaseString("foo"))->value().getStringView());
+  EXPECT_EQ("value-1", headers.get(LowerCaseString("x-header-1"))->value().getStringView());
+  EXPECT_EQ("GET", headers.get(LowerCaseString(":method"))->value().getStringView());
+
+  // Removed entries are not.
+  headers.remove(LowerCaseString("x-header-0"));
+  headers.removeMethod();
+  headers.remove(LowerCaseString("not-there"));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-0")));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString(":method")));
+  EXPECT_EQ("bar", headers.get(LowerCaseString("foo"))->value().getStringView());
+
+  // removePrefix() rebuilds the index.
+  headers.removePrefix(LowerCaseString("x-header-1"));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-1")));
+  EXPECT_EQ(nullptr, headers.get(LowerCaseString("x-header-10")));
+  EXPECT_EQ("value-2", headers.get(LowerCaseString("x-header-2"))->value().getStringView());
+  headers.addCopy("x-header-1", "again");
+  EXPECT_EQ("again", headers.get(LowerCaseString("x-header-1"))->value().getStringView());
+
+  // Values can be modified through the returned entry.
+  headers.get(LowerCaseString("foo"))->value(std::string("baz"));
+  EXPECT_EQ("baz", headers.get(LowerCaseString("foo"))->value().getStringView());
+  EXPECT_FALSE(headers.byteSize().has_value());
+}
+
+// Lookups in a const map with a hash index do not modify it, so that the map can be shared by
+// threads.
+TEST(HeaderMapImplTest, ConcurrentGetWithHashIndex) {
+  TestHeaderMapImpl headers;
+  for (size_t i = 0; i < HeaderMapImpl::HashIndexMinHeaders * 2; i++) {
+    headers.addCopy(absl::StrCat("x-header-", i), absl::StrCat("value-", i));
+  }
+  const HeaderMap& const_headers = headers;
+
+  std::vector<Thread::ThreadPtr> threads;
+  std::atomic<uint64_t> found{0};
+  for (uint32_t i = 0; i < 4; i++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&const_headers, &found]() {
+      for (size_t j = 0; j < HeaderMapImpl::HashIndexMinHeaders * 2; j++) {
+        if (const_headers.get(LowerCaseString(absl::StrCat("x-header-", j))) != nullptr) {
+          found++;
+        }
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  EXPECT_EQ(4 * HeaderMapImpl::HashIndexMinHeaders * 2, found);
+}
+
 TEST(HeaderMapImplTest, TestAppendHeader) {
   // Test appending to a string with a value.
   {
@@ -464,6 +464,21 @@ TEST(HeaderIsValidTest, ValidHeaderValuesAreAccepted) {
   EXPECT_TRUE(HeaderUtility::headerIsValid("Some Other Value"));
 }
 
+// Values longer than 16 bytes are validated a block at a time. Make sure every invalid character
+// is caught at every position, and that HTAB and obs-text are accepted.
+TEST(HeaderIsValidTest, LongHeaderValues) {
+  const std::string valid = "Mozilla/5.0 (X11; Linux x86_64)\t\x80\xff obs-text";
+  EXPECT_TRUE(HeaderUtility::headerIsValid(valid));
+
+  for (size_t position = 0; position < valid.size(); position++) {
+    for (const char invalid : {'\0', '\r', '\n', '\x1f', '\x7f'}) {
+      std::string value = valid;
+      value[position] = invalid;
+      EXPECT_FALSE(HeaderUtility::headerIsValid(value)) << position;
+    }
+  }
+}
+
 TEST(HeaderAddTest, HeaderAdd) {
   TestHeaderMapImpl headers{{"myheader1", "123value"}};
   TestHeaderMapImpl headers_to_add{{"myheader2", "456value"}};
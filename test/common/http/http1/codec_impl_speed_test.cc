@@ -0,0 +1,210 @@
+// Usage: bazel run //test/common/http/http1:codec_impl_speed_test
+
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_utility.h"
+#include "common/http/http1/codec_impl.h"
+#include "common/http/http1/legacy_parser_impl.h"
+#include "common/http/http1/vectorized_parser_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "nghttp2/nghttp2.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+/**
+ * Builds a GET request with browser-like headers followed by num_extra_headers custom headers.
+ */
+std::string makeRequest(int num_extra_headers) {
+  std::string request = "GET /api/v1/users/12345/profile?fields=name,email HTTP/1.1\r\n"
+                        "Host: www.example.com\r\n"
+                        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:70.0) Gecko/20100101\r\n"
+                        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+                        "Accept-Language: en-US,en;q=0.5\r\n"
+                        "Accept-Encoding: gzip, deflate, br\r\n"
+                        "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark\r\n"
+                        "X-Forwarded-For: 203.0.113.195, 70.41.3.18, 150.172.238.178\r\n";
+  for (int i = 0; i < num_extra_headers; i++) {
+    absl::StrAppend(&request, "X-Custom-Header-", i, ": some-moderately-long-value-", i, "\r\n");
+  }
+  request += "\r\n";
+  return request;
+}
+
+/**
+ * Measure the speed of parsing a complete request head with the HTTP/1 server codec.
+ * state.range(0) is the number of extra headers, state.range(1) selects whether strict header
+ * validation is enabled and state.range(2) selects the vectorized parser.
+ */
+static void Http1ServerCodecDispatch(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.strict_header_validation",
+        state.range(1) != 0 ? "true" : "false"}});
+
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  NiceMock<MockStreamDecoder> decoder;
+  ON_CALL(callbacks, newStream(_, _)).WillByDefault(ReturnRef(decoder));
+  Http1Settings codec_settings;
+  codec_settings.parser_impl_ = state.range(2) != 0 ? Http1Settings::ParserImpl::Vectorized
+                                                    : Http1Settings::ParserImpl::HttpParser;
+  Stats::IsolatedStoreImpl store;
+  const std::string request = makeRequest(state.range(0));
+
+  for (auto _ : state) {
+    ServerConnectionImpl codec(connection, store, callbacks, codec_settings,
+                               DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT);
+    Buffer::OwnedImpl buffer(request);
+    codec.dispatch(buffer);
+    benchmark::DoNotOptimize(buffer.length());
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK(Http1ServerCodecDispatch)
+    ->Args({0, 0, 0})
+    ->Args({0, 0, 1})
+    ->Args({0, 1, 0})
+    ->Args({0, 1, 1})
+    ->Args({20, 0, 0})
+    ->Args({20, 0, 1})
+    ->Args({20, 1, 0})
+    ->Args({20, 1, 1})
+    ->Args({80, 1, 0})
+    ->Args({80, 1, 1});
+
+class NullParserCallbacks : public ParserCallbacks {
+public:
+  // Http1::ParserCallbacks
+  void onMessageBegin() override {}
+  void onUrl(const char*, size_t) override {}
+  void onHeaderField(const char*, size_t) override {}
+  void onHeaderValue(const char*, size_t) override {}
+  int onHeadersComplete() override { return 0; }
+  void onBody(const char*, size_t) override {}
+  void onMessageComplete() override {}
+};
+
+/**
+ * Measure the speed of the parser backends alone, without the codec building a header map.
+ * state.range(0) is the number of extra headers and state.range(1) selects the vectorized parser.
+ */
+static void Http1ParserExecute(benchmark::State& state) {
+  NullParserCallbacks callbacks;
+  const std::string request = makeRequest(state.range(0));
+
+  for (auto _ : state) {
+    ParserPtr parser;
+    if (state.range(1) != 0) {
+      parser = std::make_unique<VectorizedParserImpl>(HTTP_REQUEST, callbacks,
+                                                      DEFAULT_MAX_REQUEST_HEADERS_KB * 1024);
+    } else {
+      parser = std::make_unique<LegacyHttpParserImpl>(HTTP_REQUEST, callbacks);
+    }
+    const size_t parsed = parser->execute(request.data(), request.size());
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetBytesProcessed(state.iterations() * request.size());
+}
+BENCHMARK(Http1ParserExecute)
+    ->Args({0, 0})
+    ->Args({0, 1})
+    ->Args({20, 0})
+    ->Args({20, 1})
+    ->Args({80, 0})
+    ->Args({80, 1});
+
+/**
+ * Measure the speed of a minimal request followed by encoding a typical header-only response with
+ * the HTTP/1 server codec.
+ */
+static void Http1ServerCodecEncodeResponse(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  NiceMock<Network::MockConnection> connection;
+  NiceMock<MockServerConnectionCallbacks> callbacks;
+  NiceMock<MockStreamDecoder> decoder;
+  StreamEncoder* response_encoder = nullptr;
+  ON_CALL(callbacks, newStream(_, _))
+      .WillByDefault(Invoke([&](StreamEncoder& encoder, bool) -> StreamDecoder& {
+        response_encoder = &encoder;
+        return decoder;
+      }));
+  Http1Settings codec_settings;
+  Stats::IsolatedStoreImpl store;
+  const TestHeaderMapImpl response_headers{{":status", "200"},
+                                           {"date", "Mon, 18 Nov 2019 10:00:00 GMT"},
+                                           {"server", "envoy"},
+                                           {"content-type", "application/json"},
+                                           {"cache-control", "no-cache, no-store"},
+                                           {"x-envoy-upstream-service-time", "12"}};
+
+  for (auto _ : state) {
+    ServerConnectionImpl codec(connection, store, callbacks, codec_settings,
+                               DEFAULT_MAX_REQUEST_HEADERS_KB, DEFAULT_MAX_HEADERS_COUNT);
+    Buffer::OwnedImpl buffer("GET / HTTP/1.1\r\n\r\n");
+    codec.dispatch(buffer);
+    response_encoder->encodeHeaders(response_headers, true);
+  }
+}
+BENCHMARK(Http1ServerCodecEncodeResponse);
+
+/**
+ * Compare the block-wise header value validation against the byte-wise nghttp2 check it is
+ * equivalent to. state.range(0) is the value length and state.range(1) selects nghttp2.
+ */
+static void HeaderValueValidation(benchmark::State& state) {
+  const std::string value(state.range(0), 'a');
+  const bool use_nghttp2 = state.range(1) != 0;
+  for (auto _ : state) {
+    bool valid;
+    if (use_nghttp2) {
+      valid = nghttp2_check_header_value(reinterpret_cast<const uint8_t*>(value.data()),
+                                         value.size()) != 0;
+    } else {
+      valid = HeaderUtility::headerIsValid(value);
+    }
+    benchmark::DoNotOptimize(valid);
+  }
+  state.SetBytesProcessed(state.iterations() * value.size());
+}
+BENCHMARK(HeaderValueValidation)
+    ->Args({8, 0})
+    ->Args({8, 1})
+    ->Args({32, 0})
+    ->Args({32, 1})
+    ->Args({128, 0})
+    ->Args({128, 1})
+    ->Args({1024, 0})
+    ->Args({1024, 1});
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
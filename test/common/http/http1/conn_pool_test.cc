@@ -815,6 +815,123 @@ TEST_F(Http1ConnPoolImplTest, ConcurrentConnections) {
   EXPECT_EQ(2U, cluster_->stats_.upstream_cx_destroy_remote_.value());
 }
 
+/**
+ * Test that a connection is prefetched for the next request and used by it.
+ */
+TEST_F(Http1ConnPoolImplTest, Prefetch) {
+  cluster_->per_upstream_prefetch_ratio_ = 1.5;
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  InSequence s;
+
+  // The first request creates a connection for itself and prefetches a second one.
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  EXPECT_CALL(*conn_pool_.test_clients_[0].connect_timer_, disableTimer());
+  r1.expectNewStream();
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  r1.startRequest();
+
+  // The second request finds the prefetched connection ready. The circuit breaker prevents any
+  // further prefetching.
+  EXPECT_CALL(*conn_pool_.test_clients_[1].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Immediate);
+  r2.startRequest();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_used_.value());
+
+  r1.completeResponse(false);
+  r2.completeResponse(false);
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_wasted_.value());
+}
+
+/**
+ * Test that a prefetched connection closed without serving a request is counted as wasted.
+ */
+TEST_F(Http1ConnPoolImplTest, PrefetchWasted) {
+  cluster_->per_upstream_prefetch_ratio_ = 1.5;
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  InSequence s;
+
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  r1.handle_->cancel();
+
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_used_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_wasted_.value());
+}
+
+/**
+ * Test that the warm reserve is re-established while the pool is idle and serves the next burst.
+ */
+TEST_F(Http1ConnPoolImplTest, PrefetchWarmReserveAfterIdle) {
+  cluster_->per_upstream_min_warm_connections_ = 2;
+  InSequence s;
+
+  // The first request creates a connection for itself and a second one for the reserve.
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  ActiveTestRequest r1(*this, 0, ActiveTestRequest::Type::Pending);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  EXPECT_CALL(*conn_pool_.test_clients_[0].connect_timer_, disableTimer());
+  r1.expectNewStream();
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  r1.startRequest();
+  r1.completeResponse(false);
+  EXPECT_CALL(*conn_pool_.test_clients_[1].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // While the pool is idle, the upstream closes both connections. The pool replaces them rather
+  // than waiting for the next requests.
+  conn_pool_.expectClientCreate();
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.expectClientCreate();
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  // The burst after the idle period is served by the prefetched connections, without creating
+  // new ones.
+  EXPECT_CALL(*conn_pool_.test_clients_[0].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*conn_pool_.test_clients_[1].connect_timer_, disableTimer());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  ActiveTestRequest r2(*this, 1, ActiveTestRequest::Type::Immediate);
+  r2.startRequest();
+  ActiveTestRequest r3(*this, 0, ActiveTestRequest::Type::Immediate);
+  r3.startRequest();
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_used_.value());
+  EXPECT_EQ(4U, cluster_->stats_.upstream_cx_total_.value());
+
+  r2.completeResponse(false);
+  r3.completeResponse(false);
+
+  // Connections closed by Envoy itself are not replaced.
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(2);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::LocalClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::LocalClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 TEST_F(Http1ConnPoolImplTest, DrainCallback) {
   InSequence s;
   ReadyWatcher drained;
@@ -0,0 +1,338 @@
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/http/http1/vectorized_parser_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http1 {
+namespace {
+
+// Records the callbacks raised by the parser as strings. Data callbacks of the same kind which
+// follow each other are merged, so that the log does not depend on how the input was split.
+class RecordingCallbacks : public ParserCallbacks {
+public:
+  // Http1::ParserCallbacks
+  void onMessageBegin() override { events_.push_back("begin"); }
+  void onUrl(const char* data, size_t length) override { append("url", data, length); }
+  void onHeaderField(const char* data, size_t length) override {
+    header_calls_++;
+    append("field", data, length);
+  }
+  void onHeaderValue(const char* data, size_t length) override {
+    header_calls_++;
+    append("value", data, length);
+  }
+  int onHeadersComplete() override {
+    events_.push_back("headers");
+    if (pause_on_headers_complete_) {
+      parser_->pause(true);
+    }
+    return headers_complete_rc_;
+  }
+  void onBody(const char* data, size_t length) override { append("body", data, length); }
+  void onMessageComplete() override {
+    events_.push_back("complete");
+    if (pause_on_message_complete_) {
+      parser_->pause(true);
+    }
+  }
+
+  void append(const std::string& kind, const char* data, size_t length) {
+    const std::string prefix = kind + ":";
+    if (events_.empty() || events_.back().compare(0, prefix.size(), prefix) != 0) {
+      events_.push_back(prefix);
+    }
+    events_.back().append(data, length);
+  }
+
+  Parser* parser_{};
+  std::vector<std::string> events_;
+  uint32_t header_calls_{};
+  int headers_complete_rc_{};
+  bool pause_on_headers_complete_{};
+  bool pause_on_message_complete_{};
+};
+
+class VectorizedParserImplTest : public testing::Test {
+public:
+  void initialize(http_parser_type type, uint32_t max_line_size = 1024) {
+    parser_ = std::make_unique<VectorizedParserImpl>(type, callbacks_, max_line_size);
+    callbacks_.parser_ = parser_.get();
+  }
+
+  // Dispatch the data in slices of the given size, resuming after pauses like the codec does.
+  size_t dispatch(absl::string_view data, size_t slice_size) {
+    size_t consumed = 0;
+    while (consumed < data.size()) {
+      parser_->pause(false);
+      const size_t length = std::min(slice_size, data.size() - consumed);
+      const size_t rc = parser_->execute(data.data() + consumed, length);
+      consumed += rc;
+      if (parser_->error() != HPE_OK && parser_->error() != HPE_PAUSED) {
+        break;
+      }
+      if (rc == 0 && parser_->error() != HPE_PAUSED) {
+        break;
+      }
+    }
+    return consumed;
+  }
+
+  RecordingCallbacks callbacks_;
+  std::unique_ptr<VectorizedParserImpl> parser_;
+};
+
+TEST_F(VectorizedParserImplTest, SimpleRequest) {
+  initialize(HTTP_REQUEST);
+
+  const std::string request = "GET /foo?bar=baz HTTP/1.1\r\nHost: example.com\r\nEmpty:\r\n"
+                              "X-Spaces: \t value with  spaces \t \r\n\r\n";
+  EXPECT_EQ(request.size(), parser_->execute(request.data(), request.size()));
+  EXPECT_EQ(HPE_OK, parser_->error());
+  EXPECT_EQ((std::vector<std::string>{"begin", "url:/foo?bar=baz", "field:Host",
+                                      "value:example.com", "field:Empty", "value:",
+                                      "field:X-Spaces", "value:value with  spaces", "headers",
+                                      "complete"}),
+            callbacks_.events_);
+  // Each header is handed over in one piece.
+  EXPECT_EQ(6U, callbacks_.header_calls_);
+  EXPECT_EQ(HTTP_GET, parser_->method());
+  EXPECT_EQ(1, parser_->httpMajor());
+  EXPECT_EQ(1, parser_->httpMinor());
+  EXPECT_EQ(ULLONG_MAX, parser_->contentLength());
+  EXPECT_FALSE(parser_->isChunked());
+}
+
+// Every split of a message produces the same callbacks.
+TEST_F(VectorizedParserImplTest, RequestSplitAnywhere) {
+  const std::string request = "\r\nPOST / HTTP/1.0\nContent-Length: 5\r\nFoo: bar\r\n\r\nhello"
+                              "M-SEARCH * HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                              "5;ext=1\r\nhello\r\n1\r\n!\r\n0\r\nTrailer: ignored\r\n\r\n";
+  const std::vector<std::string> expected{"begin",
+                                          "url:/",
+                                          "field:Content-Length",
+                                          "value:5",
+                                          "field:Foo",
+                                          "value:bar",
+                                          "headers",
+                                          "body:hello",
+                                          "complete",
+                                          "begin",
+                                          "url:*",
+                                          "field:Transfer-Encoding",
+                                          "value:chunked",
+                                          "headers",
+                                          "body:hello!",
+                                          "complete"};
+
+  for (size_t slice_size = 1; slice_size <= request.size(); slice_size++) {
+    callbacks_.events_.clear();
+    initialize(HTTP_REQUEST);
+    EXPECT_EQ(request.size(), dispatch(request, slice_size)) << slice_size;
+    EXPECT_EQ(HPE_OK, parser_->error()) << slice_size;
+    EXPECT_EQ(expected, callbacks_.events_) << slice_size;
+    EXPECT_EQ(HTTP_MSEARCH, parser_->method());
+    EXPECT_TRUE(parser_->isChunked());
+  }
+}
+
+TEST_F(VectorizedParserImplTest, ResponseBodyUntilClose) {
+  initialize(HTTP_RESPONSE);
+
+  const std::string response = "HTTP/1.1 200 OK\r\nServer: test\r\n\r\nsome body";
+  EXPECT_EQ(response.size(), parser_->execute(response.data(), response.size()));
+  EXPECT_EQ(200, parser_->statusCode());
+  EXPECT_EQ(0U, parser_->execute(nullptr, 0));
+  EXPECT_EQ(HPE_OK, parser_->error());
+  EXPECT_EQ((std::vector<std::string>{"begin", "field:Server", "value:test", "headers",
+                                      "body:some body", "complete"}),
+            callbacks_.events_);
+}
+
+TEST_F(VectorizedParserImplTest, ResponsesWithoutBody) {
+  initialize(HTTP_RESPONSE);
+
+  const std::string response = "HTTP/1.1 100 Continue\r\n\r\nHTTP/1.1 204 No Content\r\n\r\n"
+                               "HTTP/1.1 304 Not Modified\r\n\r\nHTTP/1.1 200\r\n"
+                               "Content-Length: 0\r\n\r\n";
+  EXPECT_EQ(response.size(), parser_->execute(response.data(), response.size()));
+  EXPECT_EQ(HPE_OK, parser_->error());
+  EXPECT_EQ(4U, std::count(callbacks_.events_.begin(), callbacks_.events_.end(), "complete"));
+  EXPECT_EQ(200, parser_->statusCode());
+  EXPECT_EQ(0U, parser_->contentLength());
+}
+
+// A return value of 1 from onHeadersComplete() skips the body, 2 also hands the rest of the data
+// to the caller.
+TEST_F(VectorizedParserImplTest, HeadersCompleteReturnValue) {
+  initialize(HTTP_RESPONSE);
+  callbacks_.headers_complete_rc_ = 1;
+  const std::string head_response = "HTTP/1.1 200 OK\r\nContent-Length: 20\r\n\r\n";
+  EXPECT_EQ(head_response.size(), parser_->execute(head_response.data(), head_response.size()));
+  EXPECT_EQ("complete", callbacks_.events_.back());
+
+  callbacks_.headers_complete_rc_ = 2;
+  const std::string upgrade = "HTTP/1.1 101 Switching Protocols\r\n\r\nwebsocket data";
+  EXPECT_EQ(upgrade.size() - 14, parser_->execute(upgrade.data(), upgrade.size()));
+  EXPECT_EQ(HPE_OK, parser_->error());
+  EXPECT_EQ("complete", callbacks_.events_.back());
+}
+
+TEST_F(VectorizedParserImplTest, Pause) {
+  initialize(HTTP_REQUEST);
+  callbacks_.pause_on_headers_complete_ = true;
+  callbacks_.pause_on_message_complete_ = true;
+
+  const std::string request = "POST / HTTP/1.1\r\ncontent-length: 2\r\n\r\nabGET / HTTP/1.1\r\n\r\n";
+  const size_t head_size = request.find("ab");
+  EXPECT_EQ(head_size, parser_->execute(request.data(), request.size()));
+  EXPECT_EQ(HPE_PAUSED, parser_->error());
+  EXPECT_EQ(0U, parser_->execute(request.data() + head_size, request.size() - head_size));
+
+  parser_->pause(false);
+  EXPECT_EQ(2U, parser_->execute(request.data() + head_size, request.size() - head_size));
+  EXPECT_EQ("complete", callbacks_.events_.back());
+
+  // Pausing after the head of a message without body leaves its last byte, which completes the
+  // message once parsing resumes.
+  parser_->pause(false);
+  const size_t rest = head_size + 2;
+  EXPECT_EQ(request.size() - rest - 1,
+            parser_->execute(request.data() + rest, request.size() - rest));
+  EXPECT_EQ("headers", callbacks_.events_.back());
+
+  parser_->pause(false);
+  EXPECT_EQ(1U, parser_->execute(request.data() + request.size() - 1, 1));
+  EXPECT_EQ(HPE_PAUSED, parser_->error());
+  EXPECT_EQ(2U, std::count(callbacks_.events_.begin(), callbacks_.events_.end(), "complete"));
+}
+
+TEST_F(VectorizedParserImplTest, LineSizeLimit) {
+  initialize(HTTP_REQUEST, 32);
+  const std::string request = absl::StrCat("GET / HTTP/1.1\r\nfoo: ", std::string(32, 'a'));
+  dispatch(request, 8);
+  EXPECT_EQ(HPE_HEADER_OVERFLOW, parser_->error());
+
+  initialize(HTTP_REQUEST, 32);
+  const std::string complete = absl::StrCat(request, "\r\n");
+  parser_->execute(complete.data(), complete.size());
+  EXPECT_EQ(HPE_HEADER_OVERFLOW, parser_->error());
+}
+
+// Garbage is rejected before the line it is in has been received completely.
+TEST_F(VectorizedParserImplTest, PartialLineValidated) {
+  initialize(HTTP_REQUEST);
+  EXPECT_EQ(1U, parser_->execute("G", 1));
+  EXPECT_EQ(HPE_OK, parser_->error());
+  parser_->execute("g", 1);
+  EXPECT_EQ(HPE_INVALID_METHOD, parser_->error());
+}
+
+TEST_F(VectorizedParserImplTest, EofInMessage) {
+  initialize(HTTP_REQUEST);
+  parser_->execute("GET / HTTP/1.1\r\n", 16);
+  parser_->execute(nullptr, 0);
+  EXPECT_EQ(HPE_INVALID_EOF_STATE, parser_->error());
+}
+
+// URLs, header names and values longer than a 16 byte block are scanned a block at a time, with
+// the remainder left to the scalar loop. Valid bytes must be skipped and an invalid byte found at
+// every offset.
+TEST_F(VectorizedParserImplTest, LongTokens) {
+  const std::string url = "/" + std::string(40, 'u') + "?q=\x80\xff";
+  const std::string name = "X-" + std::string(40, 'n') + "|~";
+  const std::string value = std::string(20, 'v') + "\t\x80\xff" + std::string(20, 'v');
+  const std::string request =
+      absl::StrCat("GET ", url, " HTTP/1.1\r\n", name, ": ", value, "\r\n\r\n");
+
+  initialize(HTTP_REQUEST);
+  EXPECT_EQ(request.size(), parser_->execute(request.data(), request.size()));
+  EXPECT_EQ(HPE_OK, parser_->error());
+  EXPECT_EQ((std::vector<std::string>{"begin", "url:" + url, "field:" + name, "value:" + value,
+                                      "headers", "complete"}),
+            callbacks_.events_);
+
+  for (size_t i = 1; i < 48; i++) {
+    std::string bad_url = std::string(48, 'u');
+    bad_url[i] = '\x7f';
+    initialize(HTTP_REQUEST);
+    const std::string bad_url_request = absl::StrCat("GET /", bad_url, " HTTP/1.1\r\n\r\n");
+    parser_->execute(bad_url_request.data(), bad_url_request.size());
+    EXPECT_EQ(HPE_INVALID_URL, parser_->error()) << i;
+
+    std::string bad_name = std::string(48, 'n');
+    bad_name[i] = '"';
+    initialize(HTTP_REQUEST);
+    const std::string bad_name_request =
+        absl::StrCat("GET / HTTP/1.1\r\n", bad_name, ": v\r\n\r\n");
+    parser_->execute(bad_name_request.data(), bad_name_request.size());
+    EXPECT_EQ(HPE_INVALID_HEADER_TOKEN, parser_->error()) << i;
+
+    std::string bad_value = std::string(48, 'v');
+    bad_value[i] = '\x1f';
+    initialize(HTTP_REQUEST);
+    const std::string bad_value_request =
+        absl::StrCat("GET / HTTP/1.1\r\nname: ", bad_value, "\r\n\r\n");
+    parser_->execute(bad_value_request.data(), bad_value_request.size());
+    EXPECT_EQ(HPE_INVALID_HEADER_TOKEN, parser_->error()) << i;
+  }
+}
+
+TEST_F(VectorizedParserImplTest, Errors) {
+  const std::vector<std::pair<std::string, http_errno>> requests{
+      {"get / HTTP/1.1\r\n\r\n", HPE_INVALID_METHOD},
+      {"GETS / HTTP/1.1\r\n\r\n", HPE_INVALID_METHOD},
+      {"GET  HTTP/1.1\r\n\r\n", HPE_INVALID_URL},
+      {std::string("GET /\0 HTTP/1.1\r\n\r\n", 19), HPE_INVALID_URL},
+      {"GET /\r\n\r\n", HPE_INVALID_VERSION},
+      {"GET / HTTP/1.x\r\n\r\n", HPE_INVALID_VERSION},
+      {"GET / HTTX/1.1\r\n\r\n", HPE_INVALID_CONSTANT},
+      {"GET / HTTP/1.1\r\r\n\r\n", HPE_INVALID_VERSION},
+      {"GET / HTTP/1.1\r\nfoo bar: baz\r\n\r\n", HPE_INVALID_HEADER_TOKEN},
+      {"GET / HTTP/1.1\r\nfoo\r\n\r\n", HPE_INVALID_HEADER_TOKEN},
+      {"GET / HTTP/1.1\r\nfoo: bar\r\n folded\r\n\r\n", HPE_INVALID_HEADER_TOKEN},
+      {"GET / HTTP/1.1\r\nfoo: b\rar\r\n\r\n", HPE_LF_EXPECTED},
+      {"GET / HTTP/1.1\r\nfoo: b\x01r\r\n\r\n", HPE_INVALID_HEADER_TOKEN},
+      {"GET / HTTP/1.1\r\nfoo: b\x7fr\r\n\r\n", HPE_INVALID_HEADER_TOKEN},
+      {std::string("GET / HTTP/1.1\r\nfoo: b\0r\r\n\r\n", 29), HPE_INVALID_HEADER_TOKEN},
+      {"GET / HTTP/1.1\r\ncontent-length: 1\r\ncontent-length: 1\r\n\r\n",
+       HPE_UNEXPECTED_CONTENT_LENGTH},
+      {"GET / HTTP/1.1\r\ncontent-length: 1x\r\n\r\n", HPE_INVALID_CONTENT_LENGTH},
+      {"GET / HTTP/1.1\r\ncontent-length: 99999999999999999999\r\n\r\n",
+       HPE_INVALID_CONTENT_LENGTH},
+      {"GET / HTTP/1.1\r\ncontent-length: 1\r\ntransfer-encoding: chunked\r\n\r\n",
+       HPE_UNEXPECTED_CONTENT_LENGTH},
+      {"GET / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\nx\r\n", HPE_INVALID_CHUNK_SIZE},
+      {"GET / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n1\r\nab\r\n", HPE_STRICT},
+      {"GET / HTTP/1.1\r\ntransfer-encoding: chunked\r\n\r\n11111111111111111\r\n",
+       HPE_INVALID_CHUNK_SIZE},
+  };
+  for (const auto& request : requests) {
+    initialize(HTTP_REQUEST);
+    parser_->execute(request.first.data(), request.first.size());
+    EXPECT_EQ(request.second, parser_->error()) << request.first;
+  }
+
+  const std::vector<std::pair<std::string, http_errno>> responses{
+      {"HTTP/1.1 2000 OK\r\n\r\n", HPE_INVALID_STATUS},
+      {"HTTP/1.1 OK\r\n\r\n", HPE_INVALID_STATUS},
+      {"HTTP/1.1\r\n\r\n", HPE_INVALID_STATUS},
+      {"HTTP/11 200 OK\r\n\r\n", HPE_INVALID_VERSION},
+      {"XTTP/1.1 200 OK\r\n\r\n", HPE_INVALID_CONSTANT},
+  };
+  for (const auto& response : responses) {
+    initialize(HTTP_RESPONSE);
+    parser_->execute(response.first.data(), response.first.size());
+    EXPECT_EQ(response.second, parser_->error()) << response.first;
+  }
+}
+
+} // namespace
+} // namespace Http1
+} // namespace Http
+} // namespace Envoy
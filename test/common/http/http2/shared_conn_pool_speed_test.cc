@@ -0,0 +1,305 @@
+// Usage: bazel run //test/common/http/http2:shared_conn_pool_speed_test
+//
+// Measures the latency which forwarding a stream to the HTTP/2 connection pool of another worker
+// adds, compared to using a pool of the same worker. The upstream answers every request right
+// away, so the results only reflect the cost of the handoff between the two dispatchers.
+//
+// Also counts the upstream connections which the workers open to a set of hosts, with and without
+// sharing them, in the "connections" counter.
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "common/http/http2/shared_conn_pool.h"
+#include "common/stream_info/stream_info_impl.h"
+
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+/**
+ * Upstream stream which completes the response as soon as the request headers are complete, and
+ * deletes itself once it is complete.
+ */
+class EchoStream : public StreamEncoder, public Stream, public Event::DeferredDeletable {
+public:
+  EchoStream(Event::Dispatcher& dispatcher, StreamDecoder& decoder)
+      : dispatcher_(dispatcher), decoder_(decoder) {}
+
+  // Http::StreamEncoder
+  void encode100ContinueHeaders(const HeaderMap&) override {}
+  void encodeHeaders(const HeaderMap&, bool end_stream) override {
+    if (end_stream) {
+      decoder_.decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+      dispatcher_.deferredDelete(Event::DeferredDeletablePtr{this});
+    }
+  }
+  void encodeData(Buffer::Instance&, bool) override {}
+  void encodeTrailers(const HeaderMap&) override {}
+  Stream& getStream() override { return *this; }
+  void encodeMetadata(const MetadataMapVector&) override {}
+
+  // Http::Stream
+  void addCallbacks(StreamCallbacks&) override {}
+  void removeCallbacks(StreamCallbacks&) override {}
+  void resetStream(StreamResetReason) override {}
+  void readDisable(bool) override {}
+  uint32_t bufferLimit() override { return 0; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  StreamDecoder& decoder_;
+};
+
+/**
+ * Connection pool which binds every new stream to an EchoStream right away.
+ */
+class EchoConnPool : public ConnectionPool::Instance {
+public:
+  EchoConnPool(Event::Dispatcher& dispatcher, uint64_t* connections = nullptr)
+      : dispatcher_(dispatcher), stream_info_(Protocol::Http2, dispatcher.timeSource()),
+        connections_(connections) {}
+
+  // Http::ConnectionPool::Instance
+  Http::Protocol protocol() const override { return Protocol::Http2; }
+  void addDrainedCallback(DrainedCb) override {}
+  void drainConnections() override {}
+  bool hasActiveConnections() const override { return false; }
+  ConnectionPool::Cancellable* newStream(StreamDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks) override {
+    // A single HTTP/2 connection carries all the streams of the pool.
+    if (connections_ != nullptr && !connected_) {
+      connected_ = true;
+      ++*connections_;
+    }
+    callbacks.onPoolReady(*new EchoStream(dispatcher_, response_decoder), nullptr, stream_info_);
+    return nullptr;
+  }
+  Upstream::HostDescriptionConstSharedPtr host() const override { return nullptr; }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  StreamInfo::StreamInfoImpl stream_info_;
+  uint64_t* const connections_;
+  bool connected_{};
+};
+
+/**
+ * A header only request, which is sent as soon as its stream is ready.
+ */
+class Request : public ConnectionPool::Callbacks, public StreamDecoder {
+public:
+  // Http::ConnectionPool::Callbacks
+  void onPoolFailure(ConnectionPool::PoolFailureReason, absl::string_view,
+                     Upstream::HostDescriptionConstSharedPtr) override {
+    complete_ = true;
+  }
+  void onPoolReady(StreamEncoder& encoder, Upstream::HostDescriptionConstSharedPtr,
+                   const StreamInfo::StreamInfo&) override {
+    encoder.encodeHeaders(headers_, true);
+  }
+
+  // Http::StreamDecoder
+  void decode100ContinueHeaders(HeaderMapPtr&&) override {}
+  void decodeHeaders(HeaderMapPtr&&, bool end_stream) override { complete_ = end_stream; }
+  void decodeData(Buffer::Instance&, bool end_stream) override { complete_ = end_stream; }
+  void decodeTrailers(HeaderMapPtr&&) override { complete_ = true; }
+  void decodeMetadata(MetadataMapPtr&&) override {}
+
+  TestHeaderMapImpl headers_{{":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  bool complete_{};
+};
+
+/**
+ * Two workers, each with their own dispatcher. The owner runs on its own thread and owns the
+ * shared pool. The origin is run by the benchmark thread, which polls its dispatcher.
+ */
+class Workers {
+public:
+  Workers()
+      : api_(Api::createApiForTest()), origin_dispatcher_(api_->allocateDispatcher()),
+        owner_dispatcher_(api_->allocateDispatcher()),
+        origin_handle_(std::make_shared<DispatcherHandle>(*origin_dispatcher_)),
+        owner_handle_(std::make_shared<DispatcherHandle>(*owner_dispatcher_)),
+        shared_pool_(*owner_dispatcher_,
+                     std::make_unique<EchoConnPool>(*owner_dispatcher_)),
+        forwarding_pool_(*origin_dispatcher_, origin_handle_, owner_handle_, host_,
+                         Protocol::Http2,
+                         [this]() -> SharedConnPoolImpl* { return &shared_pool_; }) {
+    owner_thread_ = api_->threadFactory().createThread([this]() -> void {
+      // Keep the dispatcher running while it is idle.
+      const std::chrono::milliseconds interval(500);
+      keepalive_timer_ = owner_dispatcher_->createTimer(
+          [this, interval]() -> void { keepalive_timer_->enableTimer(interval); });
+      keepalive_timer_->enableTimer(interval);
+      owner_dispatcher_->run(Event::Dispatcher::RunType::Block);
+      keepalive_timer_.reset();
+    });
+  }
+
+  ~Workers() {
+    origin_handle_->close();
+    owner_dispatcher_->post([this]() -> void {
+      owner_handle_->close();
+      owner_dispatcher_->exit();
+    });
+    owner_thread_->join();
+  }
+
+  // Sends the requests through a pool and waits for all of their responses.
+  void run(ConnectionPool::Instance& pool, std::vector<Request>& requests) {
+    for (Request& request : requests) {
+      request.complete_ = false;
+      pool.newStream(request, request);
+    }
+    for (Request& request : requests) {
+      while (!request.complete_) {
+        origin_dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+      }
+    }
+  }
+
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{
+      std::make_shared<NiceMock<Upstream::MockHost>>()};
+  Api::ApiPtr api_;
+  Event::DispatcherPtr origin_dispatcher_;
+  Event::DispatcherPtr owner_dispatcher_;
+  DispatcherHandleSharedPtr origin_handle_;
+  DispatcherHandleSharedPtr owner_handle_;
+  SharedConnPoolImpl shared_pool_;
+  ForwardingConnPoolImpl forwarding_pool_;
+  Thread::ThreadPtr owner_thread_;
+  Event::TimerPtr keepalive_timer_;
+};
+
+/**
+ * Round trip of requests forwarded to the pool of another worker. state.range(0) is the number of
+ * requests in flight at the same time.
+ */
+static void SharedConnPoolForwarded(benchmark::State& state) {
+  Workers workers;
+  std::vector<Request> requests(state.range(0));
+  for (auto _ : state) {
+    workers.run(workers.forwarding_pool_, requests);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SharedConnPoolForwarded)->Arg(1)->Arg(16)->Arg(128);
+
+/**
+ * Round trip of requests of the worker owning the pool, which are passed through. state.range(0)
+ * is the number of requests in flight at the same time.
+ */
+static void SharedConnPoolLocal(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  SharedConnPoolImpl shared_pool(*dispatcher, std::make_unique<EchoConnPool>(*dispatcher));
+  std::vector<Request> requests(state.range(0));
+  for (auto _ : state) {
+    for (Request& request : requests) {
+      shared_pool.newStream(request, request);
+    }
+    dispatcher->clearDeferredDeleteList();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(SharedConnPoolLocal)->Arg(1)->Arg(16)->Arg(128);
+
+/**
+ * Upstream connections which the workers open when each of them sends a request to every host.
+ * The workers share a dispatcher, as only the pools which the requests end up in matter here.
+ * state.range(0) is the number of workers, state.range(1) the number of hosts, and state.range(2)
+ * the number of owners per host, where 0 disables sharing.
+ */
+static void SharedConnPoolConnections(benchmark::State& state) {
+  const uint32_t num_workers = state.range(0);
+  const uint32_t num_hosts = state.range(1);
+  const uint32_t owners_per_host = state.range(2);
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  DispatcherHandleSharedPtr handle = std::make_shared<DispatcherHandle>(*dispatcher);
+  auto host = std::make_shared<NiceMock<Upstream::MockHost>>();
+  uint64_t connections = 0;
+
+  for (auto _ : state) {
+    connections = 0;
+    // Indexed by host, then by worker.
+    std::vector<std::vector<std::unique_ptr<SharedConnPoolImpl>>> shared_pools(num_hosts);
+    std::vector<ConnectionPool::InstancePtr> pools;
+    std::vector<Request> requests(num_workers * num_hosts);
+    auto shared_pool = [&](uint32_t host_index, uint32_t worker) -> SharedConnPoolImpl* {
+      std::unique_ptr<SharedConnPoolImpl>& pool = shared_pools[host_index][worker];
+      if (pool == nullptr) {
+        pool = std::make_unique<SharedConnPoolImpl>(
+            *dispatcher, std::make_unique<EchoConnPool>(*dispatcher, &connections));
+      }
+      return pool.get();
+    };
+
+    for (uint32_t host_index = 0; host_index < num_hosts; ++host_index) {
+      shared_pools[host_index].resize(num_workers);
+      for (uint32_t worker = 0; worker < num_workers; ++worker) {
+        ConnectionPool::Instance* pool;
+        if (owners_per_host == 0) {
+          pools.push_back(std::make_unique<EchoConnPool>(*dispatcher, &connections));
+          pool = pools.back().get();
+        } else {
+          const uint32_t owner = SharedConnPoolImpl::ownerWorker(host_index, worker, num_workers,
+                                                                 owners_per_host);
+          if (owner == worker) {
+            pool = shared_pool(host_index, worker);
+          } else {
+            pools.push_back(std::make_unique<ForwardingConnPoolImpl>(
+                *dispatcher, handle, handle, host, Protocol::Http2,
+                [&shared_pool, host_index, owner]() -> SharedConnPoolImpl* {
+                  return shared_pool(host_index, owner);
+                }));
+            pool = pools.back().get();
+          }
+        }
+        Request& request = requests[host_index * num_workers + worker];
+        pool->newStream(request, request);
+      }
+    }
+
+    for (Request& request : requests) {
+      while (!request.complete_) {
+        dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+      }
+    }
+    // Release the forwarded streams before their pools.
+    dispatcher->clearDeferredDeleteList();
+    pools.clear();
+  }
+  state.counters["connections"] = connections;
+}
+BENCHMARK(SharedConnPoolConnections)
+    ->Args({8, 100, 0})
+    ->Args({8, 100, 1})
+    ->Args({8, 100, 2})
+    ->Args({32, 100, 0})
+    ->Args({32, 100, 2});
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <set>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/header_map_impl.h"
+#include "common/http/http2/shared_conn_pool.h"
+
+#include "test/common/http/common.h"
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/printers.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+class SharedConnPoolTest : public testing::Test {
+public:
+  SharedConnPoolTest() {
+    // Queue the posted events, so that the tests control how the two workers interleave.
+    ON_CALL(origin_dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) -> void {
+      origin_posts_.push_back(cb);
+    }));
+    ON_CALL(owner_dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) -> void {
+      owner_posts_.push_back(cb);
+    }));
+
+    auto pool = std::make_unique<NiceMock<ConnectionPool::MockInstance>>();
+    inner_pool_ = pool.get();
+    shared_pool_ = std::make_unique<SharedConnPoolImpl>(owner_dispatcher_, std::move(pool));
+    forwarding_pool_ = std::make_unique<ForwardingConnPoolImpl>(
+        origin_dispatcher_, origin_handle_, owner_handle_, host_, Protocol::Http2,
+        [this]() -> SharedConnPoolImpl* {
+          return owner_available_ ? shared_pool_.get() : nullptr;
+        });
+  }
+
+  // Runs the events posted to both workers until none are left.
+  void runPosted() {
+    while (!origin_posts_.empty() || !owner_posts_.empty()) {
+      runPosted(owner_posts_);
+      runPosted(origin_posts_);
+    }
+  }
+
+  void runPosted(std::list<Event::PostCb>& posts) {
+    std::list<Event::PostCb> to_run;
+    to_run.swap(posts);
+    for (Event::PostCb& cb : to_run) {
+      cb();
+    }
+  }
+
+  // Forwards a new stream and attaches it to the inner pool of the owner.
+  ConnectionPool::Cancellable* forwardStream() {
+    EXPECT_CALL(*inner_pool_, newStream(_, _))
+        .WillOnce(Invoke([this](StreamDecoder& decoder, ConnectionPool::Callbacks& callbacks)
+                             -> ConnectionPool::Cancellable* {
+          owner_decoder_ = &decoder;
+          owner_callbacks_ = &callbacks;
+          return &cancellable_;
+        }));
+    ConnectionPool::Cancellable* handle =
+        forwarding_pool_->newStream(response_decoder_, callbacks_);
+    EXPECT_NE(nullptr, handle);
+    runPosted();
+    return handle;
+  }
+
+  // Forwards a new stream and binds it to an upstream stream.
+  void forwardReadyStream() {
+    forwardStream();
+    EXPECT_CALL(callbacks_.pool_ready_, ready());
+    owner_callbacks_->onPoolReady(encoder_, inner_pool_->host_, stream_info_);
+    runPosted();
+    ASSERT_NE(nullptr, callbacks_.outer_encoder_);
+  }
+
+  NiceMock<Event::MockDispatcher> origin_dispatcher_;
+  NiceMock<Event::MockDispatcher> owner_dispatcher_;
+  std::list<Event::PostCb> origin_posts_;
+  std::list<Event::PostCb> owner_posts_;
+  DispatcherHandleSharedPtr origin_handle_{std::make_shared<DispatcherHandle>(origin_dispatcher_)};
+  DispatcherHandleSharedPtr owner_handle_{std::make_shared<DispatcherHandle>(owner_dispatcher_)};
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{
+      std::make_shared<NiceMock<Upstream::MockHost>>()};
+  NiceMock<ConnectionPool::MockInstance>* inner_pool_;
+  std::unique_ptr<SharedConnPoolImpl> shared_pool_;
+  std::unique_ptr<ForwardingConnPoolImpl> forwarding_pool_;
+  bool owner_available_{true};
+
+  NiceMock<MockStreamDecoder> response_decoder_;
+  ConnPoolCallbacks callbacks_;
+  StreamDecoder* owner_decoder_{};
+  ConnectionPool::Callbacks* owner_callbacks_{};
+  NiceMock<ConnectionPool::MockCancellable> cancellable_;
+  NiceMock<MockStreamEncoder> encoder_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+};
+
+TEST_F(SharedConnPoolTest, ForwardRequestAndResponse) {
+  forwardReadyStream();
+  EXPECT_EQ(1U, host_->cluster_.stats_.upstream_rq_forwarded_.value());
+  EXPECT_TRUE(forwarding_pool_->hasActiveConnections());
+  EXPECT_EQ(1U, encoder_.stream_.callbacks_.size());
+
+  TestHeaderMapImpl request_headers{{":method", "GET"}, {":path", "/"}};
+  EXPECT_CALL(encoder_, encodeHeaders(HeaderMapEqualRef(&request_headers), false));
+  callbacks_.outer_encoder_->encodeHeaders(request_headers, false);
+  EXPECT_CALL(encoder_, encodeData(BufferStringEqual("hello"), true));
+  Buffer::OwnedImpl request_body("hello");
+  callbacks_.outer_encoder_->encodeData(request_body, true);
+  EXPECT_EQ(0U, request_body.length());
+  runPosted();
+
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  owner_decoder_->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, false);
+  EXPECT_CALL(response_decoder_, decodeTrailers_(_));
+  owner_decoder_->decodeTrailers(HeaderMapPtr{new TestHeaderMapImpl{{"foo", "bar"}}});
+  // The owner half is done once the upstream stream is complete.
+  EXPECT_TRUE(encoder_.stream_.callbacks_.empty());
+  runPosted();
+
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, CancelBeforeReady) {
+  ConnectionPool::Cancellable* handle = forwardStream();
+
+  EXPECT_CALL(cancellable_, cancel());
+  handle->cancel();
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, CancelBeforeForwarded) {
+  ConnectionPool::Cancellable* handle = forwarding_pool_->newStream(response_decoder_, callbacks_);
+  handle->cancel();
+
+  // The owner sees the cancellation after the stream has been attached.
+  EXPECT_CALL(*inner_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  EXPECT_CALL(cancellable_, cancel());
+  EXPECT_CALL(callbacks_.pool_ready_, ready()).Times(0);
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, OwnerPoolUnavailable) {
+  owner_available_ = false;
+  forwarding_pool_->newStream(response_decoder_, callbacks_);
+
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runPosted();
+  EXPECT_EQ(host_, callbacks_.host_);
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, OwnerPoolFailure) {
+  forwardStream();
+
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  owner_callbacks_->onPoolFailure(ConnectionPool::PoolFailureReason::ConnectionFailure, "",
+                                  inner_pool_->host_);
+  runPosted();
+  EXPECT_EQ(inner_pool_->host_, callbacks_.host_);
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, UpstreamReset) {
+  forwardReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  encoder_.stream_.resetStream(StreamResetReason::RemoteReset);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  runPosted();
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, LocalReset) {
+  forwardReadyStream();
+
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  callbacks_.outer_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+  runPosted();
+  EXPECT_TRUE(encoder_.stream_.callbacks_.empty());
+}
+
+TEST_F(SharedConnPoolTest, WatermarksAndReadDisable) {
+  forwardReadyStream();
+  MockStreamCallbacks stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  encoder_.stream_.runHighWatermarkCallbacks();
+  encoder_.stream_.runLowWatermarkCallbacks();
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  runPosted();
+
+  EXPECT_CALL(encoder_.stream_, readDisable(true));
+  callbacks_.outer_encoder_->getStream().readDisable(true);
+  runPosted();
+
+  callbacks_.outer_encoder_->getStream().removeCallbacks(stream_callbacks);
+  callbacks_.outer_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, RequestFlowControl) {
+  ON_CALL(encoder_.stream_, bufferLimit()).WillByDefault(Return(8));
+  forwardReadyStream();
+  EXPECT_EQ(8U, callbacks_.outer_encoder_->getStream().bufferLimit());
+  MockStreamCallbacks stream_callbacks;
+  callbacks_.outer_encoder_->getStream().addCallbacks(stream_callbacks);
+
+  // The origin half stops reading as soon as it has posted more than the buffer limit.
+  EXPECT_CALL(stream_callbacks, onAboveWriteBufferHighWatermark());
+  Buffer::OwnedImpl request_body("0123456789");
+  callbacks_.outer_encoder_->encodeData(request_body, false);
+
+  // It resumes once the owner half has encoded the bytes.
+  EXPECT_CALL(encoder_, encodeData(BufferStringEqual("0123456789"), false));
+  EXPECT_CALL(stream_callbacks, onBelowWriteBufferLowWatermark());
+  runPosted();
+
+  callbacks_.outer_encoder_->getStream().removeCallbacks(stream_callbacks);
+  callbacks_.outer_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, ResponseFlowControl) {
+  ON_CALL(encoder_.stream_, bufferLimit()).WillByDefault(Return(8));
+  forwardReadyStream();
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, false));
+  owner_decoder_->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, false);
+
+  // The owner half stops reading the upstream stream as soon as it has posted more than the
+  // buffer limit, and resumes once the origin half has decoded the bytes.
+  EXPECT_CALL(encoder_.stream_, readDisable(true));
+  Buffer::OwnedImpl response_body("0123456789");
+  owner_decoder_->decodeData(response_body, false);
+  EXPECT_CALL(response_decoder_, decodeData(BufferStringEqual("0123456789"), false));
+  EXPECT_CALL(encoder_.stream_, readDisable(false));
+  runPosted();
+
+  callbacks_.outer_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, OwnerShutDownBeforeForwarding) {
+  owner_handle_->close();
+
+  EXPECT_CALL(*inner_pool_, newStream(_, _)).Times(0);
+  forwarding_pool_->newStream(response_decoder_, callbacks_);
+  EXPECT_TRUE(owner_posts_.empty());
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runPosted();
+  EXPECT_EQ(host_, callbacks_.host_);
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, OwnerShutDownWhileForwarding) {
+  forwarding_pool_->newStream(response_decoder_, callbacks_);
+  owner_handle_->close();
+
+  // The attachment which was already posted is dropped when it runs.
+  EXPECT_CALL(*inner_pool_, newStream(_, _)).Times(0);
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runPosted();
+  EXPECT_EQ(host_, callbacks_.host_);
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, OriginShutDown) {
+  forwardReadyStream();
+  origin_handle_->close();
+
+  EXPECT_CALL(response_decoder_, decodeHeaders_(_, _)).Times(0);
+  owner_decoder_->decodeHeaders(HeaderMapPtr{new TestHeaderMapImpl{{":status", "200"}}}, true);
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, OwnerWorker) {
+  // Every worker forwards to one of the owners of a host, which own their connections.
+  for (uint32_t num_workers : {1U, 2U, 3U, 8U}) {
+    for (uint32_t owners_per_host : {1U, 2U, 8U}) {
+      for (uint64_t host_hash = 0; host_hash < 16; ++host_hash) {
+        std::set<uint32_t> owners;
+        for (uint32_t worker = 0; worker < num_workers; ++worker) {
+          const uint32_t owner = SharedConnPoolImpl::ownerWorker(host_hash, worker, num_workers,
+                                                                 owners_per_host);
+          EXPECT_EQ(owner, SharedConnPoolImpl::ownerWorker(host_hash, owner, num_workers,
+                                                           owners_per_host));
+          owners.insert(owner);
+        }
+        EXPECT_EQ(std::min(num_workers, owners_per_host), owners.size());
+      }
+    }
+  }
+}
+
+TEST_F(SharedConnPoolTest, DrainedCallbacks) {
+  ConnectionPool::Cancellable* handle = forwardStream();
+
+  ReadyWatcher drained;
+  forwarding_pool_->addDrainedCallback([&drained]() -> void { drained.ready(); });
+
+  EXPECT_CALL(drained, ready());
+  handle->cancel();
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, DrainingOwnerRejectsForwardedStreams) {
+  shared_pool_->addDrainedCallback([]() -> void {});
+
+  EXPECT_CALL(*inner_pool_, newStream(_, _)).Times(0);
+  forwarding_pool_->newStream(response_decoder_, callbacks_);
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runPosted();
+  EXPECT_EQ(host_, callbacks_.host_);
+}
+
+TEST_F(SharedConnPoolTest, OwnerPoolDestroyed) {
+  forwardStream();
+
+  shared_pool_.reset();
+  EXPECT_CALL(callbacks_.pool_failure_, ready());
+  runPosted();
+  EXPECT_EQ(host_, callbacks_.host_);
+  EXPECT_FALSE(forwarding_pool_->hasActiveConnections());
+}
+
+TEST_F(SharedConnPoolTest, ForwardingPoolDestroyed) {
+  forwardReadyStream();
+
+  EXPECT_CALL(encoder_.stream_, resetStream(StreamResetReason::LocalReset));
+  forwarding_pool_.reset();
+  runPosted();
+}
+
+TEST_F(SharedConnPoolTest, LocalStreamsPassThrough) {
+  EXPECT_CALL(*inner_pool_, newStream(_, _)).WillOnce(Return(&cancellable_));
+  EXPECT_EQ(&cancellable_, shared_pool_->newStream(response_decoder_, callbacks_));
+  EXPECT_TRUE(owner_posts_.empty());
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
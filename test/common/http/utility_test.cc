@@ -290,6 +290,22 @@ initial_connection_window_size: 65535
   }
 }
 
+TEST(HttpUtility, parseHttp1SettingsParser) {
+  {
+    envoy::api::v2::core::Http1ProtocolOptions http1_protocol_options;
+    TestUtility::loadFromYamlAndValidate("{}", http1_protocol_options);
+    EXPECT_EQ(Http1Settings::ParserImpl::HttpParser,
+              Utility::parseHttp1Settings(http1_protocol_options).parser_impl_);
+  }
+
+  {
+    envoy::api::v2::core::Http1ProtocolOptions http1_protocol_options;
+    TestUtility::loadFromYamlAndValidate("parser: VECTORIZED", http1_protocol_options);
+    EXPECT_EQ(Http1Settings::ParserImpl::Vectorized,
+              Utility::parseHttp1Settings(http1_protocol_options).parser_impl_);
+  }
+}
+
 TEST(HttpUtility, getLastAddressFromXFF) {
   {
     const std::string first_address = "192.0.2.10";
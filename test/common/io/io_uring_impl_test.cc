@@ -0,0 +1,192 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/io/io_uring_impl.h"
+
+#include "gtest/gtest.h"
+
+// The tests of IoUringImpl only build against kernel headers with io_uring support.
+#ifdef ENVOY_IO_URING_SUPPORTED
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringImplTest : public testing::Test {
+public:
+  void SetUp() override {
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+    // Older kernels and sandboxes which block the system calls run the tests as no-ops.
+    if (IoUringImpl::isAvailable()) {
+      io_uring_ = std::make_unique<IoUringImpl>(2);
+    }
+  }
+
+  void TearDown() override {
+    io_uring_.reset();
+    close(fds_[0]);
+    close(fds_[1]);
+  }
+
+  // Wait for the eventfd and return the completions.
+  std::vector<std::pair<void*, int32_t>> waitForCompletions(int event_fd) {
+    pollfd pfd{event_fd, POLLIN, 0};
+    EXPECT_EQ(1, poll(&pfd, 1, 10000));
+    // The ring never resets the eventfd; do it here so that the next poll() waits.
+    eventfd_t value;
+    eventfd_read(event_fd, &value);
+    std::vector<std::pair<void*, int32_t>> completions;
+    io_uring_->forEveryCompletion([&completions](void* user_data, int32_t result) {
+      completions.emplace_back(user_data, result);
+    });
+    return completions;
+  }
+
+  int fds_[2];
+  std::unique_ptr<IoUringImpl> io_uring_;
+};
+
+TEST_F(IoUringImplTest, ReadvWritev) {
+  if (io_uring_ == nullptr) {
+    return;
+  }
+  const int event_fd = io_uring_->registerEventfd();
+
+  std::string data = "hello";
+  iovec write_iovec{&data[0], data.size()};
+  char buf[16];
+  iovec read_iovec{buf, sizeof(buf)};
+  int write_tag, read_tag;
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareWritev(fds_[0], &write_iovec, 1, &write_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadv(fds_[1], &read_iovec, 1, &read_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+
+  std::vector<std::pair<void*, int32_t>> completions;
+  while (completions.size() < 2) {
+    const auto more = waitForCompletions(event_fd);
+    completions.insert(completions.end(), more.begin(), more.end());
+  }
+  for (const auto& completion : completions) {
+    EXPECT_TRUE(completion.first == &write_tag || completion.first == &read_tag);
+    EXPECT_EQ(5, completion.second);
+  }
+  EXPECT_EQ("hello", std::string(buf, 5));
+}
+
+TEST_F(IoUringImplTest, QueueFull) {
+  if (io_uring_ == nullptr) {
+    return;
+  }
+  io_uring_->registerEventfd();
+
+  char buf[16];
+  iovec read_iovec{buf, sizeof(buf)};
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadv(fds_[1], &read_iovec, 1, nullptr));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadv(fds_[1], &read_iovec, 1, nullptr));
+  EXPECT_EQ(IoUringResult::Busy, io_uring_->prepareReadv(fds_[1], &read_iovec, 1, nullptr));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadv(fds_[1], &read_iovec, 1, nullptr));
+}
+
+TEST_F(IoUringImplTest, Cancel) {
+  if (io_uring_ == nullptr) {
+    return;
+  }
+  const int event_fd = io_uring_->registerEventfd();
+
+  char buf[16];
+  iovec read_iovec{buf, sizeof(buf)};
+  int read_tag, cancel_tag;
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareReadv(fds_[1], &read_iovec, 1, &read_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->prepareCancel(&read_tag, &cancel_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+
+  std::vector<std::pair<void*, int32_t>> completions;
+  while (completions.size() < 2) {
+    const auto more = waitForCompletions(event_fd);
+    completions.insert(completions.end(), more.begin(), more.end());
+  }
+  for (const auto& completion : completions) {
+    if (completion.first == &read_tag) {
+      EXPECT_EQ(-ECANCELED, completion.second);
+    } else {
+      EXPECT_EQ(&cancel_tag, completion.first);
+    }
+  }
+}
+
+TEST_F(IoUringImplTest, Accept) {
+  if (io_uring_ == nullptr) {
+    return;
+  }
+  const int event_fd = io_uring_->registerEventfd();
+
+  const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_NE(-1, listen_fd);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  ASSERT_EQ(0, bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), addr_len));
+  ASSERT_EQ(0, listen(listen_fd, 1));
+  ASSERT_EQ(0, getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+
+  sockaddr_storage remote_addr;
+  socklen_t remote_addr_len = sizeof(remote_addr);
+  int accept_tag;
+  EXPECT_EQ(IoUringResult::Ok,
+            io_uring_->prepareAccept(listen_fd, reinterpret_cast<sockaddr*>(&remote_addr),
+                                     &remote_addr_len, &accept_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+  const int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(0, connect(client_fd, reinterpret_cast<sockaddr*>(&addr), addr_len));
+
+  std::vector<std::pair<void*, int32_t>> completions;
+  while (completions.empty()) {
+    completions = waitForCompletions(event_fd);
+  }
+  EXPECT_EQ(&accept_tag, completions[0].first);
+  const int accepted_fd = completions[0].second;
+  ASSERT_GE(accepted_fd, 0);
+  EXPECT_EQ(AF_INET, remote_addr.ss_family);
+  EXPECT_EQ(sizeof(sockaddr_in), remote_addr_len);
+  EXPECT_NE(0, fcntl(accepted_fd, F_GETFL) & O_NONBLOCK);
+
+  close(accepted_fd);
+  close(client_fd);
+  close(listen_fd);
+}
+
+TEST_F(IoUringImplTest, PollAdd) {
+  if (io_uring_ == nullptr) {
+    return;
+  }
+  const int event_fd = io_uring_->registerEventfd();
+
+  int poll_tag;
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->preparePollAdd(fds_[1], POLLRDHUP, &poll_tag));
+  EXPECT_EQ(IoUringResult::Ok, io_uring_->submit());
+  shutdown(fds_[0], SHUT_WR);
+
+  std::vector<std::pair<void*, int32_t>> completions;
+  while (completions.empty()) {
+    completions = waitForCompletions(event_fd);
+  }
+  EXPECT_EQ(&poll_tag, completions[0].first);
+  EXPECT_NE(0, completions[0].second & POLLRDHUP);
+}
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
+
+#endif // ENVOY_IO_URING_SUPPORTED
@@ -0,0 +1,609 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "envoy/event/dispatcher.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/io/io_uring_impl.h"
+#include "common/io/io_uring_worker_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+
+#ifdef ENVOY_IO_URING_SUPPORTED
+#include <sys/eventfd.h>
+#endif
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Io {
+namespace {
+
+class IoUringWorkerTest : public testing::Test {
+public:
+  IoUringWorkerTest() : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()) {}
+
+  void SetUp() override {
+    // Older kernels and sandboxes which block the system calls run the tests as no-ops.
+    IoUringWorker::setIoUringSize(8);
+    // The dispatcher submits the requests of its own worker before polling.
+    worker_ = dynamic_cast<Event::DispatcherImpl&>(*dispatcher_).ioUringWorker();
+  }
+
+  void TearDown() override {
+    IoUringWorker::setIoUringSize(0);
+    for (int fd : peer_fds_) {
+      close(fd);
+    }
+  }
+
+  // Create a connected socket pair, and return the worker managed end.
+  IoUringSocket& addSocket() {
+    int fds[2];
+    EXPECT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+    peer_fds_.push_back(fds[1]);
+    return worker_->addSocket(std::make_unique<Network::IoSocketHandleImpl>(fds[0]));
+  }
+
+  // Create an edge triggered file event for the socket, as a connection does.
+  Event::FileEventPtr createFileEvent(IoUringSocket& socket, uint32_t& activated,
+                                      uint32_t events = Event::FileReadyType::Read |
+                                                        Event::FileReadyType::Write) {
+    return dispatcher_->createFileEvent(
+        socket.fd(), [&activated](uint32_t events) { activated |= events; },
+        Event::FileTriggerType::Edge, events);
+  }
+
+  void runUntil(std::function<bool()> condition) {
+    while (!condition()) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  void closeSocket(IoUringSocket& socket) {
+    socket.close();
+    runUntil([this]() { return worker_->numSockets() == 0; });
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  IoUringWorker* worker_{};
+  std::vector<int> peer_fds_;
+};
+
+TEST_F(IoUringWorkerTest, Read) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  uint32_t activated = 0;
+  Event::FileEventPtr file_event = createFileEvent(socket, activated);
+
+  Buffer::OwnedImpl buffer;
+  Api::SysCallSizeResult result = socket.read(buffer, 16384);
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ(EAGAIN, result.errno_);
+
+  ASSERT_EQ(5, write(peer_fds_[0], "hello", 5));
+  runUntil([&activated]() { return activated != 0; });
+  EXPECT_EQ(static_cast<uint32_t>(Event::FileReadyType::Read), activated);
+
+  result = socket.read(buffer, 3);
+  EXPECT_EQ(3, result.rc_);
+  EXPECT_EQ("hel", buffer.toString());
+  result = socket.read(buffer, 16384);
+  EXPECT_EQ(2, result.rc_);
+  EXPECT_EQ("hello", buffer.toString());
+  result = socket.read(buffer, 16384);
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ(EAGAIN, result.errno_);
+
+  // The peer closing the connection reads as the end of the stream.
+  activated = 0;
+  close(peer_fds_[0]);
+  peer_fds_.clear();
+  runUntil([&activated]() { return activated != 0; });
+  EXPECT_EQ(0, socket.read(buffer, 16384).rc_);
+
+  file_event.reset();
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerTest, Readv) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  uint32_t activated = 0;
+  Event::FileEventPtr file_event = createFileEvent(socket, activated);
+
+  char buf[16];
+  Buffer::RawSlice slice{buf, sizeof(buf)};
+  EXPECT_EQ(-1, socket.readv(sizeof(buf), &slice, 1).rc_);
+  ASSERT_EQ(5, write(peer_fds_[0], "hello", 5));
+  runUntil([&activated]() { return activated != 0; });
+
+  EXPECT_EQ(3, socket.readv(3, &slice, 1).rc_);
+  EXPECT_EQ("hel", std::string(buf, 3));
+  EXPECT_EQ(2, socket.readv(sizeof(buf), &slice, 1).rc_);
+  EXPECT_EQ("lo", std::string(buf, 2));
+
+  file_event.reset();
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerTest, Write) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  uint32_t activated = 0;
+  Event::FileEventPtr file_event = createFileEvent(socket, activated);
+
+  Buffer::OwnedImpl buffer(std::string(IoUringSocket::MaxWriteBufferSize + 1000, 'a'));
+  Api::SysCallSizeResult result = socket.write(buffer);
+  EXPECT_EQ(static_cast<ssize_t>(IoUringSocket::MaxWriteBufferSize), result.rc_);
+  EXPECT_EQ(1000, buffer.length());
+  result = socket.write(buffer);
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ(EAGAIN, result.errno_);
+
+  // Drain the peer until the socket becomes writable again.
+  std::string received;
+  runUntil([&]() {
+    char buf[16384];
+    const ssize_t rc = read(peer_fds_[0], buf, sizeof(buf));
+    if (rc > 0) {
+      received.append(buf, rc);
+    }
+    return activated != 0 && received.size() == IoUringSocket::MaxWriteBufferSize;
+  });
+  EXPECT_EQ(static_cast<uint32_t>(Event::FileReadyType::Write), activated);
+  EXPECT_EQ(std::string(IoUringSocket::MaxWriteBufferSize, 'a'), received);
+
+  file_event.reset();
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerTest, Writev) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+
+  std::string data(IoUringSocket::MaxWriteBufferSize + 1000, 'a');
+  Buffer::RawSlice slice{&data[0], data.size()};
+  EXPECT_EQ(static_cast<ssize_t>(IoUringSocket::MaxWriteBufferSize),
+            socket.writev(&slice, 1).rc_);
+  Api::SysCallSizeResult result = socket.writev(&slice, 1);
+  EXPECT_EQ(-1, result.rc_);
+  EXPECT_EQ(EAGAIN, result.errno_);
+
+  std::string received;
+  runUntil([&]() {
+    char buf[16384];
+    const ssize_t rc = read(peer_fds_[0], buf, sizeof(buf));
+    if (rc > 0) {
+      received.append(buf, rc);
+    }
+    return received.size() == IoUringSocket::MaxWriteBufferSize;
+  });
+  closeSocket(socket);
+}
+
+// Data which arrives while reads are disabled is reported as soon as they are enabled again,
+// without the file descriptor being polled.
+TEST_F(IoUringWorkerTest, EnableReadsWithBufferedData) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  uint32_t activated = 0;
+  Event::FileEventPtr file_event = createFileEvent(socket, activated);
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(-1, socket.read(buffer, 16384).rc_);
+
+  file_event->setEnabled(Event::FileReadyType::Write);
+  ASSERT_EQ(5, write(peer_fds_[0], "hello", 5));
+  // The socket is writable, which re-enabling writes reports.
+  runUntil([&activated]() { return activated != 0; });
+  EXPECT_EQ(static_cast<uint32_t>(Event::FileReadyType::Write), activated);
+  activated = 0;
+  for (int i = 0; i < 10; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(0, activated);
+
+  file_event->setEnabled(Event::FileReadyType::Read);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(static_cast<uint32_t>(Event::FileReadyType::Read), activated);
+  EXPECT_EQ(5, socket.read(buffer, 16384).rc_);
+  EXPECT_EQ("hello", buffer.toString());
+
+  file_event.reset();
+  closeSocket(socket);
+}
+
+// With reads disabled, the peer closing the connection after sending data is still detected.
+TEST_F(IoUringWorkerTest, ClosedWhileReadsDisabled) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  uint32_t activated = 0;
+  Event::FileEventPtr file_event = createFileEvent(socket, activated);
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(-1, socket.read(buffer, 16384).rc_);
+
+  file_event->setEnabled(Event::FileReadyType::Closed);
+  ASSERT_EQ(5, write(peer_fds_[0], "hello", 5));
+  for (int i = 0; i < 10; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_EQ(0, activated);
+
+  close(peer_fds_[0]);
+  peer_fds_.clear();
+  runUntil([&activated]() { return activated != 0; });
+  EXPECT_EQ(static_cast<uint32_t>(Event::FileReadyType::Closed), activated);
+
+  // Closing the socket cancels the poll.
+  file_event.reset();
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerTest, CloseFlushesWrites) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  const int fd = socket.fd();
+
+  Buffer::OwnedImpl read_buffer;
+  socket.read(read_buffer, 16384);
+  Buffer::OwnedImpl write_buffer("response");
+  EXPECT_EQ(8, socket.write(write_buffer).rc_);
+  socket.close();
+  EXPECT_EQ(1, worker_->numSockets());
+
+  runUntil([this]() { return worker_->numSockets() == 0; });
+  EXPECT_EQ(-1, fcntl(fd, F_GETFD));
+  char buf[16];
+  EXPECT_EQ(8, read(peer_fds_[0], buf, sizeof(buf)));
+  EXPECT_EQ("response", std::string(buf, 8));
+  EXPECT_EQ(0, read(peer_fds_[0], buf, sizeof(buf)));
+}
+
+// Shutting down writes right after a write, as RawBufferSocket does at the end of a stream, must
+// not cut off the buffered data.
+TEST_F(IoUringWorkerTest, ShutdownAfterWrite) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  // A small send buffer makes the ring write the data in several parts.
+  const int send_buffer_size = 4096;
+  ASSERT_EQ(0, setsockopt(socket.fd(), SOL_SOCKET, SO_SNDBUF, &send_buffer_size,
+                          sizeof(send_buffer_size)));
+  Buffer::OwnedImpl read_buffer;
+  socket.read(read_buffer, 16384);
+
+  const std::string data(IoUringSocket::MaxWriteBufferSize, 'a');
+  Buffer::OwnedImpl write_buffer(data);
+  EXPECT_EQ(static_cast<ssize_t>(data.size()), socket.write(write_buffer).rc_);
+  EXPECT_EQ(0, socket.shutdown(SHUT_WR).rc_);
+
+  std::string received;
+  runUntil([&]() {
+    char peer_buf[16384];
+    const ssize_t rc = read(peer_fds_[0], peer_buf, sizeof(peer_buf));
+    if (rc > 0) {
+      received.append(peer_buf, rc);
+    }
+    return rc == 0;
+  });
+  EXPECT_EQ(data, received);
+
+  // Only writes were shut down.
+  ASSERT_EQ(5, write(peer_fds_[0], "hello", 5));
+  runUntil([&]() { return socket.read(read_buffer, 16384).rc_ == 5; });
+
+  closeSocket(socket);
+}
+
+// Closing a socket whose buffered writes take several completions writes all of them out first.
+TEST_F(IoUringWorkerTest, CloseFlushesLargeWrite) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  const int send_buffer_size = 4096;
+  ASSERT_EQ(0, setsockopt(socket.fd(), SOL_SOCKET, SO_SNDBUF, &send_buffer_size,
+                          sizeof(send_buffer_size)));
+  Buffer::OwnedImpl read_buffer;
+  socket.read(read_buffer, 16384);
+
+  const std::string data(IoUringSocket::MaxWriteBufferSize, 'b');
+  Buffer::OwnedImpl write_buffer(data);
+  EXPECT_EQ(static_cast<ssize_t>(data.size()), socket.write(write_buffer).rc_);
+  socket.close();
+
+  std::string received;
+  runUntil([&]() {
+    char peer_buf[16384];
+    const ssize_t rc = read(peer_fds_[0], peer_buf, sizeof(peer_buf));
+    if (rc > 0) {
+      received.append(peer_buf, rc);
+    }
+    return rc == 0;
+  });
+  EXPECT_EQ(data, received);
+  runUntil([this]() { return worker_->numSockets() == 0; });
+}
+
+// Destroying the file event of a closed socket leaves the file event of a later socket which got
+// the same file descriptor in place.
+TEST_F(IoUringWorkerTest, FileEventOfReusedFd) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& first_socket = addSocket();
+  const int fd = first_socket.fd();
+  uint32_t first_activated = 0;
+  Event::FileEventPtr first_file_event = createFileEvent(first_socket, first_activated);
+  closeSocket(first_socket);
+
+  IoUringSocket& second_socket = addSocket();
+  ASSERT_EQ(fd, second_socket.fd());
+  uint32_t second_activated = 0;
+  Event::FileEventPtr second_file_event = createFileEvent(second_socket, second_activated);
+  first_file_event.reset();
+  EXPECT_EQ(second_file_event.get(), second_socket.fileEvent());
+
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(-1, second_socket.read(buffer, 16384).rc_);
+  ASSERT_EQ(5, write(peer_fds_.back(), "hello", 5));
+  runUntil([&second_activated]() { return second_activated != 0; });
+  EXPECT_EQ(0, first_activated);
+
+  second_file_event.reset();
+  closeSocket(second_socket);
+}
+
+TEST_F(IoUringWorkerTest, Accept) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  const int listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  ASSERT_NE(-1, listen_fd);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  ASSERT_EQ(0, bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), addr_len));
+  ASSERT_EQ(0, listen(listen_fd, 128));
+  ASSERT_EQ(0, getsockname(listen_fd, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+
+  std::vector<int> accepted_fds;
+  IoUringAcceptor& acceptor = worker_->addAcceptor(
+      listen_fd, [&accepted_fds](int fd, const sockaddr* remote_addr, socklen_t) {
+        EXPECT_EQ(AF_INET, remote_addr->sa_family);
+        accepted_fds.push_back(fd);
+      });
+  acceptor.enable();
+
+  // More connections than accepts in flight.
+  const uint32_t num_connections = IoUringAcceptor::MaxAcceptsInFlight + 2;
+  for (uint32_t i = 0; i < num_connections; i++) {
+    const int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_EQ(0, connect(client_fd, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    peer_fds_.push_back(client_fd);
+  }
+  runUntil([&]() { return accepted_fds.size() == num_connections; });
+  for (int fd : accepted_fds) {
+    EXPECT_NE(0, fcntl(fd, F_GETFL) & O_NONBLOCK);
+    close(fd);
+  }
+
+  // Once disabled, connections wait in the backlog until accepts are queued again.
+  acceptor.disable();
+  for (int i = 0; i < 10; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  accepted_fds.clear();
+  const int client_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_EQ(0, connect(client_fd, reinterpret_cast<sockaddr*>(&addr), addr_len));
+  peer_fds_.push_back(client_fd);
+  for (int i = 0; i < 10; i++) {
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_TRUE(accepted_fds.empty());
+  acceptor.enable();
+  runUntil([&]() { return accepted_fds.size() == 1; });
+  close(accepted_fds[0]);
+
+  acceptor.close();
+  runUntil([this]() { return worker_->numAcceptors() == 0; });
+  close(listen_fd);
+}
+
+// More requests than submission queue entries.
+TEST_F(IoUringWorkerTest, FullQueue) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  std::vector<IoUringSocket*> sockets;
+  for (int i = 0; i < 20; i++) {
+    sockets.push_back(&addSocket());
+    Buffer::OwnedImpl buffer;
+    sockets.back()->read(buffer, 16384);
+  }
+  for (IoUringSocket* socket : sockets) {
+    socket->close();
+  }
+  runUntil([this]() { return worker_->numSockets() == 0; });
+}
+
+// Discarding pending writes, as a connection closed with NoFlush does, cancels the queued write
+// and closes the socket without writing the rest of the buffered data out.
+TEST_F(IoUringWorkerTest, DiscardPendingWrites) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  const int send_buffer_size = 4096;
+  ASSERT_EQ(0, setsockopt(socket.fd(), SOL_SOCKET, SO_SNDBUF, &send_buffer_size,
+                          sizeof(send_buffer_size)));
+  Buffer::OwnedImpl read_buffer;
+  socket.read(read_buffer, 16384);
+
+  const std::string data(IoUringSocket::MaxWriteBufferSize, 'c');
+  Buffer::OwnedImpl write_buffer(data);
+  EXPECT_EQ(static_cast<ssize_t>(data.size()), socket.write(write_buffer).rc_);
+  socket.discardPendingWrites();
+  socket.close();
+  runUntil([this]() { return worker_->numSockets() == 0; });
+
+  std::string received;
+  char peer_buf[16384];
+  ssize_t rc;
+  while ((rc = read(peer_fds_[0], peer_buf, sizeof(peer_buf))) > 0) {
+    received.append(peer_buf, rc);
+  }
+  EXPECT_EQ(0, rc);
+  EXPECT_LT(received.size(), data.size());
+}
+
+TEST_F(IoUringWorkerTest, DestroyWithRequestsInFlight) {
+  if (worker_ == nullptr) {
+    return;
+  }
+  IoUringSocket& socket = addSocket();
+  const int fd = socket.fd();
+  Buffer::OwnedImpl buffer;
+  socket.read(buffer, 16384);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  socket.close();
+
+  dispatcher_.reset();
+  EXPECT_EQ(-1, fcntl(fd, F_GETFD));
+}
+
+#ifdef ENVOY_IO_URING_SUPPORTED
+
+// IoUring whose submission queue can be kept full, with the kernel refusing submissions as it does
+// while completions wait for room in the completion queue.
+class FakeIoUring : public IoUring {
+public:
+  ~FakeIoUring() override {
+    if (event_fd_ != -1) {
+      close(event_fd_);
+    }
+  }
+
+  // Io::IoUring
+  int registerEventfd() override {
+    event_fd_ = eventfd(0, EFD_NONBLOCK);
+    return event_fd_;
+  }
+  void forEveryCompletion(const CompletionCb& completion_cb) override {
+    reaps_++;
+    std::vector<std::pair<void*, int32_t>> completions;
+    completions.swap(completions_);
+    for (const auto& completion : completions) {
+      completion_cb(completion.first, completion.second);
+    }
+  }
+  IoUringResult prepareReadv(int, const struct iovec*, unsigned, void* user_data) override {
+    return prepare(user_data);
+  }
+  IoUringResult prepareWritev(int, const struct iovec*, unsigned, void* user_data) override {
+    return prepare(user_data);
+  }
+  IoUringResult prepareAccept(int, struct sockaddr*, socklen_t*, void* user_data) override {
+    return prepare(user_data);
+  }
+  IoUringResult preparePollAdd(int, uint32_t, void* user_data) override {
+    return prepare(user_data);
+  }
+  IoUringResult prepareCancel(void*, void* user_data) override { return prepare(user_data); }
+  IoUringResult submit() override { return full_ ? IoUringResult::Busy : IoUringResult::Ok; }
+
+  void complete(void* user_data, int32_t result) {
+    completions_.emplace_back(user_data, result);
+    const uint64_t value = 1;
+    ASSERT_EQ(static_cast<ssize_t>(sizeof(value)), write(event_fd_, &value, sizeof(value)));
+  }
+
+  bool full_{};
+  std::vector<void*> prepared_;
+  std::vector<std::pair<void*, int32_t>> completions_;
+  uint32_t reaps_{};
+
+private:
+  IoUringResult prepare(void* user_data) {
+    if (full_) {
+      return IoUringResult::Busy;
+    }
+    prepared_.push_back(user_data);
+    return IoUringResult::Ok;
+  }
+
+  int event_fd_{-1};
+};
+
+// Requests which do not fit into a full submission queue are parked instead of aborting, and
+// queued in order by the next submit() once there is room.
+TEST(IoUringWorkerFullQueueTest, ParkRequests) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher();
+  auto io_uring = std::make_unique<FakeIoUring>();
+  FakeIoUring& fake_io_uring = *io_uring;
+  IoUringWorker worker(std::move(io_uring), *dispatcher);
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+  IoUringSocket& socket =
+      worker.addSocket(std::make_unique<Network::IoSocketHandleImpl>(fds[0]));
+
+  fake_io_uring.full_ = true;
+  Buffer::OwnedImpl buffer;
+  EXPECT_EQ(-1, socket.read(buffer, 16384).rc_);
+  Buffer::OwnedImpl write_buffer("hello");
+  EXPECT_EQ(5, socket.write(write_buffer).rc_);
+  // The completions were reaped to let the kernel accept submissions again.
+  EXPECT_LT(0, fake_io_uring.reaps_);
+  EXPECT_TRUE(fake_io_uring.prepared_.empty());
+  worker.submit();
+  EXPECT_TRUE(fake_io_uring.prepared_.empty());
+
+  fake_io_uring.full_ = false;
+  worker.submit();
+  ASSERT_EQ(2, fake_io_uring.prepared_.size());
+  void* read_request = fake_io_uring.prepared_[0];
+  void* write_request = fake_io_uring.prepared_[1];
+
+  fake_io_uring.complete(write_request, 5);
+  fake_io_uring.complete(read_request, 0);
+  while (socket.read(buffer, 16384).rc_ != 0) {
+    dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  }
+
+  socket.close();
+  EXPECT_EQ(0, worker.numSockets());
+  close(fds[1]);
+}
+
+#endif // ENVOY_IO_URING_SUPPORTED
+
+} // namespace
+} // namespace Io
+} // namespace Envoy
@@ -2,6 +2,7 @@
 #include <memory>
 #include <string>
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/buffer/buffer_impl.h"
 #include "common/common/empty_string.h"
 #include "common/common/fmt.h"
@@ -484,6 +485,53 @@ TEST_P(ConnectionImplTest, ReadDisable) {
   disconnect(false);
 }
 
+// Test that a bypassed connection reports socket events instead of reading from the socket.
+TEST_P(ConnectionImplTest, BypassTransportSocket) {
+  setUpBasicConnection();
+  connect();
+
+  // The server connection has a single read filter and no buffered data.
+  ASSERT_EQ(Api::OsSysCallsSingleton::get().supportsSplice(),
+            server_connection_->canBypassTransportSocket());
+  if (!server_connection_->canBypassTransportSocket()) {
+    disconnect(true);
+    return;
+  }
+
+  MockBypassCallbacks bypass_callbacks;
+  IoHandle& io_handle = server_connection_->bypassTransportSocket(bypass_callbacks);
+  EXPECT_FALSE(server_connection_->canBypassTransportSocket());
+
+  EXPECT_CALL(*read_filter_, onData(_, _)).Times(0);
+  EXPECT_CALL(bypass_callbacks, onSocketEvent(_))
+      .WillRepeatedly(Invoke([&](uint32_t events) -> void {
+        if (events & Event::FileReadyType::Read) {
+          dispatcher_->exit();
+        }
+      }));
+  Buffer::OwnedImpl buffer("hello");
+  client_connection_->write(buffer, false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  char buf[16];
+  EXPECT_EQ(5, Api::OsSysCallsSingleton::get().recv(io_handle.fd(), buf, sizeof(buf), 0).rc_);
+
+  EXPECT_CALL(server_callbacks_, onEvent(ConnectionEvent::LocalClose));
+  server_connection_->close(ConnectionCloseType::FlushWrite);
+  disconnect(false);
+}
+
+// Test that a connection with a write filter cannot be bypassed.
+TEST_P(ConnectionImplTest, BypassTransportSocketWithWriteFilter) {
+  setUpBasicConnection();
+  connect();
+
+  server_connection_->addWriteFilter(std::make_shared<NiceMock<MockWriteFilter>>());
+  EXPECT_FALSE(server_connection_->canBypassTransportSocket());
+
+  disconnect(true);
+}
+
 // The HTTP/1 codec handles pipelined connections by relying on readDisable(false) resulting in the
 // subsequent request being dispatched. Regression test this behavior.
 TEST_P(ConnectionImplTest, ReadEnableDispatches) {
@@ -0,0 +1,238 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures round trips of ListenerImpl accepted and client connections echoing messages over
+// loopback, with and without the worker's io_uring. The arguments of every benchmark are the
+// number of connections, the message size and whether io_uring is enabled. Both ends run on the
+// benchmark thread, whose system calls are counted through the raw_syscalls:sys_enter tracepoint
+// when the tracing file system is readable.
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/network/listener.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+#include "common/io/io_uring_worker_impl.h"
+#include "common/network/address_impl.h"
+#include "common/network/filter_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/raw_buffer_socket.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+
+// Counts the system calls of the calling thread.
+class SyscallCounter {
+public:
+  SyscallCounter() {
+    uint64_t id;
+    if (!readTracepointId("/sys/kernel/tracing", id) &&
+        !readTracepointId("/sys/kernel/debug/tracing", id)) {
+      return;
+    }
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_TRACEPOINT;
+    attr.config = id;
+    attr.disabled = 1;
+    fd_ = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+  }
+  ~SyscallCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  bool available() const { return fd_ >= 0; }
+  void start() { ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0); }
+  void stop() { ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0); }
+  uint64_t count() const {
+    uint64_t count = 0;
+    return read(fd_, &count, sizeof(count)) == sizeof(count) ? count : 0;
+  }
+
+private:
+  static bool readTracepointId(const std::string& tracing_dir, uint64_t& id) {
+    std::ifstream file(tracing_dir + "/events/raw_syscalls/sys_enter/id");
+    return static_cast<bool>(file >> id);
+  }
+
+  int fd_{-1};
+};
+
+class IoUringSpeedTest : public ListenerCallbacks, public ConnectionCallbacks {
+public:
+  IoUringSpeedTest(uint32_t num_connections, uint32_t message_size, bool io_uring)
+      : num_connections_(num_connections), message_(message_size, 'a') {
+    Io::IoUringWorker::setIoUringSize(io_uring ? 256 : 0);
+    api_ = Api::createApiForTest();
+    dispatcher_ = api_->allocateDispatcher();
+    io_uring_ = dynamic_cast<Event::DispatcherImpl&>(*dispatcher_).ioUringWorker() != nullptr;
+    socket_ = std::make_unique<TcpListenSocket>(
+        std::make_shared<Address::Ipv4Instance>("127.0.0.1"), nullptr, true);
+    listener_ = dispatcher_->createListener(*socket_, *this, true);
+
+    for (uint32_t i = 0; i < num_connections_; i++) {
+      clients_.push_back(dispatcher_->createClientConnection(
+          socket_->localAddress(), nullptr, std::make_unique<RawBufferSocket>(), nullptr));
+      clients_.back()->addConnectionCallbacks(*this);
+      clients_.back()->addReadFilter(std::make_shared<CountFilter>(*this));
+      clients_.back()->connect();
+    }
+    while (connected_ < num_connections_ || servers_.size() < num_connections_) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+
+  ~IoUringSpeedTest() override {
+    for (auto& client : clients_) {
+      client->close(ConnectionCloseType::NoFlush);
+    }
+    for (auto& server : servers_) {
+      server->close(ConnectionCloseType::NoFlush);
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    clients_.clear();
+    servers_.clear();
+    listener_.reset();
+    dispatcher_.reset();
+    Io::IoUringWorker::setIoUringSize(0);
+  }
+
+  bool ioUring() const { return io_uring_; }
+
+  // Sends a message on every connection and dispatches until all of them have been echoed.
+  void roundTrip() {
+    for (auto& client : clients_) {
+      Buffer::OwnedImpl buffer(message_);
+      client->write(buffer, false);
+    }
+    expected_bytes_ += message_.size() * num_connections_;
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+
+  // ListenerCallbacks
+  void onAccept(ConnectionSocketPtr&& socket) override {
+    servers_.push_back(dispatcher_->createServerConnection(std::move(socket),
+                                                           std::make_unique<RawBufferSocket>()));
+    servers_.back()->addReadFilter(std::make_shared<EchoFilter>());
+  }
+
+  // ConnectionCallbacks
+  void onEvent(ConnectionEvent event) override {
+    if (event == ConnectionEvent::Connected) {
+      connected_++;
+    }
+  }
+  void onAboveWriteBufferHighWatermark() override {}
+  void onBelowWriteBufferLowWatermark() override {}
+
+private:
+  class EchoFilter : public ReadFilterBaseImpl {
+  public:
+    // ReadFilter
+    FilterStatus onData(Buffer::Instance& data, bool) override {
+      read_callbacks_->connection().write(data, false);
+      return FilterStatus::StopIteration;
+    }
+    void initializeReadFilterCallbacks(ReadFilterCallbacks& callbacks) override {
+      read_callbacks_ = &callbacks;
+    }
+
+  private:
+    ReadFilterCallbacks* read_callbacks_{};
+  };
+
+  class CountFilter : public ReadFilterBaseImpl {
+  public:
+    CountFilter(IoUringSpeedTest& parent) : parent_(parent) {}
+
+    // ReadFilter
+    FilterStatus onData(Buffer::Instance& data, bool) override {
+      parent_.received_bytes_ += data.length();
+      data.drain(data.length());
+      if (parent_.received_bytes_ == parent_.expected_bytes_) {
+        parent_.dispatcher_->exit();
+      }
+      return FilterStatus::StopIteration;
+    }
+
+  private:
+    IoUringSpeedTest& parent_;
+  };
+
+  const uint32_t num_connections_;
+  const std::string message_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  bool io_uring_{};
+  std::unique_ptr<TcpListenSocket> socket_;
+  ListenerPtr listener_;
+  std::vector<ClientConnectionPtr> clients_;
+  std::vector<ConnectionPtr> servers_;
+  uint32_t connected_{};
+  uint64_t expected_bytes_{};
+  uint64_t received_bytes_{};
+};
+
+static void BM_EchoRoundTrip(benchmark::State& state) {
+  const bool io_uring = state.range(2) != 0;
+  IoUringSpeedTest context(state.range(0), state.range(1), io_uring);
+  if (io_uring && !context.ioUring()) {
+    state.SkipWithError("io_uring is not supported");
+    return;
+  }
+  SyscallCounter syscalls;
+  if (syscalls.available()) {
+    syscalls.start();
+  }
+  uint64_t round_trips = 0;
+  for (auto _ : state) {
+    context.roundTrip();
+    round_trips += state.range(0);
+  }
+  state.SetItemsProcessed(round_trips);
+  if (syscalls.available()) {
+    syscalls.stop();
+    state.counters["syscalls_per_round_trip"] =
+        static_cast<double>(syscalls.count()) / std::max<uint64_t>(round_trips, 1);
+  }
+}
+BENCHMARK(BM_EchoRoundTrip)
+    ->Args({1, 128, 0})
+    ->Args({1, 128, 1})
+    ->Args({64, 128, 0})
+    ->Args({64, 128, 1})
+    ->Args({64, 16384, 0})
+    ->Args({64, 16384, 1});
+
+} // namespace Network
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  Envoy::Event::Libevent::Global::initialize();
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
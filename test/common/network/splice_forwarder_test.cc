@@ -0,0 +1,178 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <limits>
+#include <string>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/splice_forwarder.h"
+
+#include "test/mocks/api/mocks.h"
+#include "test/test_common/threadsafe_singleton_injector.h"
+
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+constexpr uint64_t UnlimitedBytes = std::numeric_limits<uint64_t>::max();
+
+// Forwards from one end of a socket pair to one end of another one.
+class SpliceForwarderTest : public testing::Test {
+protected:
+  void SetUp() override {
+    if (!Api::OsSysCallsSingleton::get().supportsSplice()) {
+      return;
+    }
+    int source_fds[2];
+    int destination_fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, source_fds));
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, destination_fds));
+    client_ = std::make_unique<IoSocketHandleImpl>(source_fds[0]);
+    source_ = std::make_unique<IoSocketHandleImpl>(source_fds[1]);
+    destination_ = std::make_unique<IoSocketHandleImpl>(destination_fds[0]);
+    server_ = std::make_unique<IoSocketHandleImpl>(destination_fds[1]);
+    forwarder_ = SpliceForwarder::create(0);
+    ASSERT_NE(nullptr, forwarder_);
+  }
+
+  std::string readServer() {
+    char buf[1024];
+    const ssize_t rc = ::read(server_->fd(), buf, sizeof(buf));
+    return rc > 0 ? std::string(buf, rc) : "";
+  }
+
+  std::unique_ptr<IoSocketHandleImpl> client_;
+  std::unique_ptr<IoSocketHandleImpl> source_;
+  std::unique_ptr<IoSocketHandleImpl> destination_;
+  std::unique_ptr<IoSocketHandleImpl> server_;
+  SpliceForwarderPtr forwarder_;
+};
+
+TEST_F(SpliceForwarderTest, ForwardDataAndEndStream) {
+  if (forwarder_ == nullptr) {
+    return;
+  }
+
+  SpliceForwarder::Result result = forwarder_->forward(*source_, *destination_, UnlimitedBytes);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_EQ(0, result.bytes_written_);
+  EXPECT_EQ(0, result.error_);
+
+  ASSERT_EQ(5, ::write(client_->fd(), "hello", 5));
+  result = forwarder_->forward(*source_, *destination_, UnlimitedBytes);
+  EXPECT_EQ(5, result.bytes_read_);
+  EXPECT_EQ(5, result.bytes_written_);
+  EXPECT_EQ(0, result.error_);
+  EXPECT_FALSE(forwarder_->endStream());
+  EXPECT_EQ("hello", readServer());
+
+  ASSERT_EQ(0, ::shutdown(client_->fd(), SHUT_WR));
+  result = forwarder_->forward(*source_, *destination_, UnlimitedBytes);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_EQ(0, result.error_);
+  EXPECT_TRUE(forwarder_->endStream());
+  char buf[1];
+  EXPECT_EQ(0, ::read(server_->fd(), buf, sizeof(buf)));
+}
+
+// Data which the destination does not accept stays in the pipe until it does.
+TEST_F(SpliceForwarderTest, DestinationFull) {
+  if (forwarder_ == nullptr) {
+    return;
+  }
+
+  const std::string data(4096, 'a');
+  uint64_t sent = 0;
+  uint64_t received = 0;
+  // Fill the destination socket until the data is held back by the pipe.
+  while (true) {
+    const ssize_t rc = ::write(client_->fd(), data.data(), data.size());
+    if (rc > 0) {
+      sent += rc;
+    }
+    const SpliceForwarder::Result result = forwarder_->forward(*source_, *destination_, UnlimitedBytes);
+    EXPECT_EQ(0, result.error_);
+    if (result.bytes_read_ == 0 && rc < 0) {
+      break;
+    }
+  }
+
+  // Drain the server side and let the forwarder flush the pipe.
+  char buf[16384];
+  while (received < sent) {
+    const ssize_t rc = ::read(server_->fd(), buf, sizeof(buf));
+    if (rc > 0) {
+      received += rc;
+    }
+    const SpliceForwarder::Result result = forwarder_->forward(*source_, *destination_, UnlimitedBytes);
+    EXPECT_EQ(0, result.error_);
+    if (rc <= 0 && result.bytes_written_ == 0 && result.bytes_read_ == 0) {
+      break;
+    }
+  }
+  EXPECT_EQ(sent, received);
+}
+
+// A call stops reading once it has read max_bytes_read and reports that it yielded, the next one
+// resumes where it stopped.
+TEST_F(SpliceForwarderTest, MaxBytesRead) {
+  if (forwarder_ == nullptr) {
+    return;
+  }
+
+  ASSERT_EQ(5, ::write(client_->fd(), "hello", 5));
+  SpliceForwarder::Result result = forwarder_->forward(*source_, *destination_, 0);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_EQ(0, result.error_);
+  EXPECT_TRUE(result.yielded_);
+
+  result = forwarder_->forward(*source_, *destination_, 1);
+  EXPECT_EQ(5, result.bytes_read_);
+  EXPECT_EQ(5, result.bytes_written_);
+  EXPECT_TRUE(result.yielded_);
+  EXPECT_EQ("hello", readServer());
+
+  // Nothing is left to read, the source would block before the limit is reached.
+  result = forwarder_->forward(*source_, *destination_, 1);
+  EXPECT_EQ(0, result.bytes_read_);
+  EXPECT_FALSE(result.yielded_);
+}
+
+TEST_F(SpliceForwarderTest, DestinationClosed) {
+  if (forwarder_ == nullptr) {
+    return;
+  }
+
+  server_.reset();
+  ASSERT_EQ(5, ::write(client_->fd(), "hello", 5));
+  const SpliceForwarder::Result result = forwarder_->forward(*source_, *destination_, UnlimitedBytes);
+  EXPECT_EQ(5, result.bytes_read_);
+  EXPECT_EQ(0, result.bytes_written_);
+  EXPECT_NE(0, result.error_);
+}
+
+TEST(SpliceForwarderCreateTest, Unsupported) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, supportsSplice()).WillOnce(Return(false));
+  EXPECT_CALL(os_sys_calls, pipe(_)).Times(0);
+  EXPECT_EQ(nullptr, SpliceForwarder::create(0));
+}
+
+TEST(SpliceForwarderCreateTest, PipeFailure) {
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, supportsSplice()).WillOnce(Return(true));
+  EXPECT_CALL(os_sys_calls, pipe(_)).WillOnce(Return(Api::SysCallIntResult{-1, EMFILE}));
+  EXPECT_EQ(nullptr, SpliceForwarder::create(0));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
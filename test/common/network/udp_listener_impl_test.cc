@@ -89,6 +89,35 @@ protected:
     time_system_.sleep(std::chrono::milliseconds(100));
   }
 
+  // Replaces the listener with one batching its system calls.
+  void setBatchConfig(uint32_t max_batch_size, bool enable_udp_offload) {
+    UdpListenerBatchConfig batch_config;
+    batch_config.max_batch_size_ = max_batch_size;
+    batch_config.enable_udp_offload_ = enable_udp_offload;
+    listener_.reset();
+    listener_ = std::make_unique<UdpListenerImpl>(dispatcherImpl(), *server_socket_,
+                                                  listener_callbacks_,
+                                                  dispatcherImpl().timeSource(), batch_config);
+  }
+
+  // Reads the next datagram sent to the client socket, or returns an empty string after 10 tries.
+  std::string recvOnClientSocket() {
+    auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+    char buf[MAX_UDP_PACKET_SIZE];
+    for (int retry = 0; retry < 10; retry++) {
+      const Api::SysCallSizeResult result = os_sys_calls.recvfrom(
+          client_socket_->ioHandle().fd(), buf, sizeof(buf), 0, nullptr, nullptr);
+      if (result.rc_ >= 0) {
+        return std::string(buf, result.rc_);
+      }
+      if (result.errno_ != EAGAIN) {
+        break;
+      }
+      ::usleep(10000);
+    }
+    return "";
+  }
+
   SocketPtr server_socket_;
   SocketPtr client_socket_;
   Address::InstanceConstSharedPtr send_to_addr_;
@@ -455,6 +484,102 @@ TEST_P(UdpListenerImplTest, SendDataError) {
   EXPECT_DEATH(listener_->send(send_data), "Invalid argument passed in");
 }
 
+/**
+ * Tests that packets read with recvmmsg() are passed to the callbacks one at a time, in order. The
+ * second round of packets is read into the buffers the first round left unused.
+ */
+TEST_P(UdpListenerImplTest, BatchedRecv) {
+  setBatchConfig(16, false);
+  client_socket_ = createClientSocket(false);
+  EXPECT_CALL(listener_callbacks_, onWriteReady_(_)).Times(testing::AnyNumber());
+
+  for (const auto& payloads : std::vector<std::vector<std::string>>{
+           {"first", "second", "third"}, {"fourth", "fifth", "sixth", "seventh"}}) {
+    for (const auto& payload : payloads) {
+      Buffer::RawSlice slice{const_cast<char*>(payload.data()), payload.length()};
+      auto send_rc = client_socket_->ioHandle().sendto(slice, 0, *send_to_addr_);
+      ASSERT_EQ(send_rc.rc_, payload.length());
+    }
+
+    std::vector<std::string> received;
+    EXPECT_CALL(listener_callbacks_, onData_(_))
+        .Times(payloads.size())
+        .WillRepeatedly(Invoke([&](const UdpRecvData& data) -> void {
+          EXPECT_EQ(data.local_address_->asString(), send_to_addr_->asString());
+          EXPECT_EQ(data.peer_address_->ip()->addressAsString(),
+                    client_socket_->localAddress()->ip()->addressAsString());
+          received.push_back(data.buffer_->toString());
+          if (received.size() == payloads.size()) {
+            dispatcher_->exit();
+          }
+        }));
+
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    EXPECT_EQ(payloads, received);
+  }
+}
+
+/**
+ * Tests that sendBatch() sends every packet as its own datagram, in order, and drains them.
+ * Equally sized packets are coalesced into one message if UDP offload is enabled and supported by
+ * the kernel, which must not be visible to the receiver.
+ */
+TEST_P(UdpListenerImplTest, SendBatch) {
+  for (const bool enable_udp_offload : {false, true}) {
+    setBatchConfig(16, enable_udp_offload);
+    client_socket_ = createClientSocket(true);
+
+    const std::vector<std::string> payloads{"aaaa", "bbbb", "cccc", "dd", "eeee", "ffff"};
+    std::vector<Buffer::OwnedImpl> buffers(payloads.size());
+    std::vector<UdpSendData> send_data;
+    for (size_t i = 0; i < payloads.size(); i++) {
+      buffers[i].add(payloads[i]);
+      send_data.push_back(UdpSendData{nullptr, *client_socket_->localAddress(), buffers[i]});
+    }
+
+    auto send_result = listener_->sendBatch(send_data.data(), send_data.size());
+    ASSERT_TRUE(send_result.ok()) << send_result.err_->getErrorDetails();
+    EXPECT_EQ(payloads.size(), send_result.rc_);
+    for (size_t i = 0; i < payloads.size(); i++) {
+      EXPECT_EQ(0, buffers[i].length());
+      EXPECT_EQ(payloads[i], recvOnClientSocket());
+    }
+  }
+}
+
+#ifdef __linux__
+/**
+ * The batched send fails and leaves the packets in their buffers.
+ */
+TEST_P(UdpListenerImplTest, SendBatchError) {
+  setBatchConfig(16, false);
+  Buffer::OwnedImpl first("first");
+  Buffer::OwnedImpl second("second");
+  UdpSendData send_data[] = {{send_to_addr_->ip(), *server_socket_->localAddress(), first},
+                             {send_to_addr_->ip(), *server_socket_->localAddress(), second}};
+
+  Api::MockOsSysCalls os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::OsSysCallsImpl> os_calls(&os_sys_calls);
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, ENOTSUP}));
+  auto send_result = listener_->sendBatch(send_data, 2);
+  EXPECT_FALSE(send_result.ok());
+  EXPECT_EQ(send_result.err_->getErrorCode(), Api::IoError::IoErrorCode::NoSupport);
+  EXPECT_EQ(5, first.length());
+  EXPECT_EQ(6, second.length());
+
+  // Only the first packet is sent.
+  EXPECT_CALL(os_sys_calls, supportsMmsg()).WillOnce(Return(true));
+  EXPECT_CALL(os_sys_calls, sendmmsg(_, _, 2, _)).WillOnce(Return(Api::SysCallIntResult{1, 0}));
+  send_result = listener_->sendBatch(send_data, 2);
+  EXPECT_TRUE(send_result.ok());
+  EXPECT_EQ(1, send_result.rc_);
+  EXPECT_EQ(0, first.length());
+  EXPECT_EQ(6, second.length());
+}
+#endif
+
 } // namespace
 } // namespace Network
 } // namespace Envoy
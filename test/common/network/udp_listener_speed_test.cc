@@ -0,0 +1,141 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the packet rate of UdpListenerImpl over loopback with the system calls batched to
+// various degrees. The first argument of every benchmark is the batch size and the second one
+// whether UDP offload (GRO/GSO) is enabled.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/network/listener.h"
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/buffer/buffer_impl.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/event/libevent.h"
+#include "common/network/address_impl.h"
+#include "common/network/listen_socket_impl.h"
+#include "common/network/socket_option_factory.h"
+#include "common/network/udp_listener_impl.h"
+#include "common/network/utility.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+
+// Number of packets sent or received per benchmark iteration.
+static constexpr uint64_t PacketsPerIteration = 64;
+static constexpr uint64_t PacketSize = 1200;
+
+class UdpListenerSpeedTest : public UdpListenerCallbacks {
+public:
+  UdpListenerSpeedTest(uint32_t max_batch_size, bool enable_udp_offload)
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher()),
+        server_socket_(std::make_shared<Address::Ipv4Instance>("127.0.0.1"), nullptr, true),
+        client_socket_(std::make_shared<Address::Ipv4Instance>("127.0.0.1"), nullptr, true),
+        payload_(PacketSize, 'a') {
+    server_socket_.addOptions(SocketOptionFactory::buildIpPacketInfoOptions());
+    server_socket_.addOptions(SocketOptionFactory::buildRxQueueOverFlowOptions());
+    UdpListenerBatchConfig batch_config;
+    batch_config.max_batch_size_ = max_batch_size;
+    batch_config.enable_udp_offload_ = enable_udp_offload;
+    listener_ = std::make_unique<UdpListenerImpl>(
+        dynamic_cast<Event::DispatcherImpl&>(*dispatcher_), server_socket_, *this,
+        dispatcher_->timeSource(), batch_config);
+  }
+
+  // Sends packets to the listener and dispatches until they have all been read.
+  uint64_t receivePackets() {
+    Buffer::RawSlice slice{const_cast<char*>(payload_.data()), payload_.length()};
+    for (uint64_t i = 0; i < PacketsPerIteration; i++) {
+      client_socket_.ioHandle().sendto(slice, 0, *server_socket_.localAddress());
+    }
+    const uint64_t start = packets_received_;
+    // The kernel may drop packets, so give up after a while.
+    for (int i = 0; i < 100 && packets_received_ - start < PacketsPerIteration; i++) {
+      dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+    }
+    return packets_received_ - start;
+  }
+
+  // Sends packets to the client socket with sendBatch() and drains them.
+  uint64_t sendPackets() {
+    std::vector<Buffer::OwnedImpl> buffers(PacketsPerIteration);
+    std::vector<UdpSendData> send_data;
+    send_data.reserve(PacketsPerIteration);
+    for (auto& buffer : buffers) {
+      buffer.add(payload_);
+      send_data.push_back(UdpSendData{nullptr, *client_socket_.localAddress(), buffer});
+    }
+    const uint64_t packets_sent = listener_->sendBatch(send_data.data(), send_data.size()).rc_;
+
+    auto& os_sys_calls = Api::OsSysCallsSingleton::get();
+    char buf[PacketSize];
+    while (os_sys_calls.recv(client_socket_.ioHandle().fd(), buf, sizeof(buf), 0).rc_ > 0) {
+    }
+    return packets_sent;
+  }
+
+  // UdpListenerCallbacks
+  void onData(UdpRecvData&) override { packets_received_++; }
+  void onWriteReady(const Socket&) override {}
+  void onReceiveError(const ErrorCode&, Api::IoError::IoErrorCode) override {}
+
+private:
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  UdpListenSocket server_socket_;
+  UdpListenSocket client_socket_;
+  const std::string payload_;
+  std::unique_ptr<UdpListenerImpl> listener_;
+  uint64_t packets_received_{};
+};
+
+static void BM_UdpReceive(benchmark::State& state) {
+  UdpListenerSpeedTest context(state.range(0), state.range(1) != 0);
+  uint64_t packets = 0;
+  for (auto _ : state) {
+    packets += context.receivePackets();
+  }
+  state.SetItemsProcessed(packets);
+}
+BENCHMARK(BM_UdpReceive)
+    ->Args({1, 0})
+    ->Args({16, 0})
+    ->Args({64, 0})
+    ->Args({1, 1})
+    ->Args({64, 1});
+
+static void BM_UdpSend(benchmark::State& state) {
+  UdpListenerSpeedTest context(state.range(0), state.range(1) != 0);
+  uint64_t packets = 0;
+  for (auto _ : state) {
+    packets += context.sendPackets();
+  }
+  state.SetItemsProcessed(packets);
+}
+BENCHMARK(BM_UdpSend)
+    ->Args({1, 0})
+    ->Args({16, 0})
+    ->Args({64, 0})
+    ->Args({1, 1})
+    ->Args({64, 1});
+
+} // namespace Network
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  Envoy::Event::Libevent::Global::initialize();
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
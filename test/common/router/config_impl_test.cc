@@ -24,6 +24,7 @@
 #include "test/test_common/environment.h"
 #include "test/test_common/printers.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -938,6 +939,77 @@ virtual_hosts:
             config.route(genHeaders("example.com", "/", "GET"), 0)->routeEntry()->clusterName());
 }
 
+// With compiled route matching enabled, routes must still be evaluated in configuration order
+// and non-path criteria must still be able to reject a route whose path matched.
+TEST_F(RouteMatcherTest, CompiledRouteMatching) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.compiled_route_matching", "true"}});
+
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: compiled
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/foo"
+          headers:
+            - name: x-canary
+              exact_match: "true"
+        route: { cluster: "canary" }
+      - match: { path: "/foo/bar" }
+        route: { cluster: "exact" }
+      - match: { prefix: "/FOO", case_sensitive: false }
+        route: { cluster: "case_insensitive" }
+      - match:
+          safe_regex:
+            google_re2: {}
+            regex: "/users/\\d+"
+        route: { cluster: "regex" }
+      - match: { prefix: "/users" }
+        route: { cluster: "users" }
+      - match:
+          prefix: "/"
+          query_parameters:
+            - name: debug
+        route: { cluster: "debug" }
+      - match: { prefix: "/" }
+        route: { cluster: "default" }
+  )EOF";
+
+  TestConfigImpl config(parseRouteConfigurationFromV2Yaml(yaml), factory_context_, true);
+
+  {
+    Http::TestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo/bar", "GET");
+    headers.addCopy("x-canary", "true");
+    EXPECT_EQ("canary", config.route(headers, 0)->routeEntry()->clusterName());
+  }
+  EXPECT_EQ("exact", config.route(genHeaders("www.lyft.com", "/foo/bar", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("exact", config.route(genHeaders("www.lyft.com", "/foo/bar?a=b", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("case_insensitive", config.route(genHeaders("www.lyft.com", "/foo/baz", "GET"), 0)
+                                    ->routeEntry()
+                                    ->clusterName());
+  EXPECT_EQ("case_insensitive", config.route(genHeaders("www.lyft.com", "/Foo/bar", "GET"), 0)
+                                    ->routeEntry()
+                                    ->clusterName());
+  EXPECT_EQ("regex", config.route(genHeaders("www.lyft.com", "/users/123?x=y", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("users", config.route(genHeaders("www.lyft.com", "/users/abc", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("debug", config.route(genHeaders("www.lyft.com", "/other?debug=1", "GET"), 0)
+                         ->routeEntry()
+                         ->clusterName());
+  EXPECT_EQ("default", config.route(genHeaders("www.lyft.com", "/other", "GET"), 0)
+                           ->routeEntry()
+                           ->clusterName());
+}
+
 // When deprecating regex: this test can be removed.
 TEST_F(RouteMatcherTest, DEPRECATED_FEATURE_TEST(TestRoutesWithInvalidRegexLegacy)) {
   std::string invalid_route = R"EOF(
@@ -0,0 +1,134 @@
+#include <vector>
+
+#include "common/router/path_match_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+PathMatchIndex::Positions candidates(const PathMatchIndex& index, absl::string_view path) {
+  const size_t query_start = path.find('?');
+  const size_t path_only_length =
+      query_start == absl::string_view::npos ? path.size() : query_start;
+  PathMatchIndex::Positions positions;
+  index.candidates(path, path_only_length, positions);
+  return positions;
+}
+
+TEST(PathMatchIndexTest, Empty) {
+  PathMatchIndex index;
+  index.compile();
+  EXPECT_THAT(candidates(index, "/foo"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, Prefix) {
+  PathMatchIndex index;
+  index.addPrefix("/foo/bar", true, 0);
+  index.addPrefix("/foo", true, 1);
+  index.addPrefix("/fox", true, 2);
+  index.addPrefix("/", true, 3);
+  index.addPrefix("", true, 4);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo/bar/baz"), ElementsAre(0, 1, 3, 4));
+  EXPECT_THAT(candidates(index, "/foo/ba"), ElementsAre(1, 3, 4));
+  EXPECT_THAT(candidates(index, "/fox"), ElementsAre(2, 3, 4));
+  EXPECT_THAT(candidates(index, "/fo"), ElementsAre(3, 4));
+  EXPECT_THAT(candidates(index, "/FOO"), ElementsAre(3, 4));
+  EXPECT_THAT(candidates(index, ""), ElementsAre(4));
+  // Prefix routes are matched against the full path, including the query string.
+  EXPECT_THAT(candidates(index, "/?foo"), ElementsAre(3, 4));
+}
+
+TEST(PathMatchIndexTest, Path) {
+  PathMatchIndex index;
+  index.addPath("/foo", true, 0);
+  index.addPath("/foo/bar", true, 1);
+  index.addPrefix("/foo", true, 2);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 2));
+  EXPECT_THAT(candidates(index, "/foo?a=b"), ElementsAre(0, 2));
+  EXPECT_THAT(candidates(index, "/foo/bar"), ElementsAre(1, 2));
+  EXPECT_THAT(candidates(index, "/foo/ba"), ElementsAre(2));
+  EXPECT_THAT(candidates(index, "/fo"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, CaseInsensitive) {
+  PathMatchIndex index;
+  index.addPrefix("/Foo", false, 0);
+  index.addPath("/BAR", false, 1);
+  index.addPrefix("/foo", true, 2);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 2));
+  EXPECT_THAT(candidates(index, "/FOO/x"), ElementsAre(0));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(1));
+  EXPECT_THAT(candidates(index, "/bAr?x"), ElementsAre(1));
+  EXPECT_THAT(candidates(index, "/barx"), IsEmpty());
+}
+
+TEST(PathMatchIndexTest, Regex) {
+  PathMatchIndex index;
+  index.addRegex("/foo/\\d+", 0);
+  index.addPrefix("/foo", true, 1);
+  index.addRegex(".*", 2);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo/123"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/foo/123?x=1"), ElementsAre(0, 1, 2));
+  // Regexes are fully anchored.
+  EXPECT_THAT(candidates(index, "/foo/123x"), ElementsAre(1, 2));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(2));
+}
+
+TEST(PathMatchIndexTest, Unindexed) {
+  PathMatchIndex index;
+  index.addPrefix("/foo", true, 0);
+  index.addUnindexed(1);
+  index.addPath("/bar", true, 2);
+  index.addUnindexed(3);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1, 3));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(1, 2, 3));
+  EXPECT_THAT(candidates(index, "/baz"), ElementsAre(1, 3));
+}
+
+// Regexes which RE2::Set refuses are still returned as candidates.
+TEST(PathMatchIndexTest, InvalidRegex) {
+  PathMatchIndex index;
+  index.addRegex("(", 0);
+  index.addPrefix("/foo", true, 1);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(0));
+}
+
+// Inserting keys that split existing edges must keep every key reachable.
+TEST(PathMatchIndexTest, EdgeSplitting) {
+  PathMatchIndex index;
+  index.addPath("/api/v1/users", true, 0);
+  index.addPath("/api/v1/user", true, 1);
+  index.addPath("/api/v2", true, 2);
+  index.addPrefix("/api", true, 3);
+  index.addPath("/a", true, 4);
+  index.compile();
+
+  EXPECT_THAT(candidates(index, "/api/v1/users"), ElementsAre(0, 3));
+  EXPECT_THAT(candidates(index, "/api/v1/user"), ElementsAre(1, 3));
+  EXPECT_THAT(candidates(index, "/api/v2"), ElementsAre(2, 3));
+  EXPECT_THAT(candidates(index, "/api/v1"), ElementsAre(3));
+  EXPECT_THAT(candidates(index, "/a"), ElementsAre(4));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -0,0 +1,174 @@
+// Usage: bazel run //test/common/router:route_matcher_speed_test
+
+#include <string>
+
+#include "envoy/api/v2/rds.pb.h"
+
+#include "common/http/header_map_impl.h"
+#include "common/protobuf/message_validator_impl.h"
+#include "common/router/config_impl.h"
+
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/test_runtime.h"
+#include "test/test_common/utility.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+/**
+ * Generates a single virtual host with num_routes routes. Every fourth route is an exact path
+ * match, every sixteenth a safe regex and the rest are prefix matches, which is roughly the mix of
+ * our large production virtual hosts. The last route is a catch-all.
+ */
+envoy::api::v2::RouteConfiguration makeRouteConfig(int num_routes) {
+  envoy::api::v2::RouteConfiguration route_config;
+  auto* virtual_host = route_config.add_virtual_hosts();
+  virtual_host->set_name("benchmark");
+  virtual_host->add_domains("*");
+  for (int i = 0; i < num_routes - 1; ++i) {
+    auto* route = virtual_host->add_routes();
+    if (i % 16 == 0) {
+      route->mutable_match()->mutable_safe_regex()->mutable_google_re2();
+      route->mutable_match()->mutable_safe_regex()->set_regex(
+          absl::StrCat("/regex/service_", i, "/[a-z]+/\\d+"));
+    } else if (i % 4 == 0) {
+      route->mutable_match()->set_path(absl::StrCat("/exact/service_", i, "/health"));
+    } else {
+      route->mutable_match()->set_prefix(absl::StrCat("/prefix/service_", i, "/"));
+    }
+    route->mutable_route()->set_cluster(absl::StrCat("cluster_", i));
+  }
+  auto* catch_all = virtual_host->add_routes();
+  catch_all->mutable_match()->set_prefix("/");
+  catch_all->mutable_route()->set_cluster("default");
+  return route_config;
+}
+
+/**
+ * Measure the speed of finding a route in a virtual host with state.range(0) routes, for a request
+ * that matches the route at the middle of the route table. state.range(1) selects whether compiled
+ * route matching is enabled.
+ */
+static void RouteMatcherFindRoute(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.compiled_route_matching",
+        state.range(1) != 0 ? "true" : "false"}});
+
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  const int num_routes = state.range(0);
+  ConfigImpl config(makeRouteConfig(num_routes), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+
+  // Pick a prefix route from the middle of the table.
+  int target = num_routes / 2;
+  while (target % 4 == 0) {
+    target++;
+  }
+  Http::TestHeaderMapImpl headers{
+      {":authority", "www.lyft.com"},
+      {":path", absl::StrCat("/prefix/service_", target, "/resource?query=1")},
+      {":method", "GET"},
+      {"x-forwarded-proto", "http"}};
+
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, 0);
+    benchmark::DoNotOptimize(route);
+  }
+}
+BENCHMARK(RouteMatcherFindRoute)
+    ->ArgPairs({{10, 0}, {10, 1}, {100, 0}, {100, 1}, {1000, 0}, {1000, 1}, {3000, 0}, {3000, 1}});
+
+/**
+ * Measure the speed of a request which does not match any route but the catch-all, which is the
+ * worst case for linear matching.
+ */
+static void RouteMatcherFindCatchAll(benchmark::State& state) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.compiled_route_matching",
+        state.range(1) != 0 ? "true" : "false"}});
+
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  ConfigImpl config(makeRouteConfig(state.range(0)), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), false);
+  Http::TestHeaderMapImpl headers{{":authority", "www.lyft.com"},
+                                  {":path", "/unknown/resource"},
+                                  {":method", "GET"},
+                                  {"x-forwarded-proto", "http"}};
+
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, 0);
+    benchmark::DoNotOptimize(route);
+  }
+}
+BENCHMARK(RouteMatcherFindCatchAll)
+    ->ArgPairs({{10, 0}, {10, 1}, {100, 0}, {100, 1}, {1000, 0}, {1000, 1}, {3000, 0}, {3000, 1}});
+
+/**
+ * Measure the speed of finding a wildcard virtual host among state.range(0) virtual hosts with
+ * "*.tenant-N.example.com" suffix domains and as many "tenant-N.example.*" prefix domains, for a
+ * request which matches a suffix wildcard.
+ */
+static void RouteMatcherFindWildcardVirtualHost(benchmark::State& state) {
+  Api::ApiPtr api = Api::createApiForTest();
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  NiceMock<Envoy::StreamInfo::MockStreamInfo> stream_info;
+
+  const int num_domains = state.range(0);
+  envoy::api::v2::RouteConfiguration route_config;
+  for (int i = 0; i < num_domains; ++i) {
+    auto* virtual_host = route_config.add_virtual_hosts();
+    virtual_host->set_name(absl::StrCat("tenant_", i));
+    virtual_host->add_domains(absl::StrCat("*.tenant-", i, ".example.com"));
+    virtual_host->add_domains(absl::StrCat("tenant-", i, ".example.*"));
+    auto* route = virtual_host->add_routes();
+    route->mutable_match()->set_prefix("/");
+    route->mutable_route()->set_cluster(absl::StrCat("cluster_", i));
+  }
+  ConfigImpl config(route_config, factory_context, ProtobufMessage::getNullValidationVisitor(),
+                    false);
+
+  Http::TestHeaderMapImpl headers{
+      {":authority", absl::StrCat("api.tenant-", num_domains / 2, ".example.com")},
+      {":path", "/"},
+      {":method", "GET"},
+      {"x-forwarded-proto", "http"}};
+
+  for (auto _ : state) {
+    RouteConstSharedPtr route = config.route(headers, stream_info, 0);
+    benchmark::DoNotOptimize(route);
+  }
+}
+BENCHMARK(RouteMatcherFindWildcardVirtualHost)->Arg(10)->Arg(1000)->Arg(10000)->Arg(50000);
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
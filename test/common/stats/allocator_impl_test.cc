@@ -1,10 +1,13 @@
 #include <string>
+#include <vector>
 
 #include "common/stats/allocator_impl.h"
 #include "common/stats/symbol_table_creator.h"
 
 #include "test/test_common/logging.h"
+#include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/strings/str_cat.h"
 #include "gtest/gtest.h"
 
 namespace Envoy {
@@ -75,6 +78,55 @@ TEST_F(AllocatorImplTest, GaugesWithSameName) {
   EXPECT_EQ(0, g2->value());
 }
 
+TEST_F(AllocatorImplTest, GaugeLatchChanged) {
+  GaugeSharedPtr g = alloc_.makeGauge(makeStat("gauge.name"), "", std::vector<Tag>(),
+                                      Gauge::ImportMode::Accumulate);
+  EXPECT_FALSE(g->latchChanged());
+  g->set(5);
+  EXPECT_TRUE(g->latchChanged());
+  EXPECT_FALSE(g->latchChanged());
+  EXPECT_TRUE(g->used());
+  g->add(1);
+  g->sub(2);
+  EXPECT_TRUE(g->latchChanged());
+  g->dec();
+  EXPECT_TRUE(g->latchChanged());
+  EXPECT_FALSE(g->latchChanged());
+  EXPECT_EQ(3, g->value());
+}
+
+// Threads allocating the same counters at once all get the same objects, whichever shard of
+// the allocator the counters are in.
+TEST_F(AllocatorImplTest, ConcurrentCounters) {
+  const uint32_t num_threads = 8;
+  std::vector<StatName> names;
+  for (uint32_t i = 0; i < 64; ++i) {
+    names.push_back(makeStat(absl::StrCat("counter.", i)));
+  }
+
+  std::vector<std::vector<CounterSharedPtr>> counters(num_threads);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < num_threads; ++t) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&, t]() {
+      for (StatName name : names) {
+        counters[t].push_back(alloc_.makeCounter(name, "", std::vector<Tag>()));
+        counters[t].back()->inc();
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  for (uint32_t i = 0; i < names.size(); ++i) {
+    for (uint32_t t = 1; t < num_threads; ++t) {
+      EXPECT_EQ(counters[0][i].get(), counters[t][i].get());
+    }
+    EXPECT_EQ(num_threads, counters[0][i]->value());
+    EXPECT_EQ(num_threads, counters[0][i]->use_count());
+  }
+}
+
 } // namespace
 } // namespace Stats
 } // namespace Envoy
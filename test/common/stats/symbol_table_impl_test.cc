@@ -376,6 +376,19 @@ TEST_P(StatNameTest, JoinAllEmpty) {
   EXPECT_EQ("", table_->toString(StatName(joined.get())));
 }
 
+TEST_P(StatNameTest, StartsWith) {
+  const StatName name = makeStat("a.b.c");
+  EXPECT_TRUE(table_->startsWith(name, makeStat("")));
+  EXPECT_TRUE(table_->startsWith(name, makeStat("a")));
+  EXPECT_TRUE(table_->startsWith(name, makeStat("a.b")));
+  EXPECT_TRUE(table_->startsWith(name, makeStat("a.b.c")));
+  EXPECT_FALSE(table_->startsWith(name, makeStat("a.b.c.d")));
+  EXPECT_FALSE(table_->startsWith(name, makeStat("a.bc")));
+  EXPECT_FALSE(table_->startsWith(name, makeStat("b")));
+  EXPECT_FALSE(table_->startsWith(makeStat("a.bc"), makeStat("a.b")));
+  EXPECT_FALSE(table_->startsWith(makeStat(""), makeStat("a")));
+}
+
 // Validates that we don't get tsan or other errors when concurrently creating
 // a large number of stats.
 TEST_P(StatNameTest, RacingSymbolCreation) {
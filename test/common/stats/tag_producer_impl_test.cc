@@ -55,5 +55,40 @@ TEST(TagProducerTest, CheckConstructor) {
       "No regex specified for tag specifier and no default regex for name: 'test_extractor'");
 }
 
+// Regexes RE2 cannot parse are applied on their own, in the same order as the compiled regexes.
+TEST(TagProducerTest, CompiledAndFallbackExtractors) {
+  envoy::config::metrics::v2::StatsConfig stats_config;
+  stats_config.mutable_use_all_default_tags()->set_value(false);
+  auto add_tag = [&stats_config](const std::string& name, const std::string& regex) {
+    auto& tag_specifier = *stats_config.mutable_stats_tags()->Add();
+    tag_specifier.set_tag_name(name);
+    tag_specifier.set_regex(regex);
+  };
+  add_tag("first", R"(^foo(?=\.).*?\.first\.((\w+)\.))");
+  // RE2 does not support negative lookahead assertions.
+  add_tag("second", R"(^foo\.(?!skip)((\w+)\.))");
+  add_tag("code", R"(_rq(_(\d{3}))$)");
+  TagProducerImpl producer(stats_config);
+
+  std::vector<Tag> tags;
+  EXPECT_EQ("foo.first.upstream_rq",
+            producer.produceTags("foo.bar.first.baz.upstream_rq_200", tags));
+  ASSERT_EQ(3, tags.size());
+  EXPECT_EQ("code", tags[0].name_);
+  EXPECT_EQ("200", tags[0].value_);
+  EXPECT_EQ("first", tags[1].name_);
+  EXPECT_EQ("baz", tags[1].value_);
+  EXPECT_EQ("second", tags[2].name_);
+  EXPECT_EQ("bar", tags[2].value_);
+
+  tags.clear();
+  EXPECT_EQ("foo.skip.x", producer.produceTags("foo.skip.x", tags));
+  EXPECT_TRUE(tags.empty());
+
+  tags.clear();
+  EXPECT_EQ("bar.baz.first.x", producer.produceTags("bar.baz.first.x", tags));
+  EXPECT_TRUE(tags.empty());
+}
+
 } // namespace Stats
 } // namespace Envoy
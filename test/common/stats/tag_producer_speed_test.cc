@@ -0,0 +1,142 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Usage: bazel run //test/common/stats:tag_producer_speed_test
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/config/metrics/v2/stats.pb.h"
+
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/common/utility.h"
+#include "common/config/well_known_names.h"
+#include "common/stats/allocator_impl.h"
+#include "common/stats/tag_extractor_impl.h"
+#include "common/stats/tag_producer_impl.h"
+#include "common/stats/thread_local_store.h"
+
+#include "test/common/stats/stat_test_utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Stats {
+namespace {
+
+// Sample stat names, plus names which most of the default tag extractors apply to.
+std::vector<std::string> sampleNames() {
+  std::vector<std::string> names;
+  TestUtil::forEachSampleStat(100, [&names](absl::string_view name) {
+    names.emplace_back(std::string(name));
+  });
+  for (int i = 0; i < 100; ++i) {
+    names.push_back(fmt::format("cluster.service_{}.upstream_rq_503", i));
+    names.push_back(fmt::format("cluster.service_{}.upstream_rq_5xx", i));
+    names.push_back(fmt::format("cluster.service_{}.grpc.svc.method.success", i));
+    names.push_back(fmt::format("http.ingress_{}.user_agent.ios.downstream_cx_total", i));
+    names.push_back(fmt::format("http.ingress_{}.rds.route_{}.config_reload", i, i));
+    names.push_back(fmt::format("listener.127.0.0.1_{}.http.ingress.downstream_rq_2xx", i));
+    names.push_back(fmt::format("vhost.vhost_{}.vcluster.vcluster.upstream_rq_time", i));
+    names.push_back(fmt::format("mongo.mongo_{}.collection.col.query.total", i));
+  }
+  return names;
+}
+
+// Applies every default tag extractor whose prefix matches the name, one after the other. This
+// is how the tags were produced before the extractors were compiled into a set.
+class SequentialTagProducer {
+public:
+  SequentialTagProducer() {
+    for (const auto& desc : Config::TagNames::get().descriptorVec()) {
+      extractors_.push_back(
+          TagExtractorImpl::createTagExtractor(desc.name_, desc.regex_, desc.substr_));
+    }
+  }
+
+  std::string produceTags(absl::string_view metric_name, std::vector<Tag>& tags) const {
+    IntervalSetImpl<size_t> remove_characters;
+    const absl::string_view token = metric_name.substr(0, metric_name.find('.'));
+    for (const TagExtractorPtr& extractor : extractors_) {
+      if (extractor->prefixToken().empty() || extractor->prefixToken() == token) {
+        extractor->extractTag(metric_name, tags, remove_characters);
+      }
+    }
+    return StringUtil::removeCharacters(metric_name, remove_characters);
+  }
+
+private:
+  std::vector<TagExtractorPtr> extractors_;
+};
+
+void BM_ProduceTagsSequential(benchmark::State& state) {
+  const std::vector<std::string> names = sampleNames();
+  SequentialTagProducer producer;
+  for (auto _ : state) {
+    for (const std::string& name : names) {
+      std::vector<Tag> tags;
+      benchmark::DoNotOptimize(producer.produceTags(name, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_ProduceTagsSequential);
+
+void BM_ProduceTags(benchmark::State& state) {
+  const std::vector<std::string> names = sampleNames();
+  TagProducerImpl producer{envoy::config::metrics::v2::StatsConfig()};
+  for (auto _ : state) {
+    for (const std::string& name : names) {
+      std::vector<Tag> tags;
+      benchmark::DoNotOptimize(producer.produceTags(name, tags));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_ProduceTags);
+
+// Creates all the sample counters in a new store, which extracts their tags.
+void BM_CreateStats(benchmark::State& state) {
+  const std::vector<std::string> names = sampleNames();
+  SymbolTablePtr symbol_table = SymbolTableCreator::makeSymbolTable();
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto alloc = std::make_unique<AllocatorImpl>(*symbol_table);
+    auto store = std::make_unique<ThreadLocalStoreImpl>(*alloc);
+    store->setTagProducer(
+        std::make_unique<TagProducerImpl>(envoy::config::metrics::v2::StatsConfig()));
+    state.ResumeTiming();
+
+    for (const std::string& name : names) {
+      store->counter(name);
+    }
+
+    state.PauseTiming();
+    store->shutdownThreading();
+    store.reset();
+    alloc.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * names.size());
+}
+BENCHMARK(BM_CreateStats);
+
+} // namespace
+} // namespace Stats
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logger_context(spdlog::level::warn,
+                                        Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
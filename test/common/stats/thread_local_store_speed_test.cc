@@ -1,11 +1,13 @@
 // Note: this should be run with --compilation_mode=opt, and would benefit from a
 // quiescent system with disabled cstate power management.
 
+#include "common/common/fmt.h"
 #include "common/common/logger.h"
 #include "common/common/thread.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/stats/allocator_impl.h"
 #include "common/stats/fake_symbol_table_impl.h"
+#include "common/stats/symbol_table_impl.h"
 #include "common/stats/tag_producer_impl.h"
 #include "common/stats/thread_local_store.h"
 #include "common/thread_local/thread_local_impl.h"
@@ -65,6 +67,81 @@ private:
   std::vector<std::unique_ptr<Stats::StatNameStorage>> stat_names_;
 };
 
+/**
+ * Creates the stats of many cluster scopes from several threads at once. Each thread creates a
+ * different subset of the stats of every scope, so the threads contend on the same scopes, but
+ * do not create the same stats.
+ */
+class ThreadLocalStoreCreationPerf {
+public:
+  ThreadLocalStoreCreationPerf(int num_threads, bool real_symbol_table)
+      : num_threads_(num_threads),
+        symbol_table_(real_symbol_table
+                          ? Stats::SymbolTablePtr(std::make_unique<Stats::SymbolTableImpl>())
+                          : Stats::SymbolTablePtr(std::make_unique<Stats::FakeSymbolTableImpl>())),
+        pool_(*symbol_table_) {
+    static const char* cluster_stats[] = {"upstream_rq_200",
+                                          "upstream_rq_2xx",
+                                          "upstream_rq_503",
+                                          "upstream_rq_5xx",
+                                          "upstream_cx_total",
+                                          "upstream_cx_active",
+                                          "upstream_rq_total",
+                                          "upstream_rq_active",
+                                          "upstream_rq_retry",
+                                          "upstream_rq_timeout",
+                                          "grpc.svc.get.success",
+                                          "grpc.svc.get.failure"};
+    for (const char* cluster_stat : cluster_stats) {
+      stat_names_.push_back(pool_.add(cluster_stat));
+    }
+  }
+
+  ~ThreadLocalStoreCreationPerf() { pool_.clear(); }
+
+  // Creates the stats of num_clusters scopes in a new store. Only the creation of the stats is
+  // timed.
+  void createStats(benchmark::State& state, int num_clusters) {
+    state.PauseTiming();
+    Stats::AllocatorImpl alloc(*symbol_table_);
+    Stats::ThreadLocalStoreImpl store(alloc);
+    store.setTagProducer(std::make_unique<Stats::TagProducerImpl>(stats_config_));
+    std::vector<Stats::ScopePtr> scopes;
+    for (int i = 0; i < num_clusters; ++i) {
+      scopes.push_back(store.createScope(fmt::format("cluster.service_{}", i)));
+    }
+    state.ResumeTiming();
+
+    std::vector<Thread::ThreadPtr> threads;
+    for (int t = 0; t < num_threads_; ++t) {
+      threads.push_back(Thread::threadFactoryForTest().createThread([this, &scopes, t]() {
+        for (const Stats::ScopePtr& scope : scopes) {
+          for (size_t i = t; i < stat_names_.size(); i += num_threads_) {
+            scope->counterFromStatName(stat_names_[i]);
+          }
+        }
+      }));
+    }
+    for (Thread::ThreadPtr& thread : threads) {
+      thread->join();
+    }
+
+    state.PauseTiming();
+    scopes.clear();
+    store.shutdownThreading();
+    state.ResumeTiming();
+  }
+
+  size_t numStats() const { return stat_names_.size(); }
+
+private:
+  const int num_threads_;
+  Stats::SymbolTablePtr symbol_table_;
+  Stats::StatNamePool pool_;
+  std::vector<Stats::StatName> stat_names_;
+  envoy::config::metrics::v2::StatsConfig stats_config_;
+};
+
 } // namespace Envoy
 
 // Tests the single-threaded performance of the thread-local-store stats caches
@@ -91,8 +168,28 @@ static void BM_StatsWithTls(benchmark::State& state) {
 }
 BENCHMARK(BM_StatsWithTls);
 
-// TODO(jmarantz): add multi-threaded variant of this test, that aggressively
-// looks up stats in multiple threads to try to trigger contention issues.
+// Tests the creation of new stats from state.range(0) threads at once, which all
+// miss their caches and fill the central caches of the same scopes. state.range(1)
+// selects the real symbol table, whose lock all the threads share, over the fake one.
+static void BM_StatsCreateMultiThreaded(benchmark::State& state) {
+  Envoy::ThreadLocalStoreCreationPerf context(state.range(0), state.range(1) != 0);
+  const int num_clusters = 1000;
+
+  for (auto _ : state) {
+    context.createStats(state, num_clusters);
+  }
+  state.SetItemsProcessed(state.iterations() * num_clusters * context.numStats());
+}
+BENCHMARK(BM_StatsCreateMultiThreaded)
+    ->Args({1, 0})
+    ->Args({4, 0})
+    ->Args({16, 0})
+    ->Args({64, 0})
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({16, 1})
+    ->Args({64, 1})
+    ->UseRealTime();
 
 // Boilerplate main(), which discovers benchmarks in the same file and runs them.
 int main(int argc, char** argv) {
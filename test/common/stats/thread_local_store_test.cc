@@ -20,6 +20,7 @@
 #include "test/test_common/logging.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -999,6 +1000,52 @@ TEST(ThreadLocalStoreThreadTest, ConstructDestruct) {
   store.shutdownThreading();
 }
 
+// Creates the same stats in two scopes from several threads at once. Every thread must get the
+// same stat objects, and the rejected names must resolve to the null stats.
+TEST(ThreadLocalStoreThreadTest, ConcurrentCreation) {
+  SymbolTablePtr symbol_table(SymbolTableCreator::makeSymbolTable());
+  AllocatorImpl alloc(*symbol_table);
+  ThreadLocalStoreImpl store(alloc);
+  envoy::config::metrics::v2::StatsConfig stats_config;
+  stats_config.mutable_stats_matcher()->mutable_exclusion_list()->add_patterns()->set_suffix(
+      ".rejected");
+  store.setStatsMatcher(std::make_unique<StatsMatcherImpl>(stats_config));
+  ScopePtr scope1 = store.createScope("scope1.");
+  ScopePtr scope2 = store.createScope("scope2.");
+
+  const uint32_t num_threads = 8;
+  const uint32_t num_stats = 100;
+  std::vector<std::vector<Counter*>> counters(num_threads);
+  std::vector<std::vector<Gauge*>> gauges(num_threads);
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t t = 0; t < num_threads; ++t) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&, t]() {
+      for (uint32_t i = 0; i < num_stats; ++i) {
+        Scope& scope = (i + t) % 2 == 0 ? *scope1 : *scope2;
+        counters[t].push_back(&scope.counter(absl::StrCat("c", i)));
+        gauges[t].push_back(&scope.gauge(absl::StrCat("g", i), Gauge::ImportMode::Accumulate));
+        scope.counter(absl::StrCat("c", i, ".rejected")).inc();
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  // Even threads create c0 in scope1, odd threads in scope2.
+  for (uint32_t t = 2; t < num_threads; ++t) {
+    EXPECT_EQ(counters[t % 2], counters[t]);
+    EXPECT_EQ(gauges[t % 2], gauges[t]);
+  }
+  EXPECT_EQ(2 * num_stats, store.counters().size());
+  EXPECT_EQ(2 * num_stats, store.gauges().size());
+  EXPECT_EQ("scope1.c0", counters[0][0]->name());
+  EXPECT_EQ("scope2.c0", counters[1][0]->name());
+  EXPECT_EQ(0, scope1->counter("c0.rejected").value());
+
+  store.shutdownThreading();
+}
+
 // Histogram tests
 TEST_F(HistogramTest, BasicSingleHistogramMerge) {
   Histogram& h1 = store_->histogram("h1", Stats::Histogram::Unit::Unspecified);
@@ -789,6 +789,118 @@ TEST_F(TcpConnPoolImplTest, ConcurrentConnections) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that a connection is prefetched for the next request and used by it.
+ */
+TEST_F(TcpConnPoolImplTest, Prefetch) {
+  cluster_->per_upstream_prefetch_ratio_ = 1.5;
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  InSequence s;
+
+  // The first request creates a connection for itself and prefetches a second one.
+  conn_pool_.test_conns_.reserve(2);
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Pending);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  c1.completeConnection();
+
+  // The second request finds the prefetched connection ready. The circuit breaker prevents any
+  // further prefetching.
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  ActiveTestConn c2(*this, 1, ActiveTestConn::Type::Immediate);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_used_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  c1.releaseConn();
+  c2.releaseConn();
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_wasted_.value());
+}
+
+/**
+ * Test that a prefetched connection closed without serving a request is counted as wasted.
+ */
+TEST_F(TcpConnPoolImplTest, PrefetchWasted) {
+  cluster_->per_upstream_prefetch_ratio_ = 1.5;
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  InSequence s;
+
+  conn_pool_.test_conns_.reserve(2);
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Pending);
+  c1.handle_->cancel(ConnectionPool::CancelPolicy::Default);
+
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_used_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_wasted_.value());
+}
+
+/**
+ * Test that the warm reserve is re-established while the pool is idle and serves the next burst.
+ */
+TEST_F(TcpConnPoolImplTest, PrefetchWarmReserveAfterIdle) {
+  cluster_->per_upstream_min_warm_connections_ = 2;
+  InSequence s;
+
+  // The first request creates a connection for itself and a second one for the reserve.
+  conn_pool_.test_conns_.reserve(4);
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Pending);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  c1.completeConnection();
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest());
+  c1.releaseConn();
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // While the pool is idle, the upstream closes both connections. The pool replaces them rather
+  // than waiting for the next requests.
+  conn_pool_.expectConnCreate();
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.expectConnCreate();
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+
+  // The burst after the idle period is served by the prefetched connections, without creating
+  // new ones.
+  EXPECT_CALL(*conn_pool_.test_conns_[0].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  ActiveTestConn c2(*this, 1, ActiveTestConn::Type::Immediate);
+  ActiveTestConn c3(*this, 0, ActiveTestConn::Type::Immediate);
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_total_.value());
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_used_.value());
+  EXPECT_EQ(4U, cluster_->stats_.upstream_cx_total_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  c2.releaseConn();
+  c3.releaseConn();
+
+  // Connections closed by Envoy itself are not replaced.
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(2);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::LocalClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::LocalClose);
+  dispatcher_.clearDeferredDeleteList();
+}
+
 /**
  * Tests ConnectionState lifecycle with multiple concurrent connections.
  */
@@ -1,3 +1,6 @@
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -9,9 +12,11 @@
 #include "envoy/config/filter/network/tcp_proxy/v2/tcp_proxy.pb.h"
 #include "envoy/config/filter/network/tcp_proxy/v2/tcp_proxy.pb.validate.h"
 
+#include "common/api/os_sys_calls_impl.h"
 #include "common/buffer/buffer_impl.h"
 #include "common/network/address_impl.h"
 #include "common/network/application_protocol.h"
+#include "common/network/io_socket_handle_impl.h"
 #include "common/network/transport_socket_options_impl.h"
 #include "common/network/upstream_server_name.h"
 #include "common/router/metadatamatchcriteria_impl.h"
@@ -691,6 +696,87 @@ TEST_F(TcpProxyTest, OutlierDetection) {
   raiseEventUpstreamConnected(2);
 }
 
+// Test that data is proxied through the connections if they cannot be spliced.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(SpliceNotPossible)) {
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_enable_splice(true);
+  setup(1, config);
+
+  EXPECT_CALL(filter_callbacks_.connection_, canBypassTransportSocket()).WillOnce(Return(false));
+  EXPECT_CALL(filter_callbacks_.connection_, bypassTransportSocket(_)).Times(0);
+  EXPECT_CALL(*upstream_connections_.at(0), bypassTransportSocket(_)).Times(0);
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(0, config_->stats().downstream_cx_splice_total_.value());
+
+  Buffer::OwnedImpl buffer("hello");
+  EXPECT_CALL(*upstream_connections_.at(0), write(BufferEqual(&buffer), false));
+  filter_->onData(buffer, false);
+}
+
+// Test that data is spliced between the sockets of the connections and accounted for.
+TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(Splice)) {
+  if (!Api::OsSysCallsSingleton::get().supportsSplice()) {
+    return;
+  }
+
+  envoy::config::filter::network::tcp_proxy::v2::TcpProxy config = defaultConfig();
+  config.set_enable_splice(true);
+  setup(1, config);
+
+  // The downstream client and the upstream server each hold the other end of a socket pair.
+  int downstream_fds[2];
+  int upstream_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, downstream_fds));
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, upstream_fds));
+  Network::IoSocketHandleImpl client(downstream_fds[0]);
+  Network::IoSocketHandleImpl downstream(downstream_fds[1]);
+  Network::IoSocketHandleImpl upstream(upstream_fds[0]);
+  Network::IoSocketHandleImpl server(upstream_fds[1]);
+
+  Network::BypassCallbacks* downstream_callbacks{};
+  Network::BypassCallbacks* upstream_callbacks{};
+  EXPECT_CALL(filter_callbacks_.connection_, canBypassTransportSocket()).WillOnce(Return(true));
+  EXPECT_CALL(*upstream_connections_.at(0), canBypassTransportSocket()).WillOnce(Return(true));
+  EXPECT_CALL(filter_callbacks_.connection_, bypassTransportSocket(_))
+      .WillOnce(Invoke([&](Network::BypassCallbacks& callbacks) -> Network::IoHandle& {
+        downstream_callbacks = &callbacks;
+        return downstream;
+      }));
+  EXPECT_CALL(*upstream_connections_.at(0), bypassTransportSocket(_))
+      .WillOnce(Invoke([&](Network::BypassCallbacks& callbacks) -> Network::IoHandle& {
+        upstream_callbacks = &callbacks;
+        return upstream;
+      }));
+  raiseEventUpstreamConnected(0);
+  EXPECT_EQ(1, config_->stats().downstream_cx_splice_total_.value());
+  ASSERT_NE(nullptr, downstream_callbacks);
+  ASSERT_NE(nullptr, upstream_callbacks);
+
+  char buf[16];
+  ASSERT_EQ(5, ::write(client.fd(), "hello", 5));
+  downstream_callbacks->onSocketEvent(Event::FileReadyType::Read);
+  EXPECT_EQ(5, ::read(server.fd(), buf, sizeof(buf)));
+  EXPECT_EQ(5, filter_->getStreamInfo().bytesReceived());
+  EXPECT_EQ(5, config_->stats().downstream_cx_rx_bytes_total_.value());
+
+  ASSERT_EQ(6, ::write(server.fd(), "world!", 6));
+  upstream_callbacks->onSocketEvent(Event::FileReadyType::Read | Event::FileReadyType::Write);
+  EXPECT_EQ(6, ::read(client.fd(), buf, sizeof(buf)));
+  EXPECT_EQ(6, filter_->getStreamInfo().bytesSent());
+  EXPECT_EQ(6, config_->stats().downstream_cx_tx_bytes_total_.value());
+
+  // Half-closes are forwarded; the connections are closed once both directions have ended.
+  ASSERT_EQ(0, ::shutdown(client.fd(), SHUT_WR));
+  downstream_callbacks->onSocketEvent(Event::FileReadyType::Read);
+  EXPECT_EQ(0, ::read(server.fd(), buf, sizeof(buf)));
+
+  ASSERT_EQ(0, ::shutdown(server.fd(), SHUT_WR));
+  EXPECT_CALL(filter_callbacks_.connection_, close(Network::ConnectionCloseType::NoFlush));
+  EXPECT_CALL(*upstream_connections_.at(0), close(Network::ConnectionCloseType::NoFlush));
+  upstream_callbacks->onSocketEvent(Event::FileReadyType::Read);
+  EXPECT_EQ(0, ::read(client.fd(), buf, sizeof(buf)));
+}
+
 TEST_F(TcpProxyTest, DEPRECATED_FEATURE_TEST(UpstreamDisconnectDownstreamFlowControl)) {
   setup(1);
 
@@ -201,10 +201,12 @@ public:
         local_cluster_update_(local_cluster_update), local_hosts_removed_(local_hosts_removed) {}
 
 protected:
-  void postThreadLocalClusterUpdate(const Cluster&, uint32_t priority,
-                                    const HostVector& hosts_added,
-                                    const HostVector& hosts_removed) override {
-    local_cluster_update_.post(priority, hosts_added, hosts_removed);
+  void postThreadLocalClusterUpdate(const Cluster&,
+                                    const HostSetDeltasByPriority& deltas) override {
+    for (const auto& delta : deltas) {
+      local_cluster_update_.post(delta.first, delta.second.hosts_added_,
+                                 delta.second.hosts_removed_);
+    }
   }
 
   void postThreadLocalDrainConnections(const Cluster&, const HostVector& hosts_removed) override {
@@ -652,7 +654,8 @@ static_resources:
   const std::string yaml = fmt::format(yamlPattern, cluster_type, policy_name);
 
   if (GetParam() == envoy::api::v2::Cluster_LbPolicy_ORIGINAL_DST_LB ||
-      GetParam() == envoy::api::v2::Cluster_LbPolicy_CLUSTER_PROVIDED) {
+      GetParam() == envoy::api::v2::Cluster_LbPolicy_CLUSTER_PROVIDED ||
+      GetParam() == envoy::api::v2::Cluster_LbPolicy_PEAK_EWMA) {
     EXPECT_THROW_WITH_MESSAGE(
         create(parseBootstrapFromV2Yaml(yaml)), EnvoyException,
         fmt::format("cluster: LB policy {} cannot be combined with lb_subset_config",
@@ -2760,6 +2763,123 @@ TEST_F(ClusterManagerImplTest, MergedUpdatesDestroyedOnUpdate) {
                    .value());
 }
 
+// Tests that updates of a cluster made within the same main thread event loop iteration are
+// posted to the workers once, and that hosts which were added and removed again in between are
+// not reported to them.
+TEST_F(ClusterManagerImplTest, CoalescedThreadLocalUpdates) {
+  createWithLocalClusterUpdate(false);
+
+  Cluster& cluster = cluster_manager_->activeClusters().begin()->second;
+  HostVectorSharedPtr hosts(
+      new HostVector(cluster.prioritySet().hostSetsPerPriority()[0]->hosts()));
+  HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+  const HostSharedPtr removed_host = (*hosts)[0];
+  const HostSharedPtr transient_host = makeTestHost(cluster.info(), "tcp://127.0.0.1:11003");
+  auto update = [&](const HostVector& hosts_added, const HostVector& hosts_removed) {
+    cluster.prioritySet().updateHosts(
+        0,
+        updateHostsParams(hosts, hosts_per_locality,
+                          std::make_shared<const HealthyHostVector>(*hosts), hosts_per_locality),
+        {}, hosts_added, hosts_removed, absl::nullopt);
+  };
+
+  Event::PostCb flush;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&flush));
+  EXPECT_CALL(local_hosts_removed_, post(_)).Times(0);
+  EXPECT_CALL(local_cluster_update_, post(_, _, _)).Times(0);
+  update({}, {removed_host});
+  update({transient_host}, {});
+  update({}, {transient_host});
+  update({}, {});
+  EXPECT_EQ(4, factory_.stats_.counter("cluster_manager.cluster_updated").value());
+  EXPECT_EQ(3, factory_.stats_.counter("cluster_manager.cluster_updated_coalesced").value());
+
+  // The connection pools of the removed hosts are drained after the workers removed the hosts.
+  {
+    InSequence s;
+    EXPECT_CALL(local_cluster_update_, post(_, _, _))
+        .WillOnce(Invoke([&](uint32_t priority, const HostVector& hosts_added,
+                             const HostVector& hosts_removed) -> void {
+          EXPECT_EQ(0, priority);
+          EXPECT_EQ(0, hosts_added.size());
+          EXPECT_EQ(HostVector{removed_host}, hosts_removed);
+        }));
+    EXPECT_CALL(local_hosts_removed_, post((HostVector{removed_host, transient_host})));
+  }
+  flush();
+
+  // Updates after the flush are posted separately.
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&flush));
+  update({}, {});
+  EXPECT_CALL(local_cluster_update_, post(0, HostVector{}, HostVector{}));
+  flush();
+  EXPECT_EQ(3, factory_.stats_.counter("cluster_manager.cluster_updated_coalesced").value());
+}
+
+// Tests that pending updates are dropped when their cluster is removed.
+TEST_F(ClusterManagerImplTest, CoalescedThreadLocalUpdatesDroppedOnRemoval) {
+  createWithLocalClusterUpdate(false);
+
+  const std::string yaml = R"EOF(
+  name: new_cluster
+  connect_timeout: 0.250s
+  type: STATIC
+  lb_policy: ROUND_ROBIN
+  load_assignment:
+    endpoints:
+      - lb_endpoints:
+        - endpoint:
+            address:
+              socket_address:
+                address: 127.0.0.1
+                port_value: 12001
+  common_lb_config:
+    update_merge_window: 0s
+  )EOF";
+  EXPECT_CALL(local_cluster_update_, post(0, _, HostVector{}));
+  EXPECT_TRUE(cluster_manager_->addOrUpdateCluster(parseClusterFromV2Yaml(yaml), "version1"));
+
+  Cluster& cluster = cluster_manager_->activeClusters().find("new_cluster")->second;
+  HostVectorSharedPtr hosts(
+      new HostVector(cluster.prioritySet().hostSetsPerPriority()[0]->hosts()));
+  HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+
+  Event::PostCb flush;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&flush));
+  cluster.prioritySet().updateHosts(
+      0,
+      updateHostsParams(hosts, hosts_per_locality,
+                        std::make_shared<const HealthyHostVector>(*hosts), hosts_per_locality),
+      {}, {}, {}, absl::nullopt);
+
+  EXPECT_TRUE(cluster_manager_->removeCluster("new_cluster"));
+  EXPECT_CALL(local_cluster_update_, post(_, _, _)).Times(0);
+  flush();
+}
+
+// Tests that a flush posted to the main dispatcher does nothing once the cluster manager is gone.
+TEST_F(ClusterManagerImplTest, CoalescedThreadLocalUpdatesDroppedOnShutdown) {
+  createWithLocalClusterUpdate(false);
+
+  Cluster& cluster = cluster_manager_->activeClusters().begin()->second;
+  HostVectorSharedPtr hosts(
+      new HostVector(cluster.prioritySet().hostSetsPerPriority()[0]->hosts()));
+  HostsPerLocalitySharedPtr hosts_per_locality = std::make_shared<HostsPerLocalityImpl>();
+
+  Event::PostCb flush;
+  EXPECT_CALL(factory_.dispatcher_, post(_)).WillOnce(SaveArg<0>(&flush));
+  cluster.prioritySet().updateHosts(
+      0,
+      updateHostsParams(hosts, hosts_per_locality,
+                        std::make_shared<const HealthyHostVector>(*hosts), hosts_per_locality),
+      {}, {}, {(*hosts)[0]}, absl::nullopt);
+
+  cluster_manager_.reset();
+  EXPECT_CALL(local_cluster_update_, post(_, _, _)).Times(0);
+  EXPECT_CALL(local_hosts_removed_, post(_)).Times(0);
+  flush();
+}
+
 TEST_F(ClusterManagerImplTest, UpstreamSocketOptionsPassedToConnPool) {
   createWithLocalClusterUpdate();
   NiceMock<MockLoadBalancerContext> context;
@@ -2829,6 +2949,77 @@ TEST_F(ClusterManagerImplTest, UpstreamSocketOptionsNullIsOkay) {
   EXPECT_NE(nullptr, cp);
 }
 
+TEST_F(ClusterManagerImplTest, SharedHttp2ConnPool) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      http2_protocol_options: {}
+      http2_connection_sharing:
+        owner_workers_per_host: 2
+      load_assignment:
+        endpoints:
+        - lb_endpoints:
+          - endpoint:
+              address:
+                socket_address:
+                  address: 127.0.0.1
+                  port_value: 11001
+  )EOF";
+  create(parseBootstrapFromV2Yaml(yaml));
+
+  // A single worker owns the connections to every host, so its HTTP/2 pool wraps a regular one.
+  Http::ConnectionPool::MockInstance* to_create = new Http::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _)).WillOnce(Return(to_create));
+  Http::ConnectionPool::Instance* cp = cluster_manager_->httpConnPoolForCluster(
+      "cluster_1", ResourcePriority::Default, Http::Protocol::Http2, nullptr);
+  EXPECT_NE(nullptr, dynamic_cast<Http::Http2::SharedConnPoolImpl*>(cp));
+  EXPECT_EQ(cp, cluster_manager_->httpConnPoolForCluster("cluster_1", ResourcePriority::Default,
+                                                         Http::Protocol::Http2, nullptr));
+
+  // HTTP/1.1 connections are never shared.
+  Http::ConnectionPool::MockInstance* http1_cp = new Http::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _)).WillOnce(Return(http1_cp));
+  EXPECT_EQ(http1_cp, cluster_manager_->httpConnPoolForCluster(
+                          "cluster_1", ResourcePriority::Default, Http::Protocol::Http11, nullptr));
+}
+
+// A worker whose owner has not started yet uses connections of its own instead of forwarding to it.
+TEST_F(ClusterManagerImplTest, SharedHttp2ConnPoolOwnerNotStarted) {
+  const std::string yaml = R"EOF(
+  static_resources:
+    clusters:
+    - name: cluster_1
+      connect_timeout: 0.250s
+      type: STATIC
+      lb_policy: ROUND_ROBIN
+      http2_protocol_options: {}
+      http2_connection_sharing:
+        owner_workers_per_host: 1
+      load_assignment:
+        endpoints:
+        - lb_endpoints:
+          - endpoint:
+              address:
+                socket_address:
+                  address: 127.0.0.1
+                  port_value: 11001
+  )EOF";
+  // This is the only worker of two which has started, so it either owns the host or its owner has
+  // no cluster manager yet.
+  ON_CALL(factory_.tls_, workerCount()).WillByDefault(Return(2));
+  create(parseBootstrapFromV2Yaml(yaml));
+
+  Http::ConnectionPool::MockInstance* to_create = new Http::ConnectionPool::MockInstance();
+  EXPECT_CALL(factory_, allocateConnPool_(_, _, _)).WillOnce(Return(to_create));
+  Http::ConnectionPool::Instance* cp = cluster_manager_->httpConnPoolForCluster(
+      "cluster_1", ResourcePriority::Default, Http::Protocol::Http2, nullptr);
+  EXPECT_NE(nullptr, dynamic_cast<Http::Http2::SharedConnPoolImpl*>(cp));
+}
+
 class TestUpstreamNetworkFilter : public Network::WriteFilter {
 public:
   Network::FilterStatus onWrite(Buffer::Instance&, bool) override {
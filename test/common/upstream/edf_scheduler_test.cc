@@ -71,6 +71,48 @@ TEST(EdfSchedulerTest, Expired) {
   EXPECT_EQ(nullptr, sched.pick());
 }
 
+// Validate that removed entries are no longer picked and the others keep their deadlines.
+TEST(EdfSchedulerTest, RemoveIf) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 8;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  // Pick the first half, so that it is scheduled after the second half.
+  for (uint32_t i = 0; i < num_entries / 2; ++i) {
+    auto p = sched.pick();
+    EXPECT_EQ(i, *p);
+    sched.add(1, p);
+  }
+
+  // Remove the odd entries, the remaining ones are picked in the same order as before.
+  sched.removeIf([](const uint32_t& entry) { return entry % 2 == 1; });
+  for (uint32_t i : {4, 6, 0, 2, 4, 6}) {
+    auto p = sched.pick();
+    EXPECT_EQ(i, *p);
+    sched.add(1, p);
+  }
+
+  sched.removeIf([](const uint32_t&) { return true; });
+  EXPECT_TRUE(sched.empty());
+  EXPECT_EQ(nullptr, sched.pick());
+}
+
+// Validate that removeIf() discards expired entries.
+TEST(EdfSchedulerTest, RemoveIfExpired) {
+  EdfScheduler<uint32_t> sched;
+  {
+    auto entry = std::make_shared<uint32_t>(37);
+    sched.add(1, entry);
+  }
+  EXPECT_FALSE(sched.empty());
+  sched.removeIf([](const uint32_t&) { return false; });
+  EXPECT_TRUE(sched.empty());
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
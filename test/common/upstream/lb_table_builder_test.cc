@@ -0,0 +1,85 @@
+#include <atomic>
+#include <vector>
+
+#include "common/upstream/lb_table_builder.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class LbTableBuilderTest : public testing::Test {
+protected:
+  LbTableBuilderTest() : builder_(Thread::threadFactoryForTest()) {}
+
+  // Occupies the builder thread until release_ is notified.
+  void block() {
+    builder_.post(&blocker_, [this]() -> void {
+      blocked_.Notify();
+      release_.WaitForNotification();
+    });
+    blocked_.WaitForNotification();
+  }
+
+  int blocker_{};
+  absl::Notification blocked_;
+  absl::Notification release_;
+  LbTableBuilder builder_;
+};
+
+TEST_F(LbTableBuilderTest, Build) {
+  int owner;
+  std::atomic<uint32_t> builds{};
+  builder_.post(&owner, [&builds]() -> void { builds++; });
+  builder_.waitForIdle();
+  EXPECT_EQ(1, builds);
+
+  builder_.post(&owner, [&builds]() -> void { builds++; });
+  builder_.waitForIdle();
+  EXPECT_EQ(2, builds);
+}
+
+// Builds of an owner which are posted while one is pending are collapsed into the last one.
+TEST_F(LbTableBuilderTest, Coalesce) {
+  int owner1;
+  int owner2;
+  std::vector<int> builds;
+  block();
+  builder_.post(&owner1, [&builds]() -> void { builds.push_back(1); });
+  builder_.post(&owner2, [&builds]() -> void { builds.push_back(2); });
+  builder_.post(&owner1, [&builds]() -> void { builds.push_back(3); });
+  release_.Notify();
+  builder_.waitForIdle();
+  EXPECT_EQ((std::vector<int>{3, 2}), builds);
+}
+
+TEST_F(LbTableBuilderTest, Cancel) {
+  int owner1;
+  int owner2;
+  std::vector<int> builds;
+  block();
+  builder_.post(&owner1, [&builds]() -> void { builds.push_back(1); });
+  builder_.post(&owner2, [&builds]() -> void { builds.push_back(2); });
+  builder_.cancel(&owner1);
+  release_.Notify();
+  // Waits for the running build.
+  builder_.cancel(&blocker_);
+  builder_.waitForIdle();
+  EXPECT_EQ((std::vector<int>{2}), builds);
+}
+
+// The thread is only started once there is something to build.
+TEST(LbTableBuilderIdleTest, NoBuilds) {
+  LbTableBuilder builder(Thread::threadFactoryForTest());
+  builder.waitForIdle();
+  int owner;
+  builder.cancel(&owner);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -1,15 +1,22 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
+#include "common/config/metadata.h"
+#include "common/config/well_known_names.h"
+#include "common/event/real_time_system.h"
 #include "common/memory/stats.h"
 #include "common/runtime/runtime_impl.h"
 #include "common/upstream/maglev_lb.h"
 #include "common/upstream/ring_hash_lb.h"
+#include "common/upstream/subset_lb.h"
 #include "common/upstream/upstream_impl.h"
 
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "benchmark/benchmark.h"
 
@@ -20,7 +27,10 @@ namespace {
 class BaseTester {
 public:
   // We weight the first weighted_subset_percent of hosts with weight.
-  BaseTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0) {
+  BaseTester(uint64_t num_hosts, uint32_t weighted_subset_percent = 0, uint32_t weight = 0,
+             LoadBalancerType lb_type = LoadBalancerType::RoundRobin) {
+    // Hosts only track their response times for the load balancers which use them.
+    info_->lb_type_ = lb_type;
     HostVector hosts;
     ASSERT(num_hosts < 65536);
     for (uint64_t i = 0; i < num_hosts; i++) {
@@ -103,6 +113,123 @@ BENCHMARK(BM_RoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(benchmark::kMillisecond);
 
+void BM_RoundRobinLoadBalancerRefresh(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t churn_percent = state.range(1);
+  const uint64_t num_changed = num_hosts * churn_percent / 100;
+  // Half of the hosts are weighted, so that EDF scheduling is used.
+  RoundRobinTester tester(num_hosts, 50, 50);
+  tester.initialize();
+
+  HostVector hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  uint64_t next_host = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    // Replace a slice of the hosts with new ones, moving through the host set over iterations.
+    HostVector hosts_added;
+    HostVector hosts_removed;
+    for (uint64_t i = 0; i < num_changed; i++, next_host++) {
+      const uint64_t index = next_host % num_hosts;
+      hosts_removed.push_back(hosts[index]);
+      hosts[index] = makeTestHost(tester.info_,
+                                  fmt::format("tcp://10.{}.{}.{}:6379", 1 + next_host / 65536,
+                                              next_host / 256 % 256, next_host % 256),
+                                  index % 2 == 0 ? 50 : 1);
+      hosts_added.push_back(hosts[index]);
+    }
+    HostVectorConstSharedPtr updated_hosts = std::make_shared<HostVector>(hosts);
+    HostsPerLocalityConstSharedPtr hosts_per_locality = makeHostsPerLocality({hosts});
+    auto update_params = HostSetImpl::partitionHosts(updated_hosts, hosts_per_locality);
+    state.ResumeTiming();
+
+    // Time the update of the load balancer, which runs as a priority update callback.
+    tester.priority_set_.updateHosts(0, std::move(update_params), {}, hosts_added, hosts_removed,
+                                     absl::nullopt);
+  }
+}
+BENCHMARK(BM_RoundRobinLoadBalancerRefresh)
+    ->Args({500, 0})
+    ->Args({500, 1})
+    ->Args({500, 10})
+    ->Args({500, 100})
+    ->Args({5000, 0})
+    ->Args({5000, 1})
+    ->Args({5000, 10})
+    ->Args({5000, 100})
+    ->Args({50000, 0})
+    ->Args({50000, 1})
+    ->Args({50000, 10})
+    ->Args({50000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+// Picking hosts while some of them have been ejected, but the host set has not been updated yet.
+// state.range(0) is the number of hosts and state.range(1) the percentage of ejected hosts.
+void BM_RoundRobinLoadBalancerChooseHostEjected(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t ejected_percent = state.range(1);
+  RoundRobinTester tester(num_hosts);
+  tester.initialize();
+
+  const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  for (uint64_t i = 0; i < num_hosts * ejected_percent / 100; i++) {
+    hosts[i * 100 / ejected_percent]->healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["skipped_per_pick"] = benchmark::Counter(
+      tester.stats_.lb_unhealthy_host_skipped_.value(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_RoundRobinLoadBalancerChooseHostEjected)
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({100, 10})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Args({10000, 10});
+
+// Latency until an ejection, and the unejection which follows it, take effect on a worker. This
+// thread flips the outlier detection flag of the first of two hosts, while a worker thread keeps
+// picking hosts without any host set update. The ejection has taken effect once the worker picks
+// the second host twice in a row, the unejection once it picks the first host again. Before the
+// workers read the health flags, they had to wait for the host set update of
+// BM_RoundRobinLoadBalancerRefresh to be posted to them instead.
+void BM_EjectionPropagation(benchmark::State& state) {
+  RoundRobinTester tester(2);
+  tester.initialize();
+  const HostSharedPtr host = tester.priority_set_.hostSetsPerPriority()[0]->hosts()[0];
+
+  std::atomic<bool> ejection_seen{false};
+  std::atomic<bool> exit{false};
+  Thread::ThreadPtr worker = Thread::threadFactoryForTest().createThread([&]() -> void {
+    HostConstSharedPtr last_pick;
+    while (!exit.load(std::memory_order_relaxed)) {
+      HostConstSharedPtr pick = tester.lb_->chooseHost(nullptr);
+      if (pick == host) {
+        ejection_seen.store(false, std::memory_order_release);
+      } else if (pick == last_pick) {
+        ejection_seen.store(true, std::memory_order_release);
+      }
+      last_pick = std::move(pick);
+    }
+  });
+
+  for (auto _ : state) {
+    host->healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+    while (!ejection_seen.load(std::memory_order_acquire)) {
+    }
+    host->healthFlagClear(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+    while (ejection_seen.load(std::memory_order_acquire)) {
+    }
+  }
+
+  exit = true;
+  worker->join();
+}
+BENCHMARK(BM_EjectionPropagation)->UseRealTime();
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
@@ -284,6 +411,84 @@ BENCHMARK(BM_MaglevLoadBalancerChooseHost)
     ->Args({500, 100000})
     ->Unit(benchmark::kMillisecond);
 
+// Number of distinct keys looked up by the lookup benchmarks, which are pre-hashed so that only the
+// table lookup itself is timed.
+constexpr uint64_t LookupKeys = 4096;
+
+std::vector<TestLoadBalancerContext> lookupContexts() {
+  std::vector<TestLoadBalancerContext> contexts(LookupKeys);
+  for (uint64_t i = 0; i < LookupKeys; i++) {
+    contexts[i].hash_key_ = hashInt(i);
+  }
+  return contexts;
+}
+
+void BM_RingHashLoadBalancerLookup(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t min_ring_size = state.range(1);
+  RingHashTester tester(num_hosts, min_ring_size);
+  tester.ring_hash_lb_->initialize();
+  LoadBalancerPtr lb = tester.ring_hash_lb_->factory()->create();
+  std::vector<TestLoadBalancerContext> contexts = lookupContexts();
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lb->chooseHost(&contexts[i++ % LookupKeys]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RingHashLoadBalancerLookup)
+    ->Args({100, 65536})
+    ->Args({500, 65536})
+    ->Args({100, 1048576})
+    ->Args({500, 1048576})
+    ->Args({10000, 1048576});
+
+void BM_MaglevLoadBalancerLookup(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  MaglevTester tester(num_hosts);
+  tester.maglev_lb_->initialize();
+  LoadBalancerPtr lb = tester.maglev_lb_->factory()->create();
+  std::vector<TestLoadBalancerContext> contexts = lookupContexts();
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lb->chooseHost(&contexts[i++ % LookupKeys]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MaglevLoadBalancerLookup)->Arg(100)->Arg(500)->Arg(10000);
+
+class PeakEwmaTester : public BaseTester {
+public:
+  PeakEwmaTester(uint64_t num_hosts) : BaseTester(num_hosts, 0, 0, LoadBalancerType::PeakEwma) {
+    // Give every host a response time estimate and some active requests, so that every pick
+    // compares two real costs.
+    for (const auto& host : priority_set_.hostSetsPerPriority()[0]->hosts()) {
+      host->responseTimeEstimator().putResponseTime(
+          std::chrono::microseconds(100 + random_.random() % 10000), time_system_.monotonicTime());
+      host->stats().rq_active_.set(random_.random() % 100);
+    }
+    lb_ = std::make_unique<PeakEwmaLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                 runtime_, random_, common_config_, time_system_);
+  }
+
+  Event::RealTimeSystem time_system_;
+  std::unique_ptr<PeakEwmaLoadBalancer> lb_;
+};
+
+// Picking a host takes constant time regardless of the number of hosts.
+void BM_PeakEwmaLoadBalancerChooseHost(benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  PeakEwmaTester tester(num_hosts);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.lb_->chooseHost(nullptr));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PeakEwmaLoadBalancerChooseHost)->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+
 void BM_RingHashLoadBalancerHostLoss(benchmark::State& state) {
   for (auto _ : state) {
     const uint64_t num_hosts = state.range(0);
@@ -434,6 +639,146 @@ BENCHMARK(BM_MaglevLoadBalancerWeighted)
     ->Args({500, 95, 75, 25, 10000})
     ->Unit(benchmark::kMillisecond);
 
+class SubsetMatchCriterion : public Router::MetadataMatchCriterion {
+public:
+  SubsetMatchCriterion(const std::string& name, const HashedValue& value)
+      : name_(name), value_(value) {}
+
+  // Router::MetadataMatchCriterion
+  const std::string& name() const override { return name_; }
+  const HashedValue& value() const override { return value_; }
+
+private:
+  const std::string name_;
+  const HashedValue value_;
+};
+
+class SubsetMatchCriteria : public Router::MetadataMatchCriteria {
+public:
+  SubsetMatchCriteria(const std::string& name, const ProtobufWkt::Value& value)
+      : matches_({std::make_shared<const SubsetMatchCriterion>(name, HashedValue(value))}) {}
+
+  // Router::MetadataMatchCriteria
+  const std::vector<Router::MetadataMatchCriterionConstSharedPtr>&
+  metadataMatchCriteria() const override {
+    return matches_;
+  }
+  Router::MetadataMatchCriteriaConstPtr
+  mergeMatchCriteria(const ProtobufWkt::Struct&) const override {
+    return nullptr;
+  }
+
+private:
+  const std::vector<Router::MetadataMatchCriterionConstSharedPtr> matches_;
+};
+
+class SubsetLoadBalancerContext : public LoadBalancerContextBase {
+public:
+  SubsetLoadBalancerContext(const std::string& name, const ProtobufWkt::Value& value)
+      : criteria_(name, value) {}
+
+  // Upstream::LoadBalancerContext
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return &criteria_; }
+
+private:
+  SubsetMatchCriteria criteria_;
+};
+
+// Spreads num_hosts hosts evenly over num_subsets values of the "version" subset key.
+class SubsetTester {
+public:
+  SubsetTester(uint64_t num_hosts, uint64_t num_subsets) {
+    envoy::api::v2::Cluster::LbSubsetConfig subset_config;
+    subset_config.add_subset_selectors()->add_keys("version");
+    subset_info_ = std::make_unique<LoadBalancerSubsetInfoImpl>(subset_config);
+
+    for (uint64_t i = 0; i < num_subsets; i++) {
+      versions_.emplace_back();
+      versions_.back().set_string_value(fmt::format("v{}", i));
+    }
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      envoy::api::v2::core::Metadata metadata;
+      Config::Metadata::mutableMetadataValue(metadata, Config::MetadataFilters::get().ENVOY_LB,
+                                             "version") = versions_[i % num_subsets];
+      hosts_.push_back(makeTestHost(
+          info_, fmt::format("tcp://10.{}.{}.{}:6379", i / 65536, i / 256 % 256, i % 256),
+          metadata));
+    }
+    updateHosts(hosts_, {});
+  }
+
+  void updateHosts(const HostVector& hosts_added, const HostVector& hosts_removed) {
+    HostVectorConstSharedPtr hosts = std::make_shared<HostVector>(hosts_);
+    priority_set_.updateHosts(
+        0, HostSetImpl::partitionHosts(hosts, makeHostsPerLocality({hosts_})), {}, hosts_added,
+        hosts_removed, absl::nullopt);
+  }
+
+  std::unique_ptr<SubsetLoadBalancer> createLb() {
+    return std::make_unique<SubsetLoadBalancer>(
+        LoadBalancerType::Random, priority_set_, nullptr, stats_, stats_store_, runtime_, random_,
+        *subset_info_, absl::nullopt, absl::nullopt, common_config_);
+  }
+
+  PrioritySetImpl priority_set_;
+  Stats::IsolatedStoreImpl stats_store_;
+  ClusterStats stats_{ClusterInfoImpl::generateStats(stats_store_)};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Runtime::RandomGeneratorImpl random_;
+  envoy::api::v2::Cluster::CommonLbConfig common_config_;
+  std::shared_ptr<MockClusterInfo> info_{new NiceMock<MockClusterInfo>()};
+  std::unique_ptr<LoadBalancerSubsetInfoImpl> subset_info_;
+  std::vector<ProtobufWkt::Value> versions_;
+  HostVector hosts_;
+};
+
+void BM_SubsetLoadBalancerBuild(benchmark::State& state) {
+  SubsetTester tester(state.range(0), state.range(1));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tester.createLb());
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerBuild)
+    ->Args({1000, 10})
+    ->Args({1000, 200})
+    ->Args({10000, 200})
+    ->Unit(benchmark::kMillisecond);
+
+// Removes and re-adds a host, which updates its subset and refreshes the health of the others.
+void BM_SubsetLoadBalancerHostUpdate(benchmark::State& state) {
+  SubsetTester tester(state.range(0), state.range(1));
+  std::unique_ptr<SubsetLoadBalancer> lb = tester.createLb();
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    const HostVector changed{tester.hosts_[i++ % tester.hosts_.size()]};
+    tester.updateHosts({}, changed);
+    tester.updateHosts(changed, {});
+  }
+}
+BENCHMARK(BM_SubsetLoadBalancerHostUpdate)
+    ->Args({1000, 10})
+    ->Args({1000, 200})
+    ->Args({10000, 200})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SubsetLoadBalancerChooseHost(benchmark::State& state) {
+  SubsetTester tester(state.range(0), state.range(1));
+  std::unique_ptr<SubsetLoadBalancer> lb = tester.createLb();
+  std::vector<SubsetLoadBalancerContext> contexts;
+  for (const auto& version : tester.versions_) {
+    contexts.emplace_back("version", version);
+  }
+
+  uint64_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lb->chooseHost(&contexts[i++ % contexts.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SubsetLoadBalancerChooseHost)->Args({1000, 10})->Args({1000, 200})->Args({10000, 200});
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -0,0 +1,94 @@
+// Usage: bazel run //test/common/upstream:outlier_detection_benchmark
+
+#include <memory>
+
+#include "common/common/fmt.h"
+#include "common/upstream/outlier_detection_impl.h"
+#include "common/upstream/upstream_impl.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Upstream {
+namespace Outlier {
+namespace {
+
+class DetectorTester {
+public:
+  DetectorTester(uint64_t num_hosts, bool split_external_local_origin_errors) {
+    HostVector& hosts = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+    for (uint64_t i = 0; i < num_hosts; i++) {
+      hosts.push_back(makeTestHost(cluster_.info_, fmt::format("tcp://10.{}.{}.{}:6379", i >> 16,
+                                                               (i >> 8) & 0xff, i & 0xff)));
+    }
+    config_.set_split_external_local_origin_errors(split_external_local_origin_errors);
+    detector_ =
+        DetectorImpl::create(cluster_, config_, dispatcher_, runtime_, time_system_, nullptr);
+  }
+
+  // Reports the default success rate request volume for every host. Every 100th host only succeeds
+  // for half of its requests, which makes it an outlier.
+  void loadRequests() {
+    const HostVector& hosts = cluster_.prioritySet().getMockHostSet(0)->hosts_;
+    for (uint64_t i = 0; i < hosts.size(); i++) {
+      for (uint64_t rq = 0; rq < 100; rq++) {
+        hosts[i]->outlierDetector().putHttpResponseCode(i % 100 == 0 && rq % 2 == 0 ? 503 : 200);
+      }
+    }
+  }
+
+  NiceMock<MockClusterMockPrioritySet> cluster_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+  // The runtime does not enable enforcing, so the outliers are detected on every interval.
+  NiceMock<Runtime::MockLoader> runtime_;
+  Event::MockTimer* interval_timer_ = new Event::MockTimer(&dispatcher_);
+  Event::SimulatedTimeSystem time_system_;
+  envoy::api::v2::cluster::OutlierDetection config_;
+  std::shared_ptr<DetectorImpl> detector_;
+};
+
+// Main thread cost of an outlier detection interval. state.range(0) is the number of hosts and
+// state.range(1) whether external and local origin errors are split.
+void BM_OutlierDetectionInterval(benchmark::State& state) {
+  DetectorTester tester(state.range(0), state.range(1));
+  for (auto _ : state) {
+    state.PauseTiming();
+    tester.loadRequests();
+    state.ResumeTiming();
+
+    tester.interval_timer_->invokeCallback();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OutlierDetectionInterval)
+    ->Args({10000, false})
+    ->Args({10000, true})
+    ->Args({50000, false})
+    ->Args({50000, true})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Outlier
+} // namespace Upstream
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_context(spdlog::level::warn,
+                                         Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
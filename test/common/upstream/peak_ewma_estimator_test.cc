@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cmath>
+
+#include "common/upstream/peak_ewma_estimator.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class PeakEwmaEstimatorTest : public testing::Test {
+protected:
+  MonotonicTime at(std::chrono::milliseconds time) { return MonotonicTime(start_ + time); }
+
+  const std::chrono::seconds start_{1000};
+  PeakEwmaEstimator estimator_{std::chrono::seconds(1)};
+};
+
+TEST_F(PeakEwmaEstimatorTest, NoResponses) {
+  EXPECT_EQ(0, estimator_.estimate(at(std::chrono::milliseconds(0))));
+}
+
+// The first response and every response above the estimate replace it.
+TEST_F(PeakEwmaEstimatorTest, Peak) {
+  estimator_.putResponseTime(std::chrono::microseconds(100), at(std::chrono::milliseconds(0)));
+  EXPECT_DOUBLE_EQ(100, estimator_.estimate(at(std::chrono::milliseconds(0))));
+
+  estimator_.putResponseTime(std::chrono::microseconds(5000), at(std::chrono::milliseconds(1)));
+  EXPECT_DOUBLE_EQ(5000, estimator_.estimate(at(std::chrono::milliseconds(1))));
+}
+
+// Faster responses move the estimate down by the weight of the time since the last update.
+TEST_F(PeakEwmaEstimatorTest, Decay) {
+  estimator_.putResponseTime(std::chrono::microseconds(1000), at(std::chrono::milliseconds(0)));
+  estimator_.putResponseTime(std::chrono::microseconds(0), at(std::chrono::milliseconds(1000)));
+  EXPECT_NEAR(1000 * std::exp(-1.0), estimator_.estimate(at(std::chrono::milliseconds(1000))),
+              1e-6);
+
+  // Responses received at the same time as the last update do not move the estimate down.
+  estimator_.putResponseTime(std::chrono::microseconds(0), at(std::chrono::milliseconds(1000)));
+  EXPECT_NEAR(1000 * std::exp(-1.0), estimator_.estimate(at(std::chrono::milliseconds(1000))),
+              1e-6);
+}
+
+// Without responses the estimate decays towards zero.
+TEST_F(PeakEwmaEstimatorTest, DecayWithoutResponses) {
+  estimator_.putResponseTime(std::chrono::microseconds(1000), at(std::chrono::milliseconds(0)));
+  EXPECT_NEAR(1000 * std::exp(-2.0), estimator_.estimate(at(std::chrono::milliseconds(2000))),
+              1e-6);
+  // Reading the estimate does not change it.
+  EXPECT_DOUBLE_EQ(1000, estimator_.estimate(at(std::chrono::milliseconds(0))));
+}
+
+TEST(ResponseTimeEstimatorNullImplTest, Ignored) {
+  ResponseTimeEstimatorNullImpl estimator;
+  estimator.putResponseTime(std::chrono::microseconds(1000), MonotonicTime());
+  EXPECT_EQ(0, estimator.estimate(MonotonicTime()));
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -13,7 +13,9 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/upstream/mocks.h"
+#include "test/test_common/thread_factory_for_test.h"
 
+#include "absl/synchronization/notification.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -58,6 +60,7 @@ public:
   envoy::api::v2::Cluster::CommonLbConfig common_config_;
   NiceMock<Runtime::MockLoader> runtime_;
   NiceMock<Runtime::MockRandomGenerator> random_;
+  LbTableBuilder table_builder_{Thread::threadFactoryForTest()};
   std::unique_ptr<RingHashLoadBalancer> lb_;
 };
 
@@ -197,6 +200,88 @@ TEST_P(RingHashFailoverTest, BasicFailover) {
   EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
 }
 
+// Updates after the initial one are built on the table builder. Existing worker local load
+// balancers pick up the new tables once they are published.
+TEST_P(RingHashFailoverTest, TableBuilder) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
+                                               random_, config_, common_config_);
+  lb_->setTableBuilder(table_builder_);
+  lb_->initialize();
+  LoadBalancerPtr lb = lb_->factory()->create();
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(nullptr));
+
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:81")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  table_builder_.waitForIdle();
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(nullptr));
+  EXPECT_EQ(host_set_.hosts_[0], lb_->factory()->create()->chooseHost(nullptr));
+
+  // Builds which are still pending when the load balancer is destroyed are dropped.
+  host_set_.healthy_hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  lb_.reset();
+}
+
+// Hosts removed by an update are not chosen while its build is pending, as their connection pools
+// are drained right away. Their keys move to the same remaining host every time.
+TEST_P(RingHashFailoverTest, TableBuilderExcludesRemovedHosts) {
+  host_set_.hosts_ = {
+      makeTestHost(info_, "tcp://127.0.0.1:80"), makeTestHost(info_, "tcp://127.0.0.1:81"),
+      makeTestHost(info_, "tcp://127.0.0.1:82"), makeTestHost(info_, "tcp://127.0.0.1:83")};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  lb_ = std::make_unique<RingHashLoadBalancer>(priority_set_, stats_, stats_store_, runtime_,
+                                               random_, config_, common_config_);
+  lb_->setTableBuilder(table_builder_);
+  lb_->initialize();
+  // Worker local load balancers follow the published tables and are not re-created.
+  EXPECT_FALSE(lb_->factory()->recreateOnHostChange());
+  LoadBalancerPtr lb = lb_->factory()->create();
+
+  // Keep the builder busy with another build, so that the builds of the updates stay pending.
+  const int other_owner{};
+  absl::Notification release_builder;
+  table_builder_.post(&other_owner,
+                      [&release_builder]() { release_builder.WaitForNotification(); });
+
+  const HostSharedPtr removed_host = host_set_.hosts_[0];
+  host_set_.hosts_.erase(host_set_.hosts_.begin());
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {removed_host});
+  for (uint64_t i = 0; i < 1000; ++i) {
+    TestLoadBalancerContext context(i * 0x9e3779b97f4a7c15);
+    const HostConstSharedPtr host = lb->chooseHost(&context);
+    ASSERT_NE(nullptr, host);
+    EXPECT_NE(removed_host, host);
+    EXPECT_EQ(host, lb->chooseHost(&context));
+  }
+
+  release_builder.Notify();
+  table_builder_.waitForIdle();
+  for (uint64_t i = 0; i < 1000; ++i) {
+    TestLoadBalancerContext context(i * 0x9e3779b97f4a7c15);
+    EXPECT_NE(removed_host, lb->chooseHost(&context));
+  }
+
+  // Once most of the hosts are removed, the tables are built right away.
+  absl::Notification release_builder_again;
+  table_builder_.post(&other_owner, [&release_builder_again]() {
+    release_builder_again.WaitForNotification();
+  });
+  const HostVector removed_hosts(host_set_.hosts_.begin(), host_set_.hosts_.begin() + 2);
+  host_set_.hosts_.erase(host_set_.hosts_.begin(), host_set_.hosts_.begin() + 2);
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, removed_hosts);
+  for (uint64_t i = 0; i < 1000; ++i) {
+    TestLoadBalancerContext context(i * 0x9e3779b97f4a7c15);
+    EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&context));
+  }
+  release_builder_again.Notify();
+  table_builder_.waitForIdle();
+}
+
 // Expect reasonable results with Murmur2 hash.
 TEST_P(RingHashLoadBalancerTest, BasicWithMurmur2) {
   hostSet().hosts_ = {
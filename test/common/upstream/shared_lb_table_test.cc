@@ -0,0 +1,53 @@
+#include <memory>
+#include <string>
+
+#include "common/upstream/shared_lb_table.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+using SharedStringTable = SharedLbTable<std::string>;
+
+TEST(SharedLbTableTest, Empty) {
+  SharedStringTable shared_table;
+  EXPECT_EQ(0, shared_table.version());
+  EXPECT_EQ(nullptr, shared_table.get());
+
+  SharedStringTable::Reader reader(shared_table);
+  EXPECT_EQ(nullptr, reader.get());
+}
+
+TEST(SharedLbTableTest, Publish) {
+  SharedStringTable shared_table;
+  shared_table.publish(std::make_shared<const std::string>("a"));
+  EXPECT_EQ(1, shared_table.version());
+  EXPECT_EQ("a", *shared_table.get());
+
+  shared_table.publish(std::make_shared<const std::string>("b"));
+  EXPECT_EQ(2, shared_table.version());
+  EXPECT_EQ("b", *shared_table.get());
+}
+
+// Readers pick up new tables and keep the one they use alive.
+TEST(SharedLbTableTest, Reader) {
+  SharedStringTable shared_table;
+  SharedStringTable::Reader reader(shared_table);
+  shared_table.publish(std::make_shared<const std::string>("a"));
+  const std::string* table = reader.get();
+  ASSERT_NE(nullptr, table);
+  EXPECT_EQ("a", *table);
+  EXPECT_EQ(table, reader.get());
+
+  std::weak_ptr<const std::string> old_table = shared_table.get();
+  shared_table.publish(std::make_shared<const std::string>("b"));
+  EXPECT_FALSE(old_table.expired());
+  EXPECT_EQ("b", *reader.get());
+  EXPECT_TRUE(old_table.expired());
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -1048,6 +1048,37 @@ TEST_P(SubsetLoadBalancerTest, UpdateRemovingUnknownHost) {
   EXPECT_EQ(host_set_.hosts_[0], lb_->chooseHost(&context));
 }
 
+// Hosts stay in all the subsets they belong to when subsets are created for new hosts.
+TEST_P(SubsetLoadBalancerTest, UpdateAddingSubsetsKeepsExistingHosts) {
+  EXPECT_CALL(subset_info_, fallbackPolicy())
+      .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
+
+  std::vector<SubsetSelectorPtr> subset_selectors = {
+      std::make_shared<SubsetSelector>(
+          SubsetSelector{{"stage", "version"},
+                         envoy::api::v2::Cluster::LbSubsetConfig::LbSubsetSelector::NOT_DEFINED}),
+      std::make_shared<SubsetSelector>(SubsetSelector{
+          {"version"}, envoy::api::v2::Cluster::LbSubsetConfig::LbSubsetSelector::NOT_DEFINED})};
+
+  EXPECT_CALL(subset_info_, subsetSelectors()).WillRepeatedly(ReturnRef(subset_selectors));
+
+  init({{"tcp://127.0.0.1:80", {{"stage", "prod"}, {"version", "1.0"}}}});
+  HostSharedPtr host_v10 = host_set_.hosts_[0];
+
+  modifyHosts({makeHost("tcp://127.0.0.1:81", {{"stage", "prod"}, {"version", "1.1"}})}, {});
+  HostSharedPtr host_v11 = host_set_.hosts_[1];
+  EXPECT_EQ(4U, stats_.lb_subsets_active_.value());
+
+  TestLoadBalancerContext context_prod_10({{"stage", "prod"}, {"version", "1.0"}});
+  TestLoadBalancerContext context_10({{"version", "1.0"}});
+  TestLoadBalancerContext context_prod_11({{"stage", "prod"}, {"version", "1.1"}});
+  TestLoadBalancerContext context_11({{"version", "1.1"}});
+  EXPECT_EQ(host_v10, lb_->chooseHost(&context_prod_10));
+  EXPECT_EQ(host_v10, lb_->chooseHost(&context_10));
+  EXPECT_EQ(host_v11, lb_->chooseHost(&context_prod_11));
+  EXPECT_EQ(host_v11, lb_->chooseHost(&context_11));
+}
+
 TEST_F(SubsetLoadBalancerTest, UpdateModifyingOnlyHostHealth) {
   EXPECT_CALL(subset_info_, fallbackPolicy())
       .WillRepeatedly(Return(envoy::api::v2::Cluster::LbSubsetConfig::NO_FALLBACK));
@@ -17,6 +17,10 @@ public:
   static quic::QuicConfig& quicConfig(ActiveQuicListenerFactory& factory) {
     return factory.quic_config_;
   }
+
+  static Network::UdpListenerBatchConfig& batchConfig(ActiveQuicListenerFactory& factory) {
+    return factory.batch_config_;
+  }
 };
 
 TEST(ActiveQuicListenerConfigTest, CreateActiveQuicListenerFactory) {
@@ -42,6 +46,29 @@ TEST(ActiveQuicListenerConfigTest, CreateActiveQuicListenerFactory) {
   EXPECT_EQ(2000u, quic_config.IdleNetworkTimeout().ToMilliseconds());
   // Default value if not present in config.
   EXPECT_EQ(20000u, quic_config.max_time_before_crypto_handshake().ToMilliseconds());
+  Network::UdpListenerBatchConfig& batch_config = ActiveQuicListenerFactoryPeer::batchConfig(
+      dynamic_cast<ActiveQuicListenerFactory&>(*listener_factory));
+  EXPECT_EQ(1u, batch_config.max_batch_size_);
+  EXPECT_FALSE(batch_config.enable_udp_offload_);
+}
+
+TEST(ActiveQuicListenerConfigTest, CreateBatchingActiveQuicListenerFactory) {
+  std::string listener_name = QuicListenerName;
+  auto& config_factory =
+      Config::Utility::getAndCheckFactory<Server::ActiveUdpListenerConfigFactory>(listener_name);
+  ProtobufTypes::MessagePtr config = config_factory.createEmptyConfigProto();
+
+  std::string yaml = R"EOF(
+    max_batch_size: 16
+    enable_udp_offload: true
+  )EOF";
+  TestUtility::loadFromYaml(yaml, *config);
+  Network::ActiveUdpListenerFactoryPtr listener_factory =
+      config_factory.createActiveUdpListenerFactory(*config);
+  Network::UdpListenerBatchConfig& batch_config = ActiveQuicListenerFactoryPeer::batchConfig(
+      dynamic_cast<ActiveQuicListenerFactory&>(*listener_factory));
+  EXPECT_EQ(16u, batch_config.max_batch_size_);
+  EXPECT_TRUE(batch_config.enable_udp_offload_);
 }
 
 } // namespace Quic
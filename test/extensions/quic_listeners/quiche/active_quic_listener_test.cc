@@ -75,8 +75,9 @@ public:
           return true;
         }));
 
-    quic_listener_ = std::make_unique<ActiveQuicListener>(*dispatcher_, connection_handler_,
-                                                          listener_config_, quic_config_);
+    quic_listener_ =
+        std::make_unique<ActiveQuicListener>(*dispatcher_, connection_handler_, listener_config_,
+                                             quic_config_, Network::UdpListenerBatchConfig{});
     simulated_time_system_.sleep(std::chrono::milliseconds(100));
   }
 
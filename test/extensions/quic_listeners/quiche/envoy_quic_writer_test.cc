@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/network/address_impl.h"
 #include "common/network/io_socket_error_impl.h"
@@ -15,6 +16,9 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+using testing::_;
+using testing::ByMove;
+using testing::Invoke;
 using testing::Return;
 
 namespace Envoy {
@@ -134,5 +138,134 @@ TEST_F(EnvoyQuicWriterTest, SendFailureMessageTooBig) {
   EXPECT_FALSE(envoy_quic_writer_.IsWriteBlocked());
 }
 
+class EnvoyQuicBatchWriterTest : public ::testing::Test {
+public:
+  EnvoyQuicBatchWriterTest() : envoy_quic_writer_(socket_, udp_listener_, /*max_batch_size=*/2) {
+    self_address_.FromString("::1");
+    quic::QuicIpAddress peer_ip;
+    peer_ip.FromString("::1");
+    peer_address_ = quic::QuicSocketAddress(peer_ip, /*port=*/123);
+  }
+
+  quic::WriteResult writePacket(const std::string& packet) {
+    return envoy_quic_writer_.WritePacket(packet.data(), packet.length(), self_address_,
+                                          peer_address_, nullptr);
+  }
+
+  // Verifies the packets handed to sendBatch() and drains the first num_sent of them.
+  Api::IoCallUint64Result sendPackets(const Network::UdpSendData* data, uint64_t num_packets,
+                                      const std::vector<std::string>& expected, uint64_t num_sent) {
+    EXPECT_EQ(expected.size(), num_packets);
+    for (uint64_t i = 0; i < num_packets; i++) {
+      EXPECT_EQ(expected[i], data[i].buffer_.toString());
+      EXPECT_EQ(peer_address_.ToString(), data[i].peer_address_.asString());
+      ASSERT(data[i].local_ip_ != nullptr);
+      EXPECT_EQ("::1", data[i].local_ip_->addressAsString());
+    }
+    for (uint64_t i = 0; i < num_sent; i++) {
+      data[i].buffer_.drain(data[i].buffer_.length());
+    }
+    return Api::IoCallUint64Result(num_sent,
+                                   Api::IoErrorPtr(nullptr, Network::IoSocketError::deleteIoError));
+  }
+
+protected:
+  testing::NiceMock<Network::MockListenSocket> socket_;
+  testing::StrictMock<Network::MockUdpListener> udp_listener_;
+  quic::QuicIpAddress self_address_;
+  quic::QuicSocketAddress peer_address_;
+  EnvoyQuicPacketWriter envoy_quic_writer_;
+};
+
+// Tests that packets are buffered until the batch is full and then sent with one sendBatch().
+TEST_F(EnvoyQuicBatchWriterTest, SendFullBatch) {
+  EXPECT_TRUE(envoy_quic_writer_.IsBatchMode());
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writePacket("packet 1").status);
+  EXPECT_EQ(quic::WRITE_STATUS_OK, writePacket("packet 2").status);
+  EXPECT_EQ(2u, envoy_quic_writer_.numBufferedPackets());
+
+  // The third packet flushes the full batch before it is buffered.
+  EXPECT_CALL(udp_listener_, sendBatch(_, 2))
+      .WillOnce(Invoke([this](const Network::UdpSendData* data, uint64_t num_packets) {
+        return sendPackets(data, num_packets, {"packet 1", "packet 2"}, 2);
+      }));
+  quic::WriteResult result = writePacket("packet 3");
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(0, result.bytes_written);
+  EXPECT_EQ(1u, envoy_quic_writer_.numBufferedPackets());
+
+  EXPECT_CALL(udp_listener_, sendBatch(_, 1))
+      .WillOnce(Invoke([this](const Network::UdpSendData* data, uint64_t num_packets) {
+        return sendPackets(data, num_packets, {"packet 3"}, 1);
+      }));
+  result = envoy_quic_writer_.Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(8, result.bytes_written);
+  EXPECT_EQ(0u, envoy_quic_writer_.numBufferedPackets());
+  EXPECT_FALSE(envoy_quic_writer_.IsWriteBlocked());
+
+  // Flushing an empty batch doesn't send anything.
+  EXPECT_EQ(quic::WRITE_STATUS_OK, envoy_quic_writer_.Flush().status);
+}
+
+// Tests that the packets the socket couldn't take stay buffered until it is writable again.
+TEST_F(EnvoyQuicBatchWriterTest, FlushPartiallySent) {
+  writePacket("packet 1");
+  writePacket("packet 2");
+
+  EXPECT_CALL(udp_listener_, sendBatch(_, 2))
+      .WillOnce(Invoke([this](const Network::UdpSendData* data, uint64_t num_packets) {
+        return sendPackets(data, num_packets, {"packet 1", "packet 2"}, 1);
+      }));
+  quic::WriteResult result = envoy_quic_writer_.Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, result.status);
+  EXPECT_TRUE(envoy_quic_writer_.IsWriteBlocked());
+  EXPECT_EQ(1u, envoy_quic_writer_.numBufferedPackets());
+
+  // Nothing is sent while blocked.
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, envoy_quic_writer_.Flush().status);
+
+  envoy_quic_writer_.SetWritable();
+  EXPECT_CALL(udp_listener_, sendBatch(_, 1))
+      .WillOnce(Invoke([this](const Network::UdpSendData* data, uint64_t num_packets) {
+        return sendPackets(data, num_packets, {"packet 2"}, 1);
+      }));
+  result = envoy_quic_writer_.Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_OK, result.status);
+  EXPECT_EQ(8, result.bytes_written);
+  EXPECT_EQ(0u, envoy_quic_writer_.numBufferedPackets());
+}
+
+// Tests that a full batch which can't be flushed blocks the next packet without buffering it.
+TEST_F(EnvoyQuicBatchWriterTest, SendBlocked) {
+  writePacket("packet 1");
+  writePacket("packet 2");
+
+  EXPECT_CALL(udp_listener_, sendBatch(_, 2))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(Network::IoSocketError::getIoSocketEagainInstance(),
+                             Network::IoSocketError::deleteIoError)))));
+  quic::WriteResult result = writePacket("packet 3");
+  EXPECT_EQ(quic::WRITE_STATUS_BLOCKED, result.status);
+  EXPECT_EQ(static_cast<int>(Api::IoError::IoErrorCode::Again), result.error_code);
+  EXPECT_TRUE(envoy_quic_writer_.IsWriteBlocked());
+  EXPECT_EQ(2u, envoy_quic_writer_.numBufferedPackets());
+}
+
+// Tests that the buffered packets are dropped upon a send error.
+TEST_F(EnvoyQuicBatchWriterTest, FlushFailure) {
+  writePacket("packet 1");
+
+  EXPECT_CALL(udp_listener_, sendBatch(_, 1))
+      .WillOnce(Return(ByMove(Api::IoCallUint64Result(
+          0, Api::IoErrorPtr(new Network::IoSocketError(ENOTSUP),
+                             Network::IoSocketError::deleteIoError)))));
+  quic::WriteResult result = envoy_quic_writer_.Flush();
+  EXPECT_EQ(quic::WRITE_STATUS_ERROR, result.status);
+  EXPECT_EQ(static_cast<int>(Api::IoError::IoErrorCode::NoSupport), result.error_code);
+  EXPECT_FALSE(envoy_quic_writer_.IsWriteBlocked());
+  EXPECT_EQ(0u, envoy_quic_writer_.numBufferedPackets());
+}
+
 } // namespace Quic
 } // namespace Envoy
@@ -174,6 +174,32 @@ TEST_F(TcpStatsdSinkTest, WithCustomPrefix) {
   sink_->flush(snapshot_);
 }
 
+TEST_F(TcpStatsdSinkTest, SkipUnchangedMetrics) {
+  sink_ = std::make_unique<TcpStatsdSink>(
+      local_info_, "fake_cluster", tls_, cluster_manager_,
+      cluster_manager_.thread_local_cluster_.cluster_.info_->stats_store_, "", true);
+
+  auto unchanged_counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  unchanged_counter->name_ = "unchanged_counter";
+  unchanged_counter->used_ = true;
+  snapshot_.counters_.push_back({0, *unchanged_counter});
+  auto changed_counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  changed_counter->name_ = "changed_counter";
+  changed_counter->used_ = true;
+  snapshot_.counters_.push_back({1, *changed_counter});
+  snapshot_.changed_counters_.push_back({1, *changed_counter});
+
+  auto unchanged_gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  unchanged_gauge->name_ = "unchanged_gauge";
+  unchanged_gauge->value_ = 1;
+  unchanged_gauge->used_ = true;
+  snapshot_.gauges_.push_back(*unchanged_gauge);
+
+  expectCreateConnection();
+  EXPECT_CALL(*connection_, write(BufferStringEqual("envoy.changed_counter:1|c\n"), _));
+  sink_->flush(snapshot_);
+}
+
 TEST_F(TcpStatsdSinkTest, BufferReallocate) {
   InSequence s;
 
@@ -178,6 +178,41 @@ TEST(UdpStatsdSinkTest, CheckActualStatsWithCustomPrefix) {
   tls_.shutdownThread();
 }
 
+TEST(UdpStatsdSinkTest, SkipUnchangedMetrics) {
+  NiceMock<Stats::MockMetricSnapshot> snapshot;
+  auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  UdpStatsdSink sink(tls_, writer_ptr, false, "", true);
+
+  auto unchanged_counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  unchanged_counter->name_ = "unchanged_counter";
+  unchanged_counter->used_ = true;
+  snapshot.counters_.push_back({0, *unchanged_counter});
+  auto changed_counter = std::make_shared<NiceMock<Stats::MockCounter>>();
+  changed_counter->name_ = "changed_counter";
+  changed_counter->used_ = true;
+  snapshot.counters_.push_back({1, *changed_counter});
+  snapshot.changed_counters_.push_back({1, *changed_counter});
+
+  auto unchanged_gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  unchanged_gauge->name_ = "unchanged_gauge";
+  unchanged_gauge->value_ = 1;
+  unchanged_gauge->used_ = true;
+  snapshot.gauges_.push_back(*unchanged_gauge);
+  auto changed_gauge = std::make_shared<NiceMock<Stats::MockGauge>>();
+  changed_gauge->name_ = "changed_gauge";
+  changed_gauge->value_ = 2;
+  changed_gauge->used_ = true;
+  snapshot.gauges_.push_back(*changed_gauge);
+  snapshot.changed_gauges_.push_back(*changed_gauge);
+
+  EXPECT_CALL(*writer_ptr, write("envoy.changed_counter:1|c"));
+  EXPECT_CALL(*writer_ptr, write("envoy.changed_gauge:2|g"));
+  sink.flush(snapshot);
+
+  tls_.shutdownThread();
+}
+
 TEST(UdpStatsdSinkTest, SiSuffix) {
   NiceMock<Stats::MockMetricSnapshot> snapshot;
   auto writer_ptr = std::make_shared<NiceMock<MockWriter>>();
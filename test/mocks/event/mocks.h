@@ -66,9 +66,10 @@ public:
     return Network::ListenerPtr{createListener_(socket, cb, bind_to_port)};
   }
 
-  Network::UdpListenerPtr createUdpListener(Network::Socket& socket,
-                                            Network::UdpListenerCallbacks& cb) override {
-    return Network::UdpListenerPtr{createUdpListener_(socket, cb)};
+  Network::UdpListenerPtr
+  createUdpListener(Network::Socket& socket, Network::UdpListenerCallbacks& cb,
+                    const Network::UdpListenerBatchConfig& batch_config) override {
+    return Network::UdpListenerPtr{createUdpListener_(socket, cb, batch_config)};
   }
 
   Event::TimerPtr createTimer(Event::TimerCb cb) override {
@@ -105,8 +106,9 @@ public:
   MOCK_METHOD3(createListener_,
                Network::Listener*(Network::Socket& socket, Network::ListenerCallbacks& cb,
                                   bool bind_to_port));
-  MOCK_METHOD2(createUdpListener_,
-               Network::UdpListener*(Network::Socket& socket, Network::UdpListenerCallbacks& cb));
+  MOCK_METHOD3(createUdpListener_,
+               Network::UdpListener*(Network::Socket& socket, Network::UdpListenerCallbacks& cb,
+                                     const Network::UdpListenerBatchConfig& batch_config));
   MOCK_METHOD1(createTimer_, Timer*(Event::TimerCb cb));
   MOCK_METHOD1(deferredDelete_, void(DeferredDeletable* to_delete));
   MOCK_METHOD0(exit, void());
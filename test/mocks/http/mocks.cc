@@ -144,7 +144,9 @@ MockAsyncClientRequest::~MockAsyncClientRequest() { client_->onRequestDestroy();
 MockAsyncClientStream::MockAsyncClientStream() = default;
 MockAsyncClientStream::~MockAsyncClientStream() = default;
 
-MockFilterChainFactoryCallbacks::MockFilterChainFactoryCallbacks() = default;
+MockFilterChainFactoryCallbacks::MockFilterChainFactoryCallbacks() {
+  ON_CALL(*this, streamArena()).WillByDefault(ReturnRef(arena_));
+}
 MockFilterChainFactoryCallbacks::~MockFilterChainFactoryCallbacks() = default;
 
 } // namespace Http
@@ -14,6 +14,7 @@
 #include "envoy/http/filter.h"
 #include "envoy/ssl/connection.h"
 
+#include "common/common/arena_impl.h"
 #include "common/http/header_map_impl.h"
 #include "common/http/utility.h"
 
@@ -382,6 +383,9 @@ public:
   MOCK_METHOD1(addStreamEncoderFilter, void(Http::StreamEncoderFilterSharedPtr filter));
   MOCK_METHOD1(addStreamFilter, void(Http::StreamFilterSharedPtr filter));
   MOCK_METHOD1(addAccessLogHandler, void(AccessLog::InstanceSharedPtr handler));
+  MOCK_METHOD0(streamArena, Arena&());
+
+  ArenaImpl arena_;
 };
 
 class MockDownstreamWatermarkCallbacks : public DownstreamWatermarkCallbacks {
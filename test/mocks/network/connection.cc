@@ -12,6 +12,9 @@ namespace Network {
 MockConnectionCallbacks::MockConnectionCallbacks() = default;
 MockConnectionCallbacks::~MockConnectionCallbacks() = default;
 
+MockBypassCallbacks::MockBypassCallbacks() = default;
+MockBypassCallbacks::~MockBypassCallbacks() = default;
+
 uint64_t MockConnectionBase::next_id_;
 
 void MockConnectionBase::raiseEvent(Network::ConnectionEvent event) {
@@ -25,6 +25,15 @@ public:
   MOCK_METHOD0(onBelowWriteBufferLowWatermark, void());
 };
 
+class MockBypassCallbacks : public BypassCallbacks {
+public:
+  MockBypassCallbacks();
+  ~MockBypassCallbacks() override;
+
+  // Network::BypassCallbacks
+  MOCK_METHOD1(onSocketEvent, void(uint32_t events));
+};
+
 class MockConnectionBase {
 public:
   void raiseEvent(Network::ConnectionEvent event);
@@ -84,6 +93,8 @@ public:
   MOCK_CONST_METHOD0(streamInfo, const StreamInfo::StreamInfo&());
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_CONST_METHOD0(canBypassTransportSocket, bool());
+  MOCK_METHOD1(bypassTransportSocket, IoHandle&(BypassCallbacks&));
 };
 
 /**
@@ -129,6 +140,8 @@ public:
   MOCK_CONST_METHOD0(streamInfo, const StreamInfo::StreamInfo&());
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_CONST_METHOD0(canBypassTransportSocket, bool());
+  MOCK_METHOD1(bypassTransportSocket, IoHandle&(BypassCallbacks&));
 
   // Network::ClientConnection
   MOCK_METHOD0(connect, void());
@@ -177,6 +190,8 @@ public:
   MOCK_CONST_METHOD0(streamInfo, const StreamInfo::StreamInfo&());
   MOCK_METHOD1(setDelayedCloseTimeout, void(std::chrono::milliseconds));
   MOCK_CONST_METHOD0(transportFailureReason, absl::string_view());
+  MOCK_CONST_METHOD0(canBypassTransportSocket, bool());
+  MOCK_METHOD1(bypassTransportSocket, IoHandle&(BypassCallbacks&));
 
   // Network::FilterManagerConnection
   MOCK_METHOD0(getReadBuffer, StreamBuffer());
@@ -417,6 +417,7 @@ public:
   MOCK_METHOD0(dispatcher, Event::Dispatcher&());
   MOCK_CONST_METHOD0(localAddress, Address::InstanceConstSharedPtr&());
   MOCK_METHOD1(send, Api::IoCallUint64Result(const UdpSendData&));
+  MOCK_METHOD2(sendBatch, Api::IoCallUint64Result(const UdpSendData*, uint64_t));
 };
 
 class MockUdpReadFilterCallbacks : public UdpReadFilterCallbacks {
@@ -26,6 +26,7 @@ public:
   MOCK_METHOD2(doWrite, IoResult(Buffer::Instance& buffer, bool end_stream));
   MOCK_METHOD0(onConnected, void());
   MOCK_CONST_METHOD0(ssl, Ssl::ConnectionInfoConstSharedPtr());
+  MOCK_CONST_METHOD0(passThrough, bool());
 
   TransportSocketCallbacks* callbacks_{};
 };
@@ -60,7 +60,9 @@ MockAdmin::MockAdmin() {
 }
 MockAdmin::~MockAdmin() = default;
 
-MockAdminStream::MockAdminStream() = default;
+MockAdminStream::MockAdminStream() {
+  ON_CALL(*this, hasDecoderFilterCallbacks()).WillByDefault(Return(true));
+}
 MockAdminStream::~MockAdminStream() = default;
 
 MockDrainManager::MockDrainManager() {
@@ -164,6 +164,7 @@ public:
   MOCK_CONST_METHOD0(getRequestHeaders, Http::HeaderMap&());
   MOCK_CONST_METHOD0(getDecoderFilterCallbacks,
                      NiceMock<Http::MockStreamDecoderFilterCallbacks>&());
+  MOCK_CONST_METHOD0(hasDecoderFilterCallbacks, bool());
 };
 
 class MockDrainManager : public DrainManager {
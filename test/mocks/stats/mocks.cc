@@ -10,6 +10,7 @@
 using testing::_;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 using testing::ReturnPointee;
 using testing::ReturnRef;
 
@@ -27,6 +28,7 @@ MockGauge::MockGauge() : used_(false), value_(0), import_mode_(ImportMode::Accum
   ON_CALL(*this, used()).WillByDefault(ReturnPointee(&used_));
   ON_CALL(*this, value()).WillByDefault(ReturnPointee(&value_));
   ON_CALL(*this, importMode()).WillByDefault(ReturnPointee(&import_mode_));
+  ON_CALL(*this, latchChanged()).WillByDefault(Return(true));
 }
 MockGauge::~MockGauge() = default;
 
@@ -56,12 +58,16 @@ MockParentHistogram::~MockParentHistogram() = default;
 MockMetricSnapshot::MockMetricSnapshot() {
   ON_CALL(*this, counters()).WillByDefault(ReturnRef(counters_));
   ON_CALL(*this, gauges()).WillByDefault(ReturnRef(gauges_));
+  ON_CALL(*this, changedCounters()).WillByDefault(ReturnRef(changed_counters_));
+  ON_CALL(*this, changedGauges()).WillByDefault(ReturnRef(changed_gauges_));
   ON_CALL(*this, histograms()).WillByDefault(ReturnRef(histograms_));
 }
 
 MockMetricSnapshot::~MockMetricSnapshot() = default;
 
-MockSink::MockSink() = default;
+MockSink::MockSink() {
+  ON_CALL(*this, flushOnMainThread()).WillByDefault(Return(true));
+}
 MockSink::~MockSink() = default;
 
 MockStore::MockStore() : StoreImpl(*global_symbol_table_) {
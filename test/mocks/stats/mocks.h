@@ -174,6 +174,7 @@ public:
   MOCK_METHOD0(inc, void());
   MOCK_METHOD1(set, void(uint64_t value));
   MOCK_METHOD1(sub, void(uint64_t amount));
+  MOCK_METHOD0(latchChanged, bool());
   MOCK_METHOD1(mergeImportMode, void(ImportMode));
   MOCK_CONST_METHOD0(used, bool());
   MOCK_CONST_METHOD0(value, uint64_t());
@@ -251,10 +252,14 @@ public:
 
   MOCK_METHOD0(counters, const std::vector<CounterSnapshot>&());
   MOCK_METHOD0(gauges, const std::vector<std::reference_wrapper<const Gauge>>&());
+  MOCK_METHOD0(changedCounters, const std::vector<CounterSnapshot>&());
+  MOCK_METHOD0(changedGauges, const std::vector<std::reference_wrapper<const Gauge>>&());
   MOCK_METHOD0(histograms, const std::vector<std::reference_wrapper<const ParentHistogram>>&());
 
   std::vector<CounterSnapshot> counters_;
   std::vector<std::reference_wrapper<const Gauge>> gauges_;
+  std::vector<CounterSnapshot> changed_counters_;
+  std::vector<std::reference_wrapper<const Gauge>> changed_gauges_;
   std::vector<std::reference_wrapper<const ParentHistogram>> histograms_;
 };
 
@@ -264,6 +269,7 @@ public:
   ~MockSink() override;
 
   MOCK_METHOD1(flush, void(MetricSnapshot& snapshot));
+  MOCK_CONST_METHOD0(flushOnMainThread, bool());
   MOCK_METHOD2(onHistogramComplete, void(const Histogram& histogram, uint64_t value));
 };
 
@@ -5,6 +5,7 @@
 
 using testing::_;
 using testing::Invoke;
+using testing::Return;
 
 namespace Envoy {
 namespace ThreadLocal {
@@ -16,6 +17,9 @@ MockInstance::MockInstance() {
       .WillByDefault(Invoke(this, &MockInstance::runOnAllThreads2_));
   ON_CALL(*this, shutdownThread()).WillByDefault(Invoke(this, &MockInstance::shutdownThread_));
   ON_CALL(*this, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+  // A single worker, which runs everything on dispatcher_.
+  ON_CALL(*this, workerIndex()).WillByDefault(Return(absl::optional<uint32_t>(0)));
+  ON_CALL(*this, workerCount()).WillByDefault(Return(1));
 }
 
 MockInstance::~MockInstance() { shutdownThread_(); }
@@ -26,6 +26,8 @@ public:
   MOCK_METHOD0(shutdownGlobalThreading, void());
   MOCK_METHOD0(shutdownThread, void());
   MOCK_METHOD0(dispatcher, Event::Dispatcher&());
+  MOCK_METHOD0(workerIndex, absl::optional<uint32_t>());
+  MOCK_METHOD0(workerCount, uint32_t());
 
   SlotPtr allocateSlot_() { return SlotPtr{new SlotImpl(*this, current_slot_++)}; }
   void runOnAllThreads1_(Event::PostCb cb) { cb(); }
@@ -76,6 +76,15 @@ public:
   MOCK_METHOD0(setUnhealthy, void());
 };
 
+class MockResponseTimeEstimator : public ResponseTimeEstimator {
+public:
+  MockResponseTimeEstimator();
+  ~MockResponseTimeEstimator() override;
+
+  MOCK_METHOD2(putResponseTime, void(std::chrono::microseconds, MonotonicTime));
+  MOCK_CONST_METHOD1(estimate, double(MonotonicTime));
+};
+
 class MockHostDescription : public HostDescription {
 public:
   MockHostDescription();
@@ -90,6 +99,7 @@ public:
   MOCK_CONST_METHOD0(cluster, const ClusterInfo&());
   MOCK_CONST_METHOD0(outlierDetector, Outlier::DetectorHostMonitor&());
   MOCK_CONST_METHOD0(healthChecker, HealthCheckHostMonitor&());
+  MOCK_CONST_METHOD0(responseTimeEstimator, ResponseTimeEstimator&());
   MOCK_CONST_METHOD0(hostname, const std::string&());
   MOCK_CONST_METHOD0(transportSocketFactory, Network::TransportSocketFactory&());
   MOCK_CONST_METHOD0(stats, HostStats&());
@@ -107,6 +117,7 @@ public:
   Network::Address::InstanceConstSharedPtr address_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
   testing::NiceMock<MockHealthCheckHostMonitor> health_checker_;
+  testing::NiceMock<MockResponseTimeEstimator> response_time_estimator_;
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<MockClusterInfo> cluster_;
   HostStats stats_;
@@ -175,6 +186,7 @@ public:
   MOCK_CONST_METHOD0(hostname, const std::string&());
   MOCK_CONST_METHOD0(transportSocketFactory, Network::TransportSocketFactory&());
   MOCK_CONST_METHOD0(outlierDetector, Outlier::DetectorHostMonitor&());
+  MOCK_CONST_METHOD0(responseTimeEstimator, ResponseTimeEstimator&());
   MOCK_METHOD1(setHealthChecker_, void(HealthCheckHostMonitorPtr& health_checker));
   MOCK_METHOD1(setOutlierDetector_, void(Outlier::DetectorHostMonitorPtr& outlier_detector));
   MOCK_CONST_METHOD0(stats, HostStats&());
@@ -190,6 +202,7 @@ public:
   testing::NiceMock<MockClusterInfo> cluster_;
   Network::TransportSocketFactoryPtr socket_factory_;
   testing::NiceMock<Outlier::MockDetectorHostMonitor> outlier_detector_;
+  testing::NiceMock<MockResponseTimeEstimator> response_time_estimator_;
   HostStats stats_;
   mutable Stats::TestSymbolTable symbol_table_;
   mutable std::unique_ptr<Stats::StatNameManagedStorage> locality_zone_stat_name_;
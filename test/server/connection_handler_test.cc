@@ -836,11 +836,11 @@ TEST_F(ConnectionHandlerTest, UdpListenerNoFilterThrowsException) {
       addListener(1, true, false, "test_listener", Network::Address::SocketType::Datagram,
                   std::chrono::milliseconds());
   Network::MockUdpListener* listener = new Network::MockUdpListener();
-  EXPECT_CALL(dispatcher_, createUdpListener_(_, _))
-      .WillOnce(
-          Invoke([&](Network::Socket&, Network::UdpListenerCallbacks&) -> Network::UdpListener* {
-            return listener;
-          }));
+  EXPECT_CALL(dispatcher_, createUdpListener_(_, _, _))
+      .WillOnce(Invoke([&](Network::Socket&, Network::UdpListenerCallbacks&,
+                           const Network::UdpListenerBatchConfig&) -> Network::UdpListener* {
+        return listener;
+      }));
   EXPECT_CALL(factory_, createUdpListenerFilterChain(_, _))
       .WillOnce(Invoke([&](Network::UdpListenerFilterManager&,
                            Network::UdpReadFilterCallbacks&) -> bool { return true; }));
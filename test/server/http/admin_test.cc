@@ -33,6 +33,7 @@
 #include "absl/strings/match.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "metrics.pb.h"
 
 using testing::_;
 using testing::AllOf;
@@ -764,6 +765,48 @@ TEST_P(AdminInstanceTest, PrometheusStatsInvalidRegex) {
   EXPECT_THAT(data.toString(), EndsWith("\"\n"));
 }
 
+TEST_P(AdminInstanceTest, PrometheusStatsProtobuf) {
+  server_.stats().counter("cluster.c1.upstream_rq").add(3);
+  server_.stats().counter("cluster.c10.upstream_rq").add(5);
+  request_headers_.addCopy(Http::Headers::get().Accept,
+                           "application/vnd.google.protobuf; "
+                           "proto=io.prometheus.client.MetricFamily; encoding=delimited");
+  Http::HeaderMapImpl header_map;
+  Buffer::OwnedImpl data;
+  EXPECT_EQ(Http::Code::OK, getCallback("/stats/prometheus?prefix=cluster.c1", header_map, data));
+  EXPECT_THAT(std::string(header_map.ContentType()->value().getStringView()),
+              HasSubstr("proto=io.prometheus.client.MetricFamily"));
+
+  const std::string response = data.toString();
+  Protobuf::io::ArrayInputStream array_stream(response.data(), response.size());
+  Protobuf::io::CodedInputStream coded_stream(&array_stream);
+  uint32_t size;
+  ASSERT_TRUE(coded_stream.ReadVarint32(&size));
+  EXPECT_EQ(response.size() - 1, size);
+  io::prometheus::client::MetricFamily family;
+  ASSERT_TRUE(family.ParseFromCodedStream(&coded_stream));
+  EXPECT_EQ("envoy_cluster_c1_upstream_rq", family.name());
+  EXPECT_EQ(io::prometheus::client::MetricType::COUNTER, family.type());
+  ASSERT_EQ(1, family.metric_size());
+  EXPECT_EQ(3, family.metric(0).counter().value());
+}
+
+// Admin::request() has no stream to write further chunks to, so all of them are in the body.
+TEST_P(AdminInstanceTest, PrometheusStatsRequestMultipleChunks) {
+  const uint64_t num_counters = 2000;
+  for (uint64_t i = 0; i < num_counters; ++i) {
+    server_.stats().counter(fmt::format("cluster.c{}.upstream_rq", i)).add(i + 1);
+  }
+  Http::HeaderMapImpl response_headers;
+  std::string body;
+  EXPECT_EQ(Http::Code::OK, admin_.request("/stats/prometheus", "GET", response_headers, body));
+  // More than the 64 KiB of the first chunk.
+  EXPECT_GT(body.size(), 64u * 1024);
+  for (uint64_t i = 0; i < num_counters; ++i) {
+    EXPECT_THAT(body, HasSubstr(fmt::format("envoy_cluster_c{}_upstream_rq{{}} {}\n", i, i + 1)));
+  }
+}
+
 TEST_P(AdminInstanceTest, WriteAddressToFile) {
   std::ifstream address_file(address_out_path_);
   std::string address_from_file;
@@ -0,0 +1,135 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Usage: bazel run //test/server/http:prometheus_stats_speed_test
+//
+// Compares serializing the stats with PrometheusStatsFormatter, which builds the whole response,
+// with streaming them in chunks with PrometheusStatsWriter, in the text and protobuf formats.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/fmt.h"
+#include "common/common/logger.h"
+#include "common/common/thread.h"
+#include "common/stats/allocator_impl.h"
+#include "common/stats/symbol_table_creator.h"
+
+#include "server/http/admin.h"
+#include "server/http/prometheus_stats.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+/**
+ * Counters and gauges of the given number of clusters, tagged with their cluster names.
+ */
+class PrometheusStatsTester {
+public:
+  explicit PrometheusStatsTester(uint64_t num_clusters)
+      : symbol_table_(Stats::SymbolTableCreator::makeSymbolTable()), alloc_(*symbol_table_) {
+    const std::vector<std::string> counter_names = {"upstream_cx_total", "upstream_rq_total",
+                                                    "upstream_rq_2xx", "upstream_rq_5xx",
+                                                    "upstream_cx_connect_fail"};
+    const std::vector<std::string> gauge_names = {"upstream_cx_active", "upstream_rq_active",
+                                                  "membership_healthy", "membership_total",
+                                                  "max_host_weight"};
+    for (uint64_t i = 0; i < num_clusters; ++i) {
+      const std::string cluster_name = fmt::format("cluster_{}", i);
+      const std::vector<Stats::Tag> tags = {{"envoy.cluster_name", cluster_name}};
+      for (const std::string& name : counter_names) {
+        Stats::StatNameManagedStorage storage(fmt::format("cluster.{}.{}", cluster_name, name),
+                                              *symbol_table_);
+        counters_.push_back(
+            alloc_.makeCounter(storage.statName(), fmt::format("cluster.{}", name), tags));
+        counters_.back()->add(i + 1);
+      }
+      for (const std::string& name : gauge_names) {
+        Stats::StatNameManagedStorage storage(fmt::format("cluster.{}.{}", cluster_name, name),
+                                              *symbol_table_);
+        gauges_.push_back(alloc_.makeGauge(storage.statName(), fmt::format("cluster.{}", name),
+                                           tags, Stats::Gauge::ImportMode::Accumulate));
+        gauges_.back()->set(i + 1);
+      }
+    }
+  }
+
+  // Writes all the chunks of a writer, dropping each one as a network write would.
+  uint64_t writeChunks(PrometheusStatsWriter::Format format) {
+    PrometheusStatsWriter writer(*symbol_table_, format,
+                                 std::vector<Stats::CounterSharedPtr>(counters_),
+                                 std::vector<Stats::GaugeSharedPtr>(gauges_), {}, false,
+                                 absl::nullopt, "");
+    uint64_t length = 0;
+    bool more = true;
+    while (more) {
+      Buffer::OwnedImpl chunk;
+      more = writer.nextChunk(chunk);
+      length += chunk.length();
+    }
+    return length;
+  }
+
+  Stats::SymbolTablePtr symbol_table_;
+  Stats::AllocatorImpl alloc_;
+  std::vector<Stats::CounterSharedPtr> counters_;
+  std::vector<Stats::GaugeSharedPtr> gauges_;
+  std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+};
+
+// state.range(0) is the number of clusters, each with 10 stats.
+void BM_PrometheusStatsFormatter(benchmark::State& state) {
+  PrometheusStatsTester tester(state.range(0));
+  uint64_t length = 0;
+  for (auto _ : state) {
+    Buffer::OwnedImpl response;
+    PrometheusStatsFormatter::statsAsPrometheus(tester.counters_, tester.gauges_,
+                                                tester.histograms_, response, false,
+                                                absl::nullopt);
+    length = response.length();
+  }
+  state.counters["bytes"] = length;
+}
+BENCHMARK(BM_PrometheusStatsFormatter)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void BM_PrometheusStatsWriterText(benchmark::State& state) {
+  PrometheusStatsTester tester(state.range(0));
+  uint64_t length = 0;
+  for (auto _ : state) {
+    length = tester.writeChunks(PrometheusStatsWriter::Format::Text);
+  }
+  state.counters["bytes"] = length;
+}
+BENCHMARK(BM_PrometheusStatsWriterText)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void BM_PrometheusStatsWriterProtobuf(benchmark::State& state) {
+  PrometheusStatsTester tester(state.range(0));
+  uint64_t length = 0;
+  for (auto _ : state) {
+    length = tester.writeChunks(PrometheusStatsWriter::Format::Protobuf);
+  }
+  state.counters["bytes"] = length;
+}
+BENCHMARK(BM_PrometheusStatsWriterProtobuf)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logger_context(spdlog::level::warn,
+                                        Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock);
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}
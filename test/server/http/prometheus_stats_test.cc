@@ -0,0 +1,421 @@
+#include <functional>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/common/fmt.h"
+#include "common/protobuf/protobuf.h"
+#include "common/stats/allocator_impl.h"
+#include "common/stats/histogram_impl.h"
+
+#include "server/http/admin.h"
+#include "server/http/prometheus_stats.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/server/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Server {
+
+class PrometheusStatsWriterTest : public testing::Test {
+protected:
+  PrometheusStatsWriterTest() : alloc_(*symbol_table_) {}
+
+  void addCounter(const std::string& name, const std::string& tag_extracted_name,
+                  std::vector<Stats::Tag> tags, uint64_t value = 0) {
+    Stats::StatNameManagedStorage storage(name, *symbol_table_);
+    counters_.push_back(alloc_.makeCounter(storage.statName(), tag_extracted_name, tags));
+    // The stat is only marked as used once it has a value.
+    if (value > 0) {
+      counters_.back()->add(value);
+    }
+  }
+
+  void addGauge(const std::string& name, const std::string& tag_extracted_name,
+                std::vector<Stats::Tag> tags, uint64_t value = 0) {
+    Stats::StatNameManagedStorage storage(name, *symbol_table_);
+    gauges_.push_back(alloc_.makeGauge(storage.statName(), tag_extracted_name, tags,
+                                       Stats::Gauge::ImportMode::Accumulate));
+    if (value > 0) {
+      gauges_.back()->set(value);
+    }
+  }
+
+  using MockHistogramSharedPtr = Stats::RefcountPtr<NiceMock<Stats::MockParentHistogram>>;
+  MockHistogramSharedPtr addHistogram(const std::string& name,
+                                      const Stats::HistogramStatistics& statistics) {
+    MockHistogramSharedPtr histogram(new NiceMock<Stats::MockParentHistogram>());
+    histogram->name_ = name;
+    histogram->setTagExtractedName(name);
+    histogram->used_ = true;
+    ON_CALL(*histogram, cumulativeStatistics()).WillByDefault(ReturnRef(statistics));
+    histograms_.push_back(histogram);
+    return histogram;
+  }
+
+  PrometheusStatsWriterPtr
+  makeWriter(PrometheusStatsWriter::Format format, bool used_only = false,
+             const absl::optional<std::regex>& regex = absl::nullopt,
+             absl::string_view prefix = "") {
+    return std::make_unique<PrometheusStatsWriter>(
+        *symbol_table_, format, std::vector<Stats::CounterSharedPtr>(counters_),
+        std::vector<Stats::GaugeSharedPtr>(gauges_),
+        std::vector<Stats::ParentHistogramSharedPtr>(histograms_), used_only, regex, prefix);
+  }
+
+  // Writes all the chunks of the writer, and returns the number of chunks.
+  static uint32_t writeAll(PrometheusStatsWriter& writer, Buffer::Instance& response) {
+    uint32_t num_chunks = 1;
+    while (writer.nextChunk(response)) {
+      ++num_chunks;
+    }
+    return num_chunks;
+  }
+
+  std::string text(bool used_only = false,
+                   const absl::optional<std::regex>& regex = absl::nullopt,
+                   absl::string_view prefix = "") {
+    PrometheusStatsWriterPtr writer =
+        makeWriter(PrometheusStatsWriter::Format::Text, used_only, regex, prefix);
+    Buffer::OwnedImpl response;
+    writeAll(*writer, response);
+    return response.toString();
+  }
+
+  static std::vector<io::prometheus::client::MetricFamily>
+  parseFamilies(const std::string& response) {
+    std::vector<io::prometheus::client::MetricFamily> families;
+    Protobuf::io::ArrayInputStream array_stream(response.data(), response.size());
+    Protobuf::io::CodedInputStream coded_stream(&array_stream);
+    uint32_t size;
+    while (coded_stream.ReadVarint32(&size)) {
+      const auto limit = coded_stream.PushLimit(size);
+      families.emplace_back();
+      EXPECT_TRUE(families.back().ParseFromCodedStream(&coded_stream));
+      coded_stream.PopLimit(limit);
+    }
+    return families;
+  }
+
+  Stats::TestSymbolTable symbol_table_;
+  Stats::AllocatorImpl alloc_;
+  std::vector<Stats::CounterSharedPtr> counters_;
+  std::vector<Stats::GaugeSharedPtr> gauges_;
+  std::vector<Stats::ParentHistogramSharedPtr> histograms_;
+};
+
+TEST_F(PrometheusStatsWriterTest, SanitizeName) {
+  EXPECT_EQ("envoy_An_artist_plays_violin_019street",
+            PrometheusStatsWriter::sanitizeName("envoy_An.artist.plays-violin@019street"));
+  EXPECT_EQ("_3_artists", PrometheusStatsWriter::sanitizeName("3.artists"));
+  EXPECT_EQ("", PrometheusStatsWriter::sanitizeName(""));
+}
+
+// The samples of a metric follow its TYPE line, even when the stats are not adjacent.
+TEST_F(PrometheusStatsWriterTest, GroupsByTagExtractedName) {
+  addCounter("cluster.c1.upstream_cx_total", "cluster.upstream_cx_total",
+             {{"envoy.cluster_name", "c1"}}, 1);
+  addCounter("http.admin.downstream_rq", "http.downstream_rq", {{"http.conn-prefix", "admin"}}, 7);
+  addCounter("cluster.c2.upstream_cx_total", "cluster.upstream_cx_total",
+             {{"envoy.cluster_name", "c2"}}, 2);
+  addGauge("server.live", "server.live", {}, 1);
+
+  PrometheusStatsWriterPtr writer = makeWriter(PrometheusStatsWriter::Format::Text);
+  EXPECT_EQ(3UL, writer->numFamilies());
+  Buffer::OwnedImpl response;
+  EXPECT_FALSE(writer->nextChunk(response));
+
+  const std::string expected_output = R"EOF(# TYPE envoy_cluster_upstream_cx_total counter
+envoy_cluster_upstream_cx_total{envoy_cluster_name="c1"} 1
+envoy_cluster_upstream_cx_total{envoy_cluster_name="c2"} 2
+# TYPE envoy_http_downstream_rq counter
+envoy_http_downstream_rq{http_conn_prefix="admin"} 7
+# TYPE envoy_server_live gauge
+envoy_server_live{} 1
+)EOF";
+  EXPECT_EQ(expected_output, response.toString());
+}
+
+// Names which only differ before sanitization get a single TYPE line and metric family, of the
+// type of the first stat. Stats of other types sharing the name are left out.
+TEST_F(PrometheusStatsWriterTest, GroupsBySanitizedName) {
+  addCounter("a.b_c", "a.b_c", {}, 1);
+  addCounter("a.b.c", "a.b.c", {}, 2);
+  addCounter("shared.counter", "shared", {}, 3);
+  addGauge("shared.gauge", "shared", {}, 4);
+
+  EXPECT_EQ(R"EOF(# TYPE envoy_a_b_c counter
+envoy_a_b_c{} 1
+envoy_a_b_c{} 2
+# TYPE envoy_shared counter
+envoy_shared{} 3
+)EOF",
+            text());
+
+  PrometheusStatsWriterPtr writer = makeWriter(PrometheusStatsWriter::Format::Protobuf);
+  EXPECT_EQ(2UL, writer->numFamilies());
+  Buffer::OwnedImpl response;
+  writeAll(*writer, response);
+  const std::vector<io::prometheus::client::MetricFamily> families =
+      parseFamilies(response.toString());
+  ASSERT_EQ(2, families.size());
+  EXPECT_EQ("envoy_a_b_c", families[0].name());
+  ASSERT_EQ(2, families[0].metric_size());
+  EXPECT_EQ(1, families[0].metric(0).counter().value());
+  EXPECT_EQ(2, families[0].metric(1).counter().value());
+  EXPECT_EQ("envoy_shared", families[1].name());
+  EXPECT_EQ(io::prometheus::client::MetricType::COUNTER, families[1].type());
+  ASSERT_EQ(1, families[1].metric_size());
+  EXPECT_EQ(3, families[1].metric(0).counter().value());
+}
+
+// Without repeated metric names, the text is the same as PrometheusStatsFormatter's.
+TEST_F(PrometheusStatsWriterTest, TextMatchesFormatter) {
+  addCounter("cluster.c1.upstream_cx_total", "cluster.upstream_cx_total",
+             {{"envoy.cluster_name", "c1"}, {"a.tag-name", "a.tag-value"}}, 5);
+  addGauge("cluster.c1.upstream_cx_active", "cluster.upstream_cx_active",
+           {{"envoy.cluster_name", "c1"}}, 3);
+
+  histogram_t* hist = hist_alloc();
+  hist_insert_intscale(hist, 1, 0, 100000);
+  hist_insert_intscale(hist, 100, 0, 1000000);
+  hist_insert_intscale(hist, 1000, 0, 100000000);
+  Stats::HistogramStatisticsImpl statistics(hist);
+  hist_free(hist);
+  addHistogram("histogram1", statistics);
+  addHistogram("histogram2", statistics)->addTag({"envoy.cluster_name", "c1"});
+
+  Buffer::OwnedImpl expected;
+  EXPECT_EQ(4UL, PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_,
+                                                             expected, false, absl::nullopt));
+  EXPECT_EQ(expected.toString(), text());
+}
+
+TEST_F(PrometheusStatsWriterTest, Filters) {
+  addCounter("cluster.a.upstream_rq", "cluster.upstream_rq", {{"envoy.cluster_name", "a"}});
+  addCounter("cluster.ab.upstream_rq", "cluster.upstream_rq", {{"envoy.cluster_name", "ab"}}, 1);
+  addCounter("cluster.a.upstream_cx", "cluster.upstream_cx", {{"envoy.cluster_name", "a"}}, 1);
+  addGauge("server.live", "server.live", {}, 1);
+
+  // The prefix matches whole name tokens, with or without a trailing dot.
+  EXPECT_EQ(R"EOF(# TYPE envoy_cluster_upstream_rq counter
+envoy_cluster_upstream_rq{envoy_cluster_name="a"} 0
+# TYPE envoy_cluster_upstream_cx counter
+envoy_cluster_upstream_cx{envoy_cluster_name="a"} 1
+)EOF",
+            text(false, absl::nullopt, "cluster.a"));
+  EXPECT_EQ(text(false, absl::nullopt, "cluster.a"), text(false, absl::nullopt, "cluster.a."));
+  EXPECT_EQ("", text(false, absl::nullopt, "cluste"));
+  EXPECT_EQ("", text(false, absl::nullopt, "cluster.a.upstream"));
+  EXPECT_EQ(text(), text(false, absl::nullopt, ""));
+
+  EXPECT_EQ(R"EOF(# TYPE envoy_cluster_upstream_rq counter
+envoy_cluster_upstream_rq{envoy_cluster_name="ab"} 1
+# TYPE envoy_cluster_upstream_cx counter
+envoy_cluster_upstream_cx{envoy_cluster_name="a"} 1
+)EOF",
+            text(true, absl::nullopt, "cluster"));
+
+  EXPECT_EQ(R"EOF(# TYPE envoy_cluster_upstream_cx counter
+envoy_cluster_upstream_cx{envoy_cluster_name="a"} 1
+)EOF",
+            text(true, std::regex("upstream_cx"), "cluster"));
+}
+
+TEST_F(PrometheusStatsWriterTest, Protobuf) {
+  addCounter("cluster.c1.upstream_cx_total", "cluster.upstream_cx_total",
+             {{"envoy.cluster_name", "c1"}}, 1);
+  addCounter("cluster.c2.upstream_cx_total", "cluster.upstream_cx_total",
+             {{"envoy.cluster_name", "c2"}}, 2);
+  addGauge("server.live", "server.live", {}, 1);
+
+  histogram_t* hist = hist_alloc();
+  hist_insert_intscale(hist, 5, 0, 2);
+  Stats::HistogramStatisticsImpl statistics(hist);
+  hist_free(hist);
+  addHistogram("histogram1", statistics);
+
+  PrometheusStatsWriterPtr writer = makeWriter(PrometheusStatsWriter::Format::Protobuf);
+  Buffer::OwnedImpl response;
+  EXPECT_EQ(1, writeAll(*writer, response));
+  const std::vector<io::prometheus::client::MetricFamily> families =
+      parseFamilies(response.toString());
+  ASSERT_EQ(3, families.size());
+
+  EXPECT_EQ("envoy_cluster_upstream_cx_total", families[0].name());
+  EXPECT_EQ(io::prometheus::client::MetricType::COUNTER, families[0].type());
+  ASSERT_EQ(2, families[0].metric_size());
+  for (int i = 0; i < 2; ++i) {
+    const io::prometheus::client::Metric& metric = families[0].metric(i);
+    ASSERT_EQ(1, metric.label_size());
+    EXPECT_EQ("envoy_cluster_name", metric.label(0).name());
+    EXPECT_EQ(fmt::format("c{}", i + 1), metric.label(0).value());
+    EXPECT_EQ(i + 1, metric.counter().value());
+  }
+
+  EXPECT_EQ("envoy_server_live", families[1].name());
+  EXPECT_EQ(io::prometheus::client::MetricType::GAUGE, families[1].type());
+  ASSERT_EQ(1, families[1].metric_size());
+  EXPECT_EQ(0, families[1].metric(0).label_size());
+  EXPECT_EQ(1, families[1].metric(0).gauge().value());
+
+  EXPECT_EQ("envoy_histogram1", families[2].name());
+  EXPECT_EQ(io::prometheus::client::MetricType::HISTOGRAM, families[2].type());
+  ASSERT_EQ(1, families[2].metric_size());
+  const io::prometheus::client::Histogram& histogram = families[2].metric(0).histogram();
+  EXPECT_EQ(statistics.sampleCount(), histogram.sample_count());
+  EXPECT_EQ(statistics.sampleSum(), histogram.sample_sum());
+  ASSERT_EQ(statistics.supportedBuckets().size(), histogram.bucket_size());
+  for (int i = 0; i < histogram.bucket_size(); ++i) {
+    EXPECT_EQ(statistics.supportedBuckets()[i], histogram.bucket(i).upper_bound());
+    EXPECT_EQ(statistics.computedBuckets()[i], histogram.bucket(i).cumulative_count());
+  }
+}
+
+TEST_F(PrometheusStatsWriterTest, Chunks) {
+  // Each counter takes about 80 bytes of text, so that the stats take several chunks.
+  const uint32_t num_counters = 5000;
+  for (uint32_t i = 0; i < num_counters; ++i) {
+    addCounter(fmt::format("cluster.cluster_{}.upstream_cx_total", i), "cluster.upstream_cx_total",
+               {{"envoy.cluster_name", fmt::format("cluster_{}", i)}}, i);
+    addGauge(fmt::format("cluster.cluster_{}.upstream_cx_active", i), "cluster.upstream_cx_active",
+             {{"envoy.cluster_name", fmt::format("cluster_{}", i)}}, i);
+  }
+
+  for (const auto format :
+       {PrometheusStatsWriter::Format::Text, PrometheusStatsWriter::Format::Protobuf}) {
+    PrometheusStatsWriterPtr writer = makeWriter(format);
+    Buffer::OwnedImpl response;
+    uint32_t num_chunks = 0;
+    bool more = true;
+    while (more) {
+      Buffer::OwnedImpl chunk;
+      more = writer->nextChunk(chunk);
+      ++num_chunks;
+      // A chunk only goes over its size by its last metric, or by its only metric family.
+      if (format == PrometheusStatsWriter::Format::Text) {
+        EXPECT_LT(chunk.length(), PrometheusStatsWriter::ChunkSize + 1024);
+      }
+      response.move(chunk);
+    }
+
+    if (format == PrometheusStatsWriter::Format::Text) {
+      EXPECT_GT(num_chunks, 5);
+      EXPECT_EQ(num_counters * 2 + 2, TestUtility::split(response.toString(), '\n').size());
+    } else {
+      EXPECT_EQ(2, num_chunks);
+      const std::vector<io::prometheus::client::MetricFamily> families =
+          parseFamilies(response.toString());
+      ASSERT_EQ(2, families.size());
+      EXPECT_EQ(num_counters, families[0].metric_size());
+      EXPECT_EQ(num_counters, families[1].metric_size());
+    }
+  }
+}
+
+class PrometheusStatsStreamTest : public PrometheusStatsWriterTest {
+protected:
+  PrometheusStatsStreamTest() {
+    for (uint32_t i = 0; i < 5000; ++i) {
+      const std::string cluster_name = fmt::format("cluster_{}", i);
+      addCounter(fmt::format("cluster.{}.upstream_cx_total", cluster_name),
+                 "cluster.upstream_cx_total", {{"envoy.cluster_name", cluster_name}}, i);
+    }
+
+    ON_CALL(admin_stream_, getDecoderFilterCallbacks()).WillByDefault(ReturnRef(callbacks_));
+    ON_CALL(admin_stream_, addOnDestroyCallback(_))
+        .WillByDefault(Invoke([this](std::function<void()> cb) { on_destroy_ = cb; }));
+    ON_CALL(callbacks_.dispatcher_, post(_))
+        .WillByDefault(Invoke([this](std::function<void()> cb) { posted_.push_back(cb); }));
+    ON_CALL(callbacks_, encodeData(_, _))
+        .WillByDefault(Invoke([this](Buffer::Instance& data, bool end_stream) {
+          ASSERT_FALSE(end_stream_);
+          response_.move(data);
+          end_stream_ = end_stream;
+        }));
+  }
+
+  void start() {
+    PrometheusStatsWriterPtr writer = makeWriter(PrometheusStatsWriter::Format::Text);
+    Buffer::OwnedImpl first_chunk;
+    ASSERT_TRUE(writer->nextChunk(first_chunk));
+    response_.move(first_chunk);
+    EXPECT_CALL(admin_stream_, setEndStreamOnComplete(false));
+    PrometheusStatsStream::start(std::move(writer), admin_stream_);
+    ASSERT_EQ(1, callbacks_.callbacks_.size());
+  }
+
+  // Runs the posted callbacks, including those posted while they run.
+  void runPosted() {
+    while (!posted_.empty()) {
+      std::function<void()> cb = posted_.front();
+      posted_.erase(posted_.begin());
+      cb();
+    }
+  }
+
+  NiceMock<MockAdminStream> admin_stream_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> callbacks_;
+  std::function<void()> on_destroy_;
+  std::vector<std::function<void()>> posted_;
+  Buffer::OwnedImpl response_;
+  bool end_stream_{};
+};
+
+TEST_F(PrometheusStatsStreamTest, WritesAllChunks) {
+  start();
+  // One chunk is written per dispatcher iteration.
+  EXPECT_EQ(1, posted_.size());
+  runPosted();
+  EXPECT_TRUE(end_stream_);
+  EXPECT_EQ(text(), response_.toString());
+
+  on_destroy_();
+  EXPECT_TRUE(callbacks_.callbacks_.empty());
+}
+
+TEST_F(PrometheusStatsStreamTest, PausesAboveHighWatermark) {
+  start();
+  Http::DownstreamWatermarkCallbacks& watermark_callbacks = *callbacks_.callbacks_.front();
+
+  // The writes stop after the posted chunk while the connection is above its high watermark.
+  watermark_callbacks.onAboveWriteBufferHighWatermark();
+  watermark_callbacks.onAboveWriteBufferHighWatermark();
+  runPosted();
+  EXPECT_FALSE(end_stream_);
+  const uint64_t paused_length = response_.length();
+
+  watermark_callbacks.onBelowWriteBufferLowWatermark();
+  EXPECT_TRUE(posted_.empty());
+  watermark_callbacks.onBelowWriteBufferLowWatermark();
+  EXPECT_EQ(1, posted_.size());
+  runPosted();
+  EXPECT_TRUE(end_stream_);
+  EXPECT_LT(paused_length, response_.length());
+  EXPECT_EQ(text(), response_.toString());
+
+  on_destroy_();
+}
+
+TEST_F(PrometheusStatsStreamTest, StopsWhenDestroyed) {
+  start();
+  EXPECT_CALL(callbacks_, encodeData(_, _)).Times(0);
+  on_destroy_();
+  EXPECT_TRUE(callbacks_.callbacks_.empty());
+  runPosted();
+  EXPECT_FALSE(end_stream_);
+}
+
+} // namespace Server
+} // namespace Envoy
@@ -78,6 +78,110 @@ TEST(ServerInstanceUtil, flushHelper) {
   InstanceUtil::flushMetricsToSinks(sinks, mock_store);
 }
 
+TEST(ServerInstanceUtil, flushChangedMetrics) {
+  Stats::IsolatedStoreImpl store;
+  Stats::Counter& changed_counter = store.counter("changed_counter");
+  store.counter("unchanged_counter").inc();
+  Stats::Gauge& changed_gauge = store.gauge("changed_gauge", Stats::Gauge::ImportMode::Accumulate);
+  store.gauge("unchanged_gauge", Stats::Gauge::ImportMode::Accumulate).set(1);
+
+  std::list<Stats::SinkPtr> sinks;
+  // The first flush latches the initial updates.
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  Stats::MockSink* sink = new StrictMock<Stats::MockSink>();
+  sinks.emplace_back(sink);
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(snapshot.counters().size(), 2);
+    ASSERT_EQ(snapshot.changedCounters().size(), 1);
+    EXPECT_EQ(snapshot.changedCounters()[0].counter_.get().name(), "changed_counter");
+    EXPECT_EQ(snapshot.changedCounters()[0].delta_, 2);
+
+    EXPECT_EQ(snapshot.gauges().size(), 2);
+    ASSERT_EQ(snapshot.changedGauges().size(), 1);
+    EXPECT_EQ(snapshot.changedGauges()[0].get().name(), "changed_gauge");
+    EXPECT_EQ(snapshot.changedGauges()[0].get().value(), 0);
+  }));
+  changed_counter.add(2);
+  changed_gauge.inc();
+  changed_gauge.dec();
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+
+  EXPECT_CALL(*sink, flush(_)).WillOnce(Invoke([](Stats::MetricSnapshot& snapshot) {
+    EXPECT_TRUE(snapshot.changedCounters().empty());
+    EXPECT_TRUE(snapshot.changedGauges().empty());
+  }));
+  InstanceUtil::flushMetricsToSinks(sinks, store);
+}
+
+TEST(StatsFlushThreadTest, FlushOffAndOnMainThread) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr main_dispatcher = api->allocateDispatcher();
+  Stats::IsolatedStoreImpl store;
+  Stats::Counter& c = store.counter("hello");
+  c.inc();
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* thread_sink = new NiceMock<Stats::MockSink>();
+  ON_CALL(*thread_sink, flushOnMainThread()).WillByDefault(Return(false));
+  sinks.emplace_back(thread_sink);
+  Stats::MockSink* main_thread_sink = new NiceMock<Stats::MockSink>();
+  sinks.emplace_back(main_thread_sink);
+
+  const std::thread::id main_thread_id = std::this_thread::get_id();
+  std::thread::id flush_thread_id;
+  Stats::MetricSnapshot* flushed_snapshot = nullptr;
+  EXPECT_CALL(*thread_sink, flush(_)).WillOnce(Invoke([&](Stats::MetricSnapshot& snapshot) {
+    flush_thread_id = std::this_thread::get_id();
+    flushed_snapshot = &snapshot;
+    ASSERT_EQ(snapshot.counters().size(), 1);
+    EXPECT_EQ(snapshot.counters()[0].delta_, 1);
+  }));
+  EXPECT_CALL(*main_thread_sink, flush(_)).WillOnce(Invoke([&](Stats::MetricSnapshot& snapshot) {
+    EXPECT_EQ(main_thread_id, std::this_thread::get_id());
+    // Both sinks see the same snapshot.
+    EXPECT_EQ(flushed_snapshot, &snapshot);
+  }));
+
+  StatsFlushThread flush_thread(*api, *main_dispatcher);
+  bool done = false;
+  flush_thread.flush(sinks, store, [&done]() -> void { done = true; });
+  while (!done) {
+    main_dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  }
+  EXPECT_NE(main_thread_id, flush_thread_id);
+  EXPECT_EQ(0, c.latch());
+}
+
+// Destroying the thread drops a flush whose main thread half is already posted.
+TEST(StatsFlushThreadTest, DestroyedWithFlushInProgress) {
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr main_dispatcher = api->allocateDispatcher();
+  Stats::IsolatedStoreImpl store;
+
+  std::list<Stats::SinkPtr> sinks;
+  Stats::MockSink* thread_sink = new NiceMock<Stats::MockSink>();
+  ON_CALL(*thread_sink, flushOnMainThread()).WillByDefault(Return(false));
+  sinks.emplace_back(thread_sink);
+  Stats::MockSink* main_thread_sink = new NiceMock<Stats::MockSink>();
+  sinks.emplace_back(main_thread_sink);
+
+  absl::Notification thread_flushed;
+  EXPECT_CALL(*thread_sink, flush(_)).WillOnce(Invoke([&](Stats::MetricSnapshot&) {
+    thread_flushed.Notify();
+  }));
+  EXPECT_CALL(*main_thread_sink, flush(_)).Times(0);
+
+  auto flush_thread = std::make_unique<StatsFlushThread>(*api, *main_dispatcher);
+  bool done = false;
+  flush_thread->flush(sinks, store, [&done]() -> void { done = true; });
+  thread_flushed.WaitForNotification();
+  // Joining the thread waits for the main thread half to be posted.
+  flush_thread.reset();
+  main_dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(done);
+}
+
 class RunHelperTest : public testing::Test {
 public:
   RunHelperTest() {
@@ -247,6 +351,7 @@ public:
 
   // Stats::Sink
   void flush(Stats::MetricSnapshot&) override { stats_flushed_.inc(); }
+  bool flushOnMainThread() const override { return false; }
 
   void onHistogramComplete(const Stats::Histogram&, uint64_t) override {}
 
@@ -291,6 +396,17 @@ TEST_P(ServerInstanceImplTest, StatsFlushWhenServerIsStillInitializing) {
   server_thread->join();
 }
 
+// Validates that stats are flushed repeatedly when they are flushed on a dedicated thread.
+TEST_P(ServerInstanceImplTest, StatsFlushOnDedicatedThread) {
+  auto server_thread =
+      startTestServer("test/server/stats_sink_dedicated_thread_bootstrap.yaml", true);
+
+  TestUtility::waitForCounterEq(stats_store_, "stats.flushed", 2, time_system_);
+
+  server_->dispatcher().post([&] { server_->shutdown(); });
+  server_thread->join();
+}
+
 // Validates that the "server.version" is updated with stats_server_version_override from bootstrap.
 TEST_P(ServerInstanceImplTest, ProxyVersionOveridesFromBootstrap) {
   auto server_thread = startTestServer("test/server/proxy_version_bootstrap.yaml", true);
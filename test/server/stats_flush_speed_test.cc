@@ -0,0 +1,112 @@
+// Usage: bazel run //test/server:stats_flush_speed_test
+//
+// Compares flushing the stats to a statsd sink on the main thread with flushing them on the
+// dedicated stats flush thread. The flush_ns counter is the time the main thread spends on each
+// flush, while the iteration time is the latency until the flush is done.
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "common/common/fmt.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "server/server.h"
+
+#include "extensions/stat_sinks/common/statsd/statsd.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Server {
+namespace {
+
+/**
+ * Statsd writer which only drops the serialized metrics.
+ */
+class NullWriter : public Extensions::StatSinks::Common::Statsd::Writer {
+public:
+  void write(const std::string&) override {}
+};
+
+/**
+ * Store with half of the metrics being counters, and the other half gauges.
+ */
+class StatsFlushTester {
+public:
+  explicit StatsFlushTester(uint64_t num_metrics) {
+    for (uint64_t i = 0; i < num_metrics / 2; i++) {
+      store_.counter(fmt::format("cluster.cluster_{}.upstream_rq_total", i)).inc();
+      store_.gauge(fmt::format("cluster.cluster_{}.upstream_cx_active", i),
+                   Stats::Gauge::ImportMode::Accumulate)
+          .set(i);
+    }
+    sinks_.push_back(std::make_unique<Extensions::StatSinks::Common::Statsd::UdpStatsdSink>(
+        tls_, std::make_shared<NullWriter>(), false));
+  }
+
+  ~StatsFlushTester() { tls_.shutdownThread(); }
+
+  Stats::IsolatedStoreImpl store_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::list<Stats::SinkPtr> sinks_;
+};
+
+// Flushes on the main thread. state.range(0) is the number of metrics.
+void BM_StatsFlushMainThread(benchmark::State& state) {
+  StatsFlushTester tester(state.range(0));
+  std::chrono::nanoseconds main_thread_time{};
+  for (auto _ : state) {
+    const auto start = std::chrono::steady_clock::now();
+    InstanceUtil::flushMetricsToSinks(tester.sinks_, tester.store_);
+    main_thread_time += std::chrono::steady_clock::now() - start;
+  }
+  state.counters["flush_ns"] =
+      benchmark::Counter(main_thread_time.count(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_StatsFlushMainThread)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Flushes on the stats flush thread. state.range(0) is the number of metrics.
+void BM_StatsFlushDedicatedThread(benchmark::State& state) {
+  StatsFlushTester tester(state.range(0));
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr main_dispatcher = api->allocateDispatcher();
+  StatsFlushThread flush_thread(*api, *main_dispatcher);
+  std::chrono::nanoseconds main_thread_time{};
+  for (auto _ : state) {
+    bool done = false;
+    const auto start = std::chrono::steady_clock::now();
+    flush_thread.flush(tester.sinks_, tester.store_, [&done]() -> void { done = true; });
+    main_thread_time += std::chrono::steady_clock::now() - start;
+    while (!done) {
+      main_dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+    }
+  }
+  state.counters["flush_ns"] =
+      benchmark::Counter(main_thread_time.count(), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_StatsFlushDedicatedThread)
+    ->Arg(100000)
+    ->Arg(1000000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+} // namespace
+} // namespace Server
+} // namespace Envoy
+
+// Boilerplate main(), which discovers benchmarks in the same file and runs them.
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+}